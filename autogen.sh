@@ -1,4 +1,21 @@
 #! /bin/sh
+# Makefile.in, configure and aclocal.m4 in the tree are generated by these
+# versions, regenerate them by the same ones to keep their diffs reviewable
+AUTOMAKE_VERSION=1.16.5
+AUTOCONF_VERSION=2.71
+
+check_version()
+{
+	found=`$1 --version | sed -n '1s/.* //p'`
+	if test "$found" != "$2"; then
+		echo "$0: $1 $2 is required, but $1 $found is found" >&2
+		exit 1
+	fi
+}
+
+check_version automake $AUTOMAKE_VERSION
+check_version autoconf $AUTOCONF_VERSION
+
 aclocal $ACLOCAL_AMFLAGS
 autoheader
 automake --foreign --add-missing --copy
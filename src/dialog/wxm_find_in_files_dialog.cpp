@@ -13,6 +13,10 @@
 #include "../wxmedit_frame.h"
 #include "../wxm/edit/inframe.h"
 #include "../wxm/edit/single_line.h"
+#include "../wxm/dir_walker.h"
+#include "../wxm/find_in_files.h"
+#include "../wxm/replace_journal.h"
+#include "../wxm/trigram_index.h"
 #include "../wxm/utils.h"
 
 #ifdef _MSC_VER
@@ -24,6 +28,7 @@
 #include <wx/dir.h>
 #include <wx/tokenzr.h>
 #include <wx/filename.h>
+#include <wx/utils.h>
 
 //(*InternalHeaders(WXMFindInFilesDialog)
 #include <wx/intl.h>
@@ -35,6 +40,7 @@
 #endif
 
 //#include <boost/scoped_ptr.hpp>
+#include <algorithm>
 
 #ifdef _DEBUG
 #include <crtdbg.h>
@@ -56,6 +62,7 @@ const long WXMFindInFilesDialog::ID_WXCHECKBOXLISTFIRSTONLY = wxNewId();
 const long WXMFindInFilesDialog::ID_WXBUTTONFIND = wxNewId();
 const long WXMFindInFilesDialog::ID_WXBUTTONREPLACE = wxNewId();
 const long WXMFindInFilesDialog::ID_WXCHECKBOXENABLEREPLACE = wxNewId();
+const long WXMFindInFilesDialog::ID_WXBUTTONUNDOREPLACE = wxNewId();
 const long WXMFindInFilesDialog::ID_STATICLINE1 = wxNewId();
 const long WXMFindInFilesDialog::ID_WXRADIOBUTTONOPENEDFILES = wxNewId();
 const long WXMFindInFilesDialog::ID_WXRADIOBUTTONDIR = wxNewId();
@@ -73,6 +80,9 @@ const long WXMFindInFilesDialog::ID_STATICTEXT6 = wxNewId();
 const long WXMFindInFilesDialog::ID_STATICTEXT7 = wxNewId();
 const long WXMFindInFilesDialog::ID_WXCOMBOBOXENCODING = wxNewId();
 const long WXMFindInFilesDialog::ID_WXCHECKBOXSUBDIR = wxNewId();
+const long WXMFindInFilesDialog::ID_WXCHECKBOXUSEINDEX = wxNewId();
+const long WXMFindInFilesDialog::ID_WXCHECKBOXGITIGNORE = wxNewId();
+const long WXMFindInFilesDialog::ID_WXCHECKBOXSKIPBINARY = wxNewId();
 //*)
 
 const long WXMFindInFilesDialog::ID_MADEDIT1 = wxNewId();
@@ -140,6 +150,8 @@ WXMFindInFilesDialog::WXMFindInFilesDialog(wxWindow* parent,wxWindowID id,const
 	WxCheckBoxEnableReplace = new wxCheckBox(this, ID_WXCHECKBOXENABLEREPLACE, _("&Enable Replace"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXCHECKBOXENABLEREPLACE"));
 	WxCheckBoxEnableReplace->SetValue(false);
 	BoxSizer5->Add(WxCheckBoxEnableReplace, 0, wxALL|wxEXPAND, 2);
+	WxButtonUndoReplace = new wxButton(this, ID_WXBUTTONUNDOREPLACE, _("&Undo Replace"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXBUTTONUNDOREPLACE"));
+	BoxSizer5->Add(WxButtonUndoReplace, 0, wxALL|wxEXPAND, 2);
 	WxButtonClose = new wxButton(this, wxID_CANCEL, _("Close"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("wxID_CANCEL"));
 	BoxSizer5->Add(WxButtonClose, 0, wxALL|wxEXPAND, 2);
 	BoxSizer2->Add(BoxSizer5, 0, wxALL|wxALIGN_TOP, 0);
@@ -182,6 +194,15 @@ WXMFindInFilesDialog::WXMFindInFilesDialog(wxWindow* parent,wxWindowID id,const
 	WxCheckBoxSubDir = new wxCheckBox(this, ID_WXCHECKBOXSUBDIR, _("Include Subdirectories"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXCHECKBOXSUBDIR"));
 	WxCheckBoxSubDir->SetValue(false);
 	BoxSizer3->Add(WxCheckBoxSubDir, 0, wxALL|wxALIGN_LEFT, 2);
+	WxCheckBoxUseIndex = new wxCheckBox(this, ID_WXCHECKBOXUSEINDEX, _("Use Index of the Directory"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXCHECKBOXUSEINDEX"));
+	WxCheckBoxUseIndex->SetValue(false);
+	BoxSizer3->Add(WxCheckBoxUseIndex, 0, wxALL|wxALIGN_LEFT, 2);
+	WxCheckBoxGitIgnore = new wxCheckBox(this, ID_WXCHECKBOXGITIGNORE, _("Skip Files Ignored by .gitignore"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXCHECKBOXGITIGNORE"));
+	WxCheckBoxGitIgnore->SetValue(false);
+	BoxSizer3->Add(WxCheckBoxGitIgnore, 0, wxALL|wxALIGN_LEFT, 2);
+	WxCheckBoxSkipBinary = new wxCheckBox(this, ID_WXCHECKBOXSKIPBINARY, _("Skip Binary Files"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXCHECKBOXSKIPBINARY"));
+	WxCheckBoxSkipBinary->SetValue(false);
+	BoxSizer3->Add(WxCheckBoxSkipBinary, 0, wxALL|wxALIGN_LEFT, 2);
 	BoxSizer1->Add(BoxSizer3, 1, wxALL|wxEXPAND, 0);
 	SetSizer(BoxSizer1);
 	BoxSizer1->Fit(this);
@@ -192,6 +213,7 @@ WXMFindInFilesDialog::WXMFindInFilesDialog(wxWindow* parent,wxWindowID id,const
 	Connect(ID_WXBUTTONFIND,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMFindInFilesDialog::WxButtonFindClick);
 	Connect(ID_WXBUTTONREPLACE,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMFindInFilesDialog::WxButtonReplaceClick);
 	Connect(ID_WXCHECKBOXENABLEREPLACE,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&WXMFindInFilesDialog::WxCheckBoxEnableReplaceClick);
+	Connect(ID_WXBUTTONUNDOREPLACE,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMFindInFilesDialog::WxButtonUndoReplaceClick);
 	Connect(ID_WXBUTTONDIR,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMFindInFilesDialog::WxButtonDirClick);
 	Connect(ID_WXBUTTONACTIVEDIR,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMFindInFilesDialog::WxButtonActiveDirClick);
 	Connect(wxID_ANY,wxEVT_CLOSE_WINDOW,(wxObjectEventFunction)&WXMFindInFilesDialog::WXMFindInFilesDialogClose);
@@ -405,6 +427,7 @@ void WXMFindInFilesDialog::WXMFindInFilesDialogActivate(wxActivateEvent& event)
 	{
 		WxButtonReplace->Disable();
 		WxCheckBoxEnableReplace->SetValue(false);
+		WxButtonUndoReplace->Enable(wxm::ReplaceJournal::Exists());
 
 		bool bb;
 		cfg->Read(wxT("/wxMEdit/SearchCaseSensitive"), &bb, false);
@@ -435,6 +458,15 @@ void WXMFindInFilesDialog::WXMFindInFilesDialogActivate(wxActivateEvent& event)
 		cfg->Read(wxT("/wxMEdit/FindSubDir"), &bb, true);
 		WxCheckBoxSubDir->SetValue(bb);
 
+		cfg->Read(wxT("/wxMEdit/FindUseIndex"), &bb, false);
+		WxCheckBoxUseIndex->SetValue(bb);
+
+		cfg->Read(wxT("/wxMEdit/FindGitIgnore"), &bb, false);
+		WxCheckBoxGitIgnore->SetValue(bb);
+
+		cfg->Read(wxT("/wxMEdit/FindSkipBinary"), &bb, false);
+		WxCheckBoxSkipBinary->SetValue(bb);
+
 		if (wxm::UseForceEncoding(cfg))
 		{
 			wxString enc = wxm::GetForceEncoding(cfg);
@@ -458,6 +490,9 @@ void WXMFindInFilesDialog::WXMFindInFilesDialogActivate(wxActivateEvent& event)
 		cfg->Write(wxT("/wxMEdit/FindOpenedFiles"), WxRadioButtonOpenedFiles->GetValue());
 		cfg->Write(wxT("/wxMEdit/FindDir"), WxRadioButtonDir->GetValue());
 		cfg->Write(wxT("/wxMEdit/FindSubDir"), WxCheckBoxSubDir->GetValue());
+		cfg->Write(wxT("/wxMEdit/FindUseIndex"), WxCheckBoxUseIndex->GetValue());
+		cfg->Write(wxT("/wxMEdit/FindGitIgnore"), WxCheckBoxGitIgnore->GetValue());
+		cfg->Write(wxT("/wxMEdit/FindSkipBinary"), WxCheckBoxSkipBinary->GetValue());
 	}
 
 	cfg->SetPath(oldpath);
@@ -475,61 +510,65 @@ typedef unordered_set<wxString, wxStringHash> MadFileNameList;
 
 MadFileNameList g_FileNameList; // the filenames matched the filename filter
 
-vector<wxString> g_ExcludeFilters;
-
-class DirTraverser : public wxDirTraverser
+class CaretPosData: public wxClientData
 {
 public:
-	wxDirTraverseResult Continue()
-	{
-		wxLongLong t=wxGetLocalTimeMillis();
-		wxLongLong delta=t-g_Time;
-		if(delta.ToLong()>=350)
-		{
-			g_Time=t;
-			g_Continue=g_ProgressDialog->Update(0, wxString::Format(fmtmsg1, g_FileNameList.size()));
-			if(!g_Continue) return wxDIR_STOP;
-		}
-		return wxDIR_CONTINUE;
-	}
-	virtual wxDirTraverseResult OnFile(const wxString& filename) override
+	wxString filename;
+	int pageid; // >=0 for 'NoName'
+	wxFileOffset bpos, epos;
+	CaretPosData(const wxString &fn, int pid, const wxFileOffset &b, wxFileOffset &e)
+		: filename(fn), pageid(pid), bpos(b), epos(e) {}
+};
+
+// the first files of a list in a message
+static wxString FileListMessage(const wxString& title, const vector<wxString>& files)
+{
+	const size_t max_files = 20;
+	wxString msg(title);
+	for(size_t i=0; i<files.size() && i<max_files; ++i)
+		msg << wxT('\n') << files[i];
+	if(files.size() > max_files)
+		msg << wxT("\n...");
+	return msg;
+}
+
+// list the matches found by the worker threads of FindInFilesEngine
+static size_t AddFileMatchesToResults(const vector<wxm::FileMatches>& batch)
+{
+	size_t count = 0;
+	wxString linetext, loc;
+	g_MainFrame->m_FindInFilesResults->Freeze();
+	for(size_t i=0; i<batch.size(); ++i)
 	{
-		bool exclude=false;
-		if(!g_ExcludeFilters.empty())
+		const wxm::FileMatches& fms = batch[i];
+		wxString filename(fms.filename.c_str());
+		for(size_t idx=0; idx<fms.matches.size(); ++idx)
 		{
-			wxFileName fn;
-			size_t count=g_ExcludeFilters.size();
-			for(size_t i=0; i<count; i++)
+			const wxm::FileMatch& fm = fms.matches[idx];
+			if(fm.line >= 0)
 			{
-				fn.Assign(filename);
-				if(wxm::FilePathNormalCase(fn.GetFullName()).Matches(g_ExcludeFilters[i].c_str()))
+				if(idx==0 || fm.line!=fms.matches[idx-1].line || !fm.linetext.empty())
 				{
-					exclude=true;
-					break;
+					linetext.Empty();
+					for(size_t c=0; c<fm.linetext.size(); ++c)
+						wxm::WxStrAppendUCS4(linetext, fm.linetext[c]);
 				}
+				loc.Printf(_("Line(%d): "), fm.line+1);
 			}
+			else
+			{
+				loc.Printf(_("Offset(%s): "), wxLongLong(fm.begpos).ToString().c_str());
+				linetext = _("Binary file matches");
+			}
+
+			wxFileOffset endpos = fm.endpos;
+			g_MainFrame->AddItemToFindInFilesResults(loc+linetext, idx, filename, -1, fm.begpos, endpos);
 		}
-		if(!exclude && g_FileNameList.find(filename) == g_FileNameList.end())
-		{
-			g_FileNameList.insert(filename);
-		}
-		return Continue();
+		count += fms.matches.size();
 	}
-	virtual wxDirTraverseResult OnDir(const wxString& WXUNUSED(dirname)) override
-	{
-		return Continue();
-	}
-};
-
-class CaretPosData: public wxClientData
-{
-public:
-	wxString filename;
-	int pageid; // >=0 for 'NoName'
-	wxFileOffset bpos, epos;
-	CaretPosData(const wxString &fn, int pid, const wxFileOffset &b, wxFileOffset &e)
-		: filename(fn), pageid(pid), bpos(b), epos(e) {}
-};
+	g_MainFrame->m_FindInFilesResults->Thaw();
+	return count;
+}
 
 void WXMFindInFilesDialog::FindReplaceInFiles(bool bReplace)
 {
@@ -604,15 +643,15 @@ void WXMFindInFilesDialog::FindReplaceInFiles(bool bReplace)
 		str.Trim(true);
 		str.Trim(false);
 		wxStringTokenizer tkz2(str, wxT(" \t;"));
-		g_ExcludeFilters.clear();
+		vector<wxString> excludes;
 		for(;;)
 		{
 			tok=tkz2.GetNextToken();
 			if(tok.IsEmpty())
 				break;
-			g_ExcludeFilters.push_back(wxm::FilePathNormalCase(tok));
+			excludes.push_back(tok);
 		}
-		if(!g_ExcludeFilters.empty())
+		if(!excludes.empty())
 		{
 			m_RecentFindExclude->AddItemToHistory(str);
 			if(WxComboBoxExclude->GetCount()==0 || WxComboBoxExclude->GetString(0)!=str)
@@ -624,27 +663,132 @@ void WXMFindInFilesDialog::FindReplaceInFiles(bool bReplace)
 		// get the files matched the filters
 		g_FileNameList.clear();
 
-		DirTraverser traverser;
-		wxDir dir(WxComboBoxDir->GetValue());
-		int flags=wxDIR_FILES|wxDIR_HIDDEN;
-		if(WxCheckBoxSubDir->GetValue()) flags|=wxDIR_DIRS;
+		// walk the dirs once for all the filters
+		wxm::DirWalkerOptions wopt;
+		wopt.dir=WxComboBoxDir->GetValue();
+		wopt.recursive=WxCheckBoxSubDir->GetValue();
+		wopt.includes=filters;
+		wopt.excludes=excludes;
+		wopt.gitignore=WxCheckBoxGitIgnore->GetValue();
+		wopt.skip_binary=WxCheckBoxSkipBinary->GetValue();
+
+		wxm::DirWalker walker;
+		walker.Start(wopt);
+		while(!walker.Wait(350))
+		{
+			g_Continue=dialog.Update(0, wxString::Format(fmtmsg1, walker.GetFileCount()));
+			if(!g_Continue)
+			{
+				walker.Stop();
+				break;
+			}
+		}
+
+		vector<wxString> found;
+		walker.GetFiles(found);
+		g_FileNameList.insert(found.begin(), found.end());
 
-		if(filters.empty())
+		totalfiles=g_FileNameList.size();
+	}
+
+	wxString fmt(_("Processing %d of %d files..."));
+	bool cont = g_Continue;
+	size_t replaced = 0;
+	vector<wxString> failed, damaged;
+	bool invalid = false;
+
+	// search or replace the files not opened on the worker threads without
+	// laying them out, only the opened files are processed by MadEdit
+	if(cont && WxRadioButtonDir->GetValue())
+	{
+		// all the files are indexed after searching, the opened ones too
+		const wxString dir = WxComboBoxDir->GetValue();
+		const bool useindex = WxCheckBoxUseIndex->GetValue();
+		vector<wxString> indexfiles;
+		if(useindex)
+			indexfiles.assign(g_FileNameList.begin(), g_FileNameList.end());
+
+		vector<wxString> files;
+		for(MadFileNameList::iterator it=g_FileNameList.begin(); it!=g_FileNameList.end(); ++it)
+		{
+			int id;
+			if(g_MainFrame->GetEditByFileName(*it, id)==nullptr)
+				files.push_back(*it);
+		}
+		for(size_t i=0; i<files.size(); ++i)
+			g_FileNameList.erase(files[i]);
+
+		wxm::FindInFilesOptions opt;
+		m_FindText->GetText(opt.expr);
+		opt.inhex = WxCheckBoxFindHex->GetValue();
+		opt.use_regex = WxCheckBoxRegex->GetValue();
+		opt.case_sensitive = WxCheckBoxCaseSensitive->GetValue();
+		opt.whole_word = WxCheckBoxWholeWord->GetValue();
+		opt.first_only = WxCheckBoxListFirstOnly->GetValue();
+		opt.encoding = xm::EncodingManager::ExtractEncodingName(WxComboBoxEncoding->GetValue().wc_str());
+		if(opt.encoding == xm::EncodingManager::ExtractEncodingName(WxComboBoxEncoding->GetString(0).wc_str()))
+			opt.encoding.clear();
+		opt.replace = bReplace;
+		if(bReplace)
+			m_ReplaceText->GetText(opt.fmt);
+
+		// the indexed files not changed since then are searched only if they
+		// contain the trigrams of the literals of the expression
+		wxm::TrigramIndex index;
+		if(useindex && index.Load(wxm::TrigramIndex::IndexPath(dir).wc_str(), wxm::TrigramIndex::NormalDir(dir)))
+			opt.index = &index;
+
+		wxm::FindInFilesEngine engine;
+		if(opt.expr.IsEmpty() || files.empty())
 		{
-			dir.Traverse(traverser, wxEmptyString, flags);
+			// nothing to search
+		}
+		else if(!engine.Start(files, opt))
+		{
+			cont = false;   // the expression or the format is invalid
+			invalid = true;
+			wxMessageBox(engine.GetError(), wxT("wxMEdit"), wxOK | wxICON_ERROR);
 		}
 		else
 		{
-			for(size_t i=0; i<filters.size(); i++)
+			const size_t searching = std::max<size_t>(engine.GetFileCount(), 1);
+			vector<wxm::FileMatches> batch;
+			while(engine.WaitResults(batch, 100))
 			{
-				dir.Traverse(traverser, filters[i], flags);
+				size_t count = AddFileMatchesToResults(batch);
+#ifdef SHOW_RESULT_COUNT
+				ResultCount += int(count);
+#endif
+				if(bReplace)
+					replaced += count;
+				batch.clear();
+
+				wxLongLong t=wxGetLocalTimeMillis();
+				if(cont && (t-g_Time).ToLong()>=350)
+				{
+					g_Time=t;
+					size_t done = engine.GetProcessedCount();
+					wxString str=wxString::Format(fmt, done, searching);
+					str << wxT('\n') << engine.GetCurrentFile();
+					cont = dialog.Update(int(done*max / searching), str);
+					if(!cont)
+						engine.Stop();
+				}
 			}
+
+			const vector<wxString>& skipped = engine.GetSkippedFiles();
+			g_FileNameList.insert(skipped.begin(), skipped.end());
+			failed = engine.GetFailedFiles();
+			damaged = engine.GetDamagedFiles();
 		}
 
-		totalfiles=g_FileNameList.size();
+		// update the index on the background thread
+		index.Close();
+		if(useindex)
+			wxm::TrigramIndexer::Instance().Update(dir, indexfiles);
 	}
 
-	if(g_Continue)
+	if(cont)
 	{
 		std::unique_ptr<MadEdit> tempedit;
 		if(WxRadioButtonDir->GetValue())
@@ -652,10 +796,11 @@ void WXMFindInFilesDialog::FindReplaceInFiles(bool bReplace)
 			tempedit.reset(new wxm::SearchingWXMEdit(this, WxCheckBoxWholeWord->GetValue()));
 		}
 
-		wxString fmt(_("Processing %d of %d files..."));
+		if(WxRadioButtonDir->GetValue())
+			totalfiles=g_FileNameList.size();
+
 		vector<wxFileOffset> begpos, endpos;
 		MadFileNameList::iterator fnit=g_FileNameList.begin();
-		bool cont = true;
 		for(size_t i = 0; i < totalfiles && cont; i++)
 		{
 			MadEdit *madedit = nullptr;
@@ -713,6 +858,7 @@ void WXMFindInFilesDialog::FindReplaceInFiles(bool bReplace)
 				ok = searcher.ReplaceAll(expr, fmt, &begpos, &endpos);
 
 				if(ok<0) break;
+				replaced += size_t(ok);
 
 				expr=madedit->GetFileName();
 				int id = ((wxAuiNotebook*)g_MainFrame->m_Notebook)->GetPageIndex(madedit);
@@ -786,6 +932,19 @@ void WXMFindInFilesDialog::FindReplaceInFiles(bool bReplace)
 	g_ProgressDialog=nullptr;
 	g_FileNameList.clear();
 
+	if(bReplace && !invalid)
+	{
+		WxButtonUndoReplace->Enable(wxm::ReplaceJournal::Exists());
+
+		wxString msg = wxString::Format(_("%d string(s) were replaced."), int(replaced));
+		if(!failed.empty())
+			msg << wxT("\n\n") << FileListMessage(_("The files below were not replaced:"), failed);
+		if(!damaged.empty())
+			msg << wxT("\n\n") << FileListMessage(_("The files below could not be written completely.\nThe original of each file is kept in the file name + \".wxmbak\", and the replaced one in the file name + \".wxmtmp\":"), damaged);
+		const bool warn = !failed.empty() || !damaged.empty();
+		wxMessageBox(msg, wxT("wxMEdit"), wxOK | (warn? wxICON_WARNING: wxICON_INFORMATION));
+	}
+
 #ifdef SHOW_RESULT_COUNT
 	wxString smsg;
 	smsg.Printf(_("%d results"), ResultCount);
@@ -798,6 +957,26 @@ void WXMFindInFilesDialog::WxCheckBoxEnableReplaceClick(wxCommandEvent& event)
 	WxButtonReplace->Enable(event.IsChecked());
 }
 
+// restore the files written by the worker threads in the last Replace in Files
+void WXMFindInFilesDialog::WxButtonUndoReplaceClick(wxCommandEvent& event)
+{
+	if(wxMessageBox(_("Restore the files replaced by the last Replace in Files?"), wxT("wxMEdit"), wxYES_NO|wxICON_QUESTION, this)!=wxYES)
+		return;
+
+	vector<wxString> failed;
+	size_t count;
+	{
+		wxBusyCursor wait;
+		count = wxm::ReplaceJournal::Rollback(failed);
+	}
+	WxButtonUndoReplace->Disable();
+
+	wxString msg = wxString::Format(_("%d file(s) were restored."), int(count));
+	if(!failed.empty())
+		msg << wxT("\n\n") << FileListMessage(_("The files below were changed since replaced, or cannot be written:"), failed);
+	wxMessageBox(msg, wxT("wxMEdit"), wxOK | (failed.empty()? wxICON_INFORMATION: wxICON_WARNING), this);
+}
+
 extern wxm::InFrameWXMEdit* g_active_wxmedit;
 void WXMFindInFilesDialog::WxButtonActiveDirClick(wxCommandEvent& event)
 {
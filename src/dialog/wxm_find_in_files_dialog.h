@@ -50,12 +50,16 @@ class WXMFindInFilesDialog: public wxDialog
 		wxButton* WxButtonDir;
 		wxButton* WxButtonFind;
 		wxButton* WxButtonReplace;
+		wxButton* WxButtonUndoReplace;
 		wxCheckBox* WxCheckBoxCaseSensitive;
 		wxCheckBox* WxCheckBoxEnableReplace;
 		wxCheckBox* WxCheckBoxFindHex;
+		wxCheckBox* WxCheckBoxGitIgnore;
 		wxCheckBox* WxCheckBoxListFirstOnly;
 		wxCheckBox* WxCheckBoxRegex;
+		wxCheckBox* WxCheckBoxSkipBinary;
 		wxCheckBox* WxCheckBoxSubDir;
+		wxCheckBox* WxCheckBoxUseIndex;
 		wxCheckBox* WxCheckBoxWholeWord;
 		wxComboBox* WxComboBoxDir;
 		wxComboBox* WxComboBoxEncoding;
@@ -84,6 +88,7 @@ class WXMFindInFilesDialog: public wxDialog
 		static const long ID_WXBUTTONFIND;
 		static const long ID_WXBUTTONREPLACE;
 		static const long ID_WXCHECKBOXENABLEREPLACE;
+		static const long ID_WXBUTTONUNDOREPLACE;
 		static const long ID_STATICLINE1;
 		static const long ID_WXRADIOBUTTONOPENEDFILES;
 		static const long ID_WXRADIOBUTTONDIR;
@@ -101,6 +106,9 @@ class WXMFindInFilesDialog: public wxDialog
 		static const long ID_STATICTEXT7;
 		static const long ID_WXCOMBOBOXENCODING;
 		static const long ID_WXCHECKBOXSUBDIR;
+		static const long ID_WXCHECKBOXUSEINDEX;
+		static const long ID_WXCHECKBOXGITIGNORE;
+		static const long ID_WXCHECKBOXSKIPBINARY;
 		//*)
 
 		static const long ID_MADEDIT1;
@@ -126,6 +134,7 @@ class WXMFindInFilesDialog: public wxDialog
 		void WxButtonFindClick(wxCommandEvent& event);
 		void WxButtonReplaceClick(wxCommandEvent& event);
 		void WxCheckBoxEnableReplaceClick(wxCommandEvent& event);
+		void WxButtonUndoReplaceClick(wxCommandEvent& event);
 		void WxButtonDirClick(wxCommandEvent& event);
 		void WxButtonActiveDirClick(wxCommandEvent& event);
 		//*)
@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        dialog/wxm_performance_dialog.cpp
+// Description: Performance Counters Dialog
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxm_performance_dialog.h"
+#include "../xm/perf.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+//(*InternalHeaders(WXMPerformanceDialog)
+#include <wx/intl.h>
+#include <wx/string.h>
+//*)
+#include <wx/file.h>
+#include <wx/filedlg.h>
+#include <wx/longlong.h>
+#include <wx/msgdlg.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <vector>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+//(*IdInit(WXMPerformanceDialog)
+const long WXMPerformanceDialog::ID_WXSTATICTEXTSTATE = wxNewId();
+const long WXMPerformanceDialog::ID_WXLISTCTRLCOUNTERS = wxNewId();
+const long WXMPerformanceDialog::ID_WXBUTTONREFRESH = wxNewId();
+const long WXMPerformanceDialog::ID_WXBUTTONRESET = wxNewId();
+const long WXMPerformanceDialog::ID_WXBUTTONSAVEJSON = wxNewId();
+//*)
+
+BEGIN_EVENT_TABLE(WXMPerformanceDialog,wxDialog)
+	//(*EventTable(WXMPerformanceDialog)
+	//*)
+END_EVENT_TABLE()
+
+WXMPerformanceDialog::WXMPerformanceDialog(wxWindow* parent,wxWindowID id,const wxPoint& pos,const wxSize& size)
+{
+	//(*Initialize(WXMPerformanceDialog)
+	wxBoxSizer* BoxSizer1;
+	wxBoxSizer* BoxSizer2;
+
+	Create(parent, wxID_ANY, _("Performance"), wxDefaultPosition, wxDefaultSize, wxCAPTION|wxSYSTEM_MENU|wxRESIZE_BORDER|wxCLOSE_BOX|wxMAXIMIZE_BOX, _T("wxID_ANY"));
+	BoxSizer1 = new wxBoxSizer(wxVERTICAL);
+	WxStaticTextState = new wxStaticText(this, ID_WXSTATICTEXTSTATE, wxEmptyString, wxDefaultPosition, wxDefaultSize, 0, _T("ID_WXSTATICTEXTSTATE"));
+	BoxSizer1->Add(WxStaticTextState, 0, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+	WxListCtrlCounters = new wxListCtrl(this, ID_WXLISTCTRLCOUNTERS, wxDefaultPosition, wxSize(560,320), wxLC_REPORT|wxLC_SINGLE_SEL, wxDefaultValidator, _T("ID_WXLISTCTRLCOUNTERS"));
+	BoxSizer1->Add(WxListCtrlCounters, 1, wxALL|wxEXPAND, 4);
+	BoxSizer2 = new wxBoxSizer(wxHORIZONTAL);
+	WxButtonRefresh = new wxButton(this, ID_WXBUTTONREFRESH, _("&Refresh"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXBUTTONREFRESH"));
+	BoxSizer2->Add(WxButtonRefresh, 0, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	WxButtonReset = new wxButton(this, ID_WXBUTTONRESET, _("R&eset"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXBUTTONRESET"));
+	BoxSizer2->Add(WxButtonReset, 0, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	WxButtonSaveJSON = new wxButton(this, ID_WXBUTTONSAVEJSON, _("&Save as JSON..."), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_WXBUTTONSAVEJSON"));
+	BoxSizer2->Add(WxButtonSaveJSON, 0, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	Button1 = new wxButton(this, wxID_CANCEL, _("&Close"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("wxID_CANCEL"));
+	BoxSizer2->Add(Button1, 0, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	BoxSizer1->Add(BoxSizer2, 0, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 2);
+	SetSizer(BoxSizer1);
+	BoxSizer1->Fit(this);
+	BoxSizer1->SetSizeHints(this);
+	Center();
+
+	Connect(ID_WXBUTTONREFRESH,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMPerformanceDialog::WxButtonRefreshClick);
+	Connect(ID_WXBUTTONRESET,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMPerformanceDialog::WxButtonResetClick);
+	Connect(ID_WXBUTTONSAVEJSON,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&WXMPerformanceDialog::WxButtonSaveJSONClick);
+	Connect(wxID_ANY,wxEVT_CLOSE_WINDOW,(wxObjectEventFunction)&WXMPerformanceDialog::WXMPerformanceDialogClose);
+	//*)
+
+	WxListCtrlCounters->InsertColumn(0, _("Operation"));
+	WxListCtrlCounters->InsertColumn(1, _("Calls"), wxLIST_FORMAT_RIGHT);
+	WxListCtrlCounters->InsertColumn(2, _("Total (ms)"), wxLIST_FORMAT_RIGHT);
+	WxListCtrlCounters->InsertColumn(3, _("Mean (us)"), wxLIST_FORMAT_RIGHT);
+	WxListCtrlCounters->InsertColumn(4, _("Max (us)"), wxLIST_FORMAT_RIGHT);
+
+	if (xm::PerfCountersEnabled())
+		WxStaticTextState->SetLabel(_("The counters have been taken since wxMEdit started or was reset."));
+	else
+		WxStaticTextState->SetLabel(_("wxMEdit was built without the counters, configure it with --enable-perf-counters."));
+
+	UpdateCounters();
+	Button1->SetFocus();
+}
+
+WXMPerformanceDialog::~WXMPerformanceDialog()
+{
+	//(*Destroy(WXMPerformanceDialog)
+	//*)
+}
+
+void WXMPerformanceDialog::UpdateCounters()
+{
+	std::vector<xm::PerfStat> stats;
+	xm::GetPerfStats(stats);
+
+	WxListCtrlCounters->Freeze();
+	WxListCtrlCounters->DeleteAllItems();
+	for (size_t i = 0; i < stats.size(); ++i)
+	{
+		const xm::PerfStat& s = stats[i];
+		long item = WxListCtrlCounters->InsertItem(long(i), wxString(s.name, wxConvUTF8));
+		WxListCtrlCounters->SetItem(item, 1, wxULongLong(s.calls).ToString());
+		if (!s.timed)
+			continue;
+
+		double mean_us = (s.calls == 0)? 0.0: double(s.total_ns) / double(s.calls) / 1e3;
+		WxListCtrlCounters->SetItem(item, 2, wxString::Format(wxT("%.3f"), double(s.total_ns) / 1e6));
+		WxListCtrlCounters->SetItem(item, 3, wxString::Format(wxT("%.3f"), mean_us));
+		WxListCtrlCounters->SetItem(item, 4, wxString::Format(wxT("%.3f"), double(s.max_ns) / 1e3));
+	}
+	for (int col = 0; col < WxListCtrlCounters->GetColumnCount(); ++col)
+		WxListCtrlCounters->SetColumnWidth(col, wxLIST_AUTOSIZE_USEHEADER);
+	WxListCtrlCounters->Thaw();
+}
+
+void WXMPerformanceDialog::WXMPerformanceDialogClose(wxCloseEvent& event)
+{
+	Destroy();
+}
+
+void WXMPerformanceDialog::WxButtonRefreshClick(wxCommandEvent& event)
+{
+	UpdateCounters();
+}
+
+void WXMPerformanceDialog::WxButtonResetClick(wxCommandEvent& event)
+{
+	xm::ResetPerfStats();
+	UpdateCounters();
+}
+
+void WXMPerformanceDialog::WxButtonSaveJSONClick(wxCommandEvent& event)
+{
+	wxFileDialog dlg(this, _("Save as JSON"), wxEmptyString, wxT("wxmedit-perf.json"),
+		wxT("JSON (*.json)|*.json|") + wxString(wxFileSelectorDefaultWildcardStr), wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
+	if (dlg.ShowModal() != wxID_OK)
+		return;
+
+	// the snapshot is taken now, it may differ from the list shown
+	std::string json = xm::PerfStatsToJSON();
+
+	wxFile file;
+	if (!file.Create(dlg.GetPath(), true) || file.Write(json.data(), json.size()) != json.size())
+		wxMessageBox(wxString::Format(_("Cannot write %s."), dlg.GetPath().c_str()), _("Performance"), wxOK|wxICON_ERROR, this);
+}
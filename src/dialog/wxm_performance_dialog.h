@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        dialog/wxm_performance_dialog.h
+// Description: Performance Counters Dialog
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef WXM_PERFORMANCE_DIALOG_H
+#define WXM_PERFORMANCE_DIALOG_H
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+//(*Headers(WXMPerformanceDialog)
+#include <wx/button.h>
+#include <wx/dialog.h>
+#include <wx/listctrl.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+//*)
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+// not in the menus, opened by Ctrl-Alt-Shift-P
+class WXMPerformanceDialog: public wxDialog
+{
+	public:
+
+		WXMPerformanceDialog(wxWindow* parent,wxWindowID id=wxID_ANY,const wxPoint& pos=wxDefaultPosition,const wxSize& size=wxDefaultSize);
+		virtual ~WXMPerformanceDialog();
+
+		//(*Declarations(WXMPerformanceDialog)
+		wxButton* Button1;
+		wxButton* WxButtonRefresh;
+		wxButton* WxButtonReset;
+		wxButton* WxButtonSaveJSON;
+		wxListCtrl* WxListCtrlCounters;
+		wxStaticText* WxStaticTextState;
+		//*)
+
+	protected:
+
+		//(*Identifiers(WXMPerformanceDialog)
+		static const long ID_WXSTATICTEXTSTATE;
+		static const long ID_WXLISTCTRLCOUNTERS;
+		static const long ID_WXBUTTONREFRESH;
+		static const long ID_WXBUTTONRESET;
+		static const long ID_WXBUTTONSAVEJSON;
+		//*)
+
+	private:
+
+		//(*Handlers(WXMPerformanceDialog)
+		void WXMPerformanceDialogClose(wxCloseEvent& event);
+		void WxButtonRefreshClick(wxCommandEvent& event);
+		void WxButtonResetClick(wxCommandEvent& event);
+		void WxButtonSaveJSONClick(wxCommandEvent& event);
+		//*)
+
+		void UpdateCounters();
+
+		DECLARE_EVENT_TABLE()
+};
+
+#endif
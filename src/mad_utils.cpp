@@ -237,7 +237,7 @@ wxString GetExecutablePath()
     return path;
 }
 
-bool StringToHex(wxString ws, std::vector<wxByte> &hex)
+bool StringToHex(wxString ws, std::vector<wxByte> &hex, bool showerr)
 {
     ws.Trim(false);
 
@@ -253,9 +253,12 @@ bool StringToHex(wxString ws, std::vector<wxByte> &hex)
     {
         if(len<2)
         {
-            wxMessageDialog dlg(nullptr, errmsg+wxT("\n\n")+ws,
-                            wxT("wxMEdit"), wxOK|wxICON_ERROR );
-            dlg.ShowModal();
+            if(showerr)
+            {
+                wxMessageDialog dlg(nullptr, errmsg+wxT("\n\n")+ws,
+                                wxT("wxMEdit"), wxOK|wxICON_ERROR );
+                dlg.ShowModal();
+            }
             return false;
         }
 
@@ -265,9 +268,12 @@ bool StringToHex(wxString ws, std::vector<wxByte> &hex)
 
         if(b0<0 || b1<0)
         {
-            wxMessageDialog dlg(nullptr, errmsg+wxT("\n\n")+ws,
-                            wxT("wxMEdit"), wxOK|wxICON_ERROR );
-            dlg.ShowModal();
+            if(showerr)
+            {
+                wxMessageDialog dlg(nullptr, errmsg+wxT("\n\n")+ws,
+                                wxT("wxMEdit"), wxOK|wxICON_ERROR );
+                dlg.ShowModal();
+            }
             return false;
         }
 
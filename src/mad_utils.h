@@ -56,6 +56,7 @@ inline int FromHex(wxChar c)
     return -1;
 }
 
-bool StringToHex(wxString ws, std::vector<wxByte> &hex);
+// the error is shown if showerr
+bool StringToHex(wxString ws, std::vector<wxByte> &hex, bool showerr=true);
 
 #endif
@@ -0,0 +1,745 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/benchmark.cpp
+// Description: Document Benchmark of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include "../xm/cxx11.h"
+#include "../xm/perf.h"
+#include "edit/simple.h"
+#include "../wxmedit/wxmedit.h"
+#include "../wxmedit/wxm_undo.h"
+#include "../wxmedit/wxm_recovery.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/filename.h>
+#include <wx/frame.h>
+#include <wx/log.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#ifdef XM_PERF_COUNTERS
+#include <boost/detail/atomic_count.hpp>
+#endif
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+//==================================================
+// the allocations are counted by replacing the global operator new, which must
+// be defined before the operator new macro of _DEBUG; it's only built with
+// --enable-perf-counters, so the released wxMEdit uses the default allocator
+
+#ifdef XM_PERF_COUNTERS
+
+namespace
+{
+	boost::detail::atomic_count g_allocations(0);
+
+	long AllocationCount() { return long(g_allocations); }
+}
+
+void* operator new(std::size_t size)
+{
+	++g_allocations;
+	if (size == 0)
+		size = 1;
+
+	for (;;)
+	{
+		void* p = std::malloc(size);
+		if (p != nullptr)
+			return p;
+
+		std::new_handler handler = std::set_new_handler(nullptr);
+		std::set_new_handler(handler);
+		if (handler == nullptr)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void* operator new[](std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+	try
+	{
+		return ::operator new(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& nt) throw()
+{
+	return ::operator new(size, nt);
+}
+
+void operator delete(void* p) throw()
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) throw()
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) throw()
+{
+	std::free(p);
+}
+
+#else
+
+namespace
+{
+	// not counted
+	long AllocationCount() { return -1; }
+}
+
+#endif
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace wxm
+{
+
+namespace
+{
+
+const wxFileOffset MB = 1024 * 1024;
+
+// the document sizes, the ones over --max-size are skipped
+const wxFileOffset ALL_SIZES[] = { 1 * MB, 16 * MB, 128 * MB, 1024 * MB };
+const wxFileOffset DEFAULT_MAX_SIZE = 16 * MB;
+
+const int RANDOM_ACCESS_COUNT = 10000;
+
+// the peak RSS can be reset only on Linux, it's -1 on the other platforms
+void ResetPeakRSS()
+{
+#ifdef __LINUX__
+	FILE* f = fopen("/proc/self/clear_refs", "w");
+	if (f == nullptr)
+		return;
+	fputs("5", f);
+	fclose(f);
+#endif
+}
+
+long PeakRSSKB()
+{
+	long kb = -1;
+#ifdef __LINUX__
+	FILE* f = fopen("/proc/self/status", "r");
+	if (f == nullptr)
+		return kb;
+
+	char line[256];
+	while (fgets(line, sizeof(line), f) != nullptr)
+	{
+		if (strncmp(line, "VmHWM:", 6) == 0)
+		{
+			kb = strtol(line + 6, nullptr, 10);
+			break;
+		}
+	}
+	fclose(f);
+#endif
+	return kb;
+}
+
+// the documents are generated by a fixed seed, so every run measures the same data
+class Random
+{
+public:
+	Random(): m_state(0x2545F491UL) {}
+
+	unsigned long Next()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state & 0xFFFFFFFFUL;
+	}
+	unsigned long Below(unsigned long n) { return Next() % n; }
+
+private:
+	unsigned long m_state;
+};
+
+void AppendUTF8(std::string& buf, unsigned long uc)
+{
+	if (uc < 0x80)
+	{
+		buf += char(uc);
+	}
+	else if (uc < 0x800)
+	{
+		buf += char(0xC0 | (uc >> 6));
+		buf += char(0x80 | (uc & 0x3F));
+	}
+	else
+	{
+		buf += char(0xE0 | (uc >> 12));
+		buf += char(0x80 | ((uc >> 6) & 0x3F));
+		buf += char(0x80 | (uc & 0x3F));
+	}
+}
+
+void AppendLogLine(std::string& buf, Random& rnd)
+{
+	static const char* levels[] = { "INFO ", "DEBUG", "WARN ", "ERROR" };
+	char line[256];
+	sprintf(line, "2019-%02lu-%02lu %02lu:%02lu:%02lu.%03lu [%s] worker-%lu request id=%lu took %lu ms path=/api/v1/items/%lu\n",
+		1 + rnd.Below(12), 1 + rnd.Below(28), rnd.Below(24), rnd.Below(60), rnd.Below(60), rnd.Below(1000),
+		levels[rnd.Below(4)], rnd.Below(16), rnd.Next(), rnd.Below(5000), rnd.Below(100000));
+	buf += line;
+}
+
+void AppendCSVLine(std::string& buf, Random& rnd)
+{
+	static const char* words[] = { "apple", "banana", "cherry", "durian", "elder", "fig", "grape" };
+	char line[256];
+	sprintf(line, "%lu,item-%lu,%lu.%02lu,%lu,2019-%02lu-%02lu,\"%s %s\"\n",
+		rnd.Next(), rnd.Below(100000), rnd.Below(1000), rnd.Below(100), rnd.Below(500),
+		1 + rnd.Below(12), 1 + rnd.Below(28), words[rnd.Below(7)], words[rnd.Below(7)]);
+	buf += line;
+}
+
+// all in one line
+void AppendMinifiedJS(std::string& buf, Random& rnd)
+{
+	char code[256];
+	sprintf(code, "function f%lu(a,b){var c=a*%lu+b;return c>%lu?g%lu(c):h(c,\"k%lu\")};",
+		rnd.Below(100000), rnd.Below(100), rnd.Below(10000), rnd.Below(1000), rnd.Below(1000));
+	buf += code;
+}
+
+void AppendCJKLine(std::string& buf, Random& rnd)
+{
+	unsigned long len = 20 + rnd.Below(40);
+	for (unsigned long i = 0; i < len; ++i)
+	{
+		if (rnd.Below(12) == 0)
+			AppendUTF8(buf, 0xFF0C); // fullwidth comma
+		else
+			AppendUTF8(buf, 0x4E00 + rnd.Below(0x9FA6 - 0x4E00));
+	}
+	AppendUTF8(buf, 0x3002); // ideographic full stop
+	buf += '\n';
+}
+
+void AppendBinary(std::string& buf, Random& rnd)
+{
+	for (int i = 0; i < 64; ++i)
+		buf += char(rnd.Next());
+}
+
+typedef void (*AppendFunc)(std::string& buf, Random& rnd);
+
+struct Corpus
+{
+	const wxChar* name;
+	AppendFunc append;
+	const wxChar* header;
+	// for FindAll and ReplaceAll: a frequent text, its replacement, and a regex
+	const wxChar* frequent;
+	const wxChar* replacement;
+	const wxChar* regex;
+};
+
+const Corpus CORPORA[] =
+{
+	{ wxT("log"), AppendLogLine, nullptr, wxT("took"), wxT("TOOK"), wxT("id=[0-9]+") },
+	{ wxT("csv"), AppendCSVLine, wxT("id,name,price,qty,date,tags\n"), wxT("item-"), wxT("ITEM-"), wxT("[0-9]+\\.[0-9]{2}") },
+	{ wxT("minjs"), AppendMinifiedJS, nullptr, wxT("return"), wxT("RETURN"), wxT("f[0-9]+\\(") },
+	{ wxT("cjk"), AppendCJKLine, nullptr, wxT("\uFF0C"), wxT("\u3001"), wxT("\uFF0C[^\uFF0C\u3002]{2}") },
+	{ wxT("binary"), AppendBinary, nullptr, nullptr, nullptr, nullptr },
+};
+
+// the scenarios of a document, "<corpus>/<size>/<scenario>" is matched by --filter
+const wxChar* SCENARIOS[] =
+{
+	wxT("load"), wxT("reformat"), wxT("GetLineByPos"), wxT("GetLine"), wxT("FindNext"), wxT("FindPrevious"),
+	wxT("FindAll/string"), wxT("FindAll/regex"), wxT("ReplaceAll"), wxT("ReplaceAll/undo"), wxT("ReplaceAll/redo"),
+	wxT("SortLines"), wxT("SortLines/undo"), wxT("WordCount"), wxT("FindNext/hex"), wxT("FindPrevious/hex"),
+	wxT("FindAll/hex"), wxT("ReplaceAll/hex"), wxT("ReplaceAll/hex/undo"), wxT("save"),
+};
+
+bool GenerateCorpus(const Corpus& corpus, const wxString& filename, wxFileOffset size)
+{
+	wxFile file;
+	if (!file.Create(filename, true))
+		return false;
+
+	Random rnd;
+	std::string buf;
+	if (corpus.header != nullptr)
+		buf = std::string(wxString(corpus.header).mb_str(wxConvUTF8));
+
+	wxFileOffset written = 0;
+	while (written < size)
+	{
+		corpus.append(buf, rnd);
+		if (buf.size() >= 1024 * 1024 || written + wxFileOffset(buf.size()) >= size)
+		{
+			if (file.Write(buf.data(), buf.size()) != buf.size())
+				return false;
+			written += buf.size();
+			buf.clear();
+		}
+	}
+
+	return true;
+}
+
+wxString SizeName(wxFileOffset size)
+{
+	if (size % MB == 0)
+		return wxString::Format(wxT("%dMB"), int(size / MB));
+	return wxString::Format(wxT("%dKB"), int(size / 1024));
+}
+
+struct Measurement
+{
+	wxString name;
+	wxFileOffset bytes;
+	double seconds;
+	long peak_rss_kb;
+	long allocations;
+};
+
+class Benchmark
+{
+public:
+	Benchmark(): m_max_size(DEFAULT_MAX_SIZE) {}
+
+	bool ParseArgs(const wxArrayString& args);
+	int Run();
+
+private:
+	bool Selected(const wxString& name) const
+	{
+		return m_filter.IsEmpty() || name.Find(m_filter) != wxNOT_FOUND;
+	}
+
+	void Begin()
+	{
+		ResetPeakRSS();
+		m_allocations = AllocationCount();
+		m_start = std::chrono::steady_clock::now();
+	}
+	void End(const wxString& name, wxFileOffset bytes);
+
+	bool AnySelected(const wxString& prefix) const;
+
+	void RunCorpus(wxWindow* parent, const Corpus& corpus, wxFileOffset size);
+	void RunText(MadEdit* edit, const Corpus& corpus, const wxString& prefix);
+	void RunHex(MadEdit* edit, const wxString& prefix);
+
+	bool WriteJSON() const;
+	void RemoveWorkDir();
+
+	wxFileOffset m_max_size;
+	wxString m_filter;
+	wxString m_json_file;
+	wxString m_work_dir;
+
+	std::chrono::steady_clock::time_point m_start;
+	long m_allocations;
+	std::vector<Measurement> m_results;
+};
+
+bool Benchmark::ParseArgs(const wxArrayString& args)
+{
+	for (size_t i = 1; i < args.GetCount(); ++i)
+	{
+		wxString value;
+		if (args[i].StartsWith(wxT("--max-size="), &value))
+		{
+			wxFileOffset unit = 1;
+			if (value.EndsWith(wxT("K"))) unit = 1024;
+			else if (value.EndsWith(wxT("M"))) unit = MB;
+			else if (value.EndsWith(wxT("G"))) unit = 1024 * MB;
+			if (unit != 1)
+				value.RemoveLast();
+
+			unsigned long n;
+			if (!value.ToULong(&n))
+				return false;
+			m_max_size = wxFileOffset(n) * unit;
+		}
+		else if (args[i].StartsWith(wxT("--filter="), &value))
+		{
+			m_filter = value;
+		}
+		else if (args[i].StartsWith(wxT("--json="), &value))
+		{
+			m_json_file = value;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Benchmark::AnySelected(const wxString& prefix) const
+{
+	for (size_t i = 0; i < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); ++i)
+	{
+		if (Selected(prefix + SCENARIOS[i]))
+			return true;
+	}
+	return false;
+}
+
+void Benchmark::End(const wxString& name, wxFileOffset bytes)
+{
+	// the unselected steps, like loading the document to be searched, are not reported
+	if (!Selected(name))
+		return;
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+
+	Measurement m;
+	m.name = name;
+	m.bytes = bytes;
+	m.seconds = elapsed.count();
+	m.allocations = (m_allocations < 0) ? -1 : AllocationCount() - m_allocations;
+	m.peak_rss_kb = PeakRSSKB();
+	m_results.push_back(m);
+
+	wxPrintf(wxT("%-40s %10.3f s %10ld KB %12ld allocs\n"), name.c_str(), m.seconds, m.peak_rss_kb, m.allocations);
+	fflush(stdout);
+}
+
+int Benchmark::Run()
+{
+	m_work_dir = wxStandardPaths::Get().GetTempDir() + wxFILE_SEP_PATH
+		+ wxString::Format(wxT("wxmedit-bench-%lu"), wxGetProcessId()) + wxFILE_SEP_PATH;
+	if (!wxFileName::Mkdir(m_work_dir, 0777, wxPATH_MKDIR_FULL))
+	{
+		wxPrintf(wxT("cannot create %s\n"), m_work_dir.c_str());
+		return 1;
+	}
+
+	// the font widths are measured from scratch, and the cache of the user is not touched
+	FontWidthManager::Init(m_work_dir);
+
+	// journal the edits as the editor does
+	MadUndoBuffer::SetJournalDir(m_work_dir + wxT("undo") + wxFILE_SEP_PATH);
+	MadRecoveryJournal::SetDir(m_work_dir + wxT("recovery") + wxFILE_SEP_PATH);
+
+	wxFrame* frame = new wxFrame(nullptr, wxID_ANY, wxT("wxMEdit Benchmark"));
+
+	for (size_t s = 0; s < sizeof(ALL_SIZES) / sizeof(ALL_SIZES[0]); ++s)
+	{
+		if (ALL_SIZES[s] > m_max_size)
+			break;
+		for (size_t c = 0; c < sizeof(CORPORA) / sizeof(CORPORA[0]); ++c)
+			RunCorpus(frame, CORPORA[c], ALL_SIZES[s]);
+	}
+
+	frame->Destroy();
+	FontWidthManager::FreeMem();
+	RemoveWorkDir();
+
+	wxPrintf(wxT("%d scenarios, documents up to %s\n"), int(m_results.size()), SizeName(m_max_size).c_str());
+
+	if (!m_json_file.IsEmpty() && !WriteJSON())
+	{
+		wxPrintf(wxT("failed to write %s\n"), m_json_file.c_str());
+		return 1;
+	}
+	return 0;
+}
+
+void Benchmark::RunCorpus(wxWindow* parent, const Corpus& corpus, wxFileOffset size)
+{
+	const wxString prefix = wxString(corpus.name) + wxT("/") + SizeName(size) + wxT("/");
+	if (!AnySelected(prefix))
+		return;
+
+	const wxString filename = m_work_dir + corpus.name + wxT("-") + SizeName(size);
+	if (!GenerateCorpus(corpus, filename, size))
+	{
+		wxPrintf(wxT("cannot generate %s\n"), filename.c_str());
+		return;
+	}
+
+	// a new wxMEdit for every document, its files are closed when it's deleted
+	const wxString outname = filename + wxT(".saved");
+	{
+		std::unique_ptr<MadEdit> edit(new SearchingWXMEdit(parent, false));
+		edit->EnableRecoveryJournal();
+
+		Begin();
+		bool loaded = edit->LoadFromFile(filename);
+		End(prefix + wxT("load"), size);
+		if (!loaded)
+		{
+			wxPrintf(wxT("cannot load %s\n"), filename.c_str());
+			wxRemoveFile(filename);
+			return;
+		}
+
+		if (corpus.frequent != nullptr)
+			RunText(edit.get(), corpus, prefix);
+		else
+			RunHex(edit.get(), prefix);
+
+		if (Selected(prefix + wxT("save")))
+		{
+			Begin();
+			edit->SaveToFile(outname);
+			End(prefix + wxT("save"), edit->GetFileSize());
+		}
+	}
+
+	wxRemoveFile(outname);
+	wxRemoveFile(filename);
+}
+
+void Benchmark::RunText(MadEdit* edit, const Corpus& corpus, const wxString& prefix)
+{
+	const wxFileOffset size = edit->GetFileSize();
+	const wxString absent(wxT("wxMEdit benchmark absent text"));
+	WXMSearcher* str_searcher = edit->Searcher(false, false);
+	WXMSearcher* regex_searcher = edit->Searcher(false, true);
+	std::vector<wxFileOffset> begpos, endpos;
+	Random rnd;
+
+	if (Selected(prefix + wxT("reformat")))
+	{
+		wxString fontname;
+		int fontsize;
+		edit->GetTextFont(fontname, fontsize);
+		Begin();
+		edit->SetTextFont(fontname, fontsize, true);
+		End(prefix + wxT("reformat"), size);
+	}
+
+	if (Selected(prefix + wxT("GetLineByPos")))
+	{
+		Begin();
+		for (int i = 0; i < RANDOM_ACCESS_COUNT; ++i)
+			edit->GetLineByPos(wxFileOffset(rnd.Next()) * 4099 % size);
+		End(prefix + wxT("GetLineByPos"), size);
+	}
+
+	if (Selected(prefix + wxT("GetLine")))
+	{
+		wxString ws;
+		const int lines = edit->GetLineCount();
+		Begin();
+		for (int i = 0; i < RANDOM_ACCESS_COUNT; ++i)
+			edit->GetLine(ws, int(rnd.Below(lines)), 256);
+		End(prefix + wxT("GetLine"), size);
+	}
+
+	// the absent text is searched through the whole document
+	if (Selected(prefix + wxT("FindNext")))
+	{
+		Begin();
+		str_searcher->FindNext(absent, 0, -1);
+		End(prefix + wxT("FindNext"), size);
+	}
+
+	if (Selected(prefix + wxT("FindPrevious")))
+	{
+		Begin();
+		str_searcher->FindPrevious(absent, size, 0);
+		End(prefix + wxT("FindPrevious"), size);
+	}
+
+	if (Selected(prefix + wxT("FindAll/string")))
+	{
+		Begin();
+		str_searcher->FindAll(corpus.frequent, false, &begpos, &endpos);
+		End(prefix + wxT("FindAll/string"), size);
+		begpos.clear();
+		endpos.clear();
+	}
+
+	if (Selected(prefix + wxT("FindAll/regex")))
+	{
+		Begin();
+		regex_searcher->FindAll(corpus.regex, false, &begpos, &endpos);
+		End(prefix + wxT("FindAll/regex"), size);
+		begpos.clear();
+		endpos.clear();
+	}
+
+	if (Selected(prefix + wxT("ReplaceAll")) || Selected(prefix + wxT("ReplaceAll/undo")) || Selected(prefix + wxT("ReplaceAll/redo")))
+	{
+		Begin();
+		str_searcher->ReplaceAll(corpus.frequent, corpus.replacement);
+		End(prefix + wxT("ReplaceAll"), size);
+
+		Begin();
+		edit->Undo();
+		End(prefix + wxT("ReplaceAll/undo"), size);
+
+		Begin();
+		edit->Redo();
+		End(prefix + wxT("ReplaceAll/redo"), size);
+
+		edit->Undo();
+	}
+
+	if (Selected(prefix + wxT("SortLines")) || Selected(prefix + wxT("SortLines/undo")))
+	{
+		Begin();
+		edit->SortLines(sfAscending, -1, -1);
+		End(prefix + wxT("SortLines"), size);
+
+		Begin();
+		edit->Undo();
+		End(prefix + wxT("SortLines/undo"), size);
+	}
+
+	if (Selected(prefix + wxT("WordCount")))
+	{
+		WordCountData data;
+		Begin();
+		edit->WordCount(false, data);
+		End(prefix + wxT("WordCount"), size);
+	}
+}
+
+void Benchmark::RunHex(MadEdit* edit, const wxString& prefix)
+{
+	const wxFileOffset size = edit->GetFileSize();
+	WXMSearcher* hex_searcher = edit->Searcher(true, false);
+	std::vector<wxFileOffset> begpos, endpos;
+
+	if (Selected(prefix + wxT("FindNext/hex")))
+	{
+		Begin();
+		hex_searcher->FindNext(wxT("DE AD BE EF 01 23 45 67"), 0, -1);
+		End(prefix + wxT("FindNext/hex"), size);
+	}
+
+	if (Selected(prefix + wxT("FindPrevious/hex")))
+	{
+		Begin();
+		hex_searcher->FindPrevious(wxT("DE AD BE EF 01 23 45 67"), size, 0);
+		End(prefix + wxT("FindPrevious/hex"), size);
+	}
+
+	if (Selected(prefix + wxT("FindAll/hex")))
+	{
+		Begin();
+		hex_searcher->FindAll(wxT("00 FF"), false, &begpos, &endpos);
+		End(prefix + wxT("FindAll/hex"), size);
+	}
+
+	if (Selected(prefix + wxT("ReplaceAll/hex")) || Selected(prefix + wxT("ReplaceAll/hex/undo")))
+	{
+		Begin();
+		hex_searcher->ReplaceAll(wxT("00 FF"), wxT("FF 00"));
+		End(prefix + wxT("ReplaceAll/hex"), size);
+
+		Begin();
+		edit->Undo();
+		End(prefix + wxT("ReplaceAll/hex/undo"), size);
+	}
+}
+
+bool Benchmark::WriteJSON() const
+{
+	wxFile file;
+	if (!file.Create(m_json_file, true))
+		return false;
+
+	wxString json(wxT("{\n  \"benchmarks\": [\n"));
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const Measurement& m = m_results[i];
+		json += wxString::Format(wxT("    {\"name\": \"%s\", \"bytes\": %s, \"seconds\": %.6f, \"peak_rss_kb\": %ld, \"allocations\": %ld}%s\n"),
+			m.name.c_str(), wxLongLong(m.bytes).ToString().c_str(), m.seconds, m.peak_rss_kb, m.allocations,
+			(i + 1 < m_results.size()) ? wxT(",") : wxT(""));
+	}
+	json += wxT("  ]");
+
+	// the counters of the hot paths over all the scenarios
+	if (xm::PerfCountersEnabled())
+	{
+		wxString perf(xm::PerfStatsToJSON().c_str(), wxConvUTF8);
+		perf.Trim();
+		json += wxT(",\n  \"perf\": ") + perf;
+	}
+	json += wxT("\n}\n");
+
+	return file.Write(json, wxConvUTF8);
+}
+
+void Benchmark::RemoveWorkDir()
+{
+	wxLogNull nolog;
+	wxArrayString files;
+	wxDir::GetAllFiles(m_work_dir, &files);
+	for (size_t i = 0; i < files.GetCount(); ++i)
+		wxRemoveFile(files[i]);
+
+	wxRmdir(m_work_dir + wxT("undo"));
+	wxRmdir(m_work_dir + wxT("recovery"));
+	wxRmdir(m_work_dir);
+}
+
+} // anonymous namespace
+
+bool IsBenchmarkCommand(const wxArrayString& args)
+{
+	return !args.IsEmpty() && args[0] == wxT("--benchmark");
+}
+
+int RunDocumentBenchmark(const wxArrayString& args)
+{
+	Benchmark bench;
+	if (!bench.ParseArgs(args))
+	{
+		wxPrintf(wxT("usage: wxmedit --benchmark [--max-size=N[K|M|G]] [--filter=TEXT] [--json=FILE]\n"));
+		return 2;
+	}
+
+	return bench.Run();
+}
+
+} //namespace wxm
@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/benchmark.h
+// Description: Document Benchmark of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_BENCHMARK_H_
+#define _WXM_BENCHMARK_H_
+
+#include "../xm/cxx11.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/string.h>
+#include <wx/arrstr.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+namespace wxm
+{
+
+// args without the program name:
+//     --benchmark [--max-size=N[K|M|G]] [--filter=TEXT] [--json=FILE]
+bool IsBenchmarkCommand(const wxArrayString& args);
+
+// load, reformat, search, replace, sort, count, save and undo the generated
+// documents in a hidden wxMEdit, which needs a display, and report the wall time, the peak RSS and
+// the allocation count of each scenario; return the exit code.
+// the allocations are counted only if built with XM_PERF_COUNTERS, or -1
+int RunDocumentBenchmark(const wxArrayString& args);
+
+} //namespace wxm
+
+#endif //_WXM_BENCHMARK_H_
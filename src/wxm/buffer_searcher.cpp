@@ -0,0 +1,534 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/buffer_searcher.cpp
+// Description: Searching and Replacing in Buffers without wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "buffer_searcher.h"
+#include "search_algo.h"
+#include "../xm/cxx11.h"
+
+#include <unicode/uchar.h>
+#include <string>
+
+using namespace std;
+using namespace boost::xpressive;
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+#ifdef __WXMSW__
+namespace boost { namespace xpressive { namespace detail
+{
+	ucs4string string_literal<ucs4_t>::inter_str;
+}}}
+#endif
+
+// convert escape char to literal char
+ucs4string ConvertEscape(const ucs4string &str)
+{
+	ucs4string out;
+	detail::escape_value<ucs4_t, ucs4_regex_traits::char_class_type> esc;
+
+	ucs4string::const_iterator begin = str.begin();
+	ucs4string::const_iterator end = str.end();
+	compiler_traits<ucs4_regex_traits> ucs4traits;
+
+	while (begin != end)
+	{
+		if (*begin != '\\')
+		{
+			out += *begin;
+			++begin;
+			continue;
+		}
+
+		// last char is '\'
+		if (++begin == end)
+			throw regex_error(regex_constants::error_escape);
+
+		esc = detail::parse_escape(begin, end, ucs4traits);
+		out += esc.ch_;
+	}
+
+	return out;
+}
+
+namespace wxm
+{
+
+ucs4string WxStrToUCS4(const wxString& wxs)
+{
+	ucs4string ucs;
+	const wxChar *pwcs = wxs.c_str();
+	size_t count = wxs.Len();
+	for (size_t i = 0; i < count; ++i)
+	{
+		ucs4_t uc = pwcs[i];
+#ifdef __WXMSW__
+		if (uc >= 0xD800 && uc <= 0xDBFF && i + 1 < count)
+		{
+			ucs4_t uc1 = pwcs[i + 1];
+			if (uc1 >= 0xDC00 && uc1 <= 0xDFFF)
+			{
+				++i;
+				uc = ((uc - 0xD800) << 10) + (uc1 - 0xDC00) + 0x10000;
+			}
+		}
+#endif
+		ucs.push_back(uc);
+	}
+	return ucs;
+}
+
+struct BufferSearcher::Regex
+{
+	basic_regex<const ucs4_t*> expression;
+};
+
+BufferSearcher::BufferSearcher()
+	: m_inhex(false), m_use_regex(false), m_case_sensitive(true), m_whole_word(false), m_anchored(false)
+	, m_dot_newline(false)
+{
+}
+
+BufferSearcher::~BufferSearcher()
+{
+}
+
+bool BufferSearcher::PrepareText(const ucs4string& expr, bool use_regex, bool case_sensitive, bool whole_word,
+	bool dot_newline)
+{
+	m_inhex = false;
+	m_use_regex = use_regex;
+	m_case_sensitive = case_sensitive;
+	m_whole_word = whole_word;
+	m_expr = expr;
+
+	if (!use_regex)
+	{
+		if (!m_jtab)
+			m_jtab.reset(new JumpTable_UCS4());
+		if (!expr.empty())
+			m_jtab->Build(expr);
+		return true;
+	}
+
+	m_anchored = (expr.find(ucs4_t('^')) != ucs4string::npos || expr.find(ucs4_t('$')) != ucs4string::npos);
+	m_dot_newline = dot_newline;
+
+	try
+	{
+		regex_constants::syntax_option_type opt = regex_constants::ECMAScript;
+		if (!case_sensitive)
+			opt = opt | regex_constants::icase;
+		if (!dot_newline)
+			opt = opt | regex_constants::not_dot_newline;
+		regex_compiler<const ucs4_t*, ucs4_regex_traits > ucs4comp;
+		if (!m_regex)
+			m_regex.reset(new Regex());
+		m_regex->expression = ucs4comp.compile(expr, opt);
+	}
+	catch (regex_error)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void BufferSearcher::PrepareHex(const std::vector<wxByte>& hex)
+{
+	m_inhex = true;
+	m_hex = hex;
+
+	if (!m_hex_jtab)
+		m_hex_jtab.reset(new JumpTable_Hex());
+	if (!hex.empty())
+		m_hex_jtab->Build(hex);
+}
+
+namespace
+{
+
+inline bool IsASCIIAlnum(ucs4_t uc)
+{
+	return (uc >= '0' && uc <= '9') || (uc >= 'a' && uc <= 'z') || (uc >= 'A' && uc <= 'Z');
+}
+
+// skip a class beginning at i, return the position after it;
+// a ']' at the beginning is taken as a char of the class
+size_t SkipRegexClass(const ucs4string& expr, size_t i)
+{
+	const size_t len = expr.size();
+	++i;
+	if (i < len && expr[i] == '^')
+		++i;
+	if (i < len && expr[i] == ']')
+		++i;
+
+	for (; i < len; ++i)
+	{
+		if (expr[i] == '\\')
+			++i;
+		else if (expr[i] == ']')
+			return i + 1;
+	}
+	return len;
+}
+
+// skip a group or a "{n,m}" beginning at i, return the position after it
+size_t SkipRegexBracket(const ucs4string& expr, size_t i)
+{
+	const size_t len = expr.size();
+	const ucs4_t open = expr[i];
+	const ucs4_t close = (open == '(') ? ')' : '}';
+	int depth = 0;
+	while (i < len)
+	{
+		ucs4_t uc = expr[i];
+		if (uc == '\\')
+		{
+			i += 2;
+			continue;
+		}
+		if (uc == '[' && open == '(')
+		{
+			i = SkipRegexClass(expr, i);
+			continue;
+		}
+
+		++i;
+		if (uc == open)
+			++depth;
+		else if (uc == close && --depth == 0)
+			return i;
+	}
+	return len;
+}
+
+// skip a quantifier at i, return the position after it
+size_t SkipRegexQuantifier(const ucs4string& expr, size_t i)
+{
+	const size_t len = expr.size();
+	if (i >= len)
+		return i;
+
+	if (expr[i] == '{')
+		i = SkipRegexBracket(expr, i);
+	else if (expr[i] == '*' || expr[i] == '+' || expr[i] == '?')
+		++i;
+	else
+		return i;
+
+	// lazy
+	if (i < len && expr[i] == '?')
+		++i;
+	return i;
+}
+
+} // anonymous namespace
+
+void BufferSearcher::LiteralFactors(std::vector<ucs4string>& factors) const
+{
+	factors.clear();
+	if (m_inhex || m_expr.empty())
+		return;
+
+	if (!m_use_regex)
+	{
+		factors.push_back(m_expr);
+		return;
+	}
+
+	// the inline modifiers like "(?i)" may change the rest
+	if (m_expr.find(ucs4string(1, '(') + ucs4_t('?')) != ucs4string::npos)
+		return;
+
+	const size_t len = m_expr.size();
+	ucs4string factor;
+	size_t i = 0;
+	while (i < len)
+	{
+		ucs4_t uc = m_expr[i];
+		bool literal = false;
+		size_t next = i + 1;
+
+		switch (uc)
+		{
+		case '|':
+			factors.clear();
+			return;
+		case '\\':
+			if (next >= len)
+				break;
+			uc = m_expr[next++];
+			if (!IsASCIIAlnum(uc))
+			{
+				literal = true;
+				break;
+			}
+			// the arguments of \xHH, \uHHHH, \cX and the back references
+			if (uc == 'x')
+				next += 2;
+			else if (uc == 'u')
+				next += 4;
+			else if (uc == 'c')
+				next += 1;
+			else if (uc >= '0' && uc <= '9')
+			{
+				while (next < len && m_expr[next] >= '0' && m_expr[next] <= '9')
+					++next;
+			}
+			next = std::min(next, len);
+			break;
+		case '(':
+		case '{':
+			next = SkipRegexBracket(m_expr, i);
+			break;
+		case '[':
+			next = SkipRegexClass(m_expr, i);
+			break;
+		case '.': case '^': case '$': case '*': case '+': case '?': case ')': case ']': case '}':
+			break;
+		default:
+			literal = true;
+			break;
+		}
+
+		// a literal char with '*', '?' or "{n,m}" may be absent, with '+' it ends the factor
+		bool optional = false, repeated = false;
+		if (next < len)
+		{
+			ucs4_t q = m_expr[next];
+			optional = (q == '*' || q == '?' || q == '{');
+			repeated = (q == '+');
+		}
+
+		if (literal && !optional)
+			factor.push_back(uc);
+
+		if (!literal || optional || repeated)
+		{
+			if (!factor.empty())
+				factors.push_back(factor);
+			factor.clear();
+		}
+
+		i = SkipRegexQuantifier(m_expr, next);
+	}
+
+	if (!factor.empty())
+		factors.push_back(factor);
+}
+
+bool BufferSearcher::IsDelimiterChar(ucs4_t uc)
+{
+	// the delimiters of MadSyntax::Reset(), which SearchingWXMEdit uses
+	static const ucs4_t delimiters[] = {
+		'~', '`', '!', '@', '#', '$', '%', '^', '&', '*', '(', ')', '-', '+', '=', '|',
+		'\\', '{', '}', '[', ']', ':', ';', '"', '\'', ',', '.', '<', '>', '/', '?',
+	};
+
+	if (uc <= 0x20 || uc == 0x3000)
+		return true;
+
+	return std::find(delimiters, delimiters + sizeof(delimiters) / sizeof(delimiters[0]), uc)
+		!= delimiters + sizeof(delimiters) / sizeof(delimiters[0]);
+}
+
+bool BufferSearcher::IsWordBoundary(const ucs4_t* begin, const ucs4_t* fbegin, const ucs4_t* fend, const ucs4_t* end)
+{
+	if (fbegin >= fend)
+		return true;
+
+	// the newlines are delimiters, so only the begin and the end of the text
+	// need to be checked like the begin and the end of a line
+	if (fend != end && !IsDelimiterChar(*fend) && !IsDelimiterChar(*(fend - 1)))
+		return false;
+
+	if (fbegin != begin && !IsDelimiterChar(*fbegin) && !IsDelimiterChar(*(fbegin - 1)))
+		return false;
+
+	return true;
+}
+
+int BufferSearcher::FindAll(const ucs4_t* begin, const ucs4_t* end, size_t from, bool bFirstOnly,
+	std::vector<size_t>& begidx, std::vector<size_t>& endidx, size_t* partial)
+{
+	wxASSERT(!m_inhex);
+
+	const ucs4_t* start = begin + from;
+	if (partial != nullptr)
+		*partial = size_t(end - begin);
+	if (m_expr.empty() || start >= end)
+		return 0;
+
+	// the chars before from are the context of the assertions like '^' in the
+	// first searching, the later ones begin at the end of the previous match
+	// like those of MadEdit
+	regex_constants::match_flag_type deflags = regex_constants::match_default;
+	if (partial != nullptr)
+		deflags = deflags | regex_constants::match_partial;
+	regex_constants::match_flag_type flags = deflags;
+	if (from > 0)
+	{
+		ucs4_t prev = *(start - 1);
+		if (prev != 0x0A && prev != 0x0D)
+			flags = flags | regex_constants::match_not_bol;
+		if (prev == '_' || u_isalnum(UChar32(prev)))
+			flags = flags | regex_constants::match_not_bow;
+	}
+
+	int count = 0;
+	while (start < end)
+	{
+		const ucs4_t* fbegin = start;
+		const ucs4_t* fend = end;
+		bool found;
+
+		if (m_use_regex)
+		{
+			match_results<const ucs4_t*> what;
+			try
+			{
+				found = regex_search(start, end, what, m_regex->expression, flags);
+				flags = deflags;
+			}
+			catch (regex_error)
+			{
+				return SR_EXPR_ERROR;
+			}
+
+			// the chars after end are needed to tell whether it matches
+			if (found && !what[0].matched)
+			{
+				*partial = size_t(what[0].first - begin);
+				break;
+			}
+
+			if (found)
+			{
+				fbegin = what[0].first;
+				fend = what[0].second;
+			}
+		}
+		else
+		{
+			found = ::Search(fbegin, fend, m_expr, *m_jtab, m_case_sensitive);
+		}
+
+		if (!found)
+			break;
+
+		if (m_whole_word && !IsWordBoundary(begin, fbegin, fend, end))
+		{
+			// not found, repeat...
+			start = (fend > start) ? fend : start + 1;
+			continue;
+		}
+
+		begidx.push_back(size_t(fbegin - begin));
+		endidx.push_back(size_t(fend - begin));
+		++count;
+		if (bFirstOnly)
+			break;
+
+		start = fend;
+		if (fbegin == fend)
+		{
+			// like NextRegexSearchingPos(): skip to the end of the line for
+			// the anchors, or step one char for the other empty matches
+			if (m_anchored)
+			{
+				while (start < end && *start != 0x0A && *start != 0x0D)
+					++start;
+			}
+			if (start < end)
+				++start;
+			else
+				break;
+		}
+	}
+
+	return count;
+}
+
+int BufferSearcher::FindAll(const wxByte* begin, const wxByte* end, bool bFirstOnly,
+	std::vector<size_t>& begidx, std::vector<size_t>& endidx)
+{
+	wxASSERT(m_inhex);
+
+	if (m_hex.empty())
+		return 0;
+
+	int count = 0;
+	const wxByte* start = begin;
+	while (start < end)
+	{
+		const wxByte* fbegin = start;
+		const wxByte* fend = end;
+		if (!::Search(fbegin, fend, m_hex, *m_hex_jtab, true))
+			break;
+
+		begidx.push_back(size_t(fbegin - begin));
+		endidx.push_back(size_t(fend - begin));
+		++count;
+		if (bFirstOnly)
+			break;
+
+		start = fend;
+	}
+
+	return count;
+}
+
+bool BufferSearcher::PrepareFormat(const ucs4string& fmt)
+{
+	m_fmt = fmt;
+	if (m_inhex || !m_use_regex)
+		return true;
+
+	// the escapes are converted after the format like RegexSearcher::Replace()
+	try
+	{
+		ConvertEscape(fmt);
+	}
+	catch (regex_error)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool BufferSearcher::Replace(const ucs4_t* fbegin, const ucs4_t* fend, ucs4string& out)
+{
+	wxASSERT(!m_inhex);
+
+	out.clear();
+	if (!m_use_regex)
+	{
+		out = m_fmt;
+		return true;
+	}
+
+	try
+	{
+		std::back_insert_iterator<ucs4string> oi(out);
+		regex_replace(oi, fbegin, fend, m_regex->expression, m_fmt);
+		out = ConvertEscape(out);
+	}
+	catch (regex_error)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace wxm
@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/buffer_searcher.h
+// Description: Searching and Replacing in Buffers without wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_BUFFER_SEARCHER_H_
+#define _WXM_BUFFER_SEARCHER_H_
+
+#include "../xm/cxx11.h"
+#include "def.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/string.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <vector>
+#include <memory>
+
+class JumpTable_UCS4;
+class JumpTable_Hex;
+
+// returned state of Search & Replace
+enum MadSearchResult
+{
+	SR_EXPR_ERROR = -2, SR_YES = -1, SR_NO = 0
+};
+
+namespace wxm
+{
+
+	// convert to the chars without the UTF-16 surrogates
+	ucs4string WxStrToUCS4(const wxString& wxs);
+
+	// search in a decoded text or in raw bytes without a MadEdit, with the same
+	// semantics as the searchers of MadEdit and the default syntax delimiters;
+	// it shows no message, so it can run on the worker threads of Find in Files,
+	// one instance per thread
+	struct BufferSearcher
+	{
+		BufferSearcher();
+		~BufferSearcher();
+
+		// expr must be in normal case if !case_sensitive
+		// return false if expr is not a valid regular expression
+		bool PrepareText(const ucs4string& expr, bool use_regex, bool case_sensitive, bool whole_word,
+			bool dot_newline);
+		void PrepareHex(const std::vector<wxByte>& hex);
+
+		bool InHex() const { return m_inhex; }
+		bool IsRegex() const { return !m_inhex && m_use_regex; }
+		// '.' of the regex matches the newlines, so a match may span any lines
+		bool DotMatchesNewline() const { return IsRegex() && m_dot_newline; }
+
+		// the strings every match contains: the literal itself, or the runs of
+		// the plain chars of a regex outside the groups and the classes;
+		// none for an alternation or the hex
+		void LiteralFactors(std::vector<ucs4string>& factors) const;
+
+		// list the matched ranges in [begin+from, end) as the indices to begin,
+		// the chars before from are not searched, but they are the context of
+		// the whole word matching and of the regex assertions
+		// if partial is given, the searching of a regex stops at a match which
+		// may only be told by the chars after end, and its beginning is set to
+		// *partial, or end - begin if there is none
+		// return the found count or SR_EXPR_ERROR
+		int FindAll(const ucs4_t* begin, const ucs4_t* end, size_t from, bool bFirstOnly,
+			std::vector<size_t>& begidx, std::vector<size_t>& endidx, size_t* partial = nullptr);
+		int FindAll(const wxByte* begin, const wxByte* end, bool bFirstOnly,
+			std::vector<size_t>& begidx, std::vector<size_t>& endidx);
+
+		// the format of the replacements, must be called after PrepareText()
+		// return false if fmt is not a valid format
+		bool PrepareFormat(const ucs4string& fmt);
+
+		// the replacement of the match [fbegin, fend) like Replace() of the
+		// searchers of MadEdit, return false if the format is invalid for the match
+		bool Replace(const ucs4_t* fbegin, const ucs4_t* fend, ucs4string& out);
+
+	private:
+		struct Regex;
+
+		bool IsWordBoundary(const ucs4_t* begin, const ucs4_t* fbegin, const ucs4_t* fend, const ucs4_t* end);
+		bool IsDelimiterChar(ucs4_t uc);
+
+		bool m_inhex;
+		bool m_use_regex;
+		bool m_case_sensitive;
+		bool m_whole_word;
+		bool m_anchored;	// the regex has '^' or '$'
+		bool m_dot_newline;
+		ucs4string m_expr;
+		ucs4string m_fmt;
+		std::vector<wxByte> m_hex;
+		std::unique_ptr<JumpTable_UCS4> m_jtab;
+		std::unique_ptr<JumpTable_Hex> m_hex_jtab;
+		std::unique_ptr<Regex> m_regex;
+	};
+} //namespace wxm
+
+#endif //_WXM_BUFFER_SEARCHER_H_
@@ -0,0 +1,799 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/dir_walker.cpp
+// Description: Parallel Directory Walker of Find in Files of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "dir_walker.h"
+#include "utils.h"
+#include "../xm/mad_encdet.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <algorithm>
+#include <utility>
+
+#ifndef __WXMSW__
+# include <dirent.h>
+# include <string.h>
+#endif
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace wxm
+{
+
+// a pattern of a .gitignore file
+struct GitIgnorePattern
+{
+	std::wstring glob;
+	bool negative;      // "!pattern" re-includes the paths
+	bool dironly;       // "pattern/" matches only the dirs
+	bool anchored;      // with a slash, matched with the path relative to the .gitignore,
+	                    // otherwise with the name at any level
+};
+
+// the patterns of a .gitignore file, linked to the ones of the parent dirs
+struct GitIgnoreRules
+{
+	std::wstring base;      // the dir of the .gitignore relative to the root with '/' at
+	                        // the end, stripped from the paths matched
+	std::wstring prefix;    // the root relative to a .gitignore above it, prepended instead
+	std::vector<GitIgnorePattern> patterns;
+	std::shared_ptr<const GitIgnoreRules> parent;
+
+	// 1 if the path is ignored, -1 if re-included, 0 if no pattern matches;
+	// the last pattern matched decides, the deeper .gitignore after the parents
+	int Match(const std::wstring& rel, const std::wstring& name, bool isdir) const;
+};
+
+namespace
+{
+
+// these many entries are checked between checking the cancellation
+const size_t cancel_check_entries = 64;
+
+// the bytes read to check the binary data, the same as MadLines::LoadFromFile()
+const size_t binary_check_size = 4096;
+
+// the .gitignore files larger than this are not a list of patterns
+const wxFileOffset max_gitignore_size = 1024 * 1024;
+
+// the threads are mostly waiting for the network drives, not for the CPUs
+const size_t min_walker_threads = 8;
+
+// the extensions of the files never searched as text, in lower case
+const wchar_t* const binary_exts[] =
+{
+	L"7z", L"a", L"bin", L"bmp", L"bz2", L"class", L"dll", L"dylib", L"exe", L"gif",
+	L"gz", L"ico", L"jar", L"jpeg", L"jpg", L"lib", L"mo", L"mp3", L"mp4", L"o",
+	L"obj", L"pdb", L"pdf", L"png", L"pyc", L"so", L"tar", L"tif", L"tiff", L"wav",
+	L"xz", L"zip",
+};
+
+// '*' and '?' like wxString::Matches()
+bool WildMatch(const wchar_t* pat, const wchar_t* str)
+{
+	const wchar_t* star = nullptr;
+	const wchar_t* retry = nullptr;
+	while (*str != 0)
+	{
+		if (*pat == L'*')
+		{
+			star = ++pat;
+			retry = str;
+		}
+		else if (*pat == L'?' || *pat == *str)
+		{
+			++pat;
+			++str;
+		}
+		else if (star != nullptr)
+		{
+			pat = star;
+			str = ++retry;
+		}
+		else
+			return false;
+	}
+
+	while (*pat == L'*')
+		++pat;
+	return *pat == 0;
+}
+
+// the glob of .gitignore: '*', '?' and "[...]" do not match '/', "**/" matches
+// zero or more dirs and a trailing "/**" matches everything inside
+bool GlobMatch(const wchar_t* start, const wchar_t* p, const wchar_t* s)
+{
+	for (; *p != 0; ++p)
+	{
+		switch (*p)
+		{
+		case L'*':
+			if (p[1] == L'*' && (p == start || p[-1] == L'/'))
+			{
+				const wchar_t* q = p;
+				while (*q == L'*')
+					++q;
+				if (*q == 0)
+					return true;
+				if (*q == L'/')
+				{
+					for (const wchar_t* t = s; ; ++t)
+					{
+						if ((t == s || t[-1] == L'/') && GlobMatch(start, q + 1, t))
+							return true;
+						if (*t == 0)
+							return false;
+					}
+				}
+			}
+
+			// other consecutive asterisks are one
+			while (p[1] == L'*')
+				++p;
+			for (const wchar_t* t = s; ; ++t)
+			{
+				if (GlobMatch(start, p + 1, t))
+					return true;
+				if (*t == 0 || *t == L'/')
+					return false;
+			}
+
+		case L'?':
+			if (*s == 0 || *s == L'/')
+				return false;
+			++s;
+			break;
+
+		case L'[':
+			{
+				const wchar_t* q = p + 1;
+				const bool negative = (*q == L'!' || *q == L'^');
+				if (negative)
+					++q;
+
+				// a ']' at the beginning is a member
+				const wchar_t* first = q;
+				bool member = false;
+				for (; *q != 0 && (*q != L']' || q == first); ++q)
+				{
+					wchar_t lo = *q;
+					if (lo == L'\\' && q[1] != 0)
+						lo = *++q;
+					wchar_t hi = lo;
+					if (q[1] == L'-' && q[2] != 0 && q[2] != L']')
+					{
+						q += 2;
+						hi = *q;
+						if (hi == L'\\' && q[1] != 0)
+							hi = *++q;
+					}
+					if (*s >= lo && *s <= hi)
+						member = true;
+				}
+
+				if (*q == 0)
+				{
+					// no ']', the '[' is a plain char
+					if (*s != L'[')
+						return false;
+					++s;
+					break;
+				}
+
+				if (*s == 0 || *s == L'/' || member == negative)
+					return false;
+				++s;
+				p = q;
+			}
+			break;
+
+		case L'\\':
+			if (p[1] != 0)
+				++p;
+			// fall through
+		default:
+			if (*s != *p)
+				return false;
+			++s;
+		}
+	}
+
+	return *s == 0;
+}
+
+void ParseGitIgnore(const std::wstring& text, std::vector<GitIgnorePattern>& patterns)
+{
+	size_t pos = 0;
+	while (pos < text.size())
+	{
+		size_t eol = text.find(L'\n', pos);
+		if (eol == std::wstring::npos)
+			eol = text.size();
+		std::wstring line = text.substr(pos, eol - pos);
+		pos = eol + 1;
+
+		if (!line.empty() && line[line.size() - 1] == L'\r')
+			line.erase(line.size() - 1);
+		if (line.empty() || line[0] == L'#')
+			continue;
+
+		// the trailing spaces are ignored unless escaped
+		while (!line.empty() && line[line.size() - 1] == L' '
+			&& (line.size() < 2 || line[line.size() - 2] != L'\\'))
+		{
+			line.erase(line.size() - 1);
+		}
+
+		GitIgnorePattern pat;
+		pat.negative = (!line.empty() && line[0] == L'!');
+		if (pat.negative)
+			line.erase(0, 1);
+
+		pat.dironly = false;
+		while (!line.empty() && line[line.size() - 1] == L'/')
+		{
+			pat.dironly = true;
+			line.erase(line.size() - 1);
+		}
+		if (line.empty())
+			continue;
+
+		pat.anchored = (line.find(L'/') != std::wstring::npos);
+		if (line[0] == L'/')
+			line.erase(0, 1);
+
+		pat.glob.swap(line);
+		patterns.push_back(pat);
+	}
+}
+
+// an entry of a dir
+struct DirEntry
+{
+	std::wstring name;
+	int isdir;          // 1 or 0 as listed, -1 if the listing cannot tell
+};
+
+// the entries are listed once; the type of an entry is taken from the listing
+// where readdir() gives it, the others are left to be checked by the caller
+bool ListDir(const std::wstring& path, std::vector<DirEntry>& entries)
+{
+#if !defined(__WXMSW__) && defined(DT_DIR)
+	DIR* d = opendir(wxString(path.c_str()).fn_str());
+	if (d == nullptr)
+		return false;
+
+	while (struct dirent* de = readdir(d))
+	{
+		if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+			continue;
+
+		// the names not in the encoding of the file names are skipped like wxDir
+		wxString name(de->d_name, *wxConvFileName);
+		if (name.IsEmpty())
+			continue;
+
+		DirEntry entry;
+		entry.name = name.wc_str();
+		switch (de->d_type)
+		{
+		case DT_DIR:
+			entry.isdir = 1;
+			break;
+		case DT_LNK:        // followed like wxDirExists()
+		case DT_UNKNOWN:    // the file systems without the type in the dir entries
+			entry.isdir = -1;
+			break;
+		default:
+			entry.isdir = 0;
+		}
+		entries.push_back(entry);
+	}
+
+	closedir(d);
+	return true;
+#else
+	wxDir d;
+	if (!d.Open(wxString(path.c_str())))
+		return false;
+
+	wxString name;
+	for (bool cont = d.GetFirst(&name, wxEmptyString, wxDIR_FILES | wxDIR_DIRS | wxDIR_HIDDEN); cont; cont = d.GetNext(&name))
+	{
+		DirEntry entry;
+		entry.name = name.wc_str();
+		entry.isdir = -1;
+		entries.push_back(entry);
+	}
+	return true;
+#endif
+}
+
+// the patterns of the .gitignore file, nullptr if there is none
+std::shared_ptr<GitIgnoreRules> ReadGitIgnore(const std::wstring& filename)
+{
+	wxFile file;
+	if (!file.Open(wxString(filename.c_str()), wxFile::read))
+		return nullptr;
+
+	wxFileOffset len = file.Length();
+	if (len <= 0 || len > max_gitignore_size)
+		return nullptr;
+
+	std::vector<char> buf(size_t(len) + 1, 0);
+	if (file.Read(&buf[0], size_t(len)) != ssize_t(len))
+		return nullptr;
+
+	// as Latin-1 if not in UTF-8, the patterns are mostly ASCII
+	std::wstring text(wxString(&buf[0], wxConvUTF8).wc_str());
+	if (text.empty())
+	{
+		for (size_t i = 0; i < size_t(len); ++i)
+			text += wchar_t((unsigned char)buf[i]);
+	}
+
+	std::shared_ptr<GitIgnoreRules> rules(new GitIgnoreRules());
+	ParseGitIgnore(text, rules->patterns);
+	if (rules->patterns.empty())
+		return nullptr;
+	return rules;
+}
+
+// the .gitignore files from the top of the work tree down to the parent of dir,
+// nothing if dir is not in a work tree; the ones in dir are read by the threads
+std::shared_ptr<const GitIgnoreRules> ReadParentGitIgnores(const wxString& dir)
+{
+	wxFileName fn = wxFileName::DirName(dir);
+	fn.MakeAbsolute();
+
+	// the parent dirs and the root relative to them, nearest first
+	std::vector<std::pair<wxString, std::wstring> > parents;
+	std::wstring prefix;
+	bool worktree = false;
+	for (;;)
+	{
+		// .git is a file in the submodules and the linked work trees
+		wxString git = fn.GetPathWithSep() + wxT(".git");
+		if (wxDirExists(git) || wxFileExists(git))
+		{
+			worktree = true;
+			break;
+		}
+		if (fn.GetDirCount() == 0)
+			break;
+
+		prefix = std::wstring(fn.GetDirs().Last().wc_str()) + L'/' + prefix;
+		fn.RemoveLastDir();
+		parents.push_back(std::make_pair(fn.GetPathWithSep(), prefix));
+	}
+	if (!worktree)
+		return nullptr;
+
+	std::shared_ptr<const GitIgnoreRules> rules;
+	for (size_t i = parents.size(); i > 0; --i)
+	{
+		std::wstring filename = std::wstring(parents[i - 1].first.wc_str()) + L".gitignore";
+		std::shared_ptr<GitIgnoreRules> local = ReadGitIgnore(filename);
+		if (local == nullptr)
+			continue;
+		local->prefix = parents[i - 1].second;
+		local->parent = rules;
+		rules = local;
+	}
+	return rules;
+}
+
+} // anonymous namespace
+
+int GitIgnoreRules::Match(const std::wstring& rel, const std::wstring& name, bool isdir) const
+{
+	std::wstring sub;
+	for (size_t i = patterns.size(); i > 0; --i)
+	{
+		const GitIgnorePattern& pat = patterns[i - 1];
+		if (pat.dironly && !isdir)
+			continue;
+
+		if (pat.anchored && sub.empty())
+			sub = prefix + rel.substr(base.size());
+
+		const wchar_t* str = pat.anchored ? sub.c_str() : name.c_str();
+		if (GlobMatch(pat.glob.c_str(), pat.glob.c_str(), str))
+			return pat.negative ? -1 : 1;
+	}
+
+	return parent ? parent->Match(rel, name, isdir) : 0;
+}
+
+//==================================================
+
+void FileNameMatcher::Add(const std::wstring& wildcard)
+{
+	if (wildcard == L"*")
+	{
+		m_All = true;
+		return;
+	}
+
+	const size_t wild = wildcard.find_first_of(L"*?");
+	if (wild == std::wstring::npos)
+	{
+		m_Names.insert(wildcard);
+		return;
+	}
+
+	if (wildcard.compare(0, 2, L"*.") == 0 && wildcard.find_first_of(L"*?.", 2) == std::wstring::npos)
+	{
+		m_Exts.insert(wildcard.substr(2));
+		return;
+	}
+
+	m_Wildcards.push_back(wildcard);
+}
+
+bool FileNameMatcher::Matches(const std::wstring& name) const
+{
+	if (m_All)
+		return true;
+
+	if (!m_Names.empty() && m_Names.find(name) != m_Names.end())
+		return true;
+
+	if (!m_Exts.empty())
+	{
+		size_t dot = name.rfind(L'.');
+		if (dot != std::wstring::npos && m_Exts.find(name.substr(dot + 1)) != m_Exts.end())
+			return true;
+	}
+
+	for (size_t i = 0; i < m_Wildcards.size(); ++i)
+	{
+		if (WildMatch(m_Wildcards[i].c_str(), name.c_str()))
+			return true;
+	}
+
+	return false;
+}
+
+//==================================================
+
+class DirWalkerThread : public wxThread
+{
+public:
+	DirWalkerThread(DirWalker* walker)
+		: wxThread(wxTHREAD_JOINABLE), m_Walker(walker)
+	{}
+
+	virtual ExitCode Entry() override;
+
+private:
+	DirWalker* m_Walker;
+};
+
+wxThread::ExitCode DirWalkerThread::Entry()
+{
+	DirWalker::Dir dir;
+	bool processed = false;
+	while (!TestDestroy() && m_Walker->NextDir(dir, processed))
+	{
+		processed = true;
+		m_Walker->ReadDir(dir);
+	}
+
+	m_Walker->ThreadDone();
+
+	return (ExitCode)0;
+}
+
+//==================================================
+
+DirWalker::DirWalker()
+	: m_DirCond(m_Lock), m_DoneCond(m_Lock)
+	, m_Pending(0), m_Running(0), m_Cancelled(false)
+{
+}
+
+DirWalker::~DirWalker()
+{
+	Stop();
+}
+
+void DirWalker::Start(const DirWalkerOptions& opt, size_t threads)
+{
+	m_Options = opt;
+
+	m_Includes = FileNameMatcher();
+	for (size_t i = 0; i < opt.includes.size(); ++i)
+		m_Includes.Add(std::wstring(FilePathNormalCase(opt.includes[i]).wc_str()));
+	m_Excludes = FileNameMatcher();
+	for (size_t i = 0; i < opt.excludes.size(); ++i)
+		m_Excludes.Add(std::wstring(FilePathNormalCase(opt.excludes[i]).wc_str()));
+
+	// the paths are the same as wxDir::Traverse()
+	Dir root;
+	root.path = opt.dir.wc_str();
+	if (root.path.empty() || !wxFileName::IsPathSeparator(root.path[root.path.size() - 1]))
+		root.path += wchar_t(wxFILE_SEP_PATH);
+	if (opt.gitignore)
+		root.rules = ReadParentGitIgnores(opt.dir);
+
+	m_Dirs.clear();
+	m_Dirs.push_back(root);
+	m_Pending = 1;
+	m_Cancelled = false;
+	m_Files.clear();
+
+	if (!opt.recursive)
+	{
+		threads = 1;
+	}
+	else if (threads == 0)
+	{
+		int cpus = wxThread::GetCPUCount();
+		threads = std::max(min_walker_threads, size_t((cpus > 0)? cpus: 1));
+	}
+
+	for (size_t i = 0; i < threads; ++i)
+	{
+		std::unique_ptr<DirWalkerThread> thread(new DirWalkerThread(this));
+		if (thread->Create() != wxTHREAD_NO_ERROR)
+			break;
+
+		m_Threads.push_back(thread.release());
+	}
+
+	// read the dirs on the calling thread if no thread can be created
+	if (m_Threads.empty())
+	{
+		Dir dir;
+		bool processed = false;
+		while (NextDir(dir, processed))
+		{
+			processed = true;
+			ReadDir(dir);
+		}
+		return;
+	}
+
+	m_Running = m_Threads.size();
+	for (size_t i = 0; i < m_Threads.size(); ++i)
+		m_Threads[i]->Run();
+}
+
+bool DirWalker::Wait(unsigned long timeout)
+{
+	{
+		wxMutexLocker lock(m_Lock);
+		if (m_Running > 0)
+			m_DoneCond.WaitTimeout(timeout);
+
+		if (m_Running > 0)
+			return false;
+	}
+
+	JoinThreads();
+	return true;
+}
+
+void DirWalker::Stop()
+{
+	{
+		wxMutexLocker lock(m_Lock);
+		m_Cancelled = true;
+		m_DirCond.Broadcast();
+	}
+
+	JoinThreads();
+}
+
+size_t DirWalker::GetFileCount()
+{
+	wxMutexLocker lock(m_Lock);
+	return m_Files.size();
+}
+
+void DirWalker::GetFiles(std::vector<wxString>& files)
+{
+	JoinThreads();
+
+	files.reserve(files.size() + m_Files.size());
+	for (size_t i = 0; i < m_Files.size(); ++i)
+		files.push_back(wxString(m_Files[i].c_str()));
+}
+
+void DirWalker::JoinThreads()
+{
+	for (size_t i = 0; i < m_Threads.size(); ++i)
+	{
+		m_Threads[i]->Wait();
+		delete m_Threads[i];
+	}
+	m_Threads.clear();
+}
+
+bool DirWalker::NextDir(Dir& dir, bool processed)
+{
+	wxMutexLocker lock(m_Lock);
+	if (processed && --m_Pending == 0)
+		m_DirCond.Broadcast();
+
+	// the dirs being read by the other threads may have subdirs
+	while (!m_Cancelled && m_Dirs.empty() && m_Pending > 0)
+		m_DirCond.Wait();
+
+	if (m_Cancelled || m_Dirs.empty())
+		return false;
+
+	dir = m_Dirs.front();
+	m_Dirs.pop_front();
+	return true;
+}
+
+void DirWalker::AddDirs(std::vector<Dir>& dirs)
+{
+	if (dirs.empty())
+		return;
+
+	wxMutexLocker lock(m_Lock);
+	for (size_t i = 0; i < dirs.size(); ++i)
+	{
+		m_Dirs.push_back(Dir());
+		m_Dirs.back().path.swap(dirs[i].path);
+		m_Dirs.back().rel.swap(dirs[i].rel);
+		m_Dirs.back().rules.swap(dirs[i].rules);
+	}
+	m_Pending += dirs.size();
+	m_DirCond.Broadcast();
+}
+
+void DirWalker::AddFiles(std::vector<std::wstring>& files)
+{
+	if (files.empty())
+		return;
+
+	wxMutexLocker lock(m_Lock);
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		m_Files.push_back(std::wstring());
+		m_Files.back().swap(files[i]);
+	}
+}
+
+bool DirWalker::IsCancelled()
+{
+	wxMutexLocker lock(m_Lock);
+	return m_Cancelled;
+}
+
+void DirWalker::ThreadDone()
+{
+	wxMutexLocker lock(m_Lock);
+	if (--m_Running == 0)
+		m_DoneCond.Signal();
+}
+
+// the dirs are told from the files by the types listed with the entries, only
+// the entries of unknown types and the symbolic links are checked by stat()
+void DirWalker::ReadDir(const Dir& dir)
+{
+	wxLogNull nolog;
+	std::vector<DirEntry> entries;
+	if (!ListDir(dir.path, entries))
+		return;
+
+	bool hasgitignore = false;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		if (entries[i].name == L".gitignore")
+			hasgitignore = true;
+	}
+
+	std::shared_ptr<const GitIgnoreRules> rules = dir.rules;
+	if (m_Options.gitignore && hasgitignore)
+	{
+		std::shared_ptr<GitIgnoreRules> local = ReadGitIgnore(dir.path + L".gitignore");
+		if (local != nullptr)
+		{
+			local->base = dir.rel;
+			local->parent = rules;
+			rules = local;
+		}
+	}
+
+	std::vector<std::wstring> files;
+	std::vector<Dir> subdirs;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		if (i % cancel_check_entries == 0 && IsCancelled())
+			return;
+
+		const std::wstring& ename = entries[i].name;
+		std::wstring full = dir.path + ename;
+		bool isdir = (entries[i].isdir < 0)? wxDirExists(wxString(full.c_str())): (entries[i].isdir != 0);
+		if (isdir)
+		{
+			if (!m_Options.recursive)
+				continue;
+			if (m_Options.gitignore && (ename == L".git" || (rules && rules->Match(dir.rel + ename, ename, true) > 0)))
+				continue;
+
+			subdirs.push_back(Dir());
+			subdirs.back().path = full + wchar_t(wxFILE_SEP_PATH);
+			subdirs.back().rel = dir.rel + ename + L'/';
+			subdirs.back().rules = rules;
+			continue;
+		}
+
+		if (!m_Includes.Empty() || !m_Excludes.Empty())
+		{
+			std::wstring normal(FilePathNormalCase(wxString(ename.c_str())).wc_str());
+			if (!m_Includes.Empty() && !m_Includes.Matches(normal))
+				continue;
+			if (m_Excludes.Matches(normal))
+				continue;
+		}
+
+		if (rules && rules->Match(dir.rel + ename, ename, false) > 0)
+			continue;
+
+		if (m_Options.skip_binary && IsBinaryFile(ename, full))
+			continue;
+
+		files.push_back(full);
+	}
+
+	AddDirs(subdirs);
+	AddFiles(files);
+}
+
+bool DirWalker::IsBinaryFile(const std::wstring& name, const std::wstring& path) const
+{
+	size_t dot = name.rfind(L'.');
+	if (dot != std::wstring::npos)
+	{
+		std::wstring ext = name.substr(dot + 1);
+		for (size_t i = 0; i < ext.size(); ++i)
+		{
+			if (ext[i] >= L'A' && ext[i] <= L'Z')
+				ext[i] = ext[i] - L'A' + L'a';
+		}
+
+		const wchar_t* const* end = binary_exts + sizeof(binary_exts) / sizeof(binary_exts[0]);
+		for (const wchar_t* const* it = binary_exts; it != end; ++it)
+		{
+			if (ext == *it)
+				return true;
+		}
+	}
+
+	wxFile file;
+	if (!file.Open(wxString(path.c_str()), wxFile::read))
+		return false;
+
+	wxByte buf[binary_check_size];
+	ssize_t len = file.Read(buf, binary_check_size);
+	return len > 0 && IsBinaryData(buf, size_t(len));
+}
+
+} //namespace wxm
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/dir_walker.h
+// Description: Parallel Directory Walker of Find in Files of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_DIR_WALKER_H_
+#define _WXM_DIR_WALKER_H_
+
+#include "../xm/cxx11.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/string.h>
+#include <wx/thread.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <boost/unordered_set.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+#include <deque>
+
+namespace wxm
+{
+
+// the wildcards of the file names compiled into one matcher: "*.ext" and the
+// names without wildcards are looked up by hashing, the others are matched
+// one by one like wxString::Matches()
+class FileNameMatcher
+{
+public:
+	FileNameMatcher(): m_All(false) {}
+
+	// the wildcard and the names matched must be in FilePathNormalCase()
+	void Add(const std::wstring& wildcard);
+	bool Empty() const { return !m_All && m_Exts.empty() && m_Names.empty() && m_Wildcards.empty(); }
+	bool Matches(const std::wstring& name) const;
+
+private:
+	bool m_All;
+	boost::unordered_set<std::wstring> m_Exts;  // the extensions of "*.ext" without the dot
+	boost::unordered_set<std::wstring> m_Names;
+	std::vector<std::wstring> m_Wildcards;
+};
+
+struct GitIgnoreRules;
+
+struct DirWalkerOptions
+{
+	wxString dir;
+	bool recursive;
+	std::vector<wxString> includes; // the wildcards of the file names, empty for all the files
+	std::vector<wxString> excludes;
+	bool gitignore;                 // skip the files and dirs ignored by the .gitignore files
+	bool skip_binary;               // skip the files of the binary extensions or with binary data
+
+	DirWalkerOptions(): recursive(false), gitignore(false), skip_binary(false) {}
+};
+
+class DirWalkerThread;
+
+// list the files under a directory in one pass on a pool of threads, every
+// thread reads a whole directory and queues the subdirectories found:
+//     walker.Start(opt);
+//     while (!walker.Wait(350)) { ... walker.GetFileCount() ... }
+//     walker.GetFiles(files);
+class DirWalker
+{
+public:
+	DirWalker();
+	~DirWalker();
+
+	// threads is the count of the threads, 0 for a count fit for the network drives
+	void Start(const DirWalkerOptions& opt, size_t threads = 0);
+
+	// wait at most timeout milliseconds, return true when all the dirs are read
+	bool Wait(unsigned long timeout);
+
+	// cancel the walking and wait for the threads
+	void Stop();
+
+	size_t GetFileCount();
+
+	// the files found, must be called after Wait() returned true or Stop()
+	void GetFiles(std::vector<wxString>& files);
+
+private:
+	friend class DirWalkerThread;
+
+	struct Dir
+	{
+		std::wstring path;  // with the separator at the end
+		std::wstring rel;   // relative to the root with '/' at the end, empty for the root
+		std::shared_ptr<const GitIgnoreRules> rules;
+	};
+
+	// called by the threads
+	// processed: the thread has read a dir
+	bool NextDir(Dir& dir, bool processed);
+	void AddDirs(std::vector<Dir>& dirs);
+	void AddFiles(std::vector<std::wstring>& files);
+	bool IsCancelled();
+	void ThreadDone();
+
+	void ReadDir(const Dir& dir);
+	bool IsBinaryFile(const std::wstring& name, const std::wstring& path) const;
+
+	void JoinThreads();
+
+	DirWalkerOptions m_Options;
+	FileNameMatcher m_Includes;
+	FileNameMatcher m_Excludes;
+	std::vector<DirWalkerThread*> m_Threads;
+
+	wxMutex m_Lock;         // guards the members below
+	wxCondition m_DirCond;  // signaled when there are dirs queued or no dir left
+	wxCondition m_DoneCond; // signaled when the threads finished
+	std::deque<Dir> m_Dirs;
+	size_t m_Pending;       // the dirs queued or being read
+	size_t m_Running;
+	bool m_Cancelled;
+	std::vector<std::wstring> m_Files;
+};
+
+} //namespace wxm
+
+#endif //_WXM_DIR_WALKER_H_
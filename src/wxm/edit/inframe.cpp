@@ -105,6 +105,9 @@ InFrameWXMEdit::InFrameWXMEdit(wxWindow* parent, wxWindowID id, const wxPoint& p
 
 	m_LineNumberAreaWidth = GetLineNumberAreaWidth(0);
 
+	// the unsaved edits are recorded to be recovered after a crash
+	EnableRecoveryJournal();
+
 	SetWindowStyleFlag(GetWindowStyleFlag() & ~wxTAB_TRAVERSAL);
 	//SetDropTarget(new DnDFile());
 
@@ -170,6 +173,13 @@ void InFrameWXMEdit::DoSelectionChanged()
 	wxm::GetFrameStatusBar().Update(); // repaint immediately
 }
 
+void InFrameWXMEdit::DoAsyncSaveProgress(int percent)
+{
+	wxString name = wxFileName(m_Lines->GetSavingFileName()).GetFullName();
+	wxm::GetFrameStatusBar().SetProgress(wxString::Format(_("Saving %s..."), name.c_str()), percent);
+	wxm::GetFrameStatusBar().Update();
+}
+
 void InFrameWXMEdit::DoStatusChanged()
 {
 	g_MainFrame->m_Notebook->ConnectMouseClick();
@@ -61,6 +61,7 @@ struct InFrameWXMEdit : public MadEdit
 private:
 	virtual void DoSelectionChanged() override;
 	virtual void DoStatusChanged() override;
+	virtual void DoAsyncSaveProgress(int percent) override;
 	virtual void DoToggleWindow() override;
 	virtual void DoMouseRightUp() override;
 
@@ -0,0 +1,1427 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/find_in_files.cpp
+// Description: Parallel Find in Files Engine of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "find_in_files.h"
+#include "replace_journal.h"
+#include "buffer_searcher.h"
+#include "case_conv.h"
+#include "utils.h"
+#include "../xm/encoding/encoding.h"
+#include "../xm/encdet.h"
+#include "../xm/search_window.h"
+#include "../xm/perf.h"
+#include "../mad_utils.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/file.h>
+#include <wx/log.h>
+#include <wx/longlong.h>
+#include <wx/config.h>
+#include <wx/intl.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <cstring>
+
+#ifndef __WXMSW__
+#include <sys/stat.h>
+#endif
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace wxm
+{
+
+namespace
+{
+
+// the bytes to detect the encoding, the same as MadLines::LoadFromFile()
+const size_t max_detecting_size = 4096;
+
+// the max chars of the line text of a match, the same as FindReplaceInFiles()
+const size_t max_linetext_len = 512;
+
+// the chars shown before a match far from the beginning of a long line
+const size_t snippet_context = 64;
+
+// the files are read and decoded by blocks, so the memory of a worker is
+// bounded whatever the size of the file is
+const size_t read_block_size = 256 * 1024;
+
+// the window is committed in the middle of a line without newlines at this size
+const size_t max_window_chars = 1024 * 1024;
+
+// a regex match reaching the end of the window grows it up to this size, and
+// a regex of '.' matching the newlines is searched in windows of this size
+const size_t max_match_chars = 16 * 1024 * 1024;
+
+// the bytes left undecoded at the end of a block, a char has at most 4 bytes
+const size_t max_char_bytes = 4;
+
+// the main thread is woken up when there are so many matched files
+const size_t results_batch_size = 64;
+
+// decodes from the bytes of the window in memory
+class BufferBytesMapper: public xm::UChar32BytesMapper
+{
+public:
+	BufferBytesMapper(const wxByte* data, size_t size, size_t pos): m_data(data), m_size(size), m_pos(pos) {}
+
+	virtual void MoveUChar32Bytes(xm::UCQueue &ucqueue, ucs4_t uc, size_t len) override
+	{
+		ucqueue.push_back(xm::CharUnit(uc, int(len)));
+		m_pos += len;
+	}
+
+	virtual ubyte* BufferLoadBytes(int64_t& rest, size_t buf_len) override
+	{
+		rest = int64_t(m_size) - int64_t(m_pos);
+		if (rest <= 0)
+			return nullptr;
+		return const_cast<ubyte*>(m_data + m_pos);
+	}
+
+	size_t Pos() const { return m_pos; }
+
+private:
+	const wxByte* m_data;
+	size_t m_size;
+	size_t m_pos;
+};
+
+inline bool IsNewLine(const ucs4_t* chars, size_t idx, size_t count)
+{
+	// "\r\n" is one newline at '\n'
+	return chars[idx] == 0x0A || (chars[idx] == 0x0D && (idx + 1 == count || chars[idx + 1] != 0x0A));
+}
+
+int CountNewLines(const ucs4_t* chars, size_t count)
+{
+	int lines = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (IsNewLine(chars, i, count))
+			++lines;
+	}
+	return lines;
+}
+
+// the char not in the encoding is written as "{U+XXXX}" like MadEdit::UCStoBlock()
+std::string UEscape(ucs4_t uc)
+{
+	static const char hexdigits[] = "0123456789ABCDEF";
+	std::string digits;
+	for (unsigned int v = unsigned(uc); v != 0 || digits.size() < 4; v >>= 4)
+		digits.insert(digits.begin(), hexdigits[v & 0xF]);
+	return "{U+" + digits + "}";
+}
+
+// the link would be replaced by a regular file
+bool IsSymLink(const std::wstring& filename)
+{
+#ifdef __WXMSW__
+	return false;
+#else
+	struct stat st;
+	return lstat(wxString(filename.c_str()).fn_str(), &st) == 0 && S_ISLNK(st.st_mode);
+#endif
+}
+
+// a text containing the char must contain its bytes in enc, if no other
+// byte sequence is decoded to the char
+bool IsByteExactChar(xm::Encoding* enc, ucs4_t uc, bool case_sensitive)
+{
+	// U+0130 and U+212A are 'i' and 'k' in normal case
+	if (!case_sensitive && (uc >= 0x80 || uc == 'i' || uc == 'k'))
+		return false;
+
+	switch (enc->GetEncoding())
+	{
+	case xm::ENC_UTF_8:
+		// an invalid byte is decoded as a char of U+0080~U+00FF
+		return uc < 0x80 || uc >= 0x100;
+	case xm::ENC_UTF_16LE:
+	case xm::ENC_UTF_16BE:
+	case xm::ENC_UTF_32LE:
+	case xm::ENC_UTF_32BE:
+		// an invalid unit is decoded as '?'
+		return uc != '?';
+	default:
+		// only the ASCII bytes are decoded to the printable ASCII chars, and an
+		// invalid byte is decoded as a char of U+0080~U+00FF
+		return uc >= 0x20 && uc < 0x7F;
+	}
+}
+
+// a run of the bytes of the byte exact chars of a factor
+struct ByteRun
+{
+	std::vector<wxByte> bytes;
+	std::vector<wxByte> fold;       // 1 for the ASCII letters compared ignoring the case
+};
+
+// every match contains all the byte runs of the factors in enc
+void ByteExactRuns(xm::Encoding* enc, const std::vector<ucs4string>& factors, bool case_sensitive, std::vector<ByteRun>& runs)
+{
+	ByteRun run;
+	ubyte buf[16];
+	for (size_t f = 0; f < factors.size(); ++f)
+	{
+		const ucs4string& factor = factors[f];
+		for (size_t i = 0; i <= factor.size(); ++i)
+		{
+			size_t n = 0;
+			if (i < factor.size() && IsByteExactChar(enc, factor[i], case_sensitive))
+				n = enc->UCS4toMultiByte(factor[i], buf);
+
+			if (n == 0)
+			{
+				if (!run.bytes.empty())
+					runs.push_back(run);
+				run.bytes.clear();
+				run.fold.clear();
+				continue;
+			}
+
+			const ucs4_t uc = factor[i];
+			for (size_t b = 0; b < n; ++b)
+			{
+				run.bytes.push_back(buf[b]);
+				run.fold.push_back(!case_sensitive && uc >= 'a' && uc <= 'z' && buf[b] == uc);
+			}
+		}
+	}
+}
+
+// finds a literal in the raw bytes of a file, so that most of the files
+// are rejected before decoding them
+class BytePrefilter
+{
+public:
+	BytePrefilter(): m_Anchor(0), m_AnchorCount(0) {}
+
+	// the longest byte run of the factors in enc
+	void Build(xm::Encoding* enc, const std::vector<ucs4string>& factors, bool case_sensitive);
+	void Build(const std::vector<wxByte>& hex);
+
+	bool Empty() const { return m_Bytes.empty(); }
+	size_t Length() const { return m_Bytes.size(); }
+
+	bool Found(const wxByte* data, size_t len) const;
+
+private:
+	void SetAnchor();
+
+	bool Match(const wxByte* data) const
+	{
+		for (size_t i = 0; i < m_Bytes.size(); ++i)
+		{
+			wxByte b = m_Fold[i] ? wxByte(data[i] | 0x20) : data[i];
+			if (b != m_Bytes[i])
+				return false;
+		}
+		return true;
+	}
+
+	std::vector<wxByte> m_Bytes;
+	std::vector<wxByte> m_Fold;     // 1 for the ASCII letters compared ignoring the case
+	size_t m_Anchor;                // the byte searched by memchr()
+	wxByte m_AnchorBytes[2];
+	size_t m_AnchorCount;
+};
+
+void BytePrefilter::Build(xm::Encoding* enc, const std::vector<ucs4string>& factors, bool case_sensitive)
+{
+	std::vector<ByteRun> runs;
+	ByteExactRuns(enc, factors, case_sensitive, runs);
+
+	m_Bytes.clear();
+	m_Fold.clear();
+	for (size_t i = 0; i < runs.size(); ++i)
+	{
+		if (runs[i].bytes.size() > m_Bytes.size())
+		{
+			m_Bytes = runs[i].bytes;
+			m_Fold = runs[i].fold;
+		}
+	}
+
+	SetAnchor();
+}
+
+void BytePrefilter::Build(const std::vector<wxByte>& hex)
+{
+	m_Bytes = hex;
+	m_Fold.assign(hex.size(), 0);
+	SetAnchor();
+}
+
+// prefer a byte not so common as the spaces, the zeros of UTF-16 or the letters
+// of both cases
+void BytePrefilter::SetAnchor()
+{
+	int rank = -1;
+	for (size_t i = 0; i < m_Bytes.size(); ++i)
+	{
+		wxByte b = m_Bytes[i];
+		int r = m_Fold[i] ? 1 : (b == 0x00 || b == 0x20 || b == 0x09) ? 0 : 2;
+		if (r >= rank)
+		{
+			rank = r;
+			m_Anchor = i;
+		}
+	}
+
+	m_AnchorCount = 0;
+	if (m_Bytes.empty())
+		return;
+
+	m_AnchorBytes[m_AnchorCount++] = m_Bytes[m_Anchor];
+	if (m_Fold[m_Anchor])
+		m_AnchorBytes[m_AnchorCount++] = wxByte(m_Bytes[m_Anchor] - 0x20);
+}
+
+bool BytePrefilter::Found(const wxByte* data, size_t len) const
+{
+	const size_t n = m_Bytes.size();
+	if (n == 0 || len < n)
+		return false;
+
+	// the anchor bytes of the candidates are in [first, last)
+	const wxByte* first = data + m_Anchor;
+	const wxByte* last = data + (len - n) + m_Anchor + 1;
+	for (size_t v = 0; v < m_AnchorCount; ++v)
+	{
+		for (const wxByte* p = first; p < last; ++p)
+		{
+			p = static_cast<const wxByte*>(memchr(p, m_AnchorBytes[v], size_t(last - p)));
+			if (p == nullptr)
+				break;
+			if (Match(p - m_Anchor))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+} // anonymous namespace
+
+// searches a file through a window of the decoded chars sliding over it:
+// a block is read and decoded, the matches beginning before the commit point
+// are listed, then the chars before the commit point are dropped except the
+// ones needed by the line texts of the later matches;
+// in replace mode the bytes between the matches are copied to the new file
+// from another handle of the file, so the window is not kept for them
+class FindInFilesWorker : public wxThread
+{
+public:
+	FindInFilesWorker(FindInFilesEngine* engine)
+		: wxThread(wxTHREAD_JOINABLE), m_Engine(engine)
+		, m_Window(max_linetext_len, max_window_chars, max_match_chars)
+	{}
+
+	virtual ExitCode Entry() override;
+
+	BufferSearcher m_Searcher;
+	ReplaceJournal m_Journal;
+
+private:
+	void SearchFile(const std::wstring& filename, FileMatches& result);
+	const BytePrefilter* GetPrefilter(xm::Encoding* enc);
+	// read the rest of the file after the first block, return true if the prefilter is found
+	bool PrefilterRest(wxFile& file, const BytePrefilter& prefilter);
+	// return false at the end of the file
+	bool ReadBlock(wxFile& file);
+	xm::Encoding* DetectFileEncoding(wxFile& file, bool& binary);
+	void Decode(xm::Encoding* enc, bool eof);
+	// return false if no more match is wanted; commit is moved back to the
+	// beginning of a match which may go on after the window
+	bool SearchWindow(size_t& commit, bool eof, bool binary, FileMatches& result);
+	void Slide(size_t commit);
+
+	void WalkTo(size_t idx);
+	void WalkToByte(wxFileOffset pos);
+	void AddMatch(FileMatches& result, size_t idx, wxFileOffset begpos, wxFileOffset endpos, bool binary);
+
+	// write the replacement of the match [begpos, endpos), and get the
+	// position of the replacement in the new file; text is null in hex
+	bool ReplaceMatch(wxFileOffset begpos, wxFileOffset endpos, const ucs4string* text,
+		wxFileOffset& newbeg, wxFileOffset& newend);
+	bool BeginReplace();
+	// copy the bytes of the file before to to the new file
+	bool CopySource(wxFileOffset to);
+	void EncodeText(const ucs4string& text);
+	// rename the new file over the file; damaged is set if the file is left
+	// partly written, see ReplaceFileWith()
+	bool FinishReplace(bool& damaged);
+	void AbortReplace();
+
+	FindInFilesEngine* m_Engine;
+	xm::SlidingWindow m_Window;
+
+	// the window
+	std::vector<wxByte> m_Data;     // the bytes read, m_Data[0] is the first byte of m_Chars[0]
+	size_t m_DecodedBytes;
+	std::vector<ucs4_t> m_Chars;
+	std::vector<ubyte> m_Lengths;   // the byte count of every char
+	wxFileOffset m_WinPos;          // the file offset of m_Chars[0]
+	size_t m_WinChar;               // the char index in the file of m_Chars[0]
+	size_t m_TextBeg;               // 1 to skip the BOM in the first window
+	wxFileOffset m_NextFrom;        // where the next search starts, a char index or
+	                                // a file offset in hex
+
+	// the char being walked to the matches
+	size_t m_WalkIdx;               // in the window
+	wxFileOffset m_WalkPos;
+	int m_WalkLine;
+	size_t m_WalkLineBeg;           // the char index in the file
+
+	// the text shown for the last match
+	int m_TextLine;
+	size_t m_TextEnd;               // the char index in the file
+
+	std::vector<size_t> m_BegIdx, m_EndIdx;
+
+	// replace mode
+	std::wstring m_FileName;
+	xm::Encoding* m_Encoding;
+	wxFileOffset m_OldSize;
+	time_t m_OldMTime;
+	BufferedFileWriter m_Output;    // the new file, created at the first match
+	wxFile m_Source;                // reads the bytes copied to the new file
+	wxFileOffset m_OutPos;          // the bytes before it are copied or replaced
+	wxFileOffset m_PosDelta;        // the offset in the new file - the one in the file
+	int m_LineDelta;
+	bool m_ReplaceFailed;
+	std::vector<ucs4string> m_Replacements; // of the matches in the window
+	std::string m_Encoded;
+	std::vector<char> m_CopyBuf;
+
+	BytePrefilter m_HexPrefilter;
+	std::vector<std::pair<xm::Encoding*, BytePrefilter> > m_Prefilters;
+	xm::CharsetDetector m_Detector;
+};
+
+wxThread::ExitCode FindInFilesWorker::Entry()
+{
+	m_Window.tail = max_linetext_len;
+	if (m_Searcher.InHex())
+	{
+		m_Window.tail = std::max(m_Window.tail, m_Engine->m_Hex.size());
+		m_HexPrefilter.Build(m_Engine->m_Hex);
+	}
+	else
+		m_Window.tail = std::max(m_Window.tail, m_Engine->m_Expr.size());
+	m_Window.regex = m_Searcher.IsRegex();
+	m_Window.dot_newline = m_Searcher.DotMatchesNewline();
+
+	std::wstring filename;
+	bool processed = false;
+	while (!TestDestroy() && m_Engine->NextFile(filename, processed))
+	{
+		processed = true;
+		FileMatches result;
+		SearchFile(filename, result);
+		if (!result.matches.empty())
+			m_Engine->AddResult(result);
+	}
+
+	m_Journal.Close();
+	m_Engine->WorkerDone();
+
+	return (ExitCode)0;
+}
+
+bool FindInFilesWorker::ReadBlock(wxFile& file)
+{
+	size_t size = m_Data.size();
+	m_Data.resize(size + read_block_size);
+	ssize_t len = file.Read(&m_Data[size], read_block_size);
+	if (len <= 0)
+	{
+		m_Data.resize(size);
+		return false;
+	}
+
+	m_Data.resize(size + size_t(len));
+	return size_t(len) == read_block_size;
+}
+
+xm::Encoding* FindInFilesWorker::DetectFileEncoding(wxFile& file, bool& binary)
+{
+	const FindInFilesOptions& opt = m_Engine->m_Options;
+	if (!opt.encoding.empty())
+	{
+		binary = (file.Length() >= m_Engine->m_Detection.maxtextsize);
+		return m_Engine->GetEncoding(opt.encoding);
+	}
+
+	return m_Engine->GetEncoding(m_Engine->m_Detection.Detect(&m_Data[0], m_Data.size(), file, binary, m_Detector));
+}
+
+// decode the bytes read, but leave the last bytes to the next block
+// in case that they are a part of a char
+void FindInFilesWorker::Decode(xm::Encoding* enc, bool eof)
+{
+	size_t limit = m_Data.size();
+	if (!eof)
+		limit -= std::min(limit, max_char_bytes);
+	if (m_DecodedBytes >= limit)
+		return;
+
+	BufferBytesMapper mapper(&m_Data[0], m_Data.size(), m_DecodedBytes);
+	xm::UCQueue ucqueue;
+	for (;;)
+	{
+		bool more = false;
+		if (mapper.Pos() < limit)
+		{
+			XM_PERF_COUNT(PERF_NEXT_UCHAR32);
+			more = enc->NextUChar32(ucqueue, mapper);
+		}
+		if (ucqueue.size() >= 1024 || (!more && !ucqueue.empty()))
+		{
+			for (size_t i = 0; i < ucqueue.size(); ++i)
+			{
+				m_Chars.push_back(ucqueue[i].ucs4());
+				m_Lengths.push_back(ubyte(ucqueue[i].nbytes()));
+			}
+			ucqueue.clear();
+		}
+		if (!more)
+			break;
+	}
+
+	m_DecodedBytes = mapper.Pos();
+}
+
+void FindInFilesWorker::WalkTo(size_t idx)
+{
+	const size_t count = m_Chars.size();
+	while (m_WalkIdx < idx)
+	{
+		m_WalkPos += m_Lengths[m_WalkIdx];
+		if (IsNewLine(&m_Chars[0], m_WalkIdx++, count))
+		{
+			++m_WalkLine;
+			m_WalkLineBeg = m_WinChar + m_WalkIdx;
+		}
+	}
+}
+
+void FindInFilesWorker::WalkToByte(wxFileOffset pos)
+{
+	const size_t count = m_Chars.size();
+	while (m_WalkIdx < count && m_WalkPos + m_Lengths[m_WalkIdx] <= pos)
+		WalkTo(m_WalkIdx + 1);
+}
+
+// the walker is at the char idx of the match
+void FindInFilesWorker::AddMatch(FileMatches& result, size_t idx, wxFileOffset begpos, wxFileOffset endpos, bool binary)
+{
+	result.matches.push_back(FileMatch(begpos, endpos));
+	if (binary)
+		return;
+
+	FileMatch& fm = result.matches.back();
+	fm.line = m_WalkLine + m_LineDelta;
+
+	// the text shown for the previous match contains this one
+	const size_t absidx = m_WinChar + idx;
+	if (m_WalkLine == m_TextLine && absidx < m_TextEnd)
+		return;
+
+	// the beginning of the line, or a snippet of a long line
+	size_t beg = m_WalkLineBeg - m_WinChar;
+	if (m_WalkLineBeg < m_WinChar || absidx - m_WalkLineBeg >= max_linetext_len)
+	{
+		beg = idx - std::min(idx, snippet_context);
+		fm.linetext.assign(3, ucs4_t('.'));
+	}
+
+	// the text after the replacements in replace mode
+	size_t k = 0;
+	while (k < m_Replacements.size() && m_TextBeg + m_BegIdx[k] < beg)
+		++k;
+
+	size_t i = beg, len = 0;
+	bool eol = false;
+	while (!eol && i < m_Chars.size() && len < max_linetext_len)
+	{
+		if (k < m_Replacements.size() && m_TextBeg + m_BegIdx[k] == i)
+		{
+			const ucs4string& text = m_Replacements[k];
+			for (size_t c = 0; c < text.size() && len < max_linetext_len; ++c, ++len)
+			{
+				if (text[c] == 0x0D || text[c] == 0x0A)
+				{
+					eol = true;
+					break;
+				}
+				fm.linetext.push_back(text[c]);
+			}
+			i = m_TextBeg + m_EndIdx[k++];
+			continue;
+		}
+
+		if (m_Chars[i] == 0x0D || m_Chars[i] == 0x0A)
+			break;
+		fm.linetext.push_back(m_Chars[i]);
+		++i;
+		++len;
+	}
+
+	m_TextLine = m_WalkLine;
+	m_TextEnd = m_WinChar + i;
+}
+
+bool FindInFilesWorker::SearchWindow(size_t& commit, bool eof, bool binary, FileMatches& result)
+{
+	const bool first_only = m_Engine->m_Options.first_only;
+	const bool replacing = m_Engine->m_Options.replace;
+	m_BegIdx.clear();
+	m_EndIdx.clear();
+	m_Replacements.clear();
+
+	if (m_Searcher.InHex())
+	{
+		wxFileOffset commitpos = m_WinPos;
+		for (size_t i = 0; i < commit; ++i)
+			commitpos += m_Lengths[i];
+		if (eof)
+			commitpos = m_WinPos + wxFileOffset(m_Data.size());
+
+		size_t from = size_t(std::max(m_NextFrom, m_WinPos) - m_WinPos);
+		if (from < m_Data.size())
+			m_Searcher.FindAll(&m_Data[from], &m_Data[0] + m_Data.size(), first_only, m_BegIdx, m_EndIdx);
+
+		for (size_t m = 0; m < m_BegIdx.size(); ++m)
+		{
+			wxFileOffset begpos = m_WinPos + wxFileOffset(from + m_BegIdx[m]);
+			wxFileOffset endpos = m_WinPos + wxFileOffset(from + m_EndIdx[m]);
+			if (begpos >= commitpos)
+				break;
+
+			WalkToByte(begpos);
+			wxFileOffset newbeg = begpos, newend = endpos;
+			if (replacing && !ReplaceMatch(begpos, endpos, nullptr, newbeg, newend))
+				return false;
+			AddMatch(result, m_WalkIdx, newbeg, newend, binary);
+			m_NextFrom = endpos;
+		}
+		m_NextFrom = std::max(m_NextFrom, commitpos);
+	}
+	else if (m_Chars.size() > m_TextBeg)
+	{
+		const ucs4_t* begin = &m_Chars[m_TextBeg];
+		size_t from = std::max(size_t(m_NextFrom), m_WinChar + m_TextBeg) - m_WinChar - m_TextBeg;
+		size_t partial = m_Chars.size() - m_TextBeg;
+		const bool growing = m_Window.Growing(m_Chars.size(), eof);
+		if (m_Searcher.FindAll(begin, &m_Chars[0] + m_Chars.size(), from, first_only, m_BegIdx, m_EndIdx,
+				growing ? &partial : nullptr) < 0)
+			return false;
+		if (growing)
+			commit = std::min(commit, m_TextBeg + partial);
+
+		// the replacements of the later matches in the window are in the line texts too
+		if (replacing)
+		{
+			m_Replacements.resize(m_BegIdx.size());
+			for (size_t m = 0; m < m_BegIdx.size(); ++m)
+			{
+				if (!m_Searcher.Replace(begin + m_BegIdx[m], begin + m_EndIdx[m], m_Replacements[m]))
+					return false;
+			}
+		}
+
+		for (size_t m = 0; m < m_BegIdx.size(); ++m)
+		{
+			size_t begidx = m_TextBeg + m_BegIdx[m];
+			size_t endidx = m_TextBeg + m_EndIdx[m];
+			if (begidx >= commit)
+				break;
+
+			// searched again from its beginning after the next block is decoded
+			if (m_Window.Unfinished(endidx, m_Chars.size(), eof))
+			{
+				commit = begidx;
+				break;
+			}
+
+			WalkTo(begidx);
+			wxFileOffset endpos = m_WalkPos;
+			for (size_t i = begidx; i < endidx; ++i)
+				endpos += m_Lengths[i];
+
+			wxFileOffset newbeg = m_WalkPos, newend = endpos;
+			if (replacing && !ReplaceMatch(m_WalkPos, endpos, &m_Replacements[m], newbeg, newend))
+				return false;
+			AddMatch(result, begidx, newbeg, newend, binary);
+			if (replacing)
+			{
+				const ucs4string& text = m_Replacements[m];
+				m_LineDelta += CountNewLines(text.data(), text.size()) - CountNewLines(&m_Chars[0] + begidx, endidx - begidx);
+			}
+			m_NextFrom = wxFileOffset(m_WinChar + endidx);
+		}
+		m_NextFrom = std::max(m_NextFrom, wxFileOffset(m_WinChar + commit));
+	}
+
+	return !(first_only && !result.matches.empty());
+}
+
+// drop the chars before the commit point, but keep the beginning of the
+// line for the later matches near it
+void FindInFilesWorker::Slide(size_t commit)
+{
+	WalkTo(commit);
+
+	size_t keep = m_WinChar + commit - std::min(m_WinChar + commit, max_linetext_len);
+	keep = std::max(std::max(keep, m_WalkLineBeg), m_WinChar) - m_WinChar;
+	if (keep == 0)
+		return;
+
+	size_t keepbytes = 0;
+	for (size_t i = 0; i < keep; ++i)
+		keepbytes += m_Lengths[i];
+
+	m_Data.erase(m_Data.begin(), m_Data.begin() + keepbytes);
+	m_Chars.erase(m_Chars.begin(), m_Chars.begin() + keep);
+	m_Lengths.erase(m_Lengths.begin(), m_Lengths.begin() + keep);
+	m_DecodedBytes -= keepbytes;
+	m_WinPos += keepbytes;
+	m_WinChar += keep;
+	m_WalkIdx -= keep;
+	m_TextBeg = 0;
+}
+
+const BytePrefilter* FindInFilesWorker::GetPrefilter(xm::Encoding* enc)
+{
+	if (m_Searcher.InHex())
+		return m_HexPrefilter.Empty() ? nullptr : &m_HexPrefilter;
+
+	size_t i = 0;
+	while (i < m_Prefilters.size() && m_Prefilters[i].first != enc)
+		++i;
+
+	if (i == m_Prefilters.size())
+	{
+		m_Prefilters.push_back(std::make_pair(enc, BytePrefilter()));
+
+		// UCS4toMultiByte() of some encodings fills the tables by ICU
+		wxMutexLocker lock(m_Engine->EncodingLock());
+		m_Prefilters[i].second.Build(enc, m_Engine->m_Factors, m_Engine->m_Options.case_sensitive);
+	}
+
+	return m_Prefilters[i].second.Empty() ? nullptr : &m_Prefilters[i].second;
+}
+
+bool FindInFilesWorker::PrefilterRest(wxFile& file, const BytePrefilter& prefilter)
+{
+	// keep the bytes of a partial hit at the end of the block
+	const size_t keep = prefilter.Length() - 1;
+	for (;;)
+	{
+		m_Data.erase(m_Data.begin(), m_Data.end() - std::min(keep, m_Data.size()));
+
+		bool more = ReadBlock(file);
+		if (!m_Data.empty() && prefilter.Found(&m_Data[0], m_Data.size()))
+			return true;
+		if (!more)
+			return false;
+	}
+}
+
+void FindInFilesWorker::SearchFile(const std::wstring& filename, FileMatches& result)
+{
+	result.filename = filename;
+
+	const bool replacing = m_Engine->m_Options.replace;
+	if (replacing)
+	{
+		if (IsSymLink(filename))
+		{
+			m_Engine->SkipFile(filename);
+			return;
+		}
+		if (!GetFileStatus(filename, m_OldSize, m_OldMTime))
+			return;
+	}
+
+	wxLogNull nolog;
+	wxFile file;
+	if (!file.Open(wxString(filename.c_str()), wxFile::read))
+		return;
+
+	m_Data.clear();
+	m_Chars.clear();
+	m_Lengths.clear();
+	m_DecodedBytes = 0;
+	m_WinPos = 0;
+	m_WinChar = 0;
+	m_TextBeg = 0;
+	m_NextFrom = 0;
+	m_WalkIdx = 0;
+	m_WalkPos = 0;
+	m_WalkLine = 0;
+	m_WalkLineBeg = 0;
+	m_TextLine = -1;
+	m_TextEnd = 0;
+	m_FileName = filename;
+	m_OutPos = 0;
+	m_PosDelta = 0;
+	m_LineDelta = 0;
+	m_ReplaceFailed = false;
+
+	bool eof = !ReadBlock(file);
+	if (m_Data.empty())
+		return;
+
+	bool binary = false;
+	xm::Encoding* enc = DetectFileEncoding(file, binary);
+	m_Encoding = enc;
+
+	// most of the files have no match and are rejected here without decoding
+	const BytePrefilter* prefilter = GetPrefilter(enc);
+	if (prefilter != nullptr && !prefilter->Found(&m_Data[0], m_Data.size()))
+	{
+		if (eof || !PrefilterRest(file, *prefilter))
+			return;
+
+		file.Seek(0);
+		m_Data.clear();
+		eof = !ReadBlock(file);
+	}
+
+	for (;;)
+	{
+		Decode(enc, eof);
+
+		// ignore the BOM like MadLines::Reformat()
+		if (m_WinChar == 0 && m_WalkIdx == 0 && !m_Chars.empty() && m_Chars[0] == 0xFEFF
+			&& enc->IsUnicodeEncoding())
+		{
+			m_TextBeg = 1;
+			m_WalkLineBeg = 1;
+		}
+
+		size_t commit = m_Window.CommitPoint(m_Chars.empty() ? nullptr : &m_Chars[0], m_Chars.size(), eof);
+		if (commit > 0)
+		{
+			if (!SearchWindow(commit, eof, binary, result))
+			{
+				// all the matches are wanted in replace mode
+				m_ReplaceFailed = replacing;
+				break;
+			}
+			Slide(commit);
+		}
+
+		if (eof || m_Engine->IsCancelled())
+			break;
+
+		eof = !ReadBlock(file);
+	}
+
+	file.Close();
+	if (m_Output.IsOpened() || m_ReplaceFailed)
+	{
+		// the file is not replaced if cancelled in the middle
+		const bool complete = eof && !m_ReplaceFailed;
+		bool replaced = false;
+		bool damaged = false;
+		if (complete)
+			replaced = FinishReplace(damaged);
+		else
+			AbortReplace();
+
+		if (!replaced)
+		{
+			result.matches.clear();
+			if (damaged)
+				m_Engine->DamageFile(filename);
+			else if (complete || m_ReplaceFailed)
+				m_Engine->FailFile(filename);
+		}
+	}
+
+	m_Data.clear();
+	m_Chars.clear();
+	m_Lengths.clear();
+}
+
+bool FindInFilesWorker::ReplaceMatch(wxFileOffset begpos, wxFileOffset endpos, const ucs4string* text,
+	wxFileOffset& newbeg, wxFileOffset& newend)
+{
+	if (!m_Output.IsOpened() && !BeginReplace())
+		return false;
+	if (!CopySource(begpos))
+		return false;
+
+	if (text == nullptr)
+		m_Encoded.assign(m_Engine->m_FmtHex.begin(), m_Engine->m_FmtHex.end());
+	else
+		EncodeText(*text);
+
+	const size_t oldlen = size_t(endpos - begpos);
+	newbeg = begpos + m_PosDelta;
+	newend = newbeg + wxFileOffset(m_Encoded.size());
+	m_Journal.AddEdit(newbeg, m_Encoded.size(), &m_Data[0] + size_t(begpos - m_WinPos), oldlen);
+	m_Output.Write(m_Encoded);
+
+	// skip the bytes replaced
+	if (m_Source.Seek(endpos) == wxInvalidOffset)
+		return false;
+	m_OutPos = endpos;
+	m_PosDelta += wxFileOffset(m_Encoded.size()) - wxFileOffset(oldlen);
+	return true;
+}
+
+bool FindInFilesWorker::BeginReplace()
+{
+	const wxString filename(m_FileName.c_str());
+	const wxString newfile = ReplacingFileName(filename);
+	if (!wxFile::Access(filename, wxFile::write) || wxFileExists(newfile))
+		return false;
+
+	if (!m_Source.Open(filename, wxFile::read) || !m_Output.Open(newfile))
+	{
+		m_Source.Close();
+		return false;
+	}
+
+	m_Journal.BeginFile(m_FileName);
+	return true;
+}
+
+bool FindInFilesWorker::CopySource(wxFileOffset to)
+{
+	m_CopyBuf.resize(read_block_size);
+	while (m_OutPos < to)
+	{
+		size_t n = size_t(std::min(to - m_OutPos, wxFileOffset(read_block_size)));
+		if (m_Source.Read(&m_CopyBuf[0], n) != ssize_t(n))
+			return false;
+		m_Output.Write(&m_CopyBuf[0], n);
+		m_OutPos += wxFileOffset(n);
+	}
+	return true;
+}
+
+void FindInFilesWorker::EncodeText(const ucs4string& text)
+{
+	m_Encoded.clear();
+
+	// UCS4toMultiByte() of some encodings fills the tables by ICU
+	wxMutexLocker lock(m_Engine->EncodingLock());
+	ubyte buf[16];
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		size_t n = m_Encoding->UCS4toMultiByte(text[i], buf);
+		if (n > 0)
+		{
+			m_Encoded.append(reinterpret_cast<const char*>(buf), n);
+			continue;
+		}
+
+		const std::string uescape = UEscape(text[i]);
+		for (size_t c = 0; c < uescape.size(); ++c)
+		{
+			n = m_Encoding->UCS4toMultiByte(ucs4_t(uescape[c]), buf);
+			m_Encoded.append(reinterpret_cast<const char*>(buf), n);
+		}
+	}
+}
+
+bool FindInFilesWorker::FinishReplace(bool& damaged)
+{
+	damaged = false;
+
+	// the rest of the file
+	m_CopyBuf.resize(read_block_size);
+	ssize_t n;
+	while ((n = m_Source.Read(&m_CopyBuf[0], read_block_size)) > 0)
+		m_Output.Write(&m_CopyBuf[0], size_t(n));
+	m_Source.Close();
+
+	const wxString newfile = m_Output.GetName();
+	const bool written = (n == 0) && m_Output.Close();
+
+	// the file must not be changed while replacing, and the journal is
+	// written before the file is renamed
+	wxFileOffset size, newsize;
+	time_t mtime, newmtime;
+	if (!written || !GetFileStatus(m_FileName, size, mtime) || size != m_OldSize || mtime != m_OldMTime
+		|| !GetFileStatus(std::wstring(newfile.wc_str()), newsize, newmtime)
+		|| !m_Journal.CommitFile(newsize, newmtime))
+	{
+		m_Output.Discard();
+		wxRemoveFile(newfile);
+		m_Journal.AbortFile();
+		return false;
+	}
+
+	// a damaged file keeps the new file, its backup and the record in the journal
+	if (!ReplaceFileWith(wxString(m_FileName.c_str()), newfile, damaged))
+	{
+		if (damaged)
+			return false;
+		wxRemoveFile(newfile);
+		m_Journal.AbortFile();
+		return false;
+	}
+
+	return true;
+}
+
+void FindInFilesWorker::AbortReplace()
+{
+	m_Source.Close();
+	if (!m_Output.IsOpened())
+		return;
+
+	m_Output.Discard();
+	m_Journal.AbortFile();
+}
+
+//==================================================
+
+void FileEncodingSettings::Read()
+{
+	wxConfigBase* cfg = wxConfigBase::Get(false);
+	long maxsize = 10*1000*1000;
+	wxString oldpath = cfg->GetPath();
+	cfg->Read(wxT("/wxMEdit/MaxTextFileSize"), &maxsize, maxsize);
+	cfg->SetPath(oldpath);
+	maxtextsize = maxsize;
+
+	defenc = xm::EncodingManager::Instance().NameToEncoding(GetDefaultOrForceEncoding(cfg).wc_str());
+}
+
+std::wstring FileEncodingSettings::Key() const
+{
+	// the last field is bumped when Detect() changes
+	return xm::EncodingManager::Instance().EncodingToName(defenc) + L'|'
+		+ std::wstring(wxLongLong(maxtextsize).ToString().wc_str()) + L"|2";
+}
+
+std::wstring FileEncodingSettings::Detect(const wxByte* buf, size_t len, wxFile& file, bool& binary,
+	xm::CharsetDetector& detector) const
+{
+	const wxFileOffset filesize = file.Length();
+	binary = (filesize >= maxtextsize);
+
+	// detect by the samples of the rest if the head is plain ASCII, the bytes
+	// read already are used before reading the file
+	xm::ByteStats stats;
+	stats.Scan(buf, std::min(len, max_detecting_size));
+
+	std::vector<wxByte> samples;
+	if (!binary && filesize > wxFileOffset(max_detecting_size) && len >= max_detecting_size
+		&& stats.IsASCII())
+	{
+		const size_t buflen = len;
+		xm::ReadDetectingSamples(samples, [buf, buflen, &file](uint64_t pos, ubyte* b, size_t count) -> size_t
+			{
+				if (pos + count <= buflen)
+				{
+					memcpy(b, buf + size_t(pos), count);
+					return count;
+				}
+
+				wxFileOffset old = file.Tell();
+				ssize_t got = (file.Seek(wxFileOffset(pos)) == wxInvalidOffset)? -1: file.Read(b, count);
+				file.Seek(old);
+				return (got > 0)? size_t(got): 0;
+			}, uint64_t(filesize), max_detecting_size);
+	}
+
+	if (!samples.empty())
+	{
+		buf = &samples[0];
+		len = samples.size();
+
+		stats = xm::ByteStats();
+		stats.Scan(buf, len);
+	}
+	else
+	{
+		len = std::min(len, max_detecting_size);
+	}
+
+	std::string enc;
+	if (!binary && xm::MatchEncoding(enc, buf, len))
+		return std::wstring(enc.begin(), enc.end());
+
+	if (!binary)
+		binary = stats.IsBinary();
+
+	xm::EncodingID encid = defenc;
+	xm::DetectEncoding(buf, len, encid, filesize < maxtextsize, detector);
+	return xm::EncodingManager::Instance().EncodingToName(encid);
+}
+
+//==================================================
+
+FindInFilesEngine::FindInFilesEngine()
+	: m_Cond(m_Lock)
+	, m_NextFile(0), m_Processed(0), m_Running(0), m_Cancelled(false)
+{
+}
+
+FindInFilesEngine::~FindInFilesEngine()
+{
+	Stop();
+}
+
+bool FindInFilesEngine::Start(const std::vector<wxString>& files, const FindInFilesOptions& opt, size_t threads)
+{
+	m_Options = opt;
+	m_Error.Clear();
+
+	// read on the main thread, the workers never touch the global
+	extern bool g_regex_dot_match_newline;
+	const bool dot_newline = g_regex_dot_match_newline;
+
+	if (opt.inhex)
+	{
+		if (!StringToHex(opt.expr, m_Hex, false))
+		{
+			m_Error = wxString(_("The input string is not a valid Hex-String:")) + wxT("\n\n") + opt.expr;
+			return false;
+		}
+	}
+	else
+	{
+		// in normal case like TextSearcher::Search()
+		m_Expr = WxStrToUCS4(opt.case_sensitive? opt.expr: WxStrToNormalCase(opt.expr));
+
+		BufferSearcher checker;
+		if (!checker.PrepareText(m_Expr, opt.use_regex, opt.case_sensitive, opt.whole_word, dot_newline))
+		{
+			m_Error = wxString::Format(_("'%s' is not a valid regular expression."), opt.expr.c_str());
+			return false;
+		}
+		checker.LiteralFactors(m_Factors);
+	}
+
+	wxString journaldir;
+	if (opt.replace)
+	{
+		// MadEdit replaces all the matches
+		m_Options.first_only = false;
+
+		if (opt.inhex)
+		{
+			if (!StringToHex(opt.fmt, m_FmtHex, false))
+			{
+				m_Error = wxString(_("The input string is not a valid Hex-String:")) + wxT("\n\n") + opt.fmt;
+				return false;
+			}
+		}
+		else
+		{
+			m_Fmt = WxStrToUCS4(opt.fmt);
+
+			BufferSearcher checker;
+			checker.PrepareText(m_Expr, opt.use_regex, opt.case_sensitive, opt.whole_word, dot_newline);
+			if (!checker.PrepareFormat(m_Fmt))
+			{
+				m_Error = wxString::Format(_("The format of '%s' is invalid."), opt.fmt.c_str());
+				return false;
+			}
+		}
+
+		journaldir = ReplaceJournal::Reset();
+		if (journaldir.IsEmpty())
+		{
+			m_Error = _("Cannot create the journal of Replace in Files.");
+			return false;
+		}
+	}
+
+	// read the settings and create the encodings on the main thread
+	m_Detection.Read();
+	if (m_Options.encoding.empty() && UseForceSystemEncoding(wxConfigBase::Get(false)))
+		m_Options.encoding = xm::EncodingManager::Instance().GetSystemEncoding()->GetName();
+
+	m_Files.clear();
+	m_Files.reserve(files.size());
+	for (size_t i = 0; i < files.size(); ++i)
+		m_Files.push_back(files[i].wc_str());
+
+	if (opt.index != nullptr)
+		NarrowFiles(*opt.index);
+
+	m_NextFile = 0;
+	m_Processed = 0;
+	m_Cancelled = false;
+	m_Results.clear();
+	m_Skipped.clear();
+	m_SkippedFiles.clear();
+	m_Failed.clear();
+	m_FailedFiles.clear();
+	m_Damaged.clear();
+	m_DamagedFiles.clear();
+
+	if (threads == 0)
+	{
+		int cpus = wxThread::GetCPUCount();
+		threads = (cpus > 0)? size_t(cpus): 1;
+	}
+	threads = std::max<size_t>(1, std::min(threads, m_Files.size()));
+
+	for (size_t i = 0; i < threads; ++i)
+	{
+		std::unique_ptr<FindInFilesWorker> worker(new FindInFilesWorker(this));
+		if (opt.inhex)
+			worker->m_Searcher.PrepareHex(m_Hex);
+		else
+			worker->m_Searcher.PrepareText(m_Expr, opt.use_regex, opt.case_sensitive, opt.whole_word, dot_newline);
+
+		if (opt.replace)
+		{
+			worker->m_Searcher.PrepareFormat(m_Fmt);
+			if (!worker->m_Journal.Open(journaldir + wxString::Format(wxT("%u.rep"), unsigned(i))))
+				break;
+		}
+
+		if (worker->Create() != wxTHREAD_NO_ERROR)
+			break;
+
+		m_Workers.push_back(worker.release());
+	}
+
+	// leave all the files to MadEdit if no thread can be created
+	if (m_Workers.empty())
+		m_Skipped = m_Files;
+
+	m_Running = m_Workers.size();
+	for (size_t i = 0; i < m_Workers.size(); ++i)
+		m_Workers[i]->Run();
+
+	return true;
+}
+
+bool FindInFilesEngine::WaitResults(std::vector<FileMatches>& batch, unsigned long timeout)
+{
+	{
+		wxMutexLocker lock(m_Lock);
+		if (m_Results.empty() && m_Running > 0)
+			m_Cond.WaitTimeout(timeout);
+
+		for (size_t i = 0; i < m_Results.size(); ++i)
+			batch.push_back(m_Results[i]);
+		m_Results.clear();
+
+		if (m_Running > 0 || !batch.empty())
+			return true;
+	}
+
+	JoinWorkers();
+	return false;
+}
+
+void FindInFilesEngine::Stop()
+{
+	{
+		wxMutexLocker lock(m_Lock);
+		m_Cancelled = true;
+	}
+
+	JoinWorkers();
+}
+
+// drop the files indexed and not changed since then, which do not contain all
+// the trigrams of the factors; the other files are searched as usual
+void FindInFilesEngine::NarrowFiles(TrigramIndex& index)
+{
+	// the encodings in the index are detected with other settings
+	const bool detecting = m_Options.encoding.empty() && !m_Options.inhex;
+	if (detecting && index.Key() != m_Detection.Key())
+		return;
+
+	// the sorted ids of the files which may match in every encoding,
+	// or no id if all the files may match
+	typedef std::map<std::wstring, std::pair<bool, std::vector<uint32_t> > > CandidateMap;
+	CandidateMap candidates;
+
+	std::vector<std::wstring> files;
+	for (size_t i = 0; i < m_Files.size(); ++i)
+	{
+		int id = index.FindFile(m_Files[i]);
+		if (id < 0)
+		{
+			files.push_back(m_Files[i]);
+			continue;
+		}
+
+		std::wstring encname = m_Options.inhex ? std::wstring() :
+			detecting ? index.GetFile(id).encoding : m_Options.encoding;
+		CandidateMap::iterator it = candidates.find(encname);
+		if (it == candidates.end())
+		{
+			it = candidates.insert(std::make_pair(encname, std::make_pair(true, std::vector<uint32_t>()))).first;
+
+			std::vector<Trigram> trigrams;
+			FactorTrigrams(m_Options.inhex ? nullptr : GetEncoding(encname), trigrams);
+			if (!trigrams.empty() && index.Lookup(trigrams, it->second.second))
+				it->second.first = false;
+		}
+
+		const std::vector<uint32_t>& ids = it->second.second;
+		if (it->second.first || std::binary_search(ids.begin(), ids.end(), uint32_t(id)))
+			files.push_back(m_Files[i]);
+	}
+
+	m_Files.swap(files);
+}
+
+void FindInFilesEngine::FactorTrigrams(xm::Encoding* enc, std::vector<Trigram>& trigrams)
+{
+	std::vector<ByteRun> runs;
+	if (m_Options.inhex)
+	{
+		runs.push_back(ByteRun());
+		runs.back().bytes = m_Hex;
+	}
+	else
+	{
+		// UCS4toMultiByte() of some encodings fills the tables by ICU
+		wxMutexLocker lock(m_EncodingLock);
+		ByteExactRuns(enc, m_Factors, m_Options.case_sensitive, runs);
+	}
+
+	for (size_t r = 0; r < runs.size(); ++r)
+	{
+		const std::vector<wxByte>& bytes = runs[r].bytes;
+		for (size_t i = 2; i < bytes.size(); ++i)
+			trigrams.push_back(MakeTrigram(bytes[i - 2], bytes[i - 1], bytes[i]));
+	}
+}
+
+void FindInFilesEngine::JoinWorkers()
+{
+	for (size_t i = 0; i < m_Workers.size(); ++i)
+	{
+		m_Workers[i]->Wait();
+		delete m_Workers[i];
+	}
+	m_Workers.clear();
+
+	wxMutexLocker lock(m_Lock);
+	for (size_t i = 0; i < m_Skipped.size(); ++i)
+		m_SkippedFiles.push_back(wxString(m_Skipped[i].c_str()));
+	m_Skipped.clear();
+	for (size_t i = 0; i < m_Failed.size(); ++i)
+		m_FailedFiles.push_back(wxString(m_Failed[i].c_str()));
+	m_Failed.clear();
+	for (size_t i = 0; i < m_Damaged.size(); ++i)
+		m_DamagedFiles.push_back(wxString(m_Damaged[i].c_str()));
+	m_Damaged.clear();
+}
+
+size_t FindInFilesEngine::GetProcessedCount()
+{
+	wxMutexLocker lock(m_Lock);
+	return m_Processed;
+}
+
+wxString FindInFilesEngine::GetCurrentFile()
+{
+	wxMutexLocker lock(m_Lock);
+	return wxString(m_CurrentFile.c_str());
+}
+
+bool FindInFilesEngine::NextFile(std::wstring& filename, bool processed)
+{
+	wxMutexLocker lock(m_Lock);
+	if (processed)
+		++m_Processed;
+
+	if (m_Cancelled || m_NextFile >= m_Files.size())
+		return false;
+
+	filename = m_Files[m_NextFile++];
+	m_CurrentFile = filename;
+	return true;
+}
+
+void FindInFilesEngine::AddResult(FileMatches& result)
+{
+	wxMutexLocker lock(m_Lock);
+	m_Results.push_back(FileMatches());
+	m_Results.back().filename.swap(result.filename);
+	m_Results.back().matches.swap(result.matches);
+
+	if (m_Results.size() >= results_batch_size)
+		m_Cond.Signal();
+}
+
+bool FindInFilesEngine::IsCancelled()
+{
+	wxMutexLocker lock(m_Lock);
+	return m_Cancelled;
+}
+
+void FindInFilesEngine::WorkerDone()
+{
+	wxMutexLocker lock(m_Lock);
+	if (--m_Running == 0)
+		m_Cond.Signal();
+}
+
+void FindInFilesEngine::SkipFile(const std::wstring& filename)
+{
+	wxMutexLocker lock(m_Lock);
+	m_Skipped.push_back(filename);
+}
+
+void FindInFilesEngine::FailFile(const std::wstring& filename)
+{
+	wxMutexLocker lock(m_Lock);
+	m_Failed.push_back(filename);
+}
+
+void FindInFilesEngine::DamageFile(const std::wstring& filename)
+{
+	wxMutexLocker lock(m_Lock);
+	m_Damaged.push_back(filename);
+}
+
+xm::Encoding* FindInFilesEngine::GetEncoding(const std::wstring& name)
+{
+	wxMutexLocker lock(m_EncodingLock);
+	xm::Encoding* enc = xm::EncodingManager::Instance().GetEncoding(name);
+
+	// fill the tables before decoding concurrently, so that the workers share
+	// the encodings without locking nor calling ICU
+	if (std::find(m_PreparedEncodings.begin(), m_PreparedEncodings.end(), enc) == m_PreparedEncodings.end())
+	{
+		enc->FillDecodingTables();
+		m_PreparedEncodings.push_back(enc);
+	}
+
+	return enc;
+}
+
+} //namespace wxm
@@ -0,0 +1,201 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/find_in_files.h
+// Description: Parallel Find in Files Engine of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_FIND_IN_FILES_H_
+#define _WXM_FIND_IN_FILES_H_
+
+#include "../xm/cxx11.h"
+#include "def.h"
+#include "trigram_index.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/string.h>
+#include <wx/filefn.h>
+#include <wx/file.h>
+#include <wx/thread.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <vector>
+#include <string>
+
+namespace xm
+{
+	struct Encoding;
+	class CharsetDetector;
+}
+
+namespace wxm
+{
+
+// a matched range of a file, the positions are the byte offsets like those of MadEdit
+struct FileMatch
+{
+	wxFileOffset begpos, endpos;
+	int line;               // -1 if the file is binary data
+	ucs4string linetext;    // the beginning of the line without the newline, or a
+	                        // snippet beginning with "..." around a match far from
+	                        // the beginning of a long line; empty if the text of
+	                        // the previous match contains this one
+
+	FileMatch(wxFileOffset b, wxFileOffset e): begpos(b), endpos(e), line(-1) {}
+};
+
+// the matches of a file, the strings are not wxString, because the wxString
+// of wxWidgets 2.8 is not safe to be passed between the threads
+struct FileMatches
+{
+	std::wstring filename;
+	std::vector<FileMatch> matches;
+};
+
+struct FindInFilesOptions
+{
+	wxString expr;
+	bool inhex;
+	bool use_regex;
+	bool case_sensitive;
+	bool whole_word;
+	bool first_only;
+	std::wstring encoding;  // empty for detecting the encoding of every file
+	TrigramIndex* index;    // drops the indexed files which cannot match if not null
+	bool replace;           // replace all the matches with fmt
+	wxString fmt;
+
+	FindInFilesOptions(): inhex(false), use_regex(false), case_sensitive(true)
+		, whole_word(false), first_only(false), index(nullptr), replace(false)
+	{}
+};
+
+class FindInFilesWorker;
+
+// the settings to detect the encodings of the files, read on the main thread
+struct FileEncodingSettings
+{
+	xm::EncodingID defenc;
+	wxFileOffset maxtextsize;
+
+	FileEncodingSettings(): defenc(xm::ENC_DEFAULT), maxtextsize(0) {}
+
+	void Read();
+	// the settings the encodings stored in a trigram index are detected with
+	std::wstring Key() const;
+
+	// the name of the encoding detected by the first bytes of a file read into buf, the
+	// same steps as MadLines::LoadFromFile() with the default syntax; the samples of
+	// the rest are read from file if needed; safe on the worker threads
+	std::wstring Detect(const wxByte* buf, size_t len, wxFile& file, bool& binary,
+		xm::CharsetDetector& detector) const;
+};
+
+// search the files on a pool of worker threads without loading them to MadEdit,
+// the files are streamed by blocks and never laid out or highlighted;
+// the main thread takes the matches by batches as they are found:
+//     if (engine.Start(files, opt))
+//         while (engine.WaitResults(batch, 100)) { ... }
+// in replace mode a file is written to a new file beside it while searched,
+// which is renamed over it at the end, and the edits are recorded in the
+// ReplaceJournal; the positions of the matches are those in the new file
+class FindInFilesEngine
+{
+public:
+	FindInFilesEngine();
+	~FindInFilesEngine();
+
+	// return false if opt.expr is not a valid regular expression or hex string,
+	// or opt.fmt is not a valid format, or the journal cannot be created, and
+	// GetError() tells why; threads is the count of the workers, 0 for the count
+	// of the CPUs
+	bool Start(const std::vector<wxString>& files, const FindInFilesOptions& opt, size_t threads = 0);
+
+	// wait at most timeout milliseconds for the matches, and append them to batch;
+	// return false when all the files are processed and all the matches are taken
+	bool WaitResults(std::vector<FileMatches>& batch, unsigned long timeout);
+
+	// cancel the searching and wait for the workers
+	void Stop();
+
+	// the count of the files to search, without the ones dropped by the index
+	size_t GetFileCount() const { return m_Files.size(); }
+	size_t GetProcessedCount();
+	wxString GetCurrentFile();
+
+	// the files left to be searched by MadEdit if no worker can be created,
+	// or the symbolic links to be replaced through by MadEdit
+	const std::vector<wxString>& GetSkippedFiles() const { return m_SkippedFiles; }
+
+	// the message of the error stopping Start()
+	const wxString& GetError() const { return m_Error; }
+
+	// the files which cannot be replaced, or changed while replacing
+	const std::vector<wxString>& GetFailedFiles() const { return m_FailedFiles; }
+	// the files left partly written, their old bytes are kept in BackupFileName()
+	// and the new ones in ReplacingFileName()
+	const std::vector<wxString>& GetDamagedFiles() const { return m_DamagedFiles; }
+
+private:
+	friend class FindInFilesWorker;
+
+	// called by the workers
+	// processed: the worker has finished a file
+	bool NextFile(std::wstring& filename, bool processed);
+	void AddResult(FileMatches& result);
+	bool IsCancelled();
+	void WorkerDone();
+	void SkipFile(const std::wstring& filename);
+	void FailFile(const std::wstring& filename);
+	void DamageFile(const std::wstring& filename);
+	xm::Encoding* GetEncoding(const std::wstring& name);
+	// the encodings filling the tables by ICU when encoding must not be used concurrently
+	wxMutex& EncodingLock() { return m_EncodingLock; }
+
+	void JoinWorkers();
+	void NarrowFiles(TrigramIndex& index);
+	// the trigrams every matched file contains in enc
+	void FactorTrigrams(xm::Encoding* enc, std::vector<Trigram>& trigrams);
+
+	FindInFilesOptions m_Options;
+	wxString m_Error;
+	ucs4string m_Expr;
+	std::vector<ucs4string> m_Factors;  // the strings every match contains
+	std::vector<wxByte> m_Hex;
+	ucs4string m_Fmt;
+	std::vector<wxByte> m_FmtHex;
+	FileEncodingSettings m_Detection;
+
+	std::vector<std::wstring> m_Files;
+	std::vector<FindInFilesWorker*> m_Workers;
+
+	wxMutex m_Lock;         // guards the members below
+	wxCondition m_Cond;     // signaled when there are enough results or the workers finished
+	size_t m_NextFile;
+	size_t m_Processed;
+	size_t m_Running;
+	bool m_Cancelled;
+	std::wstring m_CurrentFile;
+	std::vector<FileMatches> m_Results;
+	std::vector<wxString> m_SkippedFiles;
+	std::vector<std::wstring> m_Skipped;
+	std::vector<wxString> m_FailedFiles;
+	std::vector<std::wstring> m_Failed;
+	std::vector<wxString> m_DamagedFiles;
+	std::vector<std::wstring> m_Damaged;
+
+	wxMutex m_EncodingLock;
+	std::vector<xm::Encoding*> m_PreparedEncodings;
+};
+
+} //namespace wxm
+
+#endif //_WXM_FIND_IN_FILES_H_
@@ -0,0 +1,597 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/replace_journal.cpp
+// Description: Journal of the Files Replaced by Replace in Files of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "replace_journal.h"
+#include "trigram_index.h"
+#include "utils.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <wx/dir.h>
+#include <wx/strconv.h>
+#include <wx/log.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+#ifndef __WXMSW__
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+#ifdef __LINUX__
+#include <sys/xattr.h>
+#endif
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace wxm
+{
+
+namespace
+{
+
+// the journal layout:
+//     magic, then the records of the files one by one:
+//     'F', the length and the UTF-8 bytes of the file name
+//     'E', the offset and the length of a replacement in the new file, the
+//          length and the old bytes of the range replaced
+//     'C', the size and the modification time of the new file
+//     'A' if the file is not replaced
+const char journal_magic[8] = { 'w', 'x', 'm', 'R', 'e', 'p', '0', '1' };
+
+// the buffer of the sequential reads and writes
+const size_t io_buffer_size = 256 * 1024;
+
+wxString JournalDir()
+{
+	return AppPath::Instance().HomeDir() + wxT("fif_replace") + wxFILE_SEP_PATH;
+}
+
+void ListJournals(wxArrayString& journals)
+{
+	const wxString dir = JournalDir();
+	if (wxDirExists(dir))
+		wxDir::GetAllFiles(dir, &journals, wxT("*.rep"), wxDIR_FILES);
+}
+
+void PutUInt(std::string& buf, uint64_t val, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+		buf += char((val >> (i * 8)) & 0xFF);
+}
+
+class JournalReader
+{
+public:
+	JournalReader(wxFile& file): m_File(file), m_Pos(0), m_Beg(0), m_End(0) {}
+
+	wxFileOffset Tell() const { return m_Pos - wxFileOffset(m_End - m_Beg); }
+
+	void Seek(wxFileOffset pos)
+	{
+		if (pos == Tell())
+			return;
+		m_Pos = pos;
+		m_Beg = m_End = 0;
+	}
+
+	bool Read(void* data, size_t len)
+	{
+		char* out = static_cast<char*>(data);
+		while (len > 0)
+		{
+			if (m_Beg == m_End && !Fill())
+				return false;
+			size_t n = std::min(len, m_End - m_Beg);
+			memcpy(out, &m_Buf[m_Beg], n);
+			m_Beg += n;
+			out += n;
+			len -= n;
+		}
+		return true;
+	}
+
+	bool UInt(uint64_t& val, size_t bytes)
+	{
+		ubyte buf[8];
+		if (!Read(buf, bytes))
+			return false;
+		val = 0;
+		for (size_t i = 0; i < bytes; ++i)
+			val |= uint64_t(buf[i]) << (i * 8);
+		return true;
+	}
+
+	// copy len bytes to out
+	bool CopyTo(BufferedFileWriter& out, size_t len)
+	{
+		while (len > 0)
+		{
+			if (m_Beg == m_End && !Fill())
+				return false;
+			size_t n = std::min(len, m_End - m_Beg);
+			out.Write(&m_Buf[m_Beg], n);
+			m_Beg += n;
+			len -= n;
+		}
+		return true;
+	}
+
+private:
+	bool Fill()
+	{
+		m_Buf.resize(io_buffer_size);
+		if (m_File.Seek(m_Pos) == wxInvalidOffset)
+			return false;
+		ssize_t len = m_File.Read(&m_Buf[0], io_buffer_size);
+		if (len <= 0)
+			return false;
+
+		m_Pos += len;
+		m_Beg = 0;
+		m_End = size_t(len);
+		return true;
+	}
+
+	wxFile& m_File;
+	wxFileOffset m_Pos;     // the file offset after the buffer
+	std::vector<char> m_Buf;
+	size_t m_Beg, m_End;
+};
+
+// copy the bytes of in from its current offset, len < 0 for the rest of the file
+bool CopyFileBytes(wxFile& in, wxFileOffset len, BufferedFileWriter& out, std::vector<char>& buf)
+{
+	buf.resize(io_buffer_size);
+	while (len != 0)
+	{
+		size_t want = (len < 0) ? io_buffer_size : size_t(std::min(len, wxFileOffset(io_buffer_size)));
+		ssize_t n = in.Read(&buf[0], want);
+		if (n < 0 || (n == 0 && len > 0))
+			return false;
+		if (n == 0)
+			break;
+
+		out.Write(&buf[0], size_t(n));
+		if (len > 0)
+			len -= n;
+	}
+	return true;
+}
+
+// a file committed in a journal
+struct JournalFile
+{
+	std::wstring name;
+	wxFileOffset edits;     // the offset of the first edit in the journal
+	wxFileOffset newsize;
+	time_t newmtime;
+};
+
+// put the old bytes back into a file not changed since replaced
+bool RollbackFile(JournalReader& reader, const JournalFile& jf)
+{
+	wxFileOffset size;
+	time_t mtime;
+	if (!GetFileStatus(jf.name, size, mtime) || size != jf.newsize || mtime != jf.newmtime)
+		return false;
+
+	// a file left damaged by the replacing is restored from its backup by the user
+	const wxString filename(jf.name.c_str());
+	wxFile in;
+	if (wxFileExists(BackupFileName(filename))
+		|| !wxFile::Access(filename, wxFile::write) || !in.Open(filename, wxFile::read))
+	{
+		return false;
+	}
+
+	BufferedFileWriter out;
+	if (!out.Open(ReplacingFileName(filename)))
+		return false;
+
+	std::vector<char> buf;
+	reader.Seek(jf.edits);
+	wxFileOffset pos = 0;
+	for (;;)
+	{
+		char type;
+		if (!reader.Read(&type, 1))
+			return false;
+		if (type != 'E')
+			break;
+
+		uint64_t newbeg, newlen, oldlen;
+		if (!reader.UInt(newbeg, 8) || !reader.UInt(newlen, 4) || !reader.UInt(oldlen, 4))
+			return false;
+
+		const wxFileOffset beg = wxFileOffset(newbeg);
+		if (beg < pos || !CopyFileBytes(in, beg - pos, out, buf)
+			|| in.Seek(beg + wxFileOffset(newlen)) == wxInvalidOffset
+			|| !reader.CopyTo(out, size_t(oldlen)))
+		{
+			return false;
+		}
+		pos = beg + wxFileOffset(newlen);
+	}
+
+	if (!CopyFileBytes(in, -1, out, buf))
+		return false;
+
+	in.Close();
+	if (!out.Close())
+		return false;
+
+	bool damaged;
+	if (ReplaceFileWith(filename, out.GetName(), damaged))
+		return true;
+	if (!damaged)
+		wxRemoveFile(out.GetName());
+	return false;
+}
+
+#ifndef __WXMSW__
+// a renamed new file would replace target if it's a symbolic link, break its
+// hard links and lose its owner, group and ACLs, which only the owner or root
+// may set again
+bool MustWriteInPlace(const wxString& target, const wxStructStat& st, const wxStructStat& newst)
+{
+	if (st.st_nlink > 1 || st.st_uid != newst.st_uid || st.st_gid != newst.st_gid)
+		return true;
+	struct stat lst;
+	if (lstat(target.fn_str(), &lst) == 0 && S_ISLNK(lst.st_mode))
+		return true;
+#ifdef __LINUX__
+	if (getxattr(target.fn_str(), "system.posix_acl_access", nullptr, 0) > 0)
+		return true;
+#endif
+	return false;
+}
+
+// copy the bytes of in over out from the beginning, truncate out to them and
+// flush it to the disk
+bool OverwriteFile(wxFile& in, wxFile& out, std::vector<char>& buf)
+{
+	if (in.Seek(0) == wxInvalidOffset || out.Seek(0) == wxInvalidOffset)
+		return false;
+
+	wxFileOffset size = 0;
+	ssize_t n;
+	while ((n = in.Read(&buf[0], buf.size())) > 0)
+	{
+		if (out.Write(&buf[0], size_t(n)) != size_t(n))
+			return false;
+		size += n;
+	}
+	return n == 0 && ftruncate(out.fd(), size) == 0 && out.Flush();
+}
+
+void SetFileTimes(const wxString& filename, const wxStructStat& st)
+{
+	struct utimbuf times;
+	times.actime = st.st_atime;
+	times.modtime = st.st_mtime;
+	utime(filename.fn_str(), &times);
+}
+
+// copy newfile over target in place and remove it, target gets the
+// modification time of newfile committed in the journal;
+// target is copied to its backup first, and put back from it if the writing
+// fails; if it cannot be put back either, damaged is set and the backup and
+// newfile are kept
+bool WriteInPlace(const wxString& target, const wxString& newfile, const wxStructStat& st,
+	const wxStructStat& newst, bool& damaged)
+{
+	std::vector<char> buf(io_buffer_size);
+	const wxString backup = BackupFileName(target);
+	if (wxFileExists(backup))
+		return false;
+
+	wxFile in, out;
+	{
+		wxFile bak;
+		if (!in.Open(target, wxFile::read) || !bak.Create(backup))
+			return false;
+		if (!OverwriteFile(in, bak, buf) || !bak.Close())
+		{
+			bak.Close();
+			wxRemoveFile(backup);
+			return false;
+		}
+		in.Close();
+	}
+
+	if (!in.Open(newfile, wxFile::read) || !out.Open(target, wxFile::read_write))
+	{
+		wxRemoveFile(backup);
+		return false;
+	}
+
+	if (!OverwriteFile(in, out, buf) || !out.Close())
+	{
+		wxFile old;
+		if (!old.Open(backup, wxFile::read) || (!out.IsOpened() && !out.Open(target, wxFile::read_write))
+			|| !OverwriteFile(old, out, buf) || !out.Close())
+		{
+			damaged = true;
+			return false;
+		}
+		old.Close();
+		SetFileTimes(target, st);
+		wxRemoveFile(backup);
+		return false;
+	}
+	in.Close();
+
+	SetFileTimes(target, newst);
+	wxRemoveFile(newfile);
+	wxRemoveFile(backup);
+	return true;
+}
+#endif
+
+} // anonymous namespace
+
+bool BufferedFileWriter::Open(const wxString& filename)
+{
+	Discard();
+	m_Ok = true;
+	m_Name = filename;
+	return m_File.Create(filename, true);
+}
+
+void BufferedFileWriter::Write(const void* data, size_t len)
+{
+	m_Buf.append(static_cast<const char*>(data), len);
+	if (m_Buf.size() >= io_buffer_size)
+		Flush();
+}
+
+bool BufferedFileWriter::Flush()
+{
+	if (!m_Buf.empty() && m_File.Write(m_Buf.data(), m_Buf.size()) != m_Buf.size())
+		m_Ok = false;
+	m_Buf.clear();
+	return m_Ok;
+}
+
+bool BufferedFileWriter::Close()
+{
+	if (!m_File.IsOpened())
+		return false;
+
+	bool ok = Flush();
+	if (!m_File.Close())
+		ok = false;
+	return ok;
+}
+
+void BufferedFileWriter::Discard()
+{
+	m_Buf.clear();
+	if (!m_File.IsOpened())
+		return;
+
+	m_File.Close();
+	wxRemoveFile(m_Name);
+}
+
+wxString ReplacingFileName(const wxString& filename)
+{
+	return filename + wxT(".wxmtmp");
+}
+
+wxString BackupFileName(const wxString& filename)
+{
+	return filename + wxT(".wxmbak");
+}
+
+bool MustWriteInPlace(const wxString& target, const wxString& newfile)
+{
+#ifndef __WXMSW__
+	wxStructStat st, newst;
+	if (wxStat(target, &st) == 0 && wxStat(newfile, &newst) == 0)
+		return MustWriteInPlace(target, st, newst);
+#endif
+	return false;
+}
+
+bool ReplaceFileWith(const wxString& target, const wxString& newfile, bool& damaged)
+{
+	damaged = false;
+#ifndef __WXMSW__
+	wxStructStat st, newst;
+	if (wxStat(target, &st) == 0 && wxStat(newfile, &newst) == 0)
+	{
+		if (MustWriteInPlace(target, st, newst))
+			return WriteInPlace(target, newfile, st, newst, damaged);
+		chmod(newfile.fn_str(), st.st_mode & 07777);
+	}
+#endif
+
+	return wxRenameFile(newfile, target, true);
+}
+
+//==================================================
+
+wxString ReplaceJournal::Reset()
+{
+	wxLogNull nolog;
+
+	wxArrayString journals;
+	ListJournals(journals);
+	for (size_t i = 0; i < journals.GetCount(); ++i)
+		wxRemoveFile(journals[i]);
+
+	const wxString dir = JournalDir();
+	if (!wxDirExists(dir) && !wxMkdir(dir))
+		return wxString();
+	return dir;
+}
+
+bool ReplaceJournal::Exists()
+{
+	wxLogNull nolog;
+
+	wxArrayString journals;
+	ListJournals(journals);
+	for (size_t i = 0; i < journals.GetCount(); ++i)
+	{
+		wxFile file;
+		if (file.Open(journals[i], wxFile::read) && file.Length() > wxFileOffset(sizeof(journal_magic)))
+			return true;
+	}
+	return false;
+}
+
+size_t ReplaceJournal::Rollback(std::vector<wxString>& failed)
+{
+	wxLogNull nolog;
+
+	wxArrayString journals;
+	ListJournals(journals);
+
+	size_t count = 0;
+	for (size_t j = 0; j < journals.GetCount(); ++j)
+	{
+		wxFile file;
+		if (!file.Open(journals[j], wxFile::read))
+			continue;
+
+		JournalReader reader(file);
+		char magic[sizeof(journal_magic)];
+		if (!reader.Read(magic, sizeof(magic)) || memcmp(magic, journal_magic, sizeof(magic)) != 0)
+			continue;
+
+		// the files committed, a truncated record ends the journal
+		std::vector<JournalFile> files;
+		JournalFile jf;
+		bool begun = false;
+		for (;;)
+		{
+			char type;
+			uint64_t val, len;
+			if (!reader.Read(&type, 1))
+				break;
+
+			if (type == 'F')
+			{
+				if (!reader.UInt(len, 4))
+					break;
+				std::string utf8(size_t(len), '\0');
+				if (len > 0 && !reader.Read(&utf8[0], utf8.size()))
+					break;
+				jf.name = wxString(utf8.c_str(), wxConvUTF8).wc_str();
+				jf.edits = reader.Tell();
+				begun = true;
+			}
+			else if (type == 'E')
+			{
+				if (!reader.UInt(val, 8) || !reader.UInt(val, 4) || !reader.UInt(len, 4))
+					break;
+				reader.Seek(reader.Tell() + wxFileOffset(len));
+			}
+			else if (type == 'C')
+			{
+				if (!reader.UInt(val, 8))
+					break;
+				jf.newsize = wxFileOffset(val);
+				if (!reader.UInt(val, 8))
+					break;
+				jf.newmtime = time_t(int64_t(val));
+				if (begun)
+					files.push_back(jf);
+				begun = false;
+			}
+			else if (type == 'A')
+			{
+				begun = false;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		for (size_t i = 0; i < files.size(); ++i)
+		{
+			if (RollbackFile(reader, files[i]))
+			{
+				++count;
+			}
+			else
+			{
+				failed.push_back(wxString(files[i].name.c_str()));
+			}
+		}
+	}
+
+	Reset();
+	return count;
+}
+
+bool ReplaceJournal::Open(const wxString& filename)
+{
+	if (!m_Writer.Open(filename))
+		return false;
+
+	m_Writer.Write(journal_magic, sizeof(journal_magic));
+	return true;
+}
+
+void ReplaceJournal::BeginFile(const std::wstring& filename)
+{
+	std::string buf;
+	wxCharBuffer utf8 = wxConvUTF8.cWC2MB(filename.c_str());
+	size_t len = (utf8.data() == nullptr) ? 0 : strlen(utf8.data());
+	buf += 'F';
+	PutUInt(buf, len, 4);
+	buf.append(utf8.data(), len);
+	m_Writer.Write(buf);
+}
+
+void ReplaceJournal::AddEdit(wxFileOffset newbeg, size_t newlen, const wxByte* oldbytes, size_t oldlen)
+{
+	std::string buf;
+	buf += 'E';
+	PutUInt(buf, uint64_t(newbeg), 8);
+	PutUInt(buf, newlen, 4);
+	PutUInt(buf, oldlen, 4);
+	m_Writer.Write(buf);
+	m_Writer.Write(oldbytes, oldlen);
+}
+
+bool ReplaceJournal::CommitFile(wxFileOffset newsize, time_t newmtime)
+{
+	std::string buf;
+	buf += 'C';
+	PutUInt(buf, uint64_t(newsize), 8);
+	PutUInt(buf, uint64_t(int64_t(newmtime)), 8);
+	m_Writer.Write(buf);
+	return m_Writer.Flush();
+}
+
+void ReplaceJournal::AbortFile()
+{
+	m_Writer.Write("A", 1);
+}
+
+} //namespace wxm
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/replace_journal.h
+// Description: Journal of the Files Replaced by Replace in Files of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_REPLACE_JOURNAL_H_
+#define _WXM_REPLACE_JOURNAL_H_
+
+#include "../xm/cxx11.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/string.h>
+#include <wx/file.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <vector>
+#include <string>
+#include <ctime>
+
+namespace wxm
+{
+
+// writes a new file through a buffer, so that the memory is bounded whatever
+// the size of the file is
+class BufferedFileWriter
+{
+public:
+	BufferedFileWriter(): m_Ok(true) {}
+	~BufferedFileWriter() { Discard(); }
+
+	// create or truncate the file
+	bool Open(const wxString& filename);
+	bool IsOpened() const { return m_File.IsOpened(); }
+	const wxString& GetName() const { return m_Name; }
+
+	void Write(const void* data, size_t len);
+	void Write(const std::string& data) { Write(data.data(), data.size()); }
+
+	// return false if any writing failed
+	bool Flush();
+	bool Close();
+
+	// close and remove the file
+	void Discard();
+
+private:
+	wxFile m_File;
+	wxString m_Name;
+	std::string m_Buf;
+	bool m_Ok;
+};
+
+// the new file written beside a file being replaced
+wxString ReplacingFileName(const wxString& filename);
+// the copy of a file kept while the new file is copied over it in place
+wxString BackupFileName(const wxString& filename);
+
+// a new file renamed over target would replace a symbolic link, break the hard
+// links or lose the owner, group or ACLs of target, so it must be copied over
+// target in place
+bool MustWriteInPlace(const wxString& target, const wxString& newfile);
+
+// rename the new file over target with the permissions of target, or copy
+// it over target in place if MustWriteInPlace(); target is backed up before copied over, and put back if the copying
+// fails; damaged is set if it cannot be put back, and then the backup and the
+// new file are both kept
+bool ReplaceFileWith(const wxString& target, const wxString& newfile, bool& damaged);
+
+// the journal of the last Replace in Files in the config dir, one file per
+// worker; only the replaced ranges with their old bytes are recorded instead
+// of the backups of the files, so that a file is rolled back by streaming it
+// once with the old bytes put back
+class ReplaceJournal
+{
+public:
+	// remove the journals of the last Replace in Files and return the dir of
+	// the new ones, empty if the dir cannot be created;
+	// the static functions must be called on the main thread
+	static wxString Reset();
+	static bool Exists();
+
+	// roll back the files committed in the journals and not changed since
+	// then, the others are listed in failed; the journals are removed
+	// return the count of the files rolled back
+	static size_t Rollback(std::vector<wxString>& failed);
+
+	bool Open(const wxString& filename);
+	bool Close() { return m_Writer.Close(); }
+
+	// the records of a file: BeginFile(), AddEdit() by the order of the
+	// positions, then CommitFile() before the file is renamed, or AbortFile()
+	void BeginFile(const std::wstring& filename);
+	// newbeg is the offset in the new file
+	void AddEdit(wxFileOffset newbeg, size_t newlen, const wxByte* oldbytes, size_t oldlen);
+	// the journal is flushed, return false if it cannot be written
+	bool CommitFile(wxFileOffset newsize, time_t newmtime);
+	void AbortFile();
+
+private:
+	BufferedFileWriter m_Writer;
+};
+
+} //namespace wxm
+
+#endif //_WXM_REPLACE_JOURNAL_H_
@@ -8,22 +8,19 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "searcher.h"
+#include "search_algo.h"
 #include "../xm/cxx11.h"
 #include "../wxmedit/wxmedit.h"
 #include "case_conv.h"
 #include "../xm/utils.hpp"
+#include "../xm/perf.h"
 #include "../mad_utils.h"
 
 #include <unicode/uchar.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 
-//#include <boost/xpressive/xpressive.hpp>
-#include <boost/xpressive/xpressive_dynamic.hpp>
-#include <boost/xpressive/traits/null_regex_traits.hpp>
-#include <boost/xpressive/traits/cpp_regex_traits.hpp>
-#include <boost/unordered_map.hpp>
-
 using namespace std;
 using namespace boost::xpressive;
 
@@ -32,281 +29,6 @@ using namespace boost::xpressive;
 #define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
 #endif
 
-template<typename char_type>
-inline char_type NormalCase(char_type ch, bool sensitive)
-{
-	return sensitive ? ch : (char_type)u_tolower((UChar32)ch);
-}
-
-template<>
-inline wxByte NormalCase(wxByte ch, bool sensitive)
-{
-	return ch;
-}
-
-class JumpTable_Hex
-{
-private:
-	int m_Table[256];
-	std::vector<wxByte> m_Pattern;
-public:
-	void Build(const std::vector<wxByte>& pat)
-	{
-		if (m_Pattern == pat)
-			return;
-		m_Pattern = pat;
-		size_t len = pat.size();
-
-		for (size_t i = 0; i<256; ++i) m_Table[i] = (int)len + 1;
-		for (size_t i = 0; i<len; ++i) m_Table[pat[i]] = (int)(len - i);
-	}
-	int GetValue(const wxByte ch) const
-	{
-		return m_Table[ch];
-	}
-};
-
-typedef boost::unordered_map<unsigned int, int> UCS4_Map;
-
-class JumpTable_UCS4
-{
-private:
-	int m_UCS2_Table[65536];
-	UCS4_Map m_Table;
-	ucs4string m_Pattern;
-	int m_Len_1;
-public:
-	void Build(const ucs4string& ucs)
-	{
-		if (m_Pattern == ucs)
-			return;
-		m_Pattern = ucs;
-
-		const int len1 = m_Len_1 = (int)ucs.size() + 1;
-		int *ptab = m_UCS2_Table;
-		for (size_t i = 0; i<65536; ++i, ++ptab) *ptab = len1;
-
-		m_Table.clear();
-		size_t len = ucs.size();
-		for (size_t i = 0; i<ucs.size(); ++i)
-		{
-			const unsigned int idx = (unsigned int)ucs[i];
-			if (idx <= 0xFFFF)
-				m_UCS2_Table[idx] = (int)(len - i);
-			else
-				m_Table[idx] = (int)(len - i);
-		}
-	}
-	int GetValue(const ucs4_t ch) const
-	{
-		if (ch <= 0xFFFF && ch >= 0)
-		{
-			return m_UCS2_Table[(unsigned int)ch];
-		}
-
-		return xm::wrap_map(m_Table).get((unsigned int)ch, m_Len_1);
-	}
-};
-
-template <typename CharIter, typename JumpTable, typename Seq>
-bool Search(CharIter &begin, CharIter &end, const Seq& pattern,
-	const JumpTable &jump_table, bool bCaseSensitive)
-	// if (!bCaseSensitive) the content of 'pattern' must be normal case.
-{
-	size_t pat_len = pattern.size();
-	wxASSERT(pat_len != 0);
-
-	if (begin == end)
-		return false;
-
-	typename Seq::const_iterator p = pattern.begin();
-	typename Seq::value_type c1;
-	size_t idx = 0;
-	CharIter beginpos = begin;
-
-	for (;;)
-	{
-		c1 = NormalCase(*begin, bCaseSensitive);
-
-		if (c1 == *p)
-		{
-			if (idx == 0)
-				beginpos = begin;
-			++idx;
-			++p;
-
-			if (idx == pat_len) // found
-			{
-				end = begin;
-				++end;
-				begin = beginpos;
-				return true;
-			}
-
-			// compare next char
-			if (++begin == end)
-				return false;
-
-			continue;
-		}
-
-		// c1 != *p
-		// jump by the jump_table
-		CharIter it = begin;
-		int i = (int)(pat_len - idx);
-		do
-		{
-			if (++it == end)
-				return false;
-		} while (--i > 0);
-
-		c1 = NormalCase(*it, bCaseSensitive);
-
-		int jv = jump_table.GetValue(c1);
-		if (jv >= (int)pat_len)
-		{
-			begin = it;
-			jv -= (int)pat_len;
-			idx = 0;
-			p = pattern.begin();
-		}
-		else if (idx != 0)
-		{
-			begin = beginpos;
-			idx = 0;
-			p = pattern.begin();
-		}
-
-		if (jv > 0)
-		{
-			do
-			{
-				if (++begin == end)
-					return false;
-			} while (--jv > 0);
-		}
-	}
-
-	return false;
-}
-
-
-#ifdef __WXMSW__
-namespace boost { namespace xpressive { namespace detail
-{
-	template<>
-	struct string_type<ucs4_t>  // defined in xpressive/detail/detail_fwd.hpp
-	{
-		typedef ucs4string type;
-	};
-
-	template<>
-	struct string_literal<ucs4_t>
-	{
-		static ucs4string inter_str;
-
-		static ucs4_t const *pick(char const *, wchar_t const *cstr)
-		{
-			inter_str.clear();
-			while (*cstr != 0)
-			{
-				inter_str.push_back(ucs4_t(*cstr));
-				++cstr;
-			}
-
-			return inter_str.c_str();
-		}
-
-		static ucs4_t pick(char, wchar_t ch)
-		{
-			return ch;
-		}
-	};
-
-	ucs4string string_literal<ucs4_t>::inter_str;
-
-}}}
-
-
-struct ucs4_regex_traits : public null_regex_traits<ucs4_t>
-{
-	typedef ucs4_t char_type;
-	typedef detail::umaskex_t char_class_type;
-	typedef ucs4string string_type;
-	typedef std::locale locale_type;
-
-	template<typename char_type2>
-	static char_type2 tolower(char_type2 ch)
-	{
-		return (char_type2)u_tolower((UChar32)ch);
-	}
-
-	template<typename char_type2>
-	static char_type2 toupper(char_type2 ch)
-	{
-		return (char_type2)u_toupper((UChar32)ch);
-	}
-
-	static char_type widen(char ch)
-	{
-		return char_type(ch);
-	}
-
-	char_type translate_nocase(char_type ch) const
-	{
-		return this->tolower(ch);
-	}
-
-	bool in_range_nocase(char_type first, char_type last, char_type ch) const
-	{
-		return this->in_range(first, last, ch)
-			|| this->in_range(first, last, this->toupper(ch))
-			|| this->in_range(first, last, this->tolower(ch));
-	}
-
-	template<typename FwdIter>
-	static char_class_type lookup_classname(FwdIter begin, FwdIter end, bool icase)
-	{
-		cpp_regex_traits<char> cpptraits;
-		char_class_type c = cpptraits.lookup_classname(begin, end, icase);
-		return c;
-	}
-
-	static bool isctype(char_type ch, char_class_type mask)
-	{
-		cpp_regex_traits<char> cpptraits;
-		int i = ch;
-		if (i<0 || i>0xFF) ch = 0x0;//?
-		return cpptraits.isctype(char(ch), mask);
-	}
-
-	static int value(char_type ch, int radix)
-	{
-		switch (radix)
-		{
-		case 8:
-			if (ch >= '0' && ch <= '7') return ch - '0';
-			break;
-		case 10:
-			if (ch >= '0' && ch <= '9') return ch - '0';
-			break;
-		case 16:
-			if (ch >= '0' && ch <= '9') return ch - '0';
-			if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
-			if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
-			break;
-		}
-		return -1;
-	}
-};
-
-#else // __WXGTK__
-
-typedef cpp_regex_traits<ucs4_t> ucs4_regex_traits;
-
-#endif
-
-
 struct UCQueueSet
 {
 	xm::UCQueue  ucq;
@@ -570,36 +292,6 @@ void MadCaretPos::AssignWith(const WXMCharIterator& ucit)
 	linepos = ucit.linepos;
 }
 
-// convert escape char to literal char
-ucs4string ConvertEscape(const ucs4string &str)
-{
-	ucs4string out;
-	detail::escape_value<ucs4_t, ucs4_regex_traits::char_class_type> esc;
-
-	ucs4string::const_iterator begin = str.begin();
-	ucs4string::const_iterator end = str.end();
-	compiler_traits<ucs4_regex_traits> ucs4traits;
-
-	while (begin != end)
-	{
-		if (*begin != '\\')
-		{
-			out += *begin;
-			++begin;
-			continue;
-		}
-
-		// last char is '\'
-		if (++begin == end)
-			throw regex_error(regex_constants::error_escape);
-
-		esc = detail::parse_escape(begin, end, ucs4traits);
-		out += esc.ch_;
-	}
-
-	return out;
-}
-
 // Hex Search
 struct ByteIterator : public WXMCharIterator
 {
@@ -848,6 +540,8 @@ bool TextSearcher::NextRegexSearchingPos(MadCaretPos& cp, const wxString &expr)
 MadSearchResult TextSearcher::Search(/*IN_OUT*/MadCaretPos& beginpos, /*IN_OUT*/MadCaretPos& endpos,
 	const wxString &text)
 {
+	XM_PERF_SCOPE(PERF_SEARCH);
+
 	if (beginpos.pos >= endpos.pos || text.IsEmpty())
 		return SR_NO;
 
@@ -1355,6 +1049,8 @@ MadSearchResult RegexSearcher::Replace(ucs4string &out, const MadCaretPos& begin
 MadSearchResult HexSearcher::SearchHex(/*IN_OUT*/MadCaretPos& beginpos, /*IN_OUT*/MadCaretPos& endpos,
 	const std::vector<wxByte>& hex)
 {
+	XM_PERF_SCOPE(PERF_SEARCH_HEX);
+
 	if (beginpos.pos >= endpos.pos || hex.empty())
 		return SR_NO;
 
@@ -12,6 +12,7 @@
 
 #include "../xm/cxx11.h"
 #include "def.h"
+#include "buffer_searcher.h"
 
 #ifdef _MSC_VER
 # pragma warning( push )
@@ -32,12 +33,6 @@ class MadEdit;
 struct MadCaretPos;
 struct UCIterator;
 
-// returned state of Search & Replace
-enum MadSearchResult
-{
-	SR_EXPR_ERROR = -2, SR_YES = -1, SR_NO = 0
-};
-
 enum MadReplaceResult
 {
 	RR_EXPR_ERROR = -1,
@@ -53,6 +53,17 @@ void WXMStatusBar::ConnectSizeEvent(wxObjectEventFunction func)
 	m_statusbar->Connect(wxEVT_SIZE, func);
 }
 
+void WXMStatusBar::SetProgress(const wxString& task, int percent)
+{
+	if (percent < 0)
+	{
+		m_statusbar->SetStatusText(wxString(), (int)STBF_HELP);
+		return;
+	}
+
+	m_statusbar->SetStatusText(wxString::Format(wxT("%s %d%%"), task.c_str(), percent), (int)STBF_HELP);
+}
+
 WXMStatusBar& GetFrameStatusBar()
 {
 	return g_MainFrame->m_wxmstatusbar;
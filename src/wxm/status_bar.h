@@ -44,6 +44,9 @@ struct WXMStatusBar
 		m_statusbar->SetStatusText(s, (int)field);
 	}
 
+	// show the progress of a background task in the help field; percent<0 clears it
+	void SetProgress(const wxString& task, int percent);
+
 	WXMStatusBar() : m_frame(nullptr), m_statusbar(nullptr) {}
 private:
 	MadEditFrame* m_frame;
@@ -0,0 +1,1021 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/trigram_index.cpp
+// Description: Trigram Index of the Files for Find in Files of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "trigram_index.h"
+#include "find_in_files.h"
+#include "utils.h"
+#include "../xm/encdet.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <wx/strconv.h>
+#include <wx/log.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <cstring>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace wxm
+{
+
+namespace
+{
+
+// the file layout:
+//     magic, header size, header: the directory, the key and the file list
+//     the file ids of every trigram, delta encoded
+//     the trigram directory: trigram, file count and offset of every trigram
+//     the offset and the count of the trigram directory
+const char index_magic[8] = { 'w', 'x', 'm', 'T', 'r', 'i', '0', '1' };
+const size_t posting_size = 16;
+const size_t trailer_size = 16;
+
+// the bytes read at a time when indexing a file
+const size_t read_block_size = 256 * 1024;
+
+// the buffer of the sequential reads and writes of the index
+const size_t io_buffer_size = 64 * 1024;
+
+// the pairs of a trigram and a file id sorted in memory before spilled to a run file
+const size_t max_memory_pairs = 4 * 1024 * 1024;
+
+// a file modified in the last seconds may be modified again without changing
+// its size and its modification time
+const time_t min_file_age = 2;
+
+void PutUInt(std::string& buf, uint64_t val, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+		buf += char((val >> (i * 8)) & 0xFF);
+}
+
+void PutVarint(std::string& buf, uint64_t val)
+{
+	while (val >= 0x80)
+	{
+		buf += char((val & 0x7F) | 0x80);
+		val >>= 7;
+	}
+	buf += char(val);
+}
+
+void PutString(std::string& buf, const std::wstring& str)
+{
+	wxCharBuffer utf8 = wxConvUTF8.cWC2MB(str.c_str());
+	size_t len = (utf8.data() == nullptr) ? 0 : strlen(utf8.data());
+	PutUInt(buf, len, 4);
+	buf.append(utf8.data(), len);
+}
+
+// parses the little endian values of the header in memory
+class ByteParser
+{
+public:
+	ByteParser(const char* data, size_t len): m_Pos(data), m_End(data + len), m_Ok(true) {}
+
+	bool Ok() const { return m_Ok; }
+
+	uint64_t UInt(size_t bytes)
+	{
+		if (size_t(m_End - m_Pos) < bytes)
+		{
+			m_Ok = false;
+			return 0;
+		}
+
+		uint64_t val = 0;
+		for (size_t i = 0; i < bytes; ++i)
+			val |= uint64_t(ubyte(m_Pos[i])) << (i * 8);
+		m_Pos += bytes;
+		return val;
+	}
+
+	std::wstring String()
+	{
+		size_t len = size_t(UInt(4));
+		if (!m_Ok || size_t(m_End - m_Pos) < len)
+		{
+			m_Ok = false;
+			return std::wstring();
+		}
+
+		std::string utf8(m_Pos, len);
+		m_Pos += len;
+		wxWCharBuffer str = wxConvUTF8.cMB2WC(utf8.c_str());
+		return (str.data() == nullptr) ? std::wstring() : std::wstring(str.data());
+	}
+
+private:
+	const char* m_Pos;
+	const char* m_End;
+	bool m_Ok;
+};
+
+// reads a file sequentially by a buffer, the readers may share the wxFile
+class FileReader
+{
+public:
+	FileReader(wxFile& file, wxFileOffset pos): m_File(file), m_Pos(pos), m_Beg(0), m_End(0) {}
+
+	wxFileOffset Tell() const { return m_Pos - wxFileOffset(m_End - m_Beg); }
+
+	void Seek(wxFileOffset pos)
+	{
+		if (pos == Tell())
+			return;
+		m_Pos = pos;
+		m_Beg = m_End = 0;
+	}
+
+	bool Read(void* data, size_t len)
+	{
+		char* out = static_cast<char*>(data);
+		while (len > 0)
+		{
+			if (m_Beg == m_End && !Fill())
+				return false;
+			size_t n = std::min(len, m_End - m_Beg);
+			memcpy(out, &m_Buf[m_Beg], n);
+			m_Beg += n;
+			out += n;
+			len -= n;
+		}
+		return true;
+	}
+
+	bool Varint(uint64_t& val)
+	{
+		val = 0;
+		for (size_t shift = 0; shift < 64; shift += 7)
+		{
+			if (m_Beg == m_End && !Fill())
+				return false;
+			ubyte b = ubyte(m_Buf[m_Beg++]);
+			val |= uint64_t(b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+				return true;
+		}
+		return false;
+	}
+
+private:
+	bool Fill()
+	{
+		m_Buf.resize(io_buffer_size);
+		if (m_File.Seek(m_Pos) == wxInvalidOffset)
+			return false;
+		ssize_t len = m_File.Read(&m_Buf[0], io_buffer_size);
+		if (len <= 0)
+			return false;
+
+		m_Pos += len;
+		m_Beg = 0;
+		m_End = size_t(len);
+		return true;
+	}
+
+	wxFile& m_File;
+	wxFileOffset m_Pos;     // the file offset after the buffer
+	std::vector<char> m_Buf;
+	size_t m_Beg, m_End;
+};
+
+class FileWriter
+{
+public:
+	FileWriter(wxFile& file): m_File(file), m_Pos(0), m_Ok(true) {}
+
+	wxFileOffset Tell() const { return m_Pos; }
+
+	void Write(const void* data, size_t len)
+	{
+		m_Buf.append(static_cast<const char*>(data), len);
+		m_Pos += len;
+		if (m_Buf.size() >= io_buffer_size)
+			Flush();
+	}
+	void Write(const std::string& data) { Write(data.data(), data.size()); }
+
+	bool Flush()
+	{
+		if (!m_Buf.empty() && m_File.Write(m_Buf.data(), m_Buf.size()) != m_Buf.size())
+			m_Ok = false;
+		m_Buf.clear();
+		return m_Ok;
+	}
+
+private:
+	wxFile& m_File;
+	std::string m_Buf;
+	wxFileOffset m_Pos;
+	bool m_Ok;
+};
+
+inline uint64_t MakePair(Trigram trigram, uint32_t id)
+{
+	return (uint64_t(trigram) << 32) | id;
+}
+
+// the pairs of a trigram and a file id sorted by the trigrams then by the ids
+class PairSource
+{
+public:
+	virtual ~PairSource() {}
+
+	// return false at the end or on error
+	virtual bool Next(uint64_t& pair) = 0;
+	virtual bool Failed() const { return false; }
+};
+
+class MemoryPairs: public PairSource
+{
+public:
+	MemoryPairs(const std::vector<uint64_t>& pairs): m_Pairs(pairs), m_Idx(0) {}
+
+	virtual bool Next(uint64_t& pair) override
+	{
+		if (m_Idx >= m_Pairs.size())
+			return false;
+		pair = m_Pairs[m_Idx++];
+		return true;
+	}
+
+private:
+	const std::vector<uint64_t>& m_Pairs;
+	size_t m_Idx;
+};
+
+// the pairs spilled to a temporary file in the native byte order
+class RunPairs: public PairSource
+{
+public:
+	RunPairs(const std::wstring& filename, size_t count)
+		: m_Reader(m_File, 0), m_Left(count), m_Failed(false)
+	{
+		m_Failed = !m_File.Open(wxString(filename.c_str()), wxFile::read);
+	}
+
+	virtual bool Next(uint64_t& pair) override
+	{
+		if (m_Failed || m_Left == 0)
+			return false;
+		if (!m_Reader.Read(&pair, sizeof(pair)))
+		{
+			m_Failed = true;
+			return false;
+		}
+		--m_Left;
+		return true;
+	}
+	virtual bool Failed() const override { return m_Failed; }
+
+private:
+	wxFile m_File;
+	FileReader m_Reader;
+	size_t m_Left;
+	bool m_Failed;
+};
+
+// the pairs of an index with the ids of the files kept in the new index
+class TrigramIndexPairs: public PairSource
+{
+public:
+	TrigramIndexPairs(wxFile& file, wxFileOffset dirpos, size_t count, const std::vector<int>& remap)
+		: m_Remap(remap), m_Dir(file, dirpos), m_Ids(file, 0)
+		, m_Count(count), m_Next(0), m_Trigram(0), m_Left(0), m_Last(-1), m_Failed(false)
+	{}
+
+	virtual bool Next(uint64_t& pair) override
+	{
+		for (;;)
+		{
+			while (m_Left == 0)
+			{
+				if (m_Next >= m_Count)
+					return false;
+
+				char buf[posting_size];
+				if (!m_Dir.Read(buf, posting_size))
+					return Fail();
+				ByteParser parser(buf, posting_size);
+				m_Trigram = Trigram(parser.UInt(4));
+				m_Left = uint32_t(parser.UInt(4));
+				m_Ids.Seek(wxFileOffset(parser.UInt(8)));
+				m_Last = -1;
+				++m_Next;
+			}
+
+			uint64_t delta;
+			if (!m_Ids.Varint(delta))
+				return Fail();
+			m_Last += int64_t(delta) + 1;
+			--m_Left;
+			if (m_Last >= int64_t(m_Remap.size()))
+				return Fail();
+
+			int id = m_Remap[size_t(m_Last)];
+			if (id >= 0)
+			{
+				pair = MakePair(m_Trigram, uint32_t(id));
+				return true;
+			}
+		}
+	}
+	virtual bool Failed() const override { return m_Failed; }
+
+private:
+	bool Fail()
+	{
+		m_Failed = true;
+		return false;
+	}
+
+	const std::vector<int>& m_Remap;
+	FileReader m_Dir;
+	FileReader m_Ids;
+	size_t m_Count;
+	size_t m_Next;
+	Trigram m_Trigram;
+	uint32_t m_Left;
+	int64_t m_Last;
+	bool m_Failed;
+};
+
+} // anonymous namespace
+
+//==================================================
+
+bool GetFileStatus(const std::wstring& filename, wxFileOffset& size, time_t& mtime)
+{
+	wxStructStat st;
+	if (wxStat(wxString(filename.c_str()), &st) != 0)
+		return false;
+
+	size = wxFileOffset(st.st_size);
+	mtime = st.st_mtime;
+	return true;
+}
+
+wxString TrigramIndex::IndexPath(const wxString& dir)
+{
+	wxString name = wxString::Format(wxT("%08lx.idx"), FilePathHash(wxString(NormalDir(dir).c_str())));
+	return AppPath::Instance().HomeDir() + wxT("fif_index") + wxFILE_SEP_PATH + name;
+}
+
+std::wstring TrigramIndex::NormalDir(const wxString& dir)
+{
+	wxFileName name = wxFileName::DirName(dir);
+	name.MakeAbsolute();
+	return std::wstring(name.GetPath(wxPATH_GET_VOLUME).wc_str());
+}
+
+bool TrigramIndex::Load(const std::wstring& path, const std::wstring& dir)
+{
+	Close();
+
+	wxLogNull nolog;
+	wxString filename(path.c_str());
+	if (!wxFileExists(filename) || !m_File.Open(filename, wxFile::read))
+		return false;
+
+	const wxFileOffset len = m_File.Length();
+	char buf[16];
+	if (len < wxFileOffset(sizeof(buf) + trailer_size) || m_File.Read(buf, sizeof(buf)) != ssize_t(sizeof(buf))
+		|| memcmp(buf, index_magic, sizeof(index_magic)) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	const uint64_t headersize = ByteParser(buf + 8, 8).UInt(8);
+	if (headersize > uint64_t(len) - sizeof(buf) - trailer_size)
+	{
+		Close();
+		return false;
+	}
+
+	std::string header(size_t(headersize), '\0');
+	if (headersize > 0 && m_File.Read(&header[0], header.size()) != ssize_t(header.size()))
+	{
+		Close();
+		return false;
+	}
+
+	ByteParser parser(header.data(), header.size());
+	std::wstring root = parser.String();
+	m_Key = parser.String();
+	size_t count = size_t(parser.UInt(4));
+	if (root != dir || count > header.size())
+	{
+		Close();
+		return false;
+	}
+
+	m_Entries.resize(count);
+	for (size_t i = 0; i < count && parser.Ok(); ++i)
+	{
+		FileEntry& entry = m_Entries[i];
+		entry.name = parser.String();
+		entry.size = wxFileOffset(parser.UInt(8));
+		entry.mtime = time_t(int64_t(parser.UInt(8)));
+		entry.encoding = parser.String();
+		m_Ids[entry.name] = uint32_t(i);
+	}
+
+	if (!parser.Ok() || m_File.Seek(len - trailer_size) == wxInvalidOffset
+		|| m_File.Read(buf, trailer_size) != ssize_t(trailer_size))
+	{
+		Close();
+		return false;
+	}
+
+	ByteParser trailer(buf, trailer_size);
+	m_DirPos = wxFileOffset(trailer.UInt(8));
+	m_TrigramCount = size_t(trailer.UInt(8));
+	if (m_DirPos < wxFileOffset(sizeof(buf) + headersize)
+		|| m_DirPos + wxFileOffset(m_TrigramCount * posting_size) != len - wxFileOffset(trailer_size))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void TrigramIndex::Close()
+{
+	if (m_File.IsOpened())
+		m_File.Close();
+	m_Key.clear();
+	m_Entries.clear();
+	m_Ids.clear();
+	m_DirPos = 0;
+	m_TrigramCount = 0;
+}
+
+int TrigramIndex::FindFile(const std::wstring& filename) const
+{
+	boost::unordered_map<std::wstring, uint32_t>::const_iterator it = m_Ids.find(filename);
+	if (it == m_Ids.end())
+		return -1;
+
+	const FileEntry& entry = m_Entries[it->second];
+	wxFileOffset size;
+	time_t mtime;
+	if (!GetFileStatus(filename, size, mtime) || size != entry.size || mtime != entry.mtime)
+		return -1;
+
+	return int(it->second);
+}
+
+bool TrigramIndex::Lookup(std::vector<Trigram> trigrams, std::vector<uint32_t>& ids)
+{
+	ids.clear();
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+	std::vector<Posting> postings;
+	for (size_t i = 0; i < trigrams.size(); ++i)
+	{
+		Posting posting;
+		bool found;
+		if (!FindPosting(trigrams[i], posting, found))
+			return false;
+		if (!found)
+			return true;    // no file contains the trigram
+		postings.push_back(posting);
+	}
+
+	// intersect from the shortest list
+	struct FewerIds
+	{
+		bool operator()(const Posting& a, const Posting& b) const { return a.count < b.count; }
+	};
+	std::sort(postings.begin(), postings.end(), FewerIds());
+
+	std::vector<uint32_t> more, both;
+	for (size_t i = 0; i < postings.size(); ++i)
+	{
+		if (!ReadIds(postings[i], (i == 0) ? ids : more))
+			return false;
+
+		if (i > 0)
+		{
+			both.clear();
+			std::set_intersection(ids.begin(), ids.end(), more.begin(), more.end(), std::back_inserter(both));
+			ids.swap(both);
+		}
+		if (ids.empty())
+			break;
+	}
+
+	return true;
+}
+
+bool TrigramIndex::ReadPosting(size_t idx, Posting& posting)
+{
+	char buf[posting_size];
+	if (m_File.Seek(m_DirPos + wxFileOffset(idx * posting_size)) == wxInvalidOffset
+		|| m_File.Read(buf, posting_size) != ssize_t(posting_size))
+		return false;
+
+	ByteParser parser(buf, posting_size);
+	posting.trigram = Trigram(parser.UInt(4));
+	posting.count = uint32_t(parser.UInt(4));
+	posting.pos = wxFileOffset(parser.UInt(8));
+	return true;
+}
+
+bool TrigramIndex::FindPosting(Trigram trigram, Posting& posting, bool& found)
+{
+	size_t beg = 0, end = m_TrigramCount;
+	while (beg < end)
+	{
+		size_t mid = beg + (end - beg) / 2;
+		if (!ReadPosting(mid, posting))
+			return false;
+
+		if (posting.trigram == trigram)
+		{
+			found = true;
+			return true;
+		}
+
+		if (posting.trigram < trigram)
+			beg = mid + 1;
+		else
+			end = mid;
+	}
+
+	found = false;
+	return true;
+}
+
+bool TrigramIndex::ReadIds(const Posting& posting, std::vector<uint32_t>& ids)
+{
+	ids.clear();
+	FileReader reader(m_File, posting.pos);
+	int64_t last = -1;
+	for (uint32_t i = 0; i < posting.count; ++i)
+	{
+		uint64_t delta;
+		if (!reader.Varint(delta))
+			return false;
+		last += int64_t(delta) + 1;
+		if (last >= int64_t(m_Entries.size()))
+			return false;
+		ids.push_back(uint32_t(last));
+	}
+
+	return true;
+}
+
+//==================================================
+
+struct TrigramIndexer::Job
+{
+	std::wstring path;      // the index file
+	std::wstring dir;
+	FileEncodingSettings settings;
+	std::wstring key;
+	std::vector<std::wstring> files;
+};
+
+// writes the new index with the trigrams of the files not changed from the old
+// index, and reads only the files new or changed; the pairs of the trigrams and
+// the file ids are sorted by runs in bounded memory, then merged to the postings
+class TrigramIndexBuilder
+{
+public:
+	TrigramIndexBuilder(TrigramIndexer& indexer, const TrigramIndexer::Job& job)
+		: m_Indexer(indexer), m_Job(job), m_Failed(false)
+	{}
+	~TrigramIndexBuilder();
+
+	bool Build();
+
+private:
+	// return false if the file is not indexed
+	bool IndexFile(const std::wstring& filename, uint32_t id, TrigramIndex::FileEntry& entry);
+	void SpillPairs();
+	bool WriteIndex(TrigramIndex& old, const std::vector<int>& remap);
+
+	TrigramIndexer& m_Indexer;
+	const TrigramIndexer::Job& m_Job;
+
+	std::vector<TrigramIndex::FileEntry> m_Entries;
+	std::vector<uint64_t> m_Pairs;
+	std::vector<std::wstring> m_Runs;
+	std::vector<size_t> m_RunSizes;
+	bool m_Failed;
+
+	// the trigrams of a file
+	std::vector<wxByte> m_Data;
+	std::vector<wxByte> m_Seen;     // a bit for every trigram
+	std::vector<Trigram> m_Trigrams;
+	xm::CharsetDetector m_Detector;
+};
+
+TrigramIndexBuilder::~TrigramIndexBuilder()
+{
+	for (size_t i = 0; i < m_Runs.size(); ++i)
+		wxRemoveFile(wxString(m_Runs[i].c_str()));
+}
+
+bool TrigramIndexBuilder::Build()
+{
+	wxLogNull nolog;
+
+	TrigramIndex old;
+	if (old.Load(m_Job.path, m_Job.dir) && old.Key() != m_Job.key)
+		old.Close();    // the encodings were detected with other settings
+
+	// keep the files not changed since indexed
+	std::vector<int> remap(old.GetFileCount(), -1);
+	for (size_t i = 0; i < old.GetFileCount(); ++i)
+	{
+		if (old.FindFile(old.GetFile(i).name) == int(i))
+		{
+			remap[i] = int(m_Entries.size());
+			m_Entries.push_back(old.GetFile(i));
+		}
+	}
+	bool changed = !old.IsLoaded() || m_Entries.size() != old.GetFileCount();
+
+	for (size_t i = 0; i < m_Job.files.size(); ++i)
+	{
+		if (m_Failed || m_Indexer.IsCancelled())
+			return false;
+
+		int id = old.FindFile(m_Job.files[i]);
+		if (id >= 0 && remap[id] >= 0)
+			continue;
+
+		TrigramIndex::FileEntry entry;
+		if (IndexFile(m_Job.files[i], uint32_t(m_Entries.size()), entry))
+		{
+			m_Entries.push_back(entry);
+			changed = true;
+		}
+	}
+
+	if (!changed || m_Failed)
+		return !m_Failed;
+
+	return WriteIndex(old, remap);
+}
+
+bool TrigramIndexBuilder::IndexFile(const std::wstring& filename, uint32_t id, TrigramIndex::FileEntry& entry)
+{
+	// the files shown in hex are searched every time
+	if (!GetFileStatus(filename, entry.size, entry.mtime) || entry.size >= m_Job.settings.maxtextsize
+		|| entry.mtime + min_file_age > time(nullptr))
+		return false;
+
+	wxFile file;
+	if (!file.Open(wxString(filename.c_str()), wxFile::read))
+		return false;
+
+	if (m_Seen.empty())
+		m_Seen.resize((size_t(1) << 24) / 8);
+	m_Data.resize(read_block_size + 2);
+	m_Trigrams.clear();
+
+	size_t keep = 0;
+	bool first = true, cancelled = false;
+	for (;;)
+	{
+		ssize_t len = file.Read(&m_Data[keep], read_block_size);
+		if (len <= 0)
+			break;
+
+		const size_t count = keep + size_t(len);
+		if (first)
+		{
+			bool binary;
+			entry.encoding = m_Job.settings.Detect(&m_Data[0], count, file, binary, m_Detector);
+			first = false;
+		}
+
+		for (size_t i = 2; i < count; ++i)
+		{
+			Trigram t = MakeTrigram(m_Data[i - 2], m_Data[i - 1], m_Data[i]);
+			if ((m_Seen[t >> 3] & (1 << (t & 7))) == 0)
+			{
+				m_Seen[t >> 3] |= wxByte(1 << (t & 7));
+				m_Trigrams.push_back(t);
+			}
+		}
+
+		keep = std::min<size_t>(count, 2);
+		memmove(&m_Data[0], &m_Data[count - keep], keep);
+
+		if (m_Indexer.IsCancelled())
+		{
+			cancelled = true;
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < m_Trigrams.size(); ++i)
+		m_Seen[m_Trigrams[i] >> 3] = 0;
+
+	// the file is changed while reading
+	wxFileOffset size;
+	time_t mtime;
+	if (cancelled || !GetFileStatus(filename, size, mtime) || size != entry.size || mtime != entry.mtime)
+		return false;
+
+	for (size_t i = 0; i < m_Trigrams.size(); ++i)
+		m_Pairs.push_back(MakePair(m_Trigrams[i], id));
+	entry.name = filename;
+
+	if (m_Pairs.size() >= max_memory_pairs)
+		SpillPairs();
+
+	return true;
+}
+
+void TrigramIndexBuilder::SpillPairs()
+{
+	std::sort(m_Pairs.begin(), m_Pairs.end());
+
+	std::wstring filename = m_Job.path + wxString::Format(wxT(".run%u"), unsigned(m_Runs.size())).wc_str();
+	wxFile file;
+	if (!file.Create(wxString(filename.c_str()), true))
+	{
+		m_Failed = true;
+		return;
+	}
+	m_Runs.push_back(filename);
+	m_RunSizes.push_back(m_Pairs.size());
+
+	const size_t bytes = m_Pairs.size() * sizeof(uint64_t);
+	if (file.Write(&m_Pairs[0], bytes) != bytes)
+		m_Failed = true;
+	m_Pairs.clear();
+}
+
+bool TrigramIndexBuilder::WriteIndex(TrigramIndex& old, const std::vector<int>& remap)
+{
+	std::sort(m_Pairs.begin(), m_Pairs.end());
+
+	std::vector<std::unique_ptr<PairSource> > sources;
+	if (old.IsLoaded())
+		sources.push_back(std::unique_ptr<PairSource>(new TrigramIndexPairs(old.m_File, old.m_DirPos, old.m_TrigramCount, remap)));
+	for (size_t i = 0; i < m_Runs.size(); ++i)
+		sources.push_back(std::unique_ptr<PairSource>(new RunPairs(m_Runs[i], m_RunSizes[i])));
+	sources.push_back(std::unique_ptr<PairSource>(new MemoryPairs(m_Pairs)));
+
+	const wxString tmpname = wxString(m_Job.path.c_str()) + wxT(".tmp");
+	wxFile out;
+	if (!out.Create(tmpname, true))
+		return false;
+	FileWriter writer(out);
+
+	std::string header;
+	PutString(header, m_Job.dir);
+	PutString(header, m_Job.key);
+	PutUInt(header, m_Entries.size(), 4);
+	for (size_t i = 0; i < m_Entries.size(); ++i)
+	{
+		const TrigramIndex::FileEntry& entry = m_Entries[i];
+		PutString(header, entry.name);
+		PutUInt(header, uint64_t(entry.size), 8);
+		PutUInt(header, uint64_t(int64_t(entry.mtime)), 8);
+		PutString(header, entry.encoding);
+	}
+	std::string prefix(index_magic, sizeof(index_magic));
+	PutUInt(prefix, header.size(), 8);
+	writer.Write(prefix);
+	writer.Write(header);
+
+	// merge the sorted sources to the postings
+	typedef std::pair<uint64_t, size_t> Head;
+	std::priority_queue<Head, std::vector<Head>, std::greater<Head> > heads;
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		uint64_t pair;
+		if (sources[i]->Next(pair))
+			heads.push(Head(pair, i));
+	}
+
+	std::string dir, buf;
+	Trigram trigram = 0;
+	uint32_t count = 0;
+	wxFileOffset pos = 0;
+	int64_t last = -1;
+	bool cancelled = false;
+	for (size_t n = 1; !heads.empty(); ++n)
+	{
+		Head head = heads.top();
+		heads.pop();
+		uint64_t pair;
+		if (sources[head.second]->Next(pair))
+			heads.push(Head(pair, head.second));
+
+		Trigram t = Trigram(head.first >> 32);
+		uint32_t id = uint32_t(head.first);
+		if (count == 0 || t != trigram)
+		{
+			if (count > 0)
+			{
+				PutUInt(dir, trigram, 4);
+				PutUInt(dir, count, 4);
+				PutUInt(dir, uint64_t(pos), 8);
+			}
+			trigram = t;
+			count = 0;
+			pos = writer.Tell();
+			last = -1;
+		}
+
+		buf.clear();
+		PutVarint(buf, uint64_t(int64_t(id) - last - 1));
+		writer.Write(buf);
+		last = id;
+		++count;
+
+		if ((n & 0xFFFFF) == 0 && m_Indexer.IsCancelled())
+		{
+			cancelled = true;
+			break;
+		}
+	}
+	if (count > 0)
+	{
+		PutUInt(dir, trigram, 4);
+		PutUInt(dir, count, 4);
+		PutUInt(dir, uint64_t(pos), 8);
+	}
+
+	std::string trailer;
+	PutUInt(trailer, uint64_t(writer.Tell()), 8);
+	PutUInt(trailer, dir.size() / posting_size, 8);
+	writer.Write(dir);
+	writer.Write(trailer);
+
+	bool ok = writer.Flush() && !cancelled;
+	for (size_t i = 0; i < sources.size(); ++i)
+		ok = ok && !sources[i]->Failed();
+	out.Close();
+
+	// the old index is replaced
+	old.Close();
+	if (!ok || !wxRenameFile(tmpname, wxString(m_Job.path.c_str()), true))
+	{
+		wxRemoveFile(tmpname);
+		return false;
+	}
+
+	return true;
+}
+
+//==================================================
+
+class TrigramIndexThread: public wxThread
+{
+public:
+	TrigramIndexThread(TrigramIndexer& indexer)
+		: wxThread(wxTHREAD_JOINABLE), m_Indexer(indexer)
+	{}
+
+	virtual ExitCode Entry() override
+	{
+		TrigramIndexer::Job* job;
+		while (m_Indexer.NextJob(job))
+		{
+			std::unique_ptr<TrigramIndexer::Job> holder(job);
+			TrigramIndexBuilder builder(m_Indexer, *job);
+			builder.Build();
+		}
+
+		return (ExitCode)0;
+	}
+
+private:
+	TrigramIndexer& m_Indexer;
+};
+
+TrigramIndexer& TrigramIndexer::Instance()
+{
+	static TrigramIndexer s_inst;
+	return s_inst;
+}
+
+TrigramIndexer::~TrigramIndexer()
+{
+	for (size_t i = 0; i < m_Jobs.size(); ++i)
+		delete m_Jobs[i];
+}
+
+void TrigramIndexer::Update(const wxString& dir, const std::vector<wxString>& files)
+{
+	const wxString path = TrigramIndex::IndexPath(dir);
+	const wxString indexdir = wxFileName(path).GetPath();
+	if (!wxDirExists(indexdir))
+	{
+		wxLogNull nolog;
+		if (!wxMkdir(indexdir))
+			return;
+	}
+
+	std::unique_ptr<Job> job(new Job);
+	job->path = path.wc_str();
+	job->dir = TrigramIndex::NormalDir(dir);
+	job->settings.Read();
+	job->key = job->settings.Key();
+	job->files.reserve(files.size());
+	for (size_t i = 0; i < files.size(); ++i)
+		job->files.push_back(files[i].wc_str());
+
+	wxMutexLocker lock(m_Lock);
+	if (m_Cancelled)
+		return;
+
+	m_Jobs.push_back(job.release());
+	if (m_Running)
+		return;
+
+	// the last thread has finished all the jobs
+	if (m_Thread != nullptr)
+	{
+		m_Thread->Wait();
+		delete m_Thread;
+		m_Thread = nullptr;
+	}
+
+	std::unique_ptr<wxThread> thread(new TrigramIndexThread(*this));
+	if (thread->Create() != wxTHREAD_NO_ERROR)
+	{
+		delete m_Jobs.back();
+		m_Jobs.pop_back();
+		return;
+	}
+
+	m_Thread = thread.release();
+	m_Running = true;
+	m_Thread->Run();
+}
+
+void TrigramIndexer::Shutdown()
+{
+	wxThread* thread;
+	{
+		wxMutexLocker lock(m_Lock);
+		m_Cancelled = true;
+		thread = m_Thread;
+		m_Thread = nullptr;
+	}
+
+	if (thread != nullptr)
+	{
+		thread->Wait();
+		delete thread;
+	}
+}
+
+bool TrigramIndexer::NextJob(Job*& job)
+{
+	wxMutexLocker lock(m_Lock);
+	if (m_Cancelled || m_Jobs.empty())
+	{
+		m_Running = false;
+		return false;
+	}
+
+	job = m_Jobs.front();
+	m_Jobs.pop_front();
+	return true;
+}
+
+bool TrigramIndexer::IsCancelled()
+{
+	wxMutexLocker lock(m_Lock);
+	return m_Cancelled;
+}
+
+} //namespace wxm
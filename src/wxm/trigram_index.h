@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        wxm/trigram_index.h
+// Description: Trigram Index of the Files for Find in Files of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_TRIGRAM_INDEX_H_
+#define _WXM_TRIGRAM_INDEX_H_
+
+#include "../xm/cxx11.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/string.h>
+#include <wx/file.h>
+#include <wx/thread.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <boost/unordered_map.hpp>
+#include <vector>
+#include <string>
+#include <deque>
+#include <ctime>
+#include <stdint.h>
+
+namespace wxm
+{
+
+// three bytes with the ASCII letters in lower case, so that a trigram of a
+// literal is found whatever the case of the letters is
+typedef uint32_t Trigram;
+
+inline Trigram MakeTrigram(wxByte b0, wxByte b1, wxByte b2)
+{
+	return (Trigram((b0 >= 'A' && b0 <= 'Z') ? (b0 | 0x20) : b0) << 16)
+		| (Trigram((b1 >= 'A' && b1 <= 'Z') ? (b1 | 0x20) : b1) << 8)
+		| Trigram((b2 >= 'A' && b2 <= 'Z') ? (b2 | 0x20) : b2);
+}
+
+// the index of the byte trigrams of the files searched under a directory, stored
+// in the config dir; only the file list is loaded, the file ids of a trigram
+// are read from the disk when looked up
+class TrigramIndex
+{
+public:
+	struct FileEntry
+	{
+		std::wstring name;
+		wxFileOffset size;
+		time_t mtime;
+		std::wstring encoding;  // the name detected by FileEncodingSettings::Detect()
+
+		FileEntry(): size(0), mtime(0) {}
+	};
+
+	TrigramIndex(): m_DirPos(0), m_TrigramCount(0) {}
+
+	// the index file of the directory, must be called on the main thread
+	static wxString IndexPath(const wxString& dir);
+	static std::wstring NormalDir(const wxString& dir);
+
+	// return false if there is no valid index of the directory
+	bool Load(const std::wstring& path, const std::wstring& dir);
+	bool IsLoaded() const { return m_File.IsOpened(); }
+	void Close();
+
+	const std::wstring& Key() const { return m_Key; }
+	size_t GetFileCount() const { return m_Entries.size(); }
+	const FileEntry& GetFile(size_t id) const { return m_Entries[id]; }
+
+	// the id of the file if it is indexed and not changed since then, otherwise -1
+	int FindFile(const std::wstring& filename) const;
+
+	// the sorted ids of the files containing all the trigrams;
+	// return false if the index cannot be read
+	bool Lookup(std::vector<Trigram> trigrams, std::vector<uint32_t>& ids);
+
+private:
+	friend class TrigramIndexBuilder;
+
+	// the entry of the trigram directory at the end of the file
+	struct Posting
+	{
+		Trigram trigram;
+		uint32_t count;
+		wxFileOffset pos;
+	};
+	bool ReadPosting(size_t idx, Posting& posting);
+	bool FindPosting(Trigram trigram, Posting& posting, bool& found);
+	bool ReadIds(const Posting& posting, std::vector<uint32_t>& ids);
+
+	wxFile m_File;
+	std::wstring m_Key;
+	std::vector<FileEntry> m_Entries;
+	boost::unordered_map<std::wstring, uint32_t> m_Ids;
+	wxFileOffset m_DirPos;
+	size_t m_TrigramCount;
+};
+
+// the size and the modification time of the file
+bool GetFileStatus(const std::wstring& filename, wxFileOffset& size, time_t& mtime);
+
+// builds the trigram indexes on a background thread, one directory at a time;
+// the files not changed since indexed are not read again
+class TrigramIndexer
+{
+public:
+	static TrigramIndexer& Instance();
+
+	// index the files of the directory with the ones indexed before, must be
+	// called on the main thread
+	void Update(const wxString& dir, const std::vector<wxString>& files);
+
+	// cancel the indexing and wait for the thread, called when wxMEdit exits
+	void Shutdown();
+
+private:
+	friend class TrigramIndexThread;
+	friend class TrigramIndexBuilder;
+	struct Job;
+
+	TrigramIndexer(): m_Thread(nullptr), m_Running(false), m_Cancelled(false) {}
+	~TrigramIndexer();
+
+	// called by the thread, return false if there is no more job
+	bool NextJob(Job*& job);
+	bool IsCancelled();
+
+	wxMutex m_Lock;     // guards the members below
+	std::deque<Job*> m_Jobs;
+	wxThread* m_Thread;
+	bool m_Running;
+	bool m_Cancelled;
+};
+
+} //namespace wxm
+
+#endif //_WXM_TRIGRAM_INDEX_H_
@@ -0,0 +1,986 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         ts=4 sw=4 expandtab
+// Name:        wxmedit/wxm_data.cpp
+// Description: The Data Storage of the Text/Data Buffer of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+//              2005-2010  Alston Chen <madedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxm_data.h"
+#include "../xm/cxx11.h"
+#include "../xm/encdet.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/filename.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __WXMSW__
+# include <wx/msw/wrapwin.h>
+#else
+# include <unistd.h>
+#endif
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+//===========================================================================
+// MadFileNameIsUTF8, MadDirExists, MadConvFileName_WC2MB_UseLibc
+// for Testing/Converting of FileName Encoding under Linux
+//===========================================================================
+
+bool g_WC2MB_2_utf8=true;
+bool g_MB2WC_is_utf8=false;
+bool g_MB2WC_check_dir_filename=false;//check dir, filename separately
+
+// return 0: filename not found, 1:yes, -1:no
+int MadFileNameIsUTF8(const wxString& filename)
+{
+    g_WC2MB_2_utf8=false;
+    wxLogNull nolog;
+    if(wxFileModificationTime(filename)!=0)
+    {
+        return -1;//libc or under win32
+    }
+
+#ifndef __WXMSW__
+    // retry by using utf8 filename
+    g_WC2MB_2_utf8=true;
+    if(wxFileModificationTime(filename)!=0)
+    {
+        return 1;//utf8
+    }
+#endif
+
+    return 0;//not found
+}
+
+// return 0: name is not a dir or not found, 1:yes(utf8), -1:yes(libc)
+int MadDirExists(const wxString& name)
+{
+#ifdef __WXMSW__
+    if(wxDirExists(name))
+        return -1;
+#else
+    int test=MadFileNameIsUTF8(name);
+
+    g_WC2MB_2_utf8 = (test>0);
+
+    if(test==0)
+    {
+        if(wxDirExists(name))
+            return -1;
+
+        return 0;
+    }
+
+    if(wxDirExists(name))
+        return test;
+#endif
+
+    return 0;
+}
+
+#ifndef __WXMSW__
+size_t MadConvFileName::MB2WC(wchar_t *outputBuf, const char *psz, size_t outputSize) const
+{
+    size_t len=strlen(psz);
+
+    if(g_MB2WC_check_dir_filename==false)
+    {
+        g_MB2WC_is_utf8=xm::IsUTF8((ubyte *)psz, int(len));
+
+        if(g_MB2WC_is_utf8)
+        {
+            return wxConvUTF8.MB2WC(outputBuf, psz, outputSize);
+        }
+
+        return wxConvLibc.MB2WC(outputBuf, psz, outputSize);
+    }
+
+    //check dir, filename separately
+    size_t dirlen=0, fnlen=0;
+    if(len>0)
+    {
+        for(int i=int(len-1);i>=0;i--, fnlen++)
+        {
+            if(psz[i]=='/')
+                break;
+        }
+        dirlen=len-fnlen;
+    }
+
+    size_t dirret=0;
+    if(dirlen!=0)
+    {
+        vector<char> cbuf;
+        cbuf.resize(dirlen+1);
+        char *pbuf = (char *) &cbuf[0];
+        memcpy(pbuf, psz, dirlen);
+        cbuf[dirlen]=0;
+
+        bool is_utf8=xm::IsUTF8((ubyte *)pbuf, int(dirlen));
+        if(is_utf8)
+        {
+            dirret=wxConvUTF8.MB2WC(outputBuf, pbuf, outputSize);
+        }
+        else
+        {
+            dirret=wxConvLibc.MB2WC(outputBuf, pbuf, outputSize);
+        }
+    }
+
+    if(dirret==size_t(-1))
+        return size_t(-1);
+
+    size_t fnret=0;
+    if(fnlen!=0)
+    {
+        bool is_utf8=xm::IsUTF8((ubyte *)psz+dirlen, int(fnlen));
+        wchar_t *obuf=outputBuf;
+        if(outputBuf!=nullptr)
+            obuf+=dirret;
+
+        if(is_utf8)
+        {
+            fnret=wxConvUTF8.MB2WC(obuf, psz+dirlen, outputSize-dirret);
+        }
+        else
+        {
+            fnret=wxConvLibc.MB2WC(obuf, psz+dirlen, outputSize-dirret);
+        }
+    }
+
+    if(fnret==size_t(-1))
+        return size_t(-1);
+
+    return dirret+fnret;
+}
+
+size_t MadConvFileName::WC2MB(char *outputBuf, const wchar_t *psz, size_t outputSize) const
+{
+    if(g_WC2MB_2_utf8)
+        return wxConvUTF8.WC2MB(outputBuf, psz, outputSize);
+
+    return wxConvLibc.WC2MB(outputBuf, psz, outputSize);
+}
+#endif
+
+//===========================================================================
+// MadMemData
+//===========================================================================
+
+MadMemData::MadMemData()
+{
+    m_Size = 0;
+}
+
+MadMemData::~MadMemData()
+{
+    size_t i, count;
+    for(i = 0, count = m_Buffers.size(); i < count; ++i)
+    {
+        delete []m_Buffers[i];
+    }
+    m_Buffers.clear();
+}
+
+wxByte MadMemData::Get(const wxFileOffset &pos)
+{
+    wxASSERT((pos >= 0) && (pos < m_Size));
+
+    int buf = int(pos >> BUFFER_BITS);    //pos / BUFFER_SIZE;
+    int idx = int(pos & BUFFER_MASK);    //pos % BUFFER_SIZE;
+
+    return m_Buffers[buf][idx];
+}
+
+void MadMemData::Get(const wxFileOffset &pos, wxByte *buffer, size_t size)
+{
+    wxASSERT((pos >= 0) && (size > 0) && ((wxFileOffset)(pos + size) <= m_Size));
+
+    int buf = int(pos >> BUFFER_BITS);    //pos / BUFFER_SIZE;
+    int idx = int(pos & BUFFER_MASK);    //pos % BUFFER_SIZE;
+
+    size_t buf_size = BUFFER_SIZE - idx;
+
+    while(true)
+    {
+        if(buf_size > size) buf_size = size;
+
+        /***
+        if(buf_size <= sizeof(int)*40) buggy!!!
+        {
+            int *src=(int*)buffer;
+            int *des=(int*)(m_Buffers[buf] + idx);
+            size_t s=buf_size;
+
+            if(s >= sizeof(int)*20)     //max:40
+            {
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                s-=sizeof(int)*20;
+            }
+            if(s >= sizeof(int)*10)     //max:20
+            {
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                s-=sizeof(int)*10;
+            }
+            if(s >= sizeof(int)*10)     //max:10
+            {
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                *src++ = *des++; *src++ = *des++;
+                s-=sizeof(int)*10;
+            }
+            if(s >= sizeof(int)*5)      //max:9
+            {
+                *src++ = *des++;
+                *src++ = *des++;
+                *src++ = *des++;
+                *src++ = *des++;
+                *src++ = *des++;
+                s-=sizeof(int)*5;
+            }
+            if(s >= sizeof(int))        //max:4
+            {
+                *src++ = *des++;
+                s-=sizeof(int);
+                if(s >= sizeof(int))        //max:3
+                {
+                    *src++ = *des++;
+                    s-=sizeof(int);
+                    if(s >= sizeof(int))        //max:2
+                    {
+                        *src++ = *des++;
+                        s-=sizeof(int);
+                        if(s >= sizeof(int))        //max:1
+                        {
+                            *src++ = *des++;
+                            s-=sizeof(int);
+                        }
+                    }
+                }
+            }
+            if(s)       //max:3byte
+            {
+                buffer=(wxByte*)src;
+                wxByte *bdes=(wxByte*)des;
+
+                *buffer++=*bdes++;
+                s--;
+                if(s)   //max:2b
+                {
+                    *buffer++=*bdes++;
+                    s--;
+                    if(s)   //max:1byte
+                    {
+                        *buffer=*bdes;
+                        s--;            //over
+                    }
+                }
+            }
+
+            wxASSERT(s==0);
+        }
+        else
+            ***/
+        {
+            memcpy(buffer, m_Buffers[buf] + idx, buf_size);
+        }
+
+        if((size -= buf_size) ==0) break;
+
+        ++buf;
+        idx = 0;
+        buffer += buf_size;
+        buf_size = BUFFER_SIZE;
+    }
+}
+
+wxFileOffset MadMemData::Put(wxByte * buffer, size_t size)
+{
+    wxASSERT(size > 0);
+
+    size_t buf = size_t(m_Size >> BUFFER_BITS);        //m_Size / BUFFER_SIZE;
+    int idx = int(m_Size & BUFFER_MASK);            //m_Size % BUFFER_SIZE;
+    size_t buf_size = BUFFER_SIZE - idx;
+    wxByte *tmp = idx!=0 ? m_Buffers[buf] : 0;
+
+    wxFileOffset pos = m_Size;
+    m_Size += size;
+    do
+    {
+        if(idx == 0)
+        {
+            if(buf < m_Buffers.size())
+            {
+                tmp = m_Buffers[buf];
+                if(tmp == nullptr)  // freed by Compact() before Reset()
+                    tmp = m_Buffers[buf] = new wxByte[BUFFER_SIZE];
+            }
+            else
+            {
+                tmp = new wxByte[BUFFER_SIZE];
+                m_Buffers.push_back(tmp);                // add a new buffer
+            }
+            buf_size = BUFFER_SIZE;
+        }
+
+        if(size < buf_size) buf_size = size;
+
+        memcpy(tmp + idx, buffer, buf_size);
+        buffer += buf_size;
+        size -= buf_size;
+        idx = 0;
+        ++buf;
+    }
+    while(size > 0);
+
+    return pos;
+}
+
+namespace
+{
+
+// a range of the bytes of MadMemData, which is moved to NewPos by compacting
+struct MadMemRange
+{
+    wxFileOffset Pos, End, NewPos;
+
+    MadMemRange(wxFileOffset pos, wxFileOffset end) :Pos(pos), End(end), NewPos(0) {}
+    bool operator<(const MadMemRange &r) const { return Pos < r.Pos; }
+};
+
+} // anonymous namespace
+
+bool MadMemData::Compact(const vector<xm::BlockVector*> &blocks, size_t maxsize)
+{
+    vector<MadMemRange> ranges;
+    for(size_t i=0; i<blocks.size(); ++i)
+    {
+        for(xm::BlockIterator bit = blocks[i]->begin(); bit != blocks[i]->end(); ++bit)
+        {
+            if(bit->m_Data == this && bit->m_Size > 0)
+                ranges.push_back(MadMemRange(bit->m_Pos, bit->m_Pos + bit->m_Size));
+        }
+    }
+
+    // merge the overlapped ranges
+    std::sort(ranges.begin(), ranges.end());
+    vector<MadMemRange> merged;
+    for(size_t i=0; i<ranges.size(); ++i)
+    {
+        if(!merged.empty() && ranges[i].Pos <= merged.back().End)
+        {
+            if(ranges[i].End > merged.back().End)
+                merged.back().End = ranges[i].End;
+        }
+        else
+        {
+            merged.push_back(ranges[i]);
+        }
+    }
+    vector<MadMemRange>().swap(ranges);
+
+    // the bytes in use of every full buffer, the last one is still appended
+    const size_t fullbufs = size_t(m_Size >> BUFFER_BITS);
+    vector<size_t> used(fullbufs, 0);
+    for(size_t i=0; i<merged.size(); ++i)
+    {
+        for(wxFileOffset pos = merged[i].Pos; pos < merged[i].End; )
+        {
+            const size_t buf = size_t(pos >> BUFFER_BITS);
+            const wxFileOffset end = std::min(merged[i].End, (pos & BUFFER_BASE_MASK) + BUFFER_SIZE);
+            if(buf < fullbufs)
+                used[buf] += size_t(end - pos);
+            pos = end;
+        }
+    }
+
+    // a range is moved as a whole, so a buffer is freed only if the ranges
+    // in it fit in the rest of maxsize
+    vector<bool> moving(merged.size(), false);
+    vector<size_t> freeing;
+    size_t movesize = 0;
+    bool more = false;
+    vector<MadMemRange>::iterator rit = merged.begin();
+    for(size_t buf = 0; buf < fullbufs; ++buf)
+    {
+        const wxFileOffset bufpos = wxFileOffset(buf) << BUFFER_BITS;
+        while(rit != merged.end() && rit->End <= bufpos)
+            ++rit;
+
+        if(m_Buffers[buf] == nullptr || used[buf] > size_t(BUFFER_SIZE / 2))
+            continue;
+
+        size_t size = 0;
+        for(vector<MadMemRange>::iterator it = rit; it != merged.end() && it->Pos < bufpos + BUFFER_SIZE; ++it)
+        {
+            if(!moving[it - merged.begin()])
+                size += size_t(it->End - it->Pos);
+        }
+
+        if(movesize + size > maxsize)
+        {
+            // the ranges of a buffer may be too large to be moved at all
+            if(size <= maxsize)
+                more = true;
+            continue;
+        }
+
+        for(vector<MadMemRange>::iterator it = rit; it != merged.end() && it->Pos < bufpos + BUFFER_SIZE; ++it)
+            moving[it - merged.begin()] = true;
+        movesize += size;
+        freeing.push_back(buf);
+    }
+
+    // copy the bytes to the end
+    vector<wxByte> buffer(BUFFER_SIZE);
+    for(size_t i=0; i<merged.size(); ++i)
+    {
+        if(!moving[i])
+            continue;
+
+        merged[i].NewPos = m_Size;
+        for(wxFileOffset pos = merged[i].Pos; pos < merged[i].End; )
+        {
+            size_t bs = BUFFER_SIZE;
+            if(merged[i].End - pos < BUFFER_SIZE)
+                bs = size_t(merged[i].End - pos);
+
+            Get(pos, &buffer[0], bs);
+            Put(&buffer[0], bs);
+            pos += bs;
+        }
+    }
+
+    for(size_t i=0; i<blocks.size(); ++i)
+    {
+        for(xm::BlockIterator bit = blocks[i]->begin(); bit != blocks[i]->end(); ++bit)
+        {
+            if(bit->m_Data != this || bit->m_Size == 0)
+                continue;
+
+            vector<MadMemRange>::iterator it =
+                std::upper_bound(merged.begin(), merged.end(), MadMemRange(bit->m_Pos, 0));
+            --it;
+            if(moving[it - merged.begin()])
+                bit->m_Pos = it->NewPos + (bit->m_Pos - it->Pos);
+        }
+    }
+
+    for(size_t i=0; i<freeing.size(); ++i)
+    {
+        delete []m_Buffers[freeing[i]];
+        m_Buffers[freeing[i]] = nullptr;
+    }
+
+    return more;
+}
+
+size_t MadMemData::GetBufferedSize()
+{
+    size_t size = 0;
+    for(size_t i=0; i<m_Buffers.size(); ++i)
+    {
+        if(m_Buffers[i] != nullptr)
+            size += BUFFER_SIZE;
+    }
+    return size;
+}
+
+
+//===========================================================================
+// MadFileData
+//===========================================================================
+
+MadFileData::MadFileData(const wxString &name)
+{
+    m_Name = name;
+    m_Size = 0;
+    m_OpenSuccess = true;
+    m_ReadOnly = false;
+    m_Buffer1 = nullptr;
+    m_Buffer2 = nullptr;
+
+    int utf8test=MadFileNameIsUTF8(name);
+
+    if(utf8test==0)// this file/dir is not exist
+    {
+        return;
+    }
+
+    MadConvFileName_WC2MB_UseLibc uselibc(utf8test<0);
+
+    if(wxDirExists(name))// test this name is a dir or not
+    {
+        m_OpenSuccess = false;
+        return;
+    }
+
+    if(OpenFile())
+    {
+        m_Size = m_File.SeekEnd();    // get size
+        m_File.Seek(0);                // move to begin
+
+        m_Buffer1 = new wxByte[BUFFER_SIZE];
+        m_Buf1Pos = 0;
+        m_Buffer2 = new wxByte[BUFFER_SIZE];
+        m_Buf2Pos = -1;
+
+        // read first data-block to buffer1
+        size_t size = BUFFER_SIZE;
+        if(BUFFER_SIZE > m_Size) size = size_t(m_Size);
+        m_File.Read(m_Buffer1, size);
+    }
+}
+
+MadFileData::~MadFileData()
+{
+    if(m_File.IsOpened())   m_File.Close();
+    if(m_Buffer1)       delete []m_Buffer1;
+    if(m_Buffer2)       delete []m_Buffer2;
+}
+
+wxByte MadFileData::Get(const wxFileOffset &pos)
+{
+    wxASSERT((pos >= 0) && (pos < m_Size));
+
+    wxFileOffset idx;
+    if(m_Buf1Pos>=0)
+    {
+        idx = pos - m_Buf1Pos;
+        if(idx >= 0 && idx < BUFFER_SIZE)       // wanted byte in buffer1
+        {
+            return m_Buffer1[(size_t)idx];
+        }
+    }
+
+    if(m_Buf2Pos>=0)
+    {
+        idx = pos - m_Buf2Pos;
+        if(idx >= 0 && idx < BUFFER_SIZE)       // wanted byte in buffer2
+        {
+            return m_Buffer2[(size_t)idx];
+        }
+    }
+
+    if(m_Buf1Pos>=0)
+    {
+        // swap buffer1 buffer2
+        wxByte *tmp=m_Buffer2;
+        m_Buffer2=m_Buffer1;
+        m_Buffer1=tmp;
+
+        m_Buf2Pos=m_Buf1Pos;
+    }
+
+    // read data-block to buffer1
+    m_Buf1Pos = pos & BUFFER_BASE_MASK; //(pos >> BUFFER_BITS) << BUFFER_BITS;    //(pos / BUFFER_SIZE) * BUFFER_SIZE;
+    m_File.Seek(m_Buf1Pos);
+
+    wxFileOffset size = m_Size - m_Buf1Pos;
+    if(size > BUFFER_SIZE)    size = BUFFER_SIZE;
+
+    m_File.Read(m_Buffer1, size_t(size));
+
+    idx = pos - m_Buf1Pos;
+    return m_Buffer1[(size_t)idx];
+}
+
+void MadFileData::Get(const wxFileOffset &pos, wxByte * buffer, size_t size)
+{
+    wxASSERT((pos >= 0) && (size > 0) && ((wxFileOffset)(pos + size) <= m_Size));
+
+    wxFileOffset idx;
+    if(m_Buf1Pos>=0)
+    {
+        idx = pos - m_Buf1Pos;
+        if(idx >= 0 && wxFileOffset(idx+size)<=BUFFER_SIZE )        // wanted bytes in buffer1
+        {
+            memcpy(buffer, m_Buffer1+idx, size);
+            return;
+        }
+    }
+
+    if(m_Buf2Pos>=0)
+    {
+        idx = pos - m_Buf2Pos;
+        if(idx >= 0 && wxFileOffset(idx+size)<=BUFFER_SIZE )    // wanted bytes in buffer2
+        {
+            memcpy(buffer, m_Buffer2+idx, size);
+            return;
+        }
+    }
+
+    idx = pos & BUFFER_BASE_MASK; //(pos >> BUFFER_BITS) << BUFFER_BITS;        //(pos / BUFFER_SIZE) * BUFFER_SIZE;
+    if(wxFileOffset(pos+size) <= idx+BUFFER_SIZE)   // wanted bytes in one block
+    {
+        if(m_Buf1Pos>=0)
+        {
+            // swap buffer1 buffer2
+            wxByte *tmp=m_Buffer2;
+            m_Buffer2=m_Buffer1;
+            m_Buffer1=tmp;
+
+            m_Buf2Pos=m_Buf1Pos;
+        }
+
+        // read data-block to buffer1
+        m_Buf1Pos = idx;
+        m_File.Seek(m_Buf1Pos);
+
+        wxFileOffset bufsize = m_Size - m_Buf1Pos;
+        if(bufsize > BUFFER_SIZE)    bufsize = BUFFER_SIZE;
+
+        m_File.Read(m_Buffer1, size_t(bufsize));
+
+        idx = pos - m_Buf1Pos;
+        memcpy(buffer, m_Buffer1+idx, size);
+        return;
+    }
+
+    // wanted bytes cross more than one block
+    m_File.Seek(pos);
+    m_File.Read(buffer, size);
+}
+
+wxFileOffset MadFileData::Put(wxByte *buffer, size_t size)
+{
+    wxFileOffset pos=m_SavePos;
+
+    m_File.Seek(m_SavePos);
+    m_File.Write(buffer, size);
+    m_SavePos+=size;
+
+    if(m_Size < m_SavePos)
+    {
+        m_Size = m_SavePos;
+    }
+
+    m_Buf1Pos=m_Buf2Pos=-1;
+
+    return pos;
+}
+
+bool MadFileData::OpenFile()
+{
+    wxLogNull nolog;// disable error message of file.Open()
+
+    m_ReadOnly = false;
+    m_OpenSuccess = m_File.Open(m_Name.c_str(), wxFile::read_write);    // read&write
+    if(m_OpenSuccess == false)
+    {
+        m_OpenSuccess = m_File.Open(m_Name.c_str(), wxFile::read);    // read only
+        if(m_OpenSuccess == false)
+        {
+            return false;
+        }
+
+        m_ReadOnly = true;
+    }
+
+    return true;
+}
+
+bool MadFileData::Rename(const wxString &name)
+{
+    //wxASSERT(handle_ != INVALID_HANDLE_VALUE);
+
+    m_File.Close();
+
+    MadConvFileName_WC2MB_UseLibc uselibc(MadFileNameIsUTF8(m_Name)<0);
+
+    if(wxRenameFile(m_Name, name))
+    {
+        m_Name = name;
+        OpenFile();
+        return true;
+    }
+
+    // can't rename the file, reopen the file
+    OpenFile();
+    return false;
+}
+
+
+//===========================================================================
+// MadMemDataSnapshot, MadFileDataReader
+//===========================================================================
+
+MadMemDataSnapshot::MadMemDataSnapshot(MadMemData *md)
+    :m_Buffers(md->m_Buffers)
+{
+    m_Size = md->m_Size;
+}
+
+wxByte MadMemDataSnapshot::Get(const wxFileOffset &pos)
+{
+    wxASSERT((pos >= 0) && (pos < m_Size));
+
+    return m_Buffers[size_t(pos >> BUFFER_BITS)][size_t(pos & BUFFER_MASK)];
+}
+
+void MadMemDataSnapshot::Get(const wxFileOffset &pos, wxByte *buffer, size_t size)
+{
+    wxASSERT((pos >= 0) && (size > 0) && ((wxFileOffset)(pos + size) <= m_Size));
+
+    size_t buf = size_t(pos >> BUFFER_BITS);
+    size_t idx = size_t(pos & BUFFER_MASK);
+    size_t buf_size = BUFFER_SIZE - idx;
+
+    while(true)
+    {
+        if(buf_size > size) buf_size = size;
+
+        memcpy(buffer, m_Buffers[buf] + idx, buf_size);
+
+        if((size -= buf_size) == 0) break;
+
+        ++buf;
+        idx = 0;
+        buffer += buf_size;
+        buf_size = BUFFER_SIZE;
+    }
+}
+
+MadFileDataReader::MadFileDataReader(MadFileData *fd)
+{
+    wxLogNull nolog;
+    MadConvFileName_WC2MB_UseLibc uselibc(MadFileNameIsUTF8(fd->m_Name)<0);
+
+    m_File.Open(fd->m_Name.c_str(), wxFile::read);
+    m_Size = fd->m_Size;
+}
+
+wxByte MadFileDataReader::Get(const wxFileOffset &pos)
+{
+    wxByte b = 0;
+    Get(pos, &b, 1);
+    return b;
+}
+
+void MadFileDataReader::Get(const wxFileOffset &pos, wxByte *buffer, size_t size)
+{
+    wxASSERT((pos >= 0) && (size > 0) && ((wxFileOffset)(pos + size) <= m_Size));
+
+    m_File.Seek(pos);
+    m_File.Read(buffer, size);
+}
+
+//===========================================================================
+// RemapFileBlocks
+//===========================================================================
+
+void RemapFileBlocks(xm::BlockVector &blocks, MadFileData *oldfd, MadFileData *newfd,
+                     MadMemData *memdata, const vector<MadSaveMapping> &mappings)
+{
+    xm::BlockIterator bit = blocks.begin();
+    while(bit != blocks.end() && bit->m_Data != oldfd)
+        ++bit;
+    if(bit == blocks.end())
+        return;
+
+    xm::BlockVector newblocks(blocks.begin(), bit);
+    vector<wxByte> buffer;
+
+    for(; bit != blocks.end(); ++bit)
+    {
+        if(bit->m_Data != oldfd)
+        {
+            newblocks.push_back(*bit);
+            continue;
+        }
+
+        wxFileOffset pos = bit->m_Pos;
+        wxFileOffset size = bit->m_Size;
+        while(size > 0)
+        {
+            vector<MadSaveMapping>::const_iterator next =
+                std::upper_bound(mappings.begin(), mappings.end(), MadSaveMapping(pos, 0, 0));
+
+            if(next != mappings.begin())
+            {
+                vector<MadSaveMapping>::const_iterator it = next - 1;
+                if(it->OldPos + it->Size > pos)
+                {
+                    wxFileOffset len = std::min(size, it->OldPos + it->Size - pos);
+                    newblocks.push_back(MadBlock(newfd, it->NewPos + (pos - it->OldPos), len));
+                    pos += len;
+                    size -= len;
+                    continue;
+                }
+            }
+
+            wxFileOffset len = size;
+            if(next != mappings.end() && next->OldPos - pos < len)
+                len = next->OldPos - pos;
+
+            if(buffer.empty())
+                buffer.resize(BUFFER_SIZE);
+
+            MadBlock blk(memdata, -1, len);
+            size_t bs;
+            do
+            {
+                bs = BUFFER_SIZE;
+                if(BUFFER_SIZE > len)
+                    bs = size_t(len);
+
+                oldfd->Get(pos, &buffer[0], bs);
+                wxFileOffset mpos = memdata->Put(&buffer[0], bs);
+                if(blk.m_Pos < 0)
+                    blk.m_Pos = mpos;
+
+                pos += bs;
+                size -= bs;
+            }
+            while((len -= bs) > 0);
+
+            newblocks.push_back(blk);
+        }
+    }
+
+    blocks.swap(newblocks);
+}
+
+vector<MadSaveMapping> InvertSaveMappings(const vector<MadSaveMapping> &mappings)
+{
+    vector<MadSaveMapping> inverted;
+    inverted.reserve(mappings.size());
+    for(size_t i=0; i<mappings.size(); ++i)
+        inverted.push_back(MadSaveMapping(mappings[i].NewPos, mappings[i].Size, mappings[i].OldPos));
+
+    std::sort(inverted.begin(), inverted.end());
+    return inverted;
+}
+
+//===========================================================================
+
+bool TruncateFile(const wxString &filename, wxFileOffset size)
+{
+#ifdef __WXMSW__
+
+    HANDLE handle = CreateFile(filename.c_str(),      // file to open
+                               GENERIC_WRITE,         // open for writing
+                               0,                     // do not share
+                               nullptr,               // default security
+                               OPEN_ALWAYS,           // open the file, if not exist then create it
+                               FILE_ATTRIBUTE_NORMAL, // normal file
+                               NULL);
+
+    if(handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER oldsize;
+    //if(GetFileSizeEx(handle, &oldsize)==FALSE)
+
+    oldsize.LowPart = GetFileSize(handle, (DWORD *) & oldsize.HighPart);
+    if(oldsize.LowPart==INVALID_FILE_SIZE && GetLastError()!=NO_ERROR)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+
+    if(size==oldsize.QuadPart) // same size, do nothing
+    {
+        CloseHandle(handle);
+        return true;
+    }
+
+    if(size>oldsize.QuadPart)
+    {
+        /**
+        if(SetFileValidData(handle, size)==FALSE)
+        {
+            CloseHandle(handle);
+            return false;
+        }
+        **/
+
+        wxFileOffset s=size-oldsize.QuadPart;
+
+        DWORD ret=SetFilePointer(handle, 0, nullptr, FILE_END);
+        if(ret==INVALID_SET_FILE_POINTER && GetLastError()!=NO_ERROR)
+        {
+            CloseHandle(handle);
+            return false;
+        }
+
+        static char *buf=nullptr;
+        static vector<char> buffervector;
+        if(buf==nullptr)
+        {
+            buffervector.resize(256*1024);
+            buf=&buffervector[0];
+            ZeroMemory(buf, 256*1024);
+        }
+
+        DWORD len=256*1024, wlen;
+
+        do
+        {
+            if(len>s) len = DWORD(s);
+            WriteFile(handle, buf, len, &wlen, nullptr);
+        }
+        while((s-=len)>0);
+
+    }
+    else    // less
+    {
+        oldsize.QuadPart=size;
+        DWORD ret=SetFilePointer(handle, oldsize.LowPart, &oldsize.HighPart, FILE_BEGIN);
+        if(ret==INVALID_SET_FILE_POINTER && GetLastError()!=NO_ERROR)
+        {
+            CloseHandle(handle);
+            return false;
+        }
+    }
+
+    bool ok= (SetEndOfFile(handle)!=FALSE);
+    CloseHandle(handle);
+    return ok;
+
+#else
+
+    int utf8test=MadFileNameIsUTF8(filename);
+    MadConvFileName_WC2MB_UseLibc uselibc(utf8test<0);
+    if(utf8test==0)
+    {
+        // create a new file
+        wxFile f(filename, wxFile::write);
+    }
+
+    return 0==truncate( wxConvFile.cWX2MB(filename.c_str()), size );
+
+#endif
+}
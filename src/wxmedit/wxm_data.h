@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wxmedit/wxm_data.h
+// Description: The Data Storage of the Text/Data Buffer of wxMEdit
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+//              2005-2010  Alston Chen <madedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_DATA_H_
+#define _WXM_DATA_H_
+
+#include "../xm/cxx11.h"
+#include "../xm/line_enc_adapter.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/wxprec.h>
+
+#ifdef __BORLANDC__
+# pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+// Include your minimal set of headers here, or wx.h
+# include <wx/wx.h>
+#endif
+
+#include <wx/file.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <vector>
+using std::vector;
+
+// the bytes of MadMemData are kept in buffers of BUFFER_SIZE,
+// MadFileData reads the file by blocks of BUFFER_SIZE too
+const int BUFFER_SIZE = 1024 * 256;     // 256KB
+const int BUFFER_BITS = 18;
+const int BUFFER_MASK = BUFFER_SIZE - 1;
+const wxFileOffset BUFFER_BASE_MASK = wxFileOffset(-1) << BUFFER_BITS;
+                                    //wxFileOffset(-1) -  BUFFER_MASK;
+
+//===========================================================================
+// MadFileNameIsUTF8, MadDirExists, MadConvFileName_WC2MB_UseLibc
+// for Testing/Converting of FileName Encoding under Linux
+//===========================================================================
+
+// return 0: filename is not found, 1:yes, -1:no
+int MadFileNameIsUTF8(const wxString& filename);
+
+// return 0: name is not a dir or not found, 1:yes(utf8), -1:yes(libc)
+int MadDirExists(const wxString& name);
+
+extern bool g_WC2MB_2_utf8;
+extern bool g_MB2WC_is_utf8;
+extern bool g_MB2WC_check_dir_filename;//check dir, filename separately
+
+class MadConvFileName_WC2MB_UseLibc
+{
+public:
+    MadConvFileName_WC2MB_UseLibc(bool uselibc)
+    {
+        g_WC2MB_2_utf8 = !uselibc;
+    }
+    ~MadConvFileName_WC2MB_UseLibc()
+    {
+        g_WC2MB_2_utf8=true;
+    }
+};
+
+#ifndef __WXMSW__
+class MadConvFileName : public wxMBConv
+{
+public:
+    virtual size_t MB2WC(wchar_t *outputBuf, const char *psz, size_t outputSize) const override;
+    virtual size_t WC2MB(char *outputBuf, const wchar_t *psz, size_t outputSize) const override;
+    virtual wxMBConv *Clone() const override { return new MadConvFileName; }
+};
+#endif
+
+//==================================================
+class MadInData
+{
+protected:
+    wxFileOffset m_Size;
+public:
+    virtual ~MadInData() {}
+    virtual wxByte Get(const wxFileOffset &pos) = 0;
+    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) = 0;
+    wxFileOffset GetSize() { return m_Size; }
+};
+
+class MadOutData
+{
+public:
+    virtual ~MadOutData() {}
+    virtual wxFileOffset Put(wxByte *buffer, size_t size) = 0;
+};
+
+
+class MadMemData : public MadInData, public MadOutData
+{
+private:
+    friend class MadLines;
+    friend class MadEdit;
+    friend class MadMemDataSnapshot;
+
+    vector <wxByte*> m_Buffers;
+    void Reset() { m_Size = 0; }
+
+public:
+    MadMemData();
+    virtual ~MadMemData();
+
+    virtual wxByte Get(const wxFileOffset &pos) override;
+    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) override;
+    virtual wxFileOffset Put(wxByte *buffer, size_t size) override;
+
+    // move the bytes referred by the blocks out of the buffers which are mostly
+    // released, append them to the end and let the blocks refer to their new
+    // positions, then free those buffers; the positions of the freed buffers
+    // are never used again until Reset(). The blocks must be all of the blocks
+    // referring to this. At most maxsize bytes are moved in a call, return
+    // true if there are more buffers to be freed.
+    bool Compact(const vector<xm::BlockVector*> &blocks, size_t maxsize);
+    // bytes of the allocated buffers
+    size_t GetBufferedSize();
+};
+
+class MadFileData : public MadInData, public MadOutData
+{
+private:
+    friend class MadLines;
+    friend class MadFileDataReader;
+
+    wxFile m_File;
+    bool m_OpenSuccess;
+    wxString m_Name;
+    bool m_ReadOnly;
+
+    wxByte *m_Buffer1,*m_Buffer2;
+    wxFileOffset m_Buf1Pos,m_Buf2Pos;
+
+    wxFileOffset m_SavePos; // for Put()
+
+    bool OpenFile();
+    bool Rename(const wxString &name);
+
+public:
+    MadFileData(const wxString &name);
+    virtual ~MadFileData();
+    virtual wxByte Get(const wxFileOffset &pos) override;
+    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) override;
+
+    virtual wxFileOffset Put(wxByte *buffer, size_t size) override;
+    void Read(const wxFileOffset &pos, wxByte *buffer, size_t size)
+    {
+        m_File.Seek(pos);
+        m_File.Read(buffer, size);
+    }
+
+    bool OpenSuccess() { return m_OpenSuccess; }
+    bool IsReadOnly() { return m_ReadOnly; }
+};
+
+// read-only view of the bytes put into a MadMemData before the snapshot,
+// it can be read by another thread while the MadMemData is appended,
+// but it is invalid after the MadMemData is reset or destroyed
+class MadMemDataSnapshot : public MadInData
+{
+private:
+    vector <wxByte*> m_Buffers;
+
+public:
+    MadMemDataSnapshot(MadMemData *md);
+
+    virtual wxByte Get(const wxFileOffset &pos) override;
+    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) override;
+};
+
+// unbuffered reader with its own handle of a file, for another thread
+class MadFileDataReader : public MadInData
+{
+private:
+    wxFile m_File;
+
+public:
+    MadFileDataReader(MadFileData *fd);
+
+    bool IsOpened() { return m_File.IsOpened(); }
+
+    virtual wxByte Get(const wxFileOffset &pos) override;
+    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) override;
+};
+
+//==================================================
+
+struct MadBlock//:public Loki::SmallObject <>
+{
+    MadInData   *m_Data;
+    wxFileOffset m_Pos;
+    wxFileOffset m_Size;
+
+    MadBlock():m_Data(nullptr), m_Pos(0), m_Size(0)
+    {
+    }
+    MadBlock(MadInData *data, const wxFileOffset &pos, const wxFileOffset &size)
+        :m_Data(data), m_Pos(pos), m_Size(size)
+    {
+    }
+    void Reset()
+    {
+        m_Data = nullptr;
+        m_Pos = 0;
+        m_Size = 0;
+    }
+    wxByte Get(const wxFileOffset &pos)
+    {
+        wxASSERT(pos >= 0 && pos < m_Size);
+        return m_Data->Get(m_Pos + pos);
+    }
+    void Get(const wxFileOffset &pos, wxByte *buffer, size_t size)
+    {
+        wxASSERT(pos >= 0 && pos < m_Size);
+        m_Data->Get(m_Pos + pos, buffer, size);
+    }
+};
+//==================================================
+// a range of the old file data written to the new file
+struct MadSaveMapping
+{
+    wxFileOffset OldPos, Size, NewPos;
+
+    MadSaveMapping(wxFileOffset oldpos, wxFileOffset size, wxFileOffset newpos)
+        :OldPos(oldpos), Size(size), NewPos(newpos)
+    {}
+    bool operator<(const MadSaveMapping &m) const { return OldPos < m.OldPos; }
+};
+
+
+// replace the blocks of oldfd by the blocks of newfd according to the mappings
+// sorted by OldPos, the bytes that are not mapped are copied to memdata
+void RemapFileBlocks(xm::BlockVector &blocks, MadFileData *oldfd, MadFileData *newfd,
+                     MadMemData *memdata, const vector<MadSaveMapping> &mappings);
+// the mappings from the new file back to the old file, sorted by their OldPos
+vector<MadSaveMapping> InvertSaveMappings(const vector<MadSaveMapping> &mappings);
+
+bool TruncateFile(const wxString &filename, wxFileOffset size);
+
+#endif
@@ -13,6 +13,8 @@
 #include "../xm/encdet.h"
 #include "../wxm/def.h"
 #include "../xm/mad_encdet.h"
+#include "../xm/perf.h"
+#include "../wxm/replace_journal.h"
 #include "../wxm/utils.h"
 #include "wxm_syntax.h"
 #include "wxmedit.h"
@@ -23,6 +25,7 @@
 #endif
 // disable 4996 {
 #include <wx/filename.h>
+#include <wx/thread.h>
 // disable 4996 }
 #ifdef _MSC_VER
 # pragma warning( pop )
@@ -31,6 +34,11 @@
 //#include <boost/scoped_ptr.hpp>
 
 #include <algorithm>
+#include <memory>
+
+#ifndef __WXMSW__
+# include <sys/stat.h>
+#endif
 
 #ifdef _DEBUG
 #include <crtdbg.h>
@@ -76,612 +84,284 @@ namespace wxm
 	}
 } // namespace wxm
 
-const int BUFFER_SIZE = 1024 * 256;     // 256KB
-const int BUFFER_BITS = 18;
-const int BUFFER_MASK = BUFFER_SIZE - 1;
-const wxFileOffset BUFFER_BASE_MASK = wxFileOffset(-1) << BUFFER_BITS;
-                                    //wxFileOffset(-1) -  BUFFER_MASK;
-
 #define NEXTUCHAR_BUFFER_SIZE (1024 * 10)
 
 //===========================================================================
-// MadFileNameIsUTF8, MadDirExists, MadConvFileName_WC2MB_UseLibc
-// for Testing/Converting of FileName Encoding under Linux
+// MadLine
 //===========================================================================
 
-bool g_WC2MB_2_utf8=true;
-bool g_MB2WC_is_utf8=false;
-bool g_MB2WC_check_dir_filename=false;//check dir, filename separately
-
-// return 0: filename not found, 1:yes, -1:no
-int MadFileNameIsUTF8(const wxString& filename)
+void MadLine::Reset(void)
 {
-    g_WC2MB_2_utf8=false;
-    wxLogNull nolog;
-    if(wxFileModificationTime(filename)!=0)
-    {
-        return -1;//libc or under win32
-    }
-
-#ifndef __WXMSW__
-    // retry by using utf8 filename
-    g_WC2MB_2_utf8=true;
-    if(wxFileModificationTime(filename)!=0)
-    {
-        return 1;//utf8
-    }
-#endif
-
-    return 0;//not found
+    m_Blocks.clear();
+    m_RowIndices.clear();
+    m_BracePairIndices.clear();
 }
 
-// return 0: name is not a dir or not found, 1:yes(utf8), -1:yes(libc)
-int MadDirExists(const wxString& name)
+void MadLine::Empty(void)
 {
-#ifdef __WXMSW__
-    if(wxDirExists(name))
-        return -1;
-#else
-    int test=MadFileNameIsUTF8(name);
-
-    g_WC2MB_2_utf8 = (test>0);
-
-    if(test==0)
-    {
-        if(wxDirExists(name))
-            return -1;
-
-        return 0;
-    }
-
-    if(wxDirExists(name))
-        return test;
-#endif
-
-    return 0;
+    m_Size = 0;
+    m_NewLineSize = 0;
+    m_nl = &wxm::g_nl_none;
+    m_Blocks.resize(1);
+    m_Blocks[0].Reset();
+    m_RowIndices.resize(2);
+    m_RowIndices[0].Reset();
+    m_RowIndices[1].Reset();
+    m_BracePairIndices.clear();
 }
 
-#ifndef __WXMSW__
-size_t MadConvFileName::MB2WC(wchar_t *outputBuf, const char *psz, size_t outputSize) const
+ucs4_t MadLine::LastUCharIsNewLine(xm::Encoding *encoding)
 {
-    size_t len=strlen(psz);
-
-    if(g_MB2WC_check_dir_filename==false)
-    {
-        g_MB2WC_is_utf8=xm::IsUTF8((ubyte *)psz, int(len));
-
-        if(g_MB2WC_is_utf8)
-        {
-            return wxConvUTF8.MB2WC(outputBuf, psz, outputSize);
-        }
-
-        return wxConvLibc.MB2WC(outputBuf, psz, outputSize);
-    }
+    if(m_Size == 0)
+        return 0;
 
-    //check dir, filename separately
-    size_t dirlen=0, fnlen=0;
-    if(len>0)
-    {
-        for(int i=int(len-1);i>=0;i--, fnlen++)
-        {
-            if(psz[i]=='/')
-                break;
-        }
-        dirlen=len-fnlen;
-    }
+    xm::BlockIterator bit = m_Blocks.end();
+    --bit;
 
-    size_t dirret=0;
-    if(dirlen!=0)
-    {
-        vector<char> cbuf;
-        cbuf.resize(dirlen+1);
-        char *pbuf = (char *) &cbuf[0];
-        memcpy(pbuf, psz, dirlen);
-        cbuf[dirlen]=0;
+    xm::BackwardBlockDumper dumper(bit);
 
-        bool is_utf8=xm::IsUTF8((ubyte *)pbuf, int(dirlen));
-        if(is_utf8)
-        {
-            dirret=wxConvUTF8.MB2WC(outputBuf, pbuf, outputSize);
-        }
-        else
-        {
-            dirret=wxConvLibc.MB2WC(outputBuf, pbuf, outputSize);
-        }
-    }
+    return encoding->PeekUChar32_Newline(dumper, size_t(m_Size));
+}
 
-    if(dirret==size_t(-1))
-        return size_t(-1);
+int MadLine::GetSubRow(const wxFileOffset &linepos)
+{
+    // the first row contains the positions before its start (BOM),
+    // and the last row contains the positions after the end of line
+    MadRowIndexIterator first = m_RowIndices.begin() + 1;
+    MadRowIndexIterator last = m_RowIndices.end() - 1;
+    return int(std::upper_bound(first, last, linepos, MadRowIndexStartLess) - first);
+}
 
-    size_t fnret=0;
-    if(fnlen!=0)
-    {
-        bool is_utf8=xm::IsUTF8((ubyte *)psz+dirlen, int(fnlen));
-        wchar_t *obuf=outputBuf;
-        if(outputBuf!=nullptr)
-            obuf+=dirret;
+bool MadLine::FirstUCharIs0x0A(xm::Encoding *encoding)
+{
+    if(m_Size == 0) return false;
 
-        if(is_utf8)
-        {
-            fnret=wxConvUTF8.MB2WC(obuf, psz+dirlen, outputSize-dirret);
-        }
-        else
-        {
-            fnret=wxConvLibc.MB2WC(obuf, psz+dirlen, outputSize-dirret);
-        }
-    }
+    xm::BlockIterator bit = m_Blocks.begin();
 
-    if(fnret==size_t(-1))
-        return size_t(-1);
+    xm::ForwardBlockDumper dumper(bit);
 
-    return dirret+fnret;
+    return encoding->IsUChar32_LineFeed(dumper, size_t(m_Size));
 }
 
-size_t MadConvFileName::WC2MB(char *outputBuf, const wchar_t *psz, size_t outputSize) const
-{
-    if(g_WC2MB_2_utf8)
-        return wxConvUTF8.WC2MB(outputBuf, psz, outputSize);
-
-    return wxConvLibc.WC2MB(outputBuf, psz, outputSize);
-}
-#endif
 
 //===========================================================================
-// MadMemData
+// MadBytesReader
 //===========================================================================
 
-MadMemData::MadMemData()
+MadBytesReader::MadBytesReader(const MadLineIterator &lit, wxFileOffset linepos, const MadLineIterator &lineend)
+    : m_LineIter(lit), m_LineEnd(lineend), m_BlockPos(linepos), m_AtEnd(false)
 {
-    m_Size = 0;
-}
+    wxASSERT(linepos >= 0 && linepos <= lit->m_Size);
 
-MadMemData::~MadMemData()
-{
-    size_t i, count;
-    for(i = 0, count = m_Buffers.size(); i < count; ++i)
+    m_BlockIter = m_LineIter->m_Blocks.begin();
+    while(m_BlockIter != m_LineIter->m_Blocks.end() && m_BlockPos >= m_BlockIter->m_Size)
     {
-        delete []m_Buffers[i];
+        m_BlockPos -= m_BlockIter->m_Size;
+        ++m_BlockIter;
     }
-    m_Buffers.clear();
 }
 
-wxByte MadMemData::Get(const wxFileOffset &pos)
+size_t MadBytesReader::Read(wxByte *buf, size_t size)
 {
-    wxASSERT((pos >= 0) && (pos < m_Size));
-
-    int buf = int(pos >> BUFFER_BITS);    //pos / BUFFER_SIZE;
-    int idx = int(pos & BUFFER_MASK);    //pos % BUFFER_SIZE;
-
-    return m_Buffers[buf][idx];
-}
-
-void MadMemData::Get(const wxFileOffset &pos, wxByte *buffer, size_t size)
-{
-    wxASSERT((pos >= 0) && (size > 0) && ((wxFileOffset)(pos + size) <= m_Size));
-
-    int buf = int(pos >> BUFFER_BITS);    //pos / BUFFER_SIZE;
-    int idx = int(pos & BUFFER_MASK);    //pos % BUFFER_SIZE;
-
-    size_t buf_size = BUFFER_SIZE - idx;
-
-    while(true)
+    size_t count = 0;
+    while(count < size && !m_AtEnd)
     {
-        if(buf_size > size) buf_size = size;
-
-        /***
-        if(buf_size <= sizeof(int)*40) buggy!!!
+        if(m_BlockIter == m_LineIter->m_Blocks.end() || m_BlockPos >= m_BlockIter->m_Size)
         {
-            int *src=(int*)buffer;
-            int *des=(int*)(m_Buffers[buf] + idx);
-            size_t s=buf_size;
+            if(m_BlockIter != m_LineIter->m_Blocks.end())
+                ++m_BlockIter;
 
-            if(s >= sizeof(int)*20)     //max:40
-            {
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                s-=sizeof(int)*20;
-            }
-            if(s >= sizeof(int)*10)     //max:20
-            {
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                s-=sizeof(int)*10;
-            }
-            if(s >= sizeof(int)*10)     //max:10
-            {
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                *src++ = *des++; *src++ = *des++;
-                s-=sizeof(int)*10;
-            }
-            if(s >= sizeof(int)*5)      //max:9
-            {
-                *src++ = *des++;
-                *src++ = *des++;
-                *src++ = *des++;
-                *src++ = *des++;
-                *src++ = *des++;
-                s-=sizeof(int)*5;
-            }
-            if(s >= sizeof(int))        //max:4
-            {
-                *src++ = *des++;
-                s-=sizeof(int);
-                if(s >= sizeof(int))        //max:3
-                {
-                    *src++ = *des++;
-                    s-=sizeof(int);
-                    if(s >= sizeof(int))        //max:2
-                    {
-                        *src++ = *des++;
-                        s-=sizeof(int);
-                        if(s >= sizeof(int))        //max:1
-                        {
-                            *src++ = *des++;
-                            s-=sizeof(int);
-                        }
-                    }
-                }
-            }
-            if(s)       //max:3byte
+            if(m_BlockIter == m_LineIter->m_Blocks.end())    // to next line
             {
-                buffer=(wxByte*)src;
-                wxByte *bdes=(wxByte*)des;
-
-                *buffer++=*bdes++;
-                s--;
-                if(s)   //max:2b
+                if(++m_LineIter == m_LineEnd || m_LineIter->m_Size == 0)
                 {
-                    *buffer++=*bdes++;
-                    s--;
-                    if(s)   //max:1byte
-                    {
-                        *buffer=*bdes;
-                        s--;            //over
-                    }
+                    m_AtEnd = true;
+                    break;
                 }
+                m_BlockIter = m_LineIter->m_Blocks.begin();
             }
-
-            wxASSERT(s==0);
-        }
-        else
-            ***/
-        {
-            memcpy(buffer, m_Buffers[buf] + idx, buf_size);
-        }
-
-        if((size -= buf_size) ==0) break;
-
-        ++buf;
-        idx = 0;
-        buffer += buf_size;
-        buf_size = BUFFER_SIZE;
-    }
-}
-
-wxFileOffset MadMemData::Put(wxByte * buffer, size_t size)
-{
-    wxASSERT(size > 0);
-
-    size_t buf = size_t(m_Size >> BUFFER_BITS);        //m_Size / BUFFER_SIZE;
-    int idx = int(m_Size & BUFFER_MASK);            //m_Size % BUFFER_SIZE;
-    size_t buf_size = BUFFER_SIZE - idx;
-    wxByte *tmp = idx!=0 ? m_Buffers[buf] : 0;
-
-    wxFileOffset pos = m_Size;
-    m_Size += size;
-    do
-    {
-        if(idx == 0)
-        {
-            if(buf < m_Buffers.size())
-            {
-                tmp = m_Buffers[buf];
-            }
-            else
-            {
-                tmp = new wxByte[BUFFER_SIZE];
-                m_Buffers.push_back(tmp);                // add a new buffer
-            }
-            buf_size = BUFFER_SIZE;
+            m_BlockPos = 0;
+            continue;
         }
 
-        if(size < buf_size) buf_size = size;
+        size_t n = size - count;
+        if(m_BlockIter->m_Size - m_BlockPos < wxFileOffset(n))
+            n = size_t(m_BlockIter->m_Size - m_BlockPos);
 
-        memcpy(tmp + idx, buffer, buf_size);
-        buffer += buf_size;
-        size -= buf_size;
-        idx = 0;
-        ++buf;
+        m_BlockIter->Get(m_BlockPos, buf + count, n);
+        m_BlockPos += n;
+        count += n;
     }
-    while(size > 0);
 
-    return pos;
+    return count;
 }
 
 
 //===========================================================================
-// MadFileData
+// MadDecodedRowCache
 //===========================================================================
 
-MadFileData::MadFileData(const wxString &name)
-{
-    m_Name = name;
-    m_Size = 0;
-    m_OpenSuccess = true;
-    m_ReadOnly = false;
-    m_Buffer1 = nullptr;
-    m_Buffer2 = nullptr;
-
-    int utf8test=MadFileNameIsUTF8(name);
-
-    if(utf8test==0)// this file/dir is not exist
-    {
-        return;
-    }
-
-    MadConvFileName_WC2MB_UseLibc uselibc(utf8test<0);
-
-    if(wxDirExists(name))// test this name is a dir or not
-    {
-        m_OpenSuccess = false;
-        return;
-    }
-
-    if(OpenFile())
-    {
-        m_Size = m_File.SeekEnd();    // get size
-        m_File.Seek(0);                // move to begin
-
-        m_Buffer1 = new wxByte[BUFFER_SIZE];
-        m_Buf1Pos = 0;
-        m_Buffer2 = new wxByte[BUFFER_SIZE];
-        m_Buf2Pos = -1;
-
-        // read first data-block to buffer1
-        size_t size = BUFFER_SIZE;
-        if(BUFFER_SIZE > m_Size) size = size_t(m_Size);
-        m_File.Read(m_Buffer1, size);
-    }
-}
-
-MadFileData::~MadFileData()
+namespace
 {
-    if(m_File.IsOpened())   m_File.Close();
-    if(m_Buffer1)       delete []m_Buffer1;
-    if(m_Buffer2)       delete []m_Buffer2;
-}
-
-wxByte MadFileData::Get(const wxFileOffset &pos)
+// the data of the blocks are never changed till MadMemData is reset or the
+// file is saved, so the bytes referred to by the same data and pos are the same;
+// return the count of the bytes from linepos on which are the same in both
+wxFileOffset SameBlockBytes(const MadLine &line, wxFileOffset linepos, const xm::BlockVector &slices)
 {
-    wxASSERT((pos >= 0) && (pos < m_Size));
-
-    wxFileOffset idx;
-    if(m_Buf1Pos>=0)
+    const xm::BlockVector &blocks = line.m_Blocks;
+    size_t b = 0;
+    wxFileOffset off = linepos;    // in blocks[b]
+    while(b < blocks.size() && off >= blocks[b].m_Size)
     {
-        idx = pos - m_Buf1Pos;
-        if(idx >= 0 && idx < BUFFER_SIZE)       // wanted byte in buffer1
-        {
-            return m_Buffer1[(size_t)idx];
-        }
+        off -= blocks[b].m_Size;
+        ++b;
     }
 
-    if(m_Buf2Pos>=0)
+    wxFileOffset same = 0;
+    for(size_t i = 0; i < slices.size(); ++i)
     {
-        idx = pos - m_Buf2Pos;
-        if(idx >= 0 && idx < BUFFER_SIZE)       // wanted byte in buffer2
+        const MadBlock &slice = slices[i];
+        wxFileOffset soff = 0;
+        while(soff < slice.m_Size)
         {
-            return m_Buffer2[(size_t)idx];
-        }
-    }
+            if(b == blocks.size())
+                return same;
 
-    if(m_Buf1Pos>=0)
-    {
-        // swap buffer1 buffer2
-        wxByte *tmp=m_Buffer2;
-        m_Buffer2=m_Buffer1;
-        m_Buffer1=tmp;
+            const MadBlock &blk = blocks[b];
+            if(blk.m_Data != slice.m_Data || blk.m_Pos + off != slice.m_Pos + soff)
+                return same;
 
-        m_Buf2Pos=m_Buf1Pos;
+            const wxFileOffset n = std::min(blk.m_Size - off, slice.m_Size - soff);
+            same += n;
+            soff += n;
+            if((off += n) == blk.m_Size)
+            {
+                off = 0;
+                ++b;
+            }
+        }
     }
-
-    // read data-block to buffer1
-    m_Buf1Pos = pos & BUFFER_BASE_MASK; //(pos >> BUFFER_BITS) << BUFFER_BITS;    //(pos / BUFFER_SIZE) * BUFFER_SIZE;
-    m_File.Seek(m_Buf1Pos);
-
-    wxFileOffset size = m_Size - m_Buf1Pos;
-    if(size > BUFFER_SIZE)    size = BUFFER_SIZE;
-
-    m_File.Read(m_Buffer1, size_t(size));
-
-    idx = pos - m_Buf1Pos;
-    return m_Buffer1[(size_t)idx];
+    return same;
 }
 
-void MadFileData::Get(const wxFileOffset &pos, wxByte * buffer, size_t size)
+// append the blocks of [begin, end) of the line to slices
+void AppendBlockSlices(const MadLine &line, wxFileOffset begin, wxFileOffset end, xm::BlockVector &slices)
 {
-    wxASSERT((pos >= 0) && (size > 0) && ((wxFileOffset)(pos + size) <= m_Size));
-
-    wxFileOffset idx;
-    if(m_Buf1Pos>=0)
+    const xm::BlockVector &blocks = line.m_Blocks;
+    wxFileOffset blkpos = 0;
+    for(size_t b = 0; b < blocks.size() && begin < end; ++b)
     {
-        idx = pos - m_Buf1Pos;
-        if(idx >= 0 && wxFileOffset(idx+size)<=BUFFER_SIZE )        // wanted bytes in buffer1
+        const MadBlock &blk = blocks[b];
+        if(begin >= blkpos + blk.m_Size)
         {
-            memcpy(buffer, m_Buffer1+idx, size);
-            return;
+            blkpos += blk.m_Size;
+            continue;
         }
-    }
 
-    if(m_Buf2Pos>=0)
-    {
-        idx = pos - m_Buf2Pos;
-        if(idx >= 0 && wxFileOffset(idx+size)<=BUFFER_SIZE )    // wanted bytes in buffer2
+        const wxFileOffset pos = blk.m_Pos + (begin - blkpos);
+        const wxFileOffset size = std::min(blkpos + blk.m_Size, end) - begin;
+        if(!slices.empty() && slices.back().m_Data == blk.m_Data
+            && slices.back().m_Pos + slices.back().m_Size == pos)
         {
-            memcpy(buffer, m_Buffer2+idx, size);
-            return;
+            slices.back().m_Size += size;
         }
-    }
-
-    idx = pos & BUFFER_BASE_MASK; //(pos >> BUFFER_BITS) << BUFFER_BITS;        //(pos / BUFFER_SIZE) * BUFFER_SIZE;
-    if(wxFileOffset(pos+size) <= idx+BUFFER_SIZE)   // wanted bytes in one block
-    {
-        if(m_Buf1Pos>=0)
+        else
         {
-            // swap buffer1 buffer2
-            wxByte *tmp=m_Buffer2;
-            m_Buffer2=m_Buffer1;
-            m_Buffer1=tmp;
-
-            m_Buf2Pos=m_Buf1Pos;
+            slices.push_back(MadBlock(blk.m_Data, pos, size));
         }
 
-        // read data-block to buffer1
-        m_Buf1Pos = idx;
-        m_File.Seek(m_Buf1Pos);
-
-        wxFileOffset bufsize = m_Size - m_Buf1Pos;
-        if(bufsize > BUFFER_SIZE)    bufsize = BUFFER_SIZE;
-
-        m_File.Read(m_Buffer1, size_t(bufsize));
-
-        idx = pos - m_Buf1Pos;
-        memcpy(buffer, m_Buffer1+idx, size);
-        return;
+        begin += size;
+        blkpos += blk.m_Size;
     }
-
-    // wanted bytes cross more than one block
-    m_File.Seek(pos);
-    m_File.Read(buffer, size);
 }
 
-wxFileOffset MadFileData::Put(wxByte *buffer, size_t size)
+} // anonymous namespace
+
+void MadDecodedRow::Truncate(wxFileOffset linepos)
 {
-    wxFileOffset pos=m_SavePos;
+    // the chars ending after linepos
+    const size_t count = size_t(std::upper_bound(m_Offsets.begin(), m_Offsets.end(), linepos) - m_Offsets.begin()) - 1;
+    if(count == m_Chars.size())
+        return;
 
-    m_File.Seek(m_SavePos);
-    m_File.Write(buffer, size);
-    m_SavePos+=size;
+    m_Chars.resize(count);
+    m_Offsets.resize(count + 1);
+    if(m_XPos.size() > count + 1)
+        m_XPos.resize(count + 1);
 
-    if(m_Size < m_SavePos)
+    wxFileOffset size = m_Offsets.back() - m_Start;
+    size_t i = 0;
+    while(i < m_Blocks.size() && size > m_Blocks[i].m_Size)
+        size -= m_Blocks[i++].m_Size;
+    if(i < m_Blocks.size())
     {
-        m_Size = m_SavePos;
+        m_Blocks[i].m_Size = size;
+        m_Blocks.resize(size == 0? i: i + 1);
     }
-
-    m_Buf1Pos=m_Buf2Pos=-1;
-
-    return pos;
 }
 
-bool MadFileData::OpenFile()
+void MadDecodedRowCache::Clear()
 {
-    wxLogNull nolog;// disable error message of file.Open()
-
-    m_ReadOnly = false;
-    m_OpenSuccess = m_File.Open(m_Name.c_str(), wxFile::read_write);    // read&write
-    if(m_OpenSuccess == false)
-    {
-        m_OpenSuccess = m_File.Open(m_Name.c_str(), wxFile::read);    // read only
-        if(m_OpenSuccess == false)
-        {
-            return false;
-        }
-
-        m_ReadOnly = true;
-    }
-
-    return true;
+    for(RowMap::iterator it = m_Rows.begin(); it != m_Rows.end(); ++it)
+        delete it->second;
+    m_Rows.clear();
 }
 
-bool MadFileData::Rename(const wxString &name)
+MadDecodedRow *MadDecodedRowCache::Get(const MadLine &line, wxFileOffset start)
 {
-    //wxASSERT(handle_ != INVALID_HANDLE_VALUE);
-
-    m_File.Close();
-
-    MadConvFileName_WC2MB_UseLibc uselibc(MadFileNameIsUTF8(m_Name)<0);
-
-    if(wxRenameFile(m_Name, name))
+    MadDecodedRow *&dr = m_Rows[std::make_pair(&line, start)];
+    if(dr == nullptr)
     {
-        m_Name = name;
-        OpenFile();
-        return true;
+        dr = new MadDecodedRow;
+        dr->m_Start = start;
+        dr->m_Offsets.push_back(start);
+        dr->m_WidthSignature = 0;
+        dr->m_RowWidth = 0;
+        dr->m_XPos.push_back(0);
+    }
+    else if(!dr->m_Chars.empty())
+    {
+        // only the chars before the first changed byte are kept
+        dr->Truncate(start + SameBlockBytes(line, start, dr->m_Blocks));
     }
 
-    // can't rename the file, reopen the file
-    OpenFile();
-    return false;
-}
-
-
-//===========================================================================
-// MadLine
-//===========================================================================
-
-void MadLine::Reset(void)
-{
-    m_Blocks.clear();
-    m_RowIndices.clear();
-    m_BracePairIndices.clear();
-}
-
-void MadLine::Empty(void)
-{
-    m_Size = 0;
-    m_NewLineSize = 0;
-    m_nl = &wxm::g_nl_none;
-    m_Blocks.resize(1);
-    m_Blocks[0].Reset();
-    m_RowIndices.resize(2);
-    m_RowIndices[0].Reset();
-    m_RowIndices[1].Reset();
-    m_BracePairIndices.clear();
-}
-
-ucs4_t MadLine::LastUCharIsNewLine(xm::Encoding *encoding)
-{
-    if(m_Size == 0)
-        return 0;
-
-    xm::BlockIterator bit = m_Blocks.end();
-    --bit;
-
-    xm::BackwardBlockDumper dumper(bit);
-
-    return encoding->PeekUChar32_Newline(dumper, size_t(m_Size));
+    dr->m_Stamp = ++m_Clock;
+    return dr;
 }
 
-bool MadLine::FirstUCharIs0x0A(xm::Encoding *encoding)
+void MadDecodedRowCache::Shrink(MadDecodedRow *keep)
 {
-    if(m_Size == 0) return false;
-
-    xm::BlockIterator bit = m_Blocks.begin();
+    size_t chars = 0;
+    for(RowMap::iterator it = m_Rows.begin(); it != m_Rows.end(); ++it)
+        chars += it->second->m_Chars.size();
+    if(m_Rows.size() <= MAX_ROWS && chars <= MAX_CHARS)
+        return;
 
-    xm::ForwardBlockDumper dumper(bit);
+    vector<RowStamp> lru;
+    for(RowMap::iterator it = m_Rows.begin(); it != m_Rows.end(); ++it)
+    {
+        if(it->second != keep)
+            lru.push_back(RowStamp(it->second->m_Stamp, it));
+    }
+    std::sort(lru.begin(), lru.end(), RowStampLess);
 
-    return encoding->IsUChar32_LineFeed(dumper, size_t(m_Size));
+    for(size_t i = 0; i < lru.size() && (m_Rows.size() > MAX_ROWS || chars > MAX_CHARS); ++i)
+    {
+        MadDecodedRow *dr = lru[i].second->second;
+        chars -= dr->m_Chars.size();
+        delete dr;
+        m_Rows.erase(lru[i].second);
+    }
 }
 
-
 //===========================================================================
 // MadLines
 //===========================================================================
 
 MadLines::MadLines(MadEdit *madedit)
-    : m_manual(false), m_line_bi_status(U_ZERO_ERROR)
+    : m_NextUChar_Decoded(nullptr), m_NextUChar_DecodedIndex(0),
+      m_NextUChar_DecodedRow(0), m_NextUChar_DecodedEnd(0),
+      m_manual(false), m_line_bi_status(U_ZERO_ERROR)
 {
     m_MadEdit = madedit;
     m_Syntax = madedit->m_Syntax;
@@ -696,6 +376,8 @@ MadLines::MadLines(MadEdit *madedit)
 
     m_FileData = nullptr;
     m_TmpFileData = nullptr;
+    m_SaveThread = nullptr;
+    m_SavedContent = 0;
 
     m_MemData = new MadMemData();
 
@@ -711,6 +393,9 @@ MadLines::MadLines(MadEdit *madedit)
 
 MadLines::~MadLines(void)
 {
+    if(m_SaveThread != nullptr)
+        EndSaveToFileAsync();
+
     // clear all lines
     Empty(true);
 
@@ -733,6 +418,8 @@ MadLines::~MadLines(void)
 
 void MadLines::Empty(bool freeAll)
 {
+    ClearDecodedRows();
+
     m_Size = 0;
     m_LineCount = 0;
     m_RowCount = 0;
@@ -796,6 +483,7 @@ void MadLines::Clear(bool freeAll)
 void MadLines::SetEncoding(xm::Encoding *encoding)
 {
     m_Encoding=encoding;
+    ClearDecodedRows();
 }
 
 void MadLines::LoadNewBuffer()
@@ -831,6 +519,7 @@ void MadLines::LoadNewBuffer()
 
 void MadLines::InitNextUChar(const MadLineIterator &iter, const wxFileOffset pos)
 {
+    m_NextUChar_Decoded = nullptr;
     m_NextUChar_LineIter = iter;
     m_NextUChar_Pos = pos;
     m_NextUChar_LineSize = iter->m_Size;
@@ -876,11 +565,99 @@ ubyte* MadLines::BufferLoadBytes(int64_t& rest, size_t buf_len)
         LoadNewBuffer();
     }
 
-    return m_NextUChar_Buffer+m_NextUChar_BufferStart;
-}
+    return m_NextUChar_Buffer+m_NextUChar_BufferStart;
+}
+
+MadDecodedRow *MadLines::InitNextUCharDecoded(const MadLineIterator &iter, size_t row)
+{
+    StartDecodedRow(iter, row);
+
+    // the rows read before are not used any more
+    m_DecodedRows.Shrink(m_NextUChar_Decoded);
+    return m_NextUChar_Decoded;
+}
+
+void MadLines::StartDecodedRow(const MadLineIterator &iter, size_t row)
+{
+    m_NextUChar_LineIter = iter;
+    m_NextUChar_LineSize = iter->m_Size;
+    m_NextUChar_Pos = iter->m_RowIndices[row].m_Start;
+    m_NextUChar_Decoded = DecodeRow(iter, row);
+    m_NextUChar_DecodedIndex = 0;
+    m_NextUChar_DecodedRow = row;
+    m_NextUChar_DecodedEnd = iter->m_RowIndices[row + 1].m_Start;
+}
+
+MadDecodedRow *MadLines::DecodeRow(const MadLineIterator &iter, size_t row)
+{
+    MadDecodedRow *dr = m_DecodedRows.Get(*iter, iter->m_RowIndices[row].m_Start);
+
+    // the chars after the row belong to the next row if it's wrapped again
+    dr->Truncate(iter->m_RowIndices[row + 1].m_Start);
+    return dr;
+}
+
+bool MadLines::DecodeRowChars(MadDecodedRow *dr, const MadLineIterator &iter, wxFileOffset end)
+{
+    const size_t DECODE_CHARS = 4096;
+
+    const wxFileOffset begin = dr->m_Offsets.back();
+    if(begin >= end || dr->m_Chars.size() >= MadDecodedRowCache::MAX_CHARS)
+        return false;
+
+    wxASSERT(m_NextUChar_BufferLoadNew);
+
+    MadDecodedRow *decoded = m_NextUChar_Decoded;
+    const size_t index = m_NextUChar_DecodedIndex;
+    const MadLineIterator lineiter = m_NextUChar_LineIter;
+    const wxFileOffset pos = m_NextUChar_Pos;
+
+    xm::UCQueue ucqueue;
+    InitNextUChar(iter, begin);
+    for(size_t i = 0; i < DECODE_CHARS && m_NextUChar_Pos < end && NextUChar(ucqueue); ++i)
+    {
+        dr->m_Chars.push_back(ucqueue.back());
+        dr->m_Offsets.push_back(m_NextUChar_Pos);
+    }
+    AppendBlockSlices(*iter, begin, dr->m_Offsets.back(), dr->m_Blocks);
+
+    m_NextUChar_Decoded = decoded;
+    m_NextUChar_DecodedIndex = index;
+    m_NextUChar_LineIter = lineiter;
+    m_NextUChar_LineSize = lineiter->m_Size;
+    m_NextUChar_Pos = pos;
+
+    return dr->m_Offsets.back() > begin;
+}
+
+bool MadLines::NextUChar(xm::UCQueue &ucqueue)
+{
+    while(m_NextUChar_Decoded != nullptr)
+    {
+        MadDecodedRow *dr = m_NextUChar_Decoded;
+        if(m_NextUChar_DecodedIndex < dr->m_Chars.size()
+            || DecodeRowChars(dr, m_NextUChar_LineIter, m_NextUChar_DecodedEnd))
+        {
+            const xm::CharUnit &cu = dr->m_Chars[m_NextUChar_DecodedIndex++];
+            ucqueue.push_back(cu);
+            m_NextUChar_Pos += cu.nbytes();
+            return true;
+        }
+
+        if(m_NextUChar_Pos < m_NextUChar_DecodedEnd)
+        {
+            // the row has too many chars to be cached, decode the rest directly
+            InitNextUChar(m_NextUChar_LineIter, m_NextUChar_Pos);
+            break;
+        }
+
+        // go on to the next row as reading the line directly
+        if(m_NextUChar_DecodedRow + 1 >= m_NextUChar_LineIter->RowCount())
+            return false;
+        StartDecodedRow(m_NextUChar_LineIter, m_NextUChar_DecodedRow + 1);
+    }
 
-bool MadLines::NextUChar(xm::UCQueue &ucqueue)
-{
+    XM_PERF_COUNT(PERF_NEXT_UCHAR32);
     return m_Encoding->NextUChar32(ucqueue, *this);
 }
 
@@ -1758,6 +1535,8 @@ MadLineState MadLines::Reformat(MadLineIterator iter)
 // return reformated line count
 size_t MadLines::Reformat(MadLineIterator first, MadLineIterator last)
 {
+    XM_PERF_SCOPE(PERF_REFORMAT);
+
     MadLineState state;
     MadLineIterator next = first, end = m_LineList.end();
     bool bContinue = true, bIsNotEnd = true, bStateIsNotOkay;
@@ -1839,6 +1618,8 @@ size_t MadLines::Reformat(MadLineIterator first, MadLineIterator last)
 
 void MadLines::RecountLineWidth(void)
 {
+    XM_PERF_SCOPE(PERF_RECOUNT_LINE_WIDTH);
+
     MadLineIterator iter = m_LineList.begin();
     MadLineIterator iterend = m_LineList.end();
 
@@ -2060,8 +1841,39 @@ void MadLines::InitFileSyntax()
     m_MadEdit->m_Syntax = m_Syntax;
 }
 
+// the newline of the counted bytes: CRLF if any like Reformat(), or else the
+// one of the most lines; nullptr if none or the newlines are not single bytes
+inline const wxm::NewLineChar* CountedNewLine(const xm::ByteStats& stats, xm::Encoding* enc)
+{
+    switch(enc->GetEncoding())
+    {
+    case xm::ENC_UTF_16LE:
+    case xm::ENC_UTF_16BE:
+    case xm::ENC_UTF_32LE:
+    case xm::ENC_UTF_32BE:
+        return nullptr;
+    default:
+        break;
+    }
+
+    if(stats.crlfs != 0)
+        return &wxm::g_nl_dos;
+
+    if(stats.lfs == 0 && stats.crs == 0)
+        return nullptr;
+
+    if(stats.lfs >= stats.crs)
+        return &wxm::g_nl_unix;
+    return &wxm::g_nl_mac;
+}
+
 bool MadLines::LoadFromFile(const wxString& filename, const std::wstring& encoding, bool hexmode)
 {
+    XM_PERF_SCOPE(PERF_LOAD_FROM_FILE);
+
+    if(m_SaveThread != nullptr)
+        EndSaveToFileAsync();
+
     MadFileData *fd = new MadFileData(filename);
 
     if(!fd->OpenSuccess())
@@ -2141,13 +1953,21 @@ bool MadLines::LoadFromFile(const wxString& filename, const std::wstring& encodi
     // set line's row indices
     iter->m_RowIndices[1].m_Start = m_Size;
 
+    // the kinds of the bytes of the head are counted in one pass
+    xm::ByteStats stats;
+    stats.Scan(m_FileData->m_Buffer1, sz);
+
     long MaxSizeToLoad;
     m_MadEdit->m_Config->Read(wxT("/wxMEdit/MaxSizeToLoad"), &MaxSizeToLoad, 20*1000*1000);
 
     wxMemorySize memsize=wxGetFreeMemory();
 
+    // the lines and the rows of a text take about its size again, a file
+    // shown in hex has none of them
+    wxFileOffset memneeded = (hexmode || stats.IsBinary())? m_Size: m_Size * 2;
+
     wxByte *buf;
-    if(m_Size<=wxFileOffset(MaxSizeToLoad) && memsize>0 && wxMemorySize(m_Size * 2 + 15 * 1024 * 1024)<memsize)    // load filedata to MemData
+    if(m_Size<=wxFileOffset(MaxSizeToLoad) && memsize>0 && wxMemorySize(memneeded + 15 * 1024 * 1024)<memsize)    // load filedata to MemData
     {
         buf = m_FileData->m_Buffer1;
         int ss = 0;
@@ -2213,22 +2033,45 @@ bool MadLines::LoadFromFile(const wxString& filename, const std::wstring& encodi
     bool preset = false;
     bool skip_utf8 = false;
 
+    // detect by the samples of the rest if the head is plain ASCII
+    const wxByte *detbuf = buf;
+    size_t detsz = sz;
+    std::vector<wxByte> samples;
+    if(m_Size<maxtextfilesize && m_Size>wxFileOffset(sz) && stats.IsASCII())
+    {
+        MadInData *data = iter->m_Blocks[0].m_Data;
+        xm::ReadDetectingSamples(samples, [data](uint64_t pos, ubyte *b, size_t len)
+            {
+                data->Get(wxFileOffset(pos), b, len);
+                return len;
+            }, uint64_t(m_Size), sz);
+
+        if(!samples.empty())
+        {
+            detbuf = &samples[0];
+            detsz = samples.size();
+
+            stats = xm::ByteStats();
+            stats.Scan(detbuf, detsz);
+        }
+    }
+
     if(m_Size>=maxtextfilesize)
     {
         hexmode = true;
     }
     else
     {
-        preset = PresetFileEncoding(encoding, buf, sz);
+        preset = PresetFileEncoding(encoding, detbuf, detsz);
         skip_utf8 = !preset;
     }
 
     if(!preset)
     {
-        SetFileEncoding(encoding, defaultenc.wc_str(), buf, sz, skip_utf8);
+        SetFileEncoding(encoding, defaultenc.wc_str(), detbuf, detsz, skip_utf8);
 
         if(!hexmode)
-            hexmode = IsBinaryData(buf, sz);
+            hexmode = stats.IsBinary();
     }
 
     if(hexmode)
@@ -2238,6 +2081,11 @@ bool MadLines::LoadFromFile(const wxString& filename, const std::wstring& encodi
     }
     else
     {
+        // Reformat() still takes a CRLF found after the counted bytes
+        const wxm::NewLineChar* nl = CountedNewLine(stats, m_MadEdit->m_Encoding);
+        if(nl != nullptr)
+            m_MadEdit->m_newline = nl;
+
         Reformat(iter, iter);
     }
 
@@ -2291,116 +2139,14 @@ void MadLines::SetFileEncoding(const std::wstring& encoding, const std::wstring&
         enc=xm::EncodingManager::Instance().NameToEncoding(defaultenc);
     }
 
-    // use Encoding Detector
-    xm::DetectEncoding(buf, sz, enc, skip_utf8);
+    // use Encoding Detector; files are loaded on the main thread only
+    static xm::CharsetDetector detector;
+    xm::DetectEncoding(buf, sz, enc, skip_utf8, detector);
 
     m_MadEdit->SetEncoding(xm::EncodingManager::Instance().EncodingToName(enc));
 }
 
-//===========================================================================
-
-bool TruncateFile(const wxString &filename, wxFileOffset size)
-{
-#ifdef __WXMSW__
-
-    HANDLE handle = CreateFile(filename.c_str(),      // file to open
-                               GENERIC_WRITE,         // open for writing
-                               0,                     // do not share
-                               nullptr,               // default security
-                               OPEN_ALWAYS,           // open the file, if not exist then create it
-                               FILE_ATTRIBUTE_NORMAL, // normal file
-                               NULL);
-
-    if(handle == INVALID_HANDLE_VALUE)
-    {
-        return false;
-    }
-
-    LARGE_INTEGER oldsize;
-    //if(GetFileSizeEx(handle, &oldsize)==FALSE)
-
-    oldsize.LowPart = GetFileSize(handle, (DWORD *) & oldsize.HighPart);
-    if(oldsize.LowPart==INVALID_FILE_SIZE && GetLastError()!=NO_ERROR)
-    {
-        CloseHandle(handle);
-        return false;
-    }
-
-    if(size==oldsize.QuadPart) // same size, do nothing
-    {
-        CloseHandle(handle);
-        return true;
-    }
-
-    if(size>oldsize.QuadPart)
-    {
-        /**
-        if(SetFileValidData(handle, size)==FALSE)
-        {
-            CloseHandle(handle);
-            return false;
-        }
-        **/
-
-        wxFileOffset s=size-oldsize.QuadPart;
-
-        DWORD ret=SetFilePointer(handle, 0, nullptr, FILE_END);
-        if(ret==INVALID_SET_FILE_POINTER && GetLastError()!=NO_ERROR)
-        {
-            CloseHandle(handle);
-            return false;
-        }
-
-        static char *buf=nullptr;
-        static vector<char> buffervector;
-        if(buf==nullptr)
-        {
-            buffervector.resize(256*1024);
-            buf=&buffervector[0];
-            ZeroMemory(buf, 256*1024);
-        }
-
-        DWORD len=256*1024, wlen;
-
-        do
-        {
-            if(len>s) len = DWORD(s);
-            WriteFile(handle, buf, len, &wlen, nullptr);
-        }
-        while((s-=len)>0);
-
-    }
-    else    // less
-    {
-        oldsize.QuadPart=size;
-        DWORD ret=SetFilePointer(handle, oldsize.LowPart, &oldsize.HighPart, FILE_BEGIN);
-        if(ret==INVALID_SET_FILE_POINTER && GetLastError()!=NO_ERROR)
-        {
-            CloseHandle(handle);
-            return false;
-        }
-    }
-
-    bool ok= (SetEndOfFile(handle)!=FALSE);
-    CloseHandle(handle);
-    return ok;
-
-#else
-
-    int utf8test=MadFileNameIsUTF8(filename);
-    MadConvFileName_WC2MB_UseLibc uselibc(utf8test<0);
-    if(utf8test==0)
-    {
-        // create a new file
-        wxFile f(filename, wxFile::write);
-    }
-
-    return 0==truncate( wxConvFile.cWX2MB(filename.c_str()), size );
-
-#endif
-}
-
-void MadLines::WriteBlockToData(MadOutData *data, const xm::BlockIterator &bit)
+void MadLines::WriteBlockToData(MadOutData *data, const xm::BlockIterator &bit, MadContentHash *hash)
 {
     wxASSERT(data!=nullptr);
 
@@ -2417,12 +2163,15 @@ void MadLines::WriteBlockToData(MadOutData *data, const xm::BlockIterator &bit)
         pos += bs;
 
         data->Put(m_WriteBuffer, bs);
+        if(hash != nullptr)
+            hash->Update(m_WriteBuffer, bs);
     }
     while((size -= bs) > 0);
 }
 
 void MadLines::WriteToFile(wxFile &file, MadFileData *oldfd, MadFileData *newfd)
 {
+    MadContentHash hash;
     if(m_Size > 0)
     {
         if(m_WriteBuffer == nullptr)
@@ -2455,6 +2204,7 @@ void MadLines::WriteToFile(wxFile &file, MadFileData *oldfd, MadFileData *newfd)
                         pos += bs;
 
                         file.Write(m_WriteBuffer, bs);
+                        hash.Update(m_WriteBuffer, bs);
                     }
                     while((size -= bs) > 0);
 
@@ -2472,6 +2222,7 @@ void MadLines::WriteToFile(wxFile &file, MadFileData *oldfd, MadFileData *newfd)
         }
         while(++lit != m_LineList.end());
     }
+    m_SavedContent = hash.GetHash();
 }
 
 wxFileOffset MadLines::GetMaxTempSize(const wxString &filename)
@@ -2656,6 +2407,14 @@ void MadLines::DetectSyntax(const wxString &filename)
 
 bool MadLines::SaveToFile(const wxString& filename, const wxString& tempdir)
 {
+    XM_PERF_SCOPE(PERF_SAVE_TO_FILE);
+
+    if(m_SaveThread != nullptr)
+        EndSaveToFileAsync();
+
+    // the blocks will refer to the new data
+    ClearDecodedRows();
+
     if (!m_manual)
         DetectSyntax(filename);
 
@@ -2759,6 +2518,7 @@ bool MadLines::SaveToFile(const wxString& filename, const wxString& tempdir)
 
     if(m_Size==0)
     {
+        m_SavedContent = MadContentHash().GetHash();
         if(m_FileData->m_File.SeekEnd(0)!=0)
         {
             m_FileData->m_File.Close();
@@ -2804,6 +2564,7 @@ bool MadLines::SaveToFile(const wxString& filename, const wxString& tempdir)
 
     MadLineIterator write_lit;
     xm::BlockIterator write_bit, write_bitend;
+    MadContentHash contenthash;
 
     MadLineIterator file_lit;
     xm::BlockIterator file_bit, file_bitend;
@@ -2940,9 +2701,9 @@ bool MadLines::SaveToFile(const wxString& filename, const wxString& tempdir)
             while(writable_size < write_bit->m_Size);
         }
 
-        // write the block to file
+        // write the block to file, the blocks are written in order
         m_FileData->m_SavePos=writepos;
-        WriteBlockToData(m_FileData, write_bit);
+        WriteBlockToData(m_FileData, write_bit, &contenthash);
 
         if(write_bit->m_Data==m_FileData)
         {
@@ -3015,6 +2776,7 @@ bool MadLines::SaveToFile(const wxString& filename, const wxString& tempdir)
     m_FileData->m_Size=m_Size;
     m_FileData->m_Buf1Pos=-1;
     m_FileData->m_Buf2Pos=-1;
+    m_SavedContent = contenthash.GetHash();
 
     if(tempmemdata!=nullptr)
     {
@@ -3029,6 +2791,350 @@ bool MadLines::SaveToFile(const wxString& filename, const wxString& tempdir)
     return true;
 }
 
+//===========================================================================
+// Asynchronous Saving
+//===========================================================================
+
+DEFINE_LOCAL_EVENT_TYPE( wxmEVT_ASYNCSAVE_PROGRESS )
+DEFINE_LOCAL_EVENT_TYPE( wxmEVT_ASYNCSAVE_DONE )
+
+class MadSaveThread : public wxThread
+{
+public:
+    wxEvtHandler    *m_Handler;
+    wxString        m_FileName, m_TempFileName;
+    wxFile          m_TempFile;    // created by the main thread
+
+    std::unique_ptr<MadMemDataSnapshot> m_MemData;
+    std::unique_ptr<MadFileDataReader>  m_FileData;    // nullptr if there is no file data
+
+    xm::BlockVector         m_Blocks;      // the snapshot, m_Data is m_MemData or m_FileData
+    vector<MadSaveMapping>  m_Mappings;    // sorted by OldPos
+    wxFileOffset            m_Total;
+    bool                    m_Success;
+    MadContentHash          m_Content;     // of the bytes written
+
+    MadSaveThread(wxEvtHandler *handler)
+        : wxThread(wxTHREAD_JOINABLE), m_Handler(handler), m_Total(0), m_Success(false)
+    {}
+
+    virtual ExitCode Entry() override;
+
+private:
+    void PostProgress(wxEventType type, int val)
+    {
+        wxCommandEvent evt(type);
+        evt.SetInt(val);
+        evt.SetClientData(this);
+        wxPostEvent(m_Handler, evt);
+    }
+};
+
+wxThread::ExitCode MadSaveThread::Entry()
+{
+    // the writing of an asynchronous saving is counted as a SaveToFile()
+    XM_PERF_SCOPE(PERF_SAVE_TO_FILE);
+
+    vector<wxByte> buffer(BUFFER_SIZE);
+    wxFileOffset written = 0;
+    int percent = 0;
+
+    m_Success = true;
+
+    for(xm::BlockIterator bit = m_Blocks.begin(); m_Success && bit != m_Blocks.end(); ++bit)
+    {
+        wxFileOffset pos = bit->m_Pos;
+        wxFileOffset size = bit->m_Size;
+
+        while(size > 0)
+        {
+            if(TestDestroy())
+            {
+                m_Success = false;
+                break;
+            }
+
+            size_t bs = BUFFER_SIZE;
+            if(BUFFER_SIZE > size)
+                bs = size_t(size);
+
+            bit->m_Data->Get(pos, &buffer[0], bs);
+            if(m_TempFile.Write(&buffer[0], bs) != bs)
+            {
+                m_Success = false;
+                break;
+            }
+            m_Content.Update(&buffer[0], bs);
+
+            pos += bs;
+            size -= bs;
+            written += bs;
+
+            int p = int(written * 100 / m_Total);
+            if(p != percent)
+            {
+                percent = p;
+                PostProgress(wxmEVT_ASYNCSAVE_PROGRESS, percent);
+            }
+        }
+    }
+
+    if(m_Success)
+        m_Success = m_TempFile.Flush();
+    m_TempFile.Close();
+
+    PostProgress(wxmEVT_ASYNCSAVE_DONE, m_Success? 1: 0);
+
+    return (ExitCode)0;
+}
+
+bool MadLines::BeginSaveToFileAsync(const wxString& filename, wxEvtHandler *handler)
+{
+    if(m_SaveThread != nullptr)
+        EndSaveToFileAsync();
+
+    if(filename == m_Name && m_ReadOnly)
+        return false;
+
+    if (!m_manual)
+        DetectSyntax(filename);
+
+    int utf8test=MadFileNameIsUTF8(filename);
+#ifndef __WXMSW__
+    if(utf8test==0) // not found
+    {
+        // test parent dir
+        wxFileName fn(filename);
+        utf8test=MadDirExists(fn.GetPath(wxPATH_GET_VOLUME));
+    }
+#endif
+    MadConvFileName_WC2MB_UseLibc uselibc(utf8test<0);
+
+    // write to a temporary file in the same dir, then rename it to filename
+    wxString tempfilename = filename + wxT(".wxMEdit.saving");
+    int id=0;
+    while(wxFileExists(tempfilename + wxString::Format(wxT("%d"), id))) ++id;
+    tempfilename<<id;   // append "id"
+
+    std::unique_ptr<MadSaveThread> thread(new MadSaveThread(handler));
+    thread->m_FileName = filename;
+    thread->m_TempFileName = tempfilename;
+
+    {
+        wxLogNull nolog;
+        if(!thread->m_TempFile.Create(tempfilename.c_str(), true))
+            return false;
+    }
+
+#ifndef __WXMSW__
+    // keep the permissions of the original file
+    struct stat st;
+    if(stat(wxConvFile.cWX2MB(filename.c_str()), &st) == 0)
+        chmod(wxConvFile.cWX2MB(tempfilename.c_str()), st.st_mode & 07777);
+#endif
+
+    // a symbolic link, a file with hard links or of another owner would be
+    // replaced by the renamed temporary file, so it's saved synchronously in place
+    if(wxm::MustWriteInPlace(filename, tempfilename))
+    {
+        thread->m_TempFile.Close();
+        wxRemoveFile(tempfilename);
+        return false;
+    }
+
+    MadInData *filedata = nullptr;
+    if(m_FileData != nullptr)
+    {
+        thread->m_FileData.reset(new MadFileDataReader(m_FileData));
+        filedata = thread->m_FileData.get();
+    }
+    thread->m_MemData.reset(new MadMemDataSnapshot(m_MemData));
+    MadInData *memdata = thread->m_MemData.get();
+
+    bool ok = (filedata == nullptr || thread->m_FileData->IsOpened());
+
+    // take the snapshot, the adjacent blocks are merged
+    xm::BlockVector &blocks = thread->m_Blocks;
+    vector<MadSaveMapping> &mappings = thread->m_Mappings;
+    wxFileOffset newpos = 0;
+
+    for(MadLineIterator lit = m_LineList.begin(); ok && lit != m_LineList.end(); ++lit)
+    {
+        for(xm::BlockIterator bit = lit->m_Blocks.begin(); bit != lit->m_Blocks.end(); ++bit)
+        {
+            if(bit->m_Size == 0)
+                continue;
+
+            MadInData *data = nullptr;
+            if(bit->m_Data == m_MemData)
+            {
+                data = memdata;
+            }
+            else if(m_FileData != nullptr && bit->m_Data == m_FileData)
+            {
+                data = filedata;
+
+                if(!mappings.empty() && mappings.back().OldPos + mappings.back().Size == bit->m_Pos
+                    && mappings.back().NewPos + mappings.back().Size == newpos)
+                {
+                    mappings.back().Size += bit->m_Size;
+                }
+                else
+                {
+                    mappings.push_back(MadSaveMapping(bit->m_Pos, bit->m_Size, newpos));
+                }
+            }
+            else
+            {
+                wxASSERT(0); // unknown data
+                ok = false;
+                break;
+            }
+
+            if(!blocks.empty() && blocks.back().m_Data == data
+                && blocks.back().m_Pos + blocks.back().m_Size == bit->m_Pos)
+            {
+                blocks.back().m_Size += bit->m_Size;
+            }
+            else
+            {
+                blocks.push_back(MadBlock(data, bit->m_Pos, bit->m_Size));
+            }
+
+            newpos += bit->m_Size;
+        }
+    }
+
+    wxASSERT(!ok || newpos == m_Size);
+
+    thread->m_Total = newpos;
+    std::sort(mappings.begin(), mappings.end());
+
+    if(ok)
+        ok = (thread->Create() == wxTHREAD_NO_ERROR && thread->Run() == wxTHREAD_NO_ERROR);
+
+    if(!ok)
+    {
+        thread->m_TempFile.Close();
+        wxRemoveFile(tempfilename);
+        return false;
+    }
+
+    m_SaveThread = thread.release();
+    return true;
+}
+
+bool MadLines::EndSaveToFileAsync(wxString *keptfile)
+{
+    if(m_SaveThread == nullptr)
+        return false;
+
+    std::unique_ptr<MadSaveThread> thread(m_SaveThread);
+    m_SaveThread = nullptr;
+
+    thread->Wait();
+    thread->m_FileData.reset();
+
+    MadConvFileName_WC2MB_UseLibc uselibc(MadFileNameIsUTF8(thread->m_TempFileName)<0);
+
+    if(!thread->m_Success)
+    {
+        wxRemoveFile(thread->m_TempFileName);
+        return false;
+    }
+
+    MadFileData *newfd = new MadFileData(thread->m_TempFileName);
+    if(!newfd->OpenSuccess())
+    {
+        delete newfd;
+        wxRemoveFile(thread->m_TempFileName);
+        return false;
+    }
+
+    // the lines may be edited while saving, so remap the remaining file blocks
+    MadFileData *oldfd = m_FileData;
+    if(oldfd != nullptr)
+    {
+        RemapFileBlocks(oldfd, newfd, thread->m_Mappings);
+
+        // an opened file can't be replaced under Windows
+        oldfd->m_File.Close();
+    }
+
+    // replace the target file by the temporary file
+    if(!newfd->Rename(thread->m_FileName))
+    {
+        if(oldfd != nullptr && !oldfd->OpenFile())
+        {
+            // the blocks can only be kept by the temporary file
+            delete oldfd;
+            m_FileData = newfd;
+            if(keptfile != nullptr)
+                *keptfile = thread->m_TempFileName;
+            return false;
+        }
+
+        // the target file is not changed, let the blocks refer to it again
+        if(oldfd != nullptr)
+            RemapFileBlocks(newfd, oldfd, InvertSaveMappings(thread->m_Mappings));
+
+        delete newfd;
+        wxRemoveFile(thread->m_TempFileName);
+        return false;
+    }
+
+    delete oldfd;
+    m_FileData = newfd;
+
+    m_Name = thread->m_FileName;
+    m_ReadOnly = m_FileData->IsReadOnly();
+    m_SavedContent = thread->m_Content.GetHash();
+
+    return true;
+}
+
+void MadLines::RemapFileBlocks(MadFileData *oldfd, MadFileData *newfd, const vector<MadSaveMapping> &mappings)
+{
+    MadLineIterator lit = m_LineList.begin();
+    do
+    {
+        ::RemapFileBlocks(lit->m_Blocks, oldfd, newfd, m_MemData, mappings);
+    }
+    while(++lit != m_LineList.end());
+
+    // the deleted bytes of oldfd are kept by the undos too
+    m_MadEdit->m_UndoBuffer->RemapFileBlocks(oldfd, newfd, mappings);
+
+    ClearDecodedRows();
+}
+
+bool MadLines::CompactMemData()
+{
+    // the snapshot of the saving thread shares the buffers of m_MemData
+    if(m_SaveThread != nullptr)
+        return false;
+
+    vector<xm::BlockVector*> blocks;
+    blocks.reserve(m_LineCount);
+    MadLineIterator lit = m_LineList.begin();
+    do
+    {
+        blocks.push_back(&lit->m_Blocks);
+    }
+    while(++lit != m_LineList.end());
+
+    // the decoded rows are kept: the moved bytes get new positions and the
+    // old ones are never used again, so only the rows of them are decoded again
+    return m_MadEdit->m_UndoBuffer->CompactMemData(blocks);
+}
+
+wxString MadLines::GetSavingFileName()
+{
+    if(m_SaveThread == nullptr)
+        return wxEmptyString;
+    return m_SaveThread->m_FileName;
+}
+
 MadLineList::MadLineList()
 {
 }
@@ -13,6 +13,7 @@
 #include "../xm/line_enc_adapter.h"
 #include "../xm/encoding/encoding.h"
 #include "../wxm/def.h"
+#include "wxm_data.h"
 
 #ifdef _MSC_VER
 # pragma warning( push )
@@ -43,10 +44,19 @@ using namespace U_ICU_NAMESPACE;
 
 #include <vector>
 #include <list>
+#include <map>
 #include <deque>
 #include <utility>
 #include <exception>
 
+// posted by the worker thread of MadLines::BeginSaveToFileAsync(),
+// the int of the wxCommandEvent is the percentage, or the result(0/1) when done,
+// and the client data is the worker thread
+BEGIN_DECLARE_EVENT_TYPES()
+    DECLARE_LOCAL_EVENT_TYPE( wxmEVT_ASYNCSAVE_PROGRESS, wxNewEventType() )
+    DECLARE_LOCAL_EVENT_TYPE( wxmEVT_ASYNCSAVE_DONE, wxNewEventType() )
+END_DECLARE_EVENT_TYPES()
+
 class MadEdit;
 
 namespace wxm
@@ -192,150 +202,6 @@ using std::list;
 using std::deque;
 using std::pair;
 
-//===========================================================================
-// MadFileNameIsUTF8, MadDirExists, MadConvFileName_WC2MB_UseLibc
-// for Testing/Converting of FileName Encoding under Linux
-//===========================================================================
-
-// return 0: filename is not found, 1:yes, -1:no
-int MadFileNameIsUTF8(const wxString& filename);
-
-// return 0: name is not a dir or not found, 1:yes(utf8), -1:yes(libc)
-int MadDirExists(const wxString& name);
-
-extern bool g_WC2MB_2_utf8;
-extern bool g_MB2WC_is_utf8;
-extern bool g_MB2WC_check_dir_filename;//check dir, filename separately
-
-class MadConvFileName_WC2MB_UseLibc
-{
-public:
-    MadConvFileName_WC2MB_UseLibc(bool uselibc)
-    {
-        g_WC2MB_2_utf8 = !uselibc;
-    }
-    ~MadConvFileName_WC2MB_UseLibc()
-    {
-        g_WC2MB_2_utf8=true;
-    }
-};
-
-#ifndef __WXMSW__
-class MadConvFileName : public wxMBConv
-{
-public:
-    virtual size_t MB2WC(wchar_t *outputBuf, const char *psz, size_t outputSize) const override;
-    virtual size_t WC2MB(char *outputBuf, const wchar_t *psz, size_t outputSize) const override;
-    virtual wxMBConv *Clone() const override { return new MadConvFileName; }
-};
-#endif
-
-//==================================================
-class MadInData
-{
-protected:
-    wxFileOffset m_Size;
-public:
-    virtual ~MadInData() {}
-    virtual wxByte Get(const wxFileOffset &pos) = 0;
-    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) = 0;
-    wxFileOffset GetSize() { return m_Size; }
-};
-
-class MadOutData
-{
-public:
-    virtual ~MadOutData() {}
-    virtual wxFileOffset Put(wxByte *buffer, size_t size) = 0;
-};
-
-
-class MadMemData : public MadInData, public MadOutData
-{
-private:
-    friend class MadLines;
-    friend class MadEdit;
-
-    vector <wxByte*> m_Buffers;
-    void Reset() { m_Size = 0; }
-
-public:
-    MadMemData();
-    virtual ~MadMemData();
-
-    virtual wxByte Get(const wxFileOffset &pos) override;
-    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) override;
-    virtual wxFileOffset Put(wxByte *buffer, size_t size) override;
-};
-
-class MadFileData : public MadInData, public MadOutData
-{
-private:
-    friend class MadLines;
-
-    wxFile m_File;
-    bool m_OpenSuccess;
-    wxString m_Name;
-    bool m_ReadOnly;
-
-    wxByte *m_Buffer1,*m_Buffer2;
-    wxFileOffset m_Buf1Pos,m_Buf2Pos;
-
-    wxFileOffset m_SavePos; // for Put()
-
-    bool OpenFile();
-    bool Rename(const wxString &name);
-
-public:
-    MadFileData(const wxString &name);
-    virtual ~MadFileData();
-    virtual wxByte Get(const wxFileOffset &pos) override;
-    virtual void Get(const wxFileOffset &pos, wxByte *buffer, size_t size) override;
-
-    virtual wxFileOffset Put(wxByte *buffer, size_t size) override;
-    void Read(const wxFileOffset &pos, wxByte *buffer, size_t size)
-    {
-        m_File.Seek(pos);
-        m_File.Read(buffer, size);
-    }
-
-    bool OpenSuccess() { return m_OpenSuccess; }
-    bool IsReadOnly() { return m_ReadOnly; }
-};
-
-//==================================================
-
-struct MadBlock//:public Loki::SmallObject <>
-{
-    MadInData   *m_Data;
-    wxFileOffset m_Pos;
-    wxFileOffset m_Size;
-
-    MadBlock():m_Data(nullptr), m_Pos(0), m_Size(0)
-    {
-    }
-    MadBlock(MadInData *data, const wxFileOffset &pos, const wxFileOffset &size)
-        :m_Data(data), m_Pos(pos), m_Size(size)
-    {
-    }
-    void Reset()
-    {
-        m_Data = nullptr;
-        m_Pos = 0;
-        m_Size = 0;
-    }
-    wxByte Get(const wxFileOffset &pos)
-    {
-        wxASSERT(pos >= 0 && pos < m_Size);
-        return m_Data->Get(m_Pos + pos);
-    }
-    void Get(const wxFileOffset &pos, wxByte *buffer, size_t size)
-    {
-        wxASSERT(pos >= 0 && pos < m_Size);
-        m_Data->Get(m_Pos + pos, buffer, size);
-    }
-};
-
 struct MadRowIndex    // wrapped-line index
 {
     wxFileOffset m_Start;                   // start position
@@ -393,6 +259,11 @@ struct BracePairIndex
 
 typedef vector < MadRowIndex >::iterator MadRowIndexIterator;
 
+inline bool MadRowIndexStartLess(const wxFileOffset &pos, const MadRowIndex &rowidx)
+{
+    return pos < rowidx.m_Start;
+}
+
 struct MadLine
 {
     xm::BlockVector         m_Blocks;
@@ -467,6 +338,10 @@ struct MadLine
     {
         return m_RowIndices.size() - 1;
     }
+
+    // the subrow containing linepos, the row indices are searched by binary
+    // search, for the long lines with many rows
+    int GetSubRow(const wxFileOffset &linepos);
 };
 
 //==================================================
@@ -475,6 +350,25 @@ typedef xm::UCQueue::iterator      UCQueueIterator;
 typedef list<MadLine>::iterator    MadLineIterator;
 typedef vector<wxString>::iterator MadStringIterator;
 
+// reads the bytes sequentially from a position of the lines on, it keeps the
+// current block, so the next read doesn't seek the block from the beginning
+// of the line again like MadLine::Get(); the data of a large binary file in
+// HexMode is one line of many blocks after editing
+class MadBytesReader
+{
+private:
+    MadLineIterator m_LineIter, m_LineEnd;
+    xm::BlockIterator m_BlockIter;
+    wxFileOffset m_BlockPos;
+    bool m_AtEnd;
+
+public:
+    MadBytesReader(const MadLineIterator &lit, wxFileOffset linepos, const MadLineIterator &lineend);
+
+    // return the number of bytes read, less than size at the end of the data
+    size_t Read(wxByte *buf, size_t size);
+};
+
 class MadLineList : public list <MadLine>
 {
     list<MadLineIterator> m_BookmarkList;
@@ -502,9 +396,60 @@ private:
 };
 typedef list<MadLineIterator>::iterator  MadBookmarkIterator;
 
+//==================================================
+
+// the decoded chars of a row, for the rows painted and edited repeatedly;
+// they are decoded from the beginning of the row as far as they are read, and
+// only the chars from the first changed byte on are decoded again after the
+// line is edited
+struct MadDecodedRow
+{
+    wxFileOffset            m_Start;    // linepos of the row
+    wxUint32                m_Stamp;    // last used
+    xm::BlockVector         m_Blocks;   // the bytes of the decoded chars
+    vector<xm::CharUnit>    m_Chars;    // including the newline chars of the last row
+    vector<wxFileOffset>    m_Offsets;  // linepos of m_Chars[i], and the end of the decoded bytes
+
+    // set by MadEdit: the xpos of the first chars in the row as far as they
+    // are measured, the pixel-width of m_Chars[i] is m_XPos[i+1]-m_XPos[i]
+    wxUint64                m_WidthSignature;   // 0: not set
+    int                     m_RowWidth;         // the tab chars are fit in
+    vector<int>             m_XPos;
+
+    // remove the chars from linepos on
+    void Truncate(wxFileOffset linepos);
+};
+
+// a bounded LRU cache of MadDecodedRow, by the lines and the linepos of the rows
+class MadDecodedRowCache
+{
+private:
+    typedef std::map<std::pair<const MadLine*, wxFileOffset>, MadDecodedRow*> RowMap;
+    typedef std::pair<wxUint32, RowMap::iterator> RowStamp;
+    RowMap      m_Rows;
+    wxUint32    m_Clock;
+
+    static bool RowStampLess(const RowStamp &a, const RowStamp &b) { return a.first < b.first; }
+
+public:
+    enum { MAX_ROWS = 1024, MAX_CHARS = 4 * 1024 * 1024 };
+
+    MadDecodedRowCache() : m_Clock(0) {}
+    ~MadDecodedRowCache() { Clear(); }
+
+    void Clear();
+    // get the row of the line beginning at linepos start, an empty one if it's
+    // not cached; the chars decoded from the bytes changed since are removed
+    MadDecodedRow *Get(const MadLine &line, wxFileOffset start);
+    // remove the least recently used rows except keep to fit the limits
+    void Shrink(MadDecodedRow *keep);
+};
+
 class MadEdit;
 class MadSyntax;
 struct MadSyntaxRange;
+class MadSaveThread;
+class MadContentHash;
 
 class MadLines: public xm::UChar32BytesMapper
 {
@@ -559,14 +504,17 @@ private:
     // append lit2 after lit1
     void Append(const MadLineIterator &lit1, const MadLineIterator &lit2);
 
-    // write to fd or file if which one isn't Null
-    void WriteBlockToData(MadOutData *fd, const xm::BlockIterator &bit);
+    // write to fd or file if which one isn't Null, and hash the bytes if hash isn't Null
+    void WriteBlockToData(MadOutData *fd, const xm::BlockIterator &bit, MadContentHash *hash = nullptr);
     void WriteToFile(wxFile &file, MadFileData *oldfd, MadFileData *newfd);
 
     wxFileOffset GetMaxTempSize(const wxString &filename);
 
     void InitFileSyntax();
 
+    MadSaveThread *m_SaveThread;   // worker of asynchronous saving
+    wxUint64 m_SavedContent;       // MadContentHash of the file saved last
+
 public:
     MadLines(MadEdit *madedit);
     virtual ~MadLines();
@@ -575,6 +523,36 @@ public:
     bool SaveToFile(const wxString& filename, const wxString& tempdir);
     wxFileOffset GetSize() { return m_Size; }
 
+    // Asynchronous saving: take a snapshot of the blocks and write them to
+    // a temporary file beside filename by a worker thread, which posts
+    // wxmEVT_ASYNCSAVE_PROGRESS/wxmEVT_ASYNCSAVE_DONE events to handler;
+    // the lines can be edited while saving; return false if filename must be
+    // written in place, see wxm::MustWriteInPlace(), or the saving cannot begin
+    bool BeginSaveToFileAsync(const wxString& filename, wxEvtHandler *handler);
+    // wait for the worker thread, then replace filename by the temporary
+    // file and remap the file blocks to it; return false if saving failed.
+    // if neither filename nor the original file can be opened after saving,
+    // the lines refer to the temporary file, which is kept and put to keptfile
+    bool EndSaveToFileAsync(wxString *keptfile = nullptr);
+    bool IsSavingAsync() { return m_SaveThread != nullptr; }
+    // the events posted by a finished saving may arrive after a new saving begins
+    bool IsAsyncSaveEvent(wxCommandEvent &evt)
+    {
+        return m_SaveThread != nullptr && evt.GetClientData() == (void*)m_SaveThread;
+    }
+    wxString GetSavingFileName();
+    // the MadContentHash of the bytes written by the last successful saving
+    wxUint64 GetSavedContentHash() { return m_SavedContent; }
+
+    // release the bytes of m_MemData which are referred by neither the lines
+    // nor the undos in memory, it's skipped while saving asynchronously;
+    // a part is compacted at a time, return true if there is more
+    bool CompactMemData();
+
+private:
+    // let the blocks of oldfd in the lines and the undos refer to newfd
+    void RemapFileBlocks(MadFileData *oldfd, MadFileData *newfd, const vector<MadSaveMapping> &mappings);
+
 private:  // NextUChar()
     wxByte          *m_NextUChar_Buffer;
     size_t          m_NextUChar_BufferStart;
@@ -588,6 +566,17 @@ private:  // NextUChar()
     wxFileOffset    m_NextUChar_LineSize;
     wxFileOffset    m_NextUChar_Pos;
 
+    MadDecodedRowCache m_DecodedRows;
+    MadDecodedRow   *m_NextUChar_Decoded;   // NextUChar() from the decoded chars if not null
+    size_t          m_NextUChar_DecodedIndex;
+    size_t          m_NextUChar_DecodedRow; // the row of m_NextUChar_Decoded
+    wxFileOffset    m_NextUChar_DecodedEnd; // linepos of the next row
+
+    void StartDecodedRow(const MadLineIterator &iter, size_t row);
+    // decode more chars of the row before end and cache them, NextUChar() keeps
+    // its position; return false if there are none or the row is too long
+    bool DecodeRowChars(MadDecodedRow *dr, const MadLineIterator &iter, wxFileOffset end);
+
     bool m_manual;
 
     UErrorCode m_line_bi_status;
@@ -621,6 +610,19 @@ public:
     void SetEncoding(xm::Encoding *encoding);
 
     void InitNextUChar(const MadLineIterator &iter, const wxFileOffset pos);
+    // same as InitNextUChar() from the beginning of the row, but NextUChar()
+    // gets the chars of the rows by DecodeRow() and decodes only the ones not
+    // cached yet; return the decoded row
+    MadDecodedRow *InitNextUCharDecoded(const MadLineIterator &iter, size_t row);
+
+    // get the cached chars of the row, they are decoded as NextUChar() reads
+    // them from InitNextUCharDecoded()
+    MadDecodedRow *DecodeRow(const MadLineIterator &iter, size_t row);
+    void ClearDecodedRows()
+    {
+        m_NextUChar_Decoded = nullptr;
+        m_DecodedRows.Clear();
+    }
 
     bool NextUChar(xm::UCQueue &ucqueue);
     bool NextUChar(wxm::ExtUCQueue &ucq)
@@ -636,5 +638,4 @@ public:
     xm::CharUnit PreviousUChar(/*IN_OUT*/MadLineIterator &lit, /*IN_OUT*/wxFileOffset &linepos);
 };
 
-
 #endif
@@ -0,0 +1,371 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wxmedit/wxm_recovery.cpp
+// Description: Recovery Journal of Unsaved Edits
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxm_recovery.h"
+#include  "../xm/cxx11.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/process.h>
+#include <wx/utils.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <cstring>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace
+{
+
+const char JOURNAL_MAGIC[] = "wxMEdit recovery journal 1\n";
+const size_t JOURNAL_MAGIC_SIZE = sizeof(JOURNAL_MAGIC) - 1;
+const size_t JOURNAL_BUFFER_SIZE = 256 * 1024;
+const wxUint32 MAX_STRING_SIZE = 64 * 1024;
+
+template <typename T>
+inline void AppendValue(vector<wxByte> &buffer, const T &value)
+{
+    const wxByte *b = (const wxByte *)&value;
+    buffer.insert(buffer.end(), b, b + sizeof(value));
+}
+
+void AppendString(vector<wxByte> &buffer, const wxString &str)
+{
+    wxCharBuffer utf8 = str.mb_str(wxConvUTF8);
+    wxUint32 len = wxUint32(strlen(utf8.data()));
+    AppendValue(buffer, len);
+    buffer.insert(buffer.end(), (const wxByte *)utf8.data(), (const wxByte *)utf8.data() + len);
+}
+
+template <typename T>
+inline bool ReadValue(wxFile &file, T &value)
+{
+    return file.Read(&value, sizeof(value)) == (ssize_t)sizeof(value);
+}
+
+bool ReadString(wxFile &file, wxString &str)
+{
+    wxUint32 len;
+    if(!ReadValue(file, len) || len > MAX_STRING_SIZE)
+        return false;
+
+    vector<char> utf8(len + 1, 0);
+    if(len != 0 && file.Read(&utf8[0], len) != (ssize_t)len)
+        return false;
+
+    str = wxString(&utf8[0], wxConvUTF8);
+    return true;
+}
+
+} // anonymous namespace
+
+//==================================================
+// MadRecoveryJournal
+
+wxString MadRecoveryJournal::s_Dir;
+unsigned long MadRecoveryJournal::s_Serial = 0;
+
+MadRecoveryJournal::MadRecoveryJournal() : m_Failed(false), m_HeaderSize(0)
+{
+    m_Header.filesize = 0;
+    m_Header.modtime = 0;
+}
+
+MadRecoveryJournal::~MadRecoveryJournal()
+{
+    Reset(m_Header);
+}
+
+void MadRecoveryJournal::FindOrphans(vector<wxString> &journals)
+{
+    if(s_Dir.IsEmpty() || !wxDirExists(s_Dir))
+        return;
+
+    wxLogNull nolog;
+    wxArrayString files;
+    wxDir::GetAllFiles(s_Dir, &files, wxT("*.journal"), wxDIR_FILES);
+
+    for(size_t i=0; i<files.GetCount(); ++i)
+    {
+        unsigned long pid;
+        wxString name = wxFileName(files[i]).GetName();
+        if(!name.BeforeFirst(wxT('-')).ToULong(&pid))
+            continue;
+
+        // the journal of a running wxMEdit, including this one
+        if(pid == wxGetProcessId() || wxProcess::Exists(int(pid)))
+            continue;
+
+        journals.push_back(files[i]);
+    }
+}
+
+wxString MadRecoveryJournal::KeepAside(const wxString &journal)
+{
+    wxLogNull nolog;
+    wxString kept = journal + wxT(".failed");
+    for(int i=1; wxFileExists(kept); ++i)
+        kept = journal + wxString::Format(wxT(".failed%d"), i);
+
+    return wxRenameFile(journal, kept, false)? kept: journal;
+}
+
+bool MadRecoveryJournal::Create()
+{
+    if(s_Dir.IsEmpty())
+        return false;
+
+    wxLogNull nolog;
+    if(!wxDirExists(s_Dir) && !wxFileName::Mkdir(s_Dir, 0777, wxPATH_MKDIR_FULL))
+        return false;
+
+    m_FileName = s_Dir + wxString::Format(wxT("%lu-%lu.journal"), wxGetProcessId(), ++s_Serial);
+    if(!m_File.Create(m_FileName, true))
+        return false;
+
+    vector<wxByte> header(JOURNAL_MAGIC, JOURNAL_MAGIC + JOURNAL_MAGIC_SIZE);
+    AppendString(header, m_Header.docname);
+    AppendString(header, m_Header.encoding);
+    AppendValue(header, m_Header.filesize);
+    AppendValue(header, m_Header.modtime);
+    m_HeaderSize = wxFileOffset(header.size());
+
+    return m_File.Write(&header[0], header.size()) == header.size();
+}
+
+bool MadRecoveryJournal::WriteBuffer()
+{
+    bool ok = m_Buffer.empty() || m_File.Write(&m_Buffer[0], m_Buffer.size()) == m_Buffer.size();
+    m_Buffer.clear();
+    return ok;
+}
+
+void MadRecoveryJournal::Reset(const MadRecoveryHeader &header)
+{
+    if(m_File.IsOpened())
+        m_File.Close();
+
+    if(!m_FileName.IsEmpty())
+    {
+        wxLogNull nolog;
+        wxRemoveFile(m_FileName);
+        m_FileName.Clear();
+    }
+
+    if(&header != &m_Header)
+        m_Header = header;
+    m_Buffer.clear();
+    m_Failed = false;
+}
+
+void MadRecoveryJournal::Record(wxFileOffset pos, wxFileOffset delsize, wxFileOffset inssize, xm::BlockVector *insdata)
+{
+    if(m_Failed || (delsize == 0 && inssize == 0))
+        return;
+
+    if(!m_File.IsOpened() && !Create())
+    {
+        // the document can't be recovered without any of the edits
+        Reset(m_Header);
+        m_Failed = true;
+        return;
+    }
+
+    // the record is appended to the buffered ones
+    m_Buffer.push_back(wxByte('E'));
+    AppendValue(m_Buffer, pos);
+    AppendValue(m_Buffer, delsize);
+    AppendValue(m_Buffer, inssize);
+
+    bool ok = true;
+    if(inssize != 0)
+    {
+        // append the inserted bytes to the record in m_Buffer, and write
+        // them in pieces when they are too large
+        xm::BlockIterator bit = insdata->begin();
+        for(; ok && bit != insdata->end(); ++bit)
+        {
+            wxFileOffset bpos = bit->m_Pos, bsize = bit->m_Size;
+            while(bsize > 0)
+            {
+                if(m_Buffer.size() >= JOURNAL_BUFFER_SIZE && !(ok = WriteBuffer()))
+                    break;
+
+                size_t used = m_Buffer.size();
+                size_t n = JOURNAL_BUFFER_SIZE - used;
+                if(wxFileOffset(n) > bsize)
+                    n = size_t(bsize);
+
+                m_Buffer.resize(used + n);
+                bit->m_Data->Get(bpos, &m_Buffer[used], n);
+                bpos += n;
+                bsize -= n;
+            }
+        }
+    }
+
+    if(!ok)
+    {
+        Reset(m_Header);
+        m_Failed = true;
+    }
+    else if(m_Buffer.size() >= JOURNAL_BUFFER_SIZE)
+        Flush();
+}
+
+void MadRecoveryJournal::SetEncoding(const wxString &encoding)
+{
+    m_Header.encoding = encoding;
+    if(!m_File.IsOpened())
+        return;
+
+    m_Buffer.push_back(wxByte('C'));
+    AppendString(m_Buffer, encoding);
+}
+
+void MadRecoveryJournal::Flush()
+{
+    if(m_Buffer.empty())
+        return;
+
+    if(!WriteBuffer())
+    {
+        Reset(m_Header);
+        m_Failed = true;
+    }
+
+    if(m_Buffer.capacity() > JOURNAL_BUFFER_SIZE)
+        vector<wxByte>().swap(m_Buffer);
+}
+
+wxFileOffset MadRecoveryJournal::GetMark()
+{
+    Flush();
+
+    // no record is written
+    if(!m_File.IsOpened())
+        return 0;
+
+    return m_File.Length();
+}
+
+void MadRecoveryJournal::Rebase(const MadRecoveryHeader &header, wxFileOffset mark)
+{
+    Flush();
+
+    wxFileOffset from = (mark > m_HeaderSize) ? mark : m_HeaderSize;
+    if(m_Failed || !m_File.IsOpened() || m_File.Length() <= from)
+    {
+        // the edits while saving were not recorded, the document can't be recovered
+        bool failed = m_Failed;
+        Reset(header);
+        m_Failed = failed;
+        return;
+    }
+
+    wxLogNull nolog;
+    wxString oldname = m_FileName;
+    m_File.Close();
+    m_FileName.Clear();
+    m_Header = header;
+
+    wxFile oldfile(oldname, wxFile::read);
+    bool ok = oldfile.IsOpened() && oldfile.Seek(from) != wxInvalidOffset && Create();
+
+    ssize_t n = 0;
+    if(ok)
+    {
+        vector<wxByte> buf(JOURNAL_BUFFER_SIZE);
+        while((n = oldfile.Read(&buf[0], JOURNAL_BUFFER_SIZE)) > 0)
+        {
+            if(m_File.Write(&buf[0], size_t(n)) != size_t(n))
+            {
+                ok = false;
+                break;
+            }
+        }
+        ok = ok && n == 0;
+    }
+
+    oldfile.Close();
+    wxRemoveFile(oldname);
+
+    if(!ok)
+    {
+        Reset(m_Header);
+        m_Failed = true;
+    }
+}
+
+//==================================================
+// MadRecoveryReader
+
+bool MadRecoveryReader::Open(const wxString &journal)
+{
+    wxLogNull nolog;
+    if(!m_File.Open(journal, wxFile::read))
+        return false;
+
+    char magic[JOURNAL_MAGIC_SIZE];
+    return m_File.Read(magic, JOURNAL_MAGIC_SIZE) == (ssize_t)JOURNAL_MAGIC_SIZE
+        && memcmp(magic, JOURNAL_MAGIC, JOURNAL_MAGIC_SIZE) == 0
+        && ReadString(m_File, m_Header.docname)
+        && ReadString(m_File, m_Header.encoding)
+        && ReadValue(m_File, m_Header.filesize)
+        && ReadValue(m_File, m_Header.modtime);
+}
+
+bool MadRecoveryReader::Next(wxFileOffset &pos, wxFileOffset &delsize, MadMemData *memdata, MadBlock &blk)
+{
+    wxByte tag = 0;
+    while(ReadValue(m_File, tag) && tag == 'C')
+    {
+        if(!ReadString(m_File, m_Header.encoding))
+            return false;
+    }
+
+    wxFileOffset inssize;
+    if(tag != 'E' || !ReadValue(m_File, pos) || !ReadValue(m_File, delsize) || !ReadValue(m_File, inssize))
+        return false;
+
+    if(pos < 0 || delsize < 0 || inssize < 0 || inssize > m_File.Length() - m_File.Tell())
+        return false;
+
+    blk.m_Data = memdata;
+    blk.m_Pos = -1;
+    blk.m_Size = inssize;
+
+    if(inssize != 0)
+    {
+        m_Buffer.resize(JOURNAL_BUFFER_SIZE);
+        do
+        {
+            size_t n = (inssize > wxFileOffset(JOURNAL_BUFFER_SIZE)) ? JOURNAL_BUFFER_SIZE : size_t(inssize);
+            if(m_File.Read(&m_Buffer[0], n) != (ssize_t)n)
+                return false;
+
+            wxFileOffset p = memdata->Put(&m_Buffer[0], n);
+            if(blk.m_Pos < 0)
+                blk.m_Pos = p;
+            inssize -= n;
+        }
+        while(inssize > 0);
+    }
+
+    return true;
+}
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wxmedit/wxm_recovery.h
+// Description: Recovery Journal of Unsaved Edits
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WXM_RECOVERY_H_
+#define _WXM_RECOVERY_H_
+
+#include "../xm/cxx11.h"
+
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/wxprec.h>
+
+#ifdef __BORLANDC__
+# pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+// Include your minimal set of headers here, or wx.h
+#include <wx/wx.h>
+#endif
+#include <wx/file.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <vector>
+using std::vector;
+
+#include "wxm_lines.h"
+
+// The recovery journal records every edit of a document as it happens:
+// position, deleted size and the inserted bytes, so its cost is proportional
+// to the size of the edits. If wxMEdit is not closed normally, the original
+// file plus the journal replays to the unsaved document.
+//
+// journal := magic header record*
+// header  := docname encoding filesize modtime
+// record  := 'E' pos delsize inssize insdata
+//          | 'C' encoding                      (the encoding is changed)
+//
+// The journal file is named by the process id, the journals of dead processes
+// are the orphans to be recovered. The records are buffered and written by
+// Flush() when the editor is idle, or when the buffer is full.
+
+struct MadRecoveryHeader
+{
+    wxString docname;       // empty for a new document
+    wxString encoding;
+    wxFileOffset filesize;  // the size and modification time of docname,
+    wxInt64 modtime;        // which the records are applied to
+};
+
+class MadRecoveryJournal
+{
+private:
+    MadRecoveryHeader m_Header;
+    wxString m_FileName;
+    wxFile m_File;
+    bool m_Failed;          // stop journaling till Reset()
+    wxFileOffset m_HeaderSize;
+    vector<wxByte> m_Buffer;    // the records not written yet
+
+    static wxString s_Dir;
+    static unsigned long s_Serial;
+
+    bool Create();
+    bool WriteBuffer();
+
+public:
+    MadRecoveryJournal();
+    ~MadRecoveryJournal();  // the journal is removed
+
+    static void SetDir(const wxString &dir) { s_Dir = dir; }
+    // get the journals left by the processes which were not closed normally
+    static void FindOrphans(vector<wxString> &journals);
+    // rename a journal which cannot be recovered so that it is not found as
+    // an orphan again, return its new name, or journal if it cannot be renamed
+    static wxString KeepAside(const wxString &journal);
+
+    // the document is loaded or saved, remove the journal and start a new one
+    // when the next edit is recorded
+    void Reset(const MadRecoveryHeader &header);
+    void Record(wxFileOffset pos, wxFileOffset delsize, wxFileOffset inssize, xm::BlockVector *insdata);
+    void SetEncoding(const wxString &encoding);
+    // write the buffered records
+    void Flush();
+
+    // the document is saved as header asynchronously and edited while saving,
+    // start a new journal with the records written after GetMark() at the
+    // beginning of saving, which are the edits applied to the saved file
+    wxFileOffset GetMark();
+    void Rebase(const MadRecoveryHeader &header, wxFileOffset mark);
+};
+
+class MadRecoveryReader
+{
+private:
+    wxFile m_File;
+    MadRecoveryHeader m_Header;
+    vector<wxByte> m_Buffer;
+
+public:
+    bool Open(const wxString &journal);
+    const MadRecoveryHeader &GetHeader() { return m_Header; }
+
+    // read the next edit, the inserted bytes are put into memdata as blk;
+    // return false at the end or at a record broken by the crash.
+    // the encoding of the header is updated by the records till the edit
+    bool Next(wxFileOffset &pos, wxFileOffset &delsize, MadMemData *memdata, MadBlock &blk);
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "wxm_syntax.h"
 #include "../xm/cxx11.h"
 #include "wxmedit.h"
+#include "../xm/perf.h"
 
 #ifdef _MSC_VER
 # pragma warning( push )
@@ -1239,6 +1240,18 @@ void MadSyntax::InitNextWord1(MadLines *madlines, ucs4_t *word, int *widths, con
         FindString=&MadSyntax::FindStringNoCase;
 }
 
+// the width of the char at idx of nw_ucqueue, it's kept in the decoded row
+// and not measured again when the row is painted next time
+int MadSyntax::WordCharWidth(ucs4_t uc, size_t idx)
+{
+    return nw_MadEdit->GetDisplayCharWidth(nw_DecodedRow, nw_DecodedIndex + idx, uc, nw_LineWidth);
+}
+
+int MadSyntax::PopWordCharWidth(ucs4_t uc)
+{
+    return nw_MadEdit->GetDisplayCharWidth(nw_DecodedRow, nw_DecodedIndex++, uc, nw_LineWidth);
+}
+
 void MadSyntax::InitNextWord2(MadLineIterator &lit, size_t row)
 {
     nw_LineIter = lit;
@@ -1251,7 +1264,8 @@ void MadSyntax::InitNextWord2(MadLineIterator &lit, size_t row)
 
     nw_RowIndexIter = lit->m_RowIndices.begin();
     std::advance(nw_RowIndexIter, row);
-    nw_MadLines->InitNextUChar(lit, nw_RowIndexIter->m_Start);
+    nw_DecodedRow = nw_MadEdit->InitDisplayRow(lit, int(row));
+    nw_DecodedIndex = 0;
 
     nw_NotSpaceCount = 0;
     nw_LineWidth = 0;
@@ -1458,6 +1472,8 @@ int MadSyntax::FindStringNoCase(xm::UCQueue & ucqueue, size_t first,
 // return wordlength
 int MadSyntax::NextWord(int &wordwidth)
 {
+    XM_PERF_SCOPE(PERF_NEXT_WORD);
+
     wordwidth = 0;
 
     if(nw_RestCount == 0)
@@ -1773,7 +1789,7 @@ int MadSyntax::NextWord(int &wordwidth)
             nw_Word[idx] = uc;
             nw_ucqueue.pop_front();
 
-            width = nw_MadEdit->GetUCharTextFontWidth(uc, nw_RowIndexIter->m_Width, nw_LineWidth);
+            width = PopWordCharWidth(uc);
             nw_Widths[idx] = width;
 
             nw_LineWidth += width;
@@ -1795,7 +1811,7 @@ int MadSyntax::NextWord(int &wordwidth)
             nw_Word[idx] = uc;
             nw_ucqueue.pop_front();
 
-            width = nw_MadEdit->GetUCharWidth(uc);
+            width = PopWordCharWidth(uc);
             nw_Widths[idx] = width;
             nw_LineWidth += width;
             ++idx;
@@ -1816,7 +1832,7 @@ int MadSyntax::NextWord(int &wordwidth)
             nw_Word[idx] = uc;
             nw_ucqueue.pop_front();
 
-            width = nw_MadEdit->GetUCharWidth(uc);
+            width = PopWordCharWidth(uc);
             nw_Widths[idx] = width;
             nw_LineWidth += width;
             ++idx;
@@ -1837,7 +1853,7 @@ int MadSyntax::NextWord(int &wordwidth)
             nw_Word[idx] = uc;
             nw_ucqueue.pop_front();
 
-            width = nw_MadEdit->GetUCharWidth(uc);
+            width = PopWordCharWidth(uc);
             nw_Widths[idx] = width;
             nw_LineWidth += width;
             ++idx;
@@ -1861,7 +1877,7 @@ int MadSyntax::NextWord(int &wordwidth)
                 nw_Word[idx] = uc;
                 nw_ucqueue.pop_front();
 
-                width = nw_MadEdit->GetUCharWidth(uc);
+                width = PopWordCharWidth(uc);
                 nw_Widths[idx] = width;
                 nw_LineWidth += width;
                 ++idx;
@@ -1882,7 +1898,7 @@ int MadSyntax::NextWord(int &wordwidth)
                 nw_Word[idx] = uc;
                 nw_ucqueue.pop_front();
 
-                width = nw_MadEdit->GetUCharWidth(uc);
+                width = PopWordCharWidth(uc);
                 nw_Widths[idx] = width;
                 nw_LineWidth += width;
                 ++idx;
@@ -1905,7 +1921,7 @@ int MadSyntax::NextWord(int &wordwidth)
                 nw_Word[idx] = uc;
                 //nw_ucqueue.pop_front(); // cannot pop here
 
-                width = nw_MadEdit->GetUCharWidth(uc);
+                width = WordCharWidth(uc, idx);
                 nw_Widths[idx] = width;
                 nw_LineWidth += width;
                 ++idx;
@@ -1975,6 +1991,7 @@ int MadSyntax::NextWord(int &wordwidth)
                     nw_ucqueue.pop_front();
                     ++i;
                 }
+                nw_DecodedIndex += idx;
             }
             else
             {
@@ -1984,7 +2001,8 @@ int MadSyntax::NextWord(int &wordwidth)
                 nw_ucqueue.pop_front();
                 nw_FirstIndex = old_firstindex - 1;
                 nw_RestCount = old_rest_count - 1;
-                nw_LineWidth = old_line_width + nw_MadEdit->GetUCharWidth(nw_Word[0]);
+                nw_LineWidth = old_line_width + nw_Widths[0];
+                ++nw_DecodedIndex;
             }
 
         }
@@ -1997,7 +2015,7 @@ int MadSyntax::NextWord(int &wordwidth)
                 nw_Word[idx] = uc;
                 nw_ucqueue.pop_front();
 
-                width = nw_MadEdit->GetUCharWidth(uc);
+                width = PopWordCharWidth(uc);
                 nw_Widths[idx] = width;
                 nw_LineWidth += width;
                 ++idx;
@@ -2019,7 +2037,7 @@ int MadSyntax::NextWord(int &wordwidth)
                 nw_Word[idx] = uc;
                 nw_ucqueue.pop_front();
 
-                width = nw_MadEdit->GetUCharWidth(uc);
+                width = PopWordCharWidth(uc);
                 nw_Widths[idx] = width;
                 nw_LineWidth += width;
                 ++idx;
@@ -2100,7 +2118,7 @@ int MadSyntax::NextWord(int &wordwidth)
             nw_Word[idx] = uc;
             nw_ucqueue.pop_front();
 
-            width = nw_MadEdit->GetUCharWidth(uc);
+            width = PopWordCharWidth(uc);
             nw_Widths[idx] = width;
             nw_LineWidth += width;
             ++idx;
@@ -2171,6 +2189,9 @@ int MadSyntax::NextWord(int &wordwidth)
             MadRowIndexIterator nextit=nw_RowIndexIter;
             ++nextit;
             nw_MaxLength = size_t(nextit->m_Start - nw_RowIndexIter->m_Start);
+
+            nw_DecodedRow = nw_MadEdit->GetDisplayRow(nw_LineIter, int(nw_RowIndexIter - nw_LineIter->m_RowIndices.begin()));
+            nw_DecodedIndex = 0;
         }
     }
 
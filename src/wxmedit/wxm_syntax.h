@@ -254,6 +254,8 @@ private: // for NextWord()
 
     MadLineIterator nw_LineIter;
     MadRowIndexIterator nw_RowIndexIter;
+    MadDecodedRow *nw_DecodedRow;   // the widths of the chars in the row
+    size_t nw_DecodedIndex;         // of the front of nw_ucqueue
 
     int nw_LineWidth;
     size_t nw_FirstIndex;
@@ -277,6 +279,9 @@ private: // for NextWord()
                    size_t & len);
     FindStringPtr FindString;
 
+    int WordCharWidth(ucs4_t uc, size_t idx);
+    int PopWordCharWidth(ucs4_t uc);
+
 public:
     void InitNextWord1(MadLines *madlines, ucs4_t *word, int *widths, const wxString &fontname, int fontsize, int fontfamily);
     void InitNextWord2(MadLineIterator &lit, size_t row);
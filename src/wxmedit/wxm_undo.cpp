@@ -9,12 +9,128 @@
 #include "wxm_undo.h"
 #include  "../xm/cxx11.h"
 
+#ifdef _MSC_VER
+# pragma warning( push )
+# pragma warning( disable : 4996 )
+#endif
+// disable 4996 {
+#include <wx/filename.h>
+#include <wx/dir.h>
+#include <wx/process.h>
+// disable 4996 }
+#ifdef _MSC_VER
+# pragma warning( pop )
+#endif
+
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+
 #ifdef _DEBUG
 #include <crtdbg.h>
 #define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
 #endif
 
+//==================================================
+// Arena of MadUndoData
+
+namespace
+{
+
+const size_t UNDODATA_SLOT_SIZE = sizeof(MadOverwriteUndoData);
+const size_t UNDODATA_CHUNK_SLOTS = 1024;
+
+static_assert(sizeof(MadInsertUndoData) <= UNDODATA_SLOT_SIZE, "slot of MadUndoData is too small");
+static_assert(sizeof(MadDeleteUndoData) <= UNDODATA_SLOT_SIZE, "slot of MadUndoData is too small");
+static_assert(UNDODATA_SLOT_SIZE % sizeof(void*) == 0, "slot of MadUndoData is not aligned");
+
+// only used by the main thread
+class MadUndoDataArena
+{
+    vector<char*> m_Chunks;
+    void *m_FreeList;
+    size_t m_UsedSlots;
+
+    void ReleaseChunks()
+    {
+        for(size_t i=0; i<m_Chunks.size(); ++i)
+            delete[] m_Chunks[i];
+        m_Chunks.clear();
+        m_FreeList = nullptr;
+    }
+
+public:
+    MadUndoDataArena() : m_FreeList(nullptr), m_UsedSlots(0) {}
+    ~MadUndoDataArena() { ReleaseChunks(); }
+
+    void *Alloc()
+    {
+        if(m_FreeList == nullptr)
+        {
+            char *chunk = new char[UNDODATA_SLOT_SIZE * UNDODATA_CHUNK_SLOTS];
+            m_Chunks.push_back(chunk);
+
+            for(size_t i=UNDODATA_CHUNK_SLOTS; i>0; --i)
+            {
+                void *slot = chunk + (i-1) * UNDODATA_SLOT_SIZE;
+                *(void**)slot = m_FreeList;
+                m_FreeList = slot;
+            }
+        }
+
+        void *slot = m_FreeList;
+        m_FreeList = *(void**)slot;
+        ++m_UsedSlots;
+        return slot;
+    }
+
+    void Free(void *slot)
+    {
+        *(void**)slot = m_FreeList;
+        m_FreeList = slot;
+
+        // give the memory back after all undo buffers were cleared
+        if(--m_UsedSlots == 0)
+            ReleaseChunks();
+    }
+};
+
+MadUndoDataArena& UndoDataArena()
+{
+    static MadUndoDataArena arena;
+    return arena;
+}
+
+} // anonymous namespace
+
+#undef new
+
+void *MadUndoData::operator new(size_t size)
+{
+    wxASSERT(size <= UNDODATA_SLOT_SIZE);
+    return UndoDataArena().Alloc();
+}
+
+void MadUndoData::operator delete(void *p)
+{
+    if(p != nullptr)
+        UndoDataArena().Free(p);
+}
+
+#ifdef _DEBUG
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+//==================================================
+
 MadUndo::~MadUndo()
+{
+    ClearData();
+}
+
+void MadUndo::ClearData()
 {
     if(m_Undos.size())
     {
@@ -26,12 +142,29 @@ MadUndo::~MadUndo()
         }
         while(++it != m_Undos.end());
 
-        //m_Undos.clear();
+        vector < MadUndoData* >().swap(m_Undos);
     }
 }
 
+namespace
+{
+
+// caret movement undo has no data, but the spilled/discarded undo has no data too
+inline bool IsCaretMovementUndo(const MadUndo &undo)
+{
+    return undo.m_State == MadUndo::usInMemory && undo.m_Undos.size() == 0;
+}
+
+} // anonymous namespace
+
+
+wxString MadUndoBuffer::s_JournalDir;
 
-MadUndoBuffer::MadUndoBuffer()
+MadUndoBuffer::MadUndoBuffer(MadMemData *memdata)
+    : m_MergeKind(mkNone), m_MergeUndo(nullptr), m_MergeLastChar(0),
+      m_MemLimit(0), m_DiscardOld(false), m_MemSize(0), m_Releasable(0), m_HasEvicted(false),
+      m_MemData(memdata), m_PendingUndo(nullptr), m_PendingIndex(0), m_DataCount(0),
+      m_Journaling(false), m_JournalSize(0), m_JournalCompactedSize(0)
 {
     m_CurrentUndo = m_UndoList.begin();
 }
@@ -43,14 +176,30 @@ MadUndoBuffer::~MadUndoBuffer()
 
 void MadUndoBuffer::Clear()
 {
+    BreakMerging();
+    CompletePending();
     m_UndoList.clear();
     m_CurrentUndo = m_UndoList.begin();
+
+    m_MemSize = 0;
+    m_Releasable = 0;
+    m_HasEvicted = false;
+    m_DataCount = 0;
+    CloseSpillFile();
 }
 
 void MadUndoBuffer::ClearTillEnd()
 {
     if(m_CurrentUndo != m_UndoList.end())
     {
+        // the evicted undos are always before m_CurrentUndo
+        for(MadUndoIterator it = m_CurrentUndo; it != m_UndoList.end(); ++it)
+        {
+            Release(*it);
+            if(!it->m_CaretMovement)
+                --m_DataCount;
+        }
+
         m_CurrentUndo = m_UndoList.erase(m_CurrentUndo, m_UndoList.end());
     }
 }
@@ -58,11 +207,17 @@ void MadUndoBuffer::ClearTillEnd()
 
 MadUndo *MadUndoBuffer::Add()
 {
+    BreakMerging();
+    CompletePending();
     ClearTillEnd();
+    Trim();
 
     static MadUndo undo;
     m_UndoList.push_back(undo);
-    return &m_UndoList.back();
+
+    m_PendingUndo = &m_UndoList.back();
+    m_PendingIndex = m_DataCount++;
+    return m_PendingUndo;
 }
 
 void MadUndoBuffer::Add(wxFileOffset caretPosBefore, wxFileOffset caretPosAfter)
@@ -74,6 +229,8 @@ void MadUndoBuffer::Add(wxFileOffset caretPosBefore, wxFileOffset caretPosAfter)
     }
 #endif
 
+    BreakMerging();
+    CompletePending();
     m_UndoList.insert(m_CurrentUndo, MadUndo(caretPosBefore, caretPosAfter) );
 }
 
@@ -85,10 +242,10 @@ MadUndo *MadUndoBuffer::GetPrevUndo()
     MadUndoIterator it = m_CurrentUndo;
     --it; // to previous
 
-    while(it!=m_UndoList.begin() && it->m_Undos.size()==0)
+    while(it!=m_UndoList.begin() && IsCaretMovementUndo(*it))
         --it;
 
-    if(it==m_UndoList.begin() && it->m_Undos.size()==0)
+    if(it==m_UndoList.begin() && IsCaretMovementUndo(*it))
         return nullptr;
 
     return &(*it);
@@ -96,30 +253,46 @@ MadUndo *MadUndoBuffer::GetPrevUndo()
 
 MadUndo *MadUndoBuffer::Undo(bool noCaretMovement)
 {
+    BreakMerging();
+    CompletePending();
+
     if(m_CurrentUndo == m_UndoList.begin())
         return nullptr;
 
+    MadUndoIterator it = m_CurrentUndo;
+    --it;
+
     if(noCaretMovement)
     {
-        --m_CurrentUndo;
-
-        while(m_CurrentUndo != m_UndoList.begin() && m_CurrentUndo->m_Undos.size()==0)
-            --m_CurrentUndo;
+        while(it != m_UndoList.begin() && IsCaretMovementUndo(*it))
+            --it;
 
-        if(m_CurrentUndo==m_UndoList.begin() && m_CurrentUndo->m_Undos.size()==0)
+        if(it==m_UndoList.begin() && IsCaretMovementUndo(*it))
             return nullptr;
-
-        return &(*m_CurrentUndo);
     }
 
-    return &(*--m_CurrentUndo);
+    if(it->m_State == MadUndo::usDiscarded)
+        return nullptr;
+
+    if(it->m_State == MadUndo::usSpilled && !Reload(it))
+        return nullptr;
+
+    m_CurrentUndo = it;
+    Reaccount(*m_CurrentUndo, false);
+    return &(*m_CurrentUndo);
 }
 
 MadUndo *MadUndoBuffer::Redo(bool noCaretMovement)
 {
+    BreakMerging();
+    CompletePending();
+    // the undos reloaded by Undo() and redone are evicted again
+    Trim();
+
     if(m_CurrentUndo == m_UndoList.end())
         return nullptr;
 
+    // the undos after m_CurrentUndo are always in memory
     if(noCaretMovement)
     {
         while(m_CurrentUndo != m_UndoList.end() && m_CurrentUndo->m_Undos.size()==0)
@@ -129,6 +302,7 @@ MadUndo *MadUndoBuffer::Redo(bool noCaretMovement)
             return nullptr;
     }
 
+    Reaccount(*m_CurrentUndo, true);
     return &(*m_CurrentUndo++);
 }
 
@@ -137,19 +311,19 @@ bool MadUndoBuffer::CanUndo(bool noCaretMovement)
     if(m_CurrentUndo == m_UndoList.begin())
         return false;
 
+    MadUndoIterator it=m_CurrentUndo;
+    --it;
+
     if(noCaretMovement)
     {
-        MadUndoIterator it=m_CurrentUndo;
-        --it;
-
-        while(it!=m_UndoList.begin() && it->m_Undos.size()==0)
+        while(it!=m_UndoList.begin() && IsCaretMovementUndo(*it))
             --it;
 
-        if(it==m_UndoList.begin() && it->m_Undos.size()==0)
+        if(it==m_UndoList.begin() && IsCaretMovementUndo(*it))
             return false;
     }
 
-    return true;
+    return it->m_State != MadUndo::usDiscarded;
 }
 
 bool MadUndoBuffer::CanRedo(bool noCaretMovement)
@@ -170,3 +344,1185 @@ bool MadUndoBuffer::CanRedo(bool noCaretMovement)
 
     return true;
 }
+
+//==================================================
+// Memory Limit
+
+namespace
+{
+
+const size_t SPILL_BUFFER_SIZE = 128 * 1024;
+const size_t COMPACTING_MIN_SIZE = 4 * 1024 * 1024;
+const size_t COMPACTING_STEP_SIZE = 4 * 1024 * 1024;   // moved in an idle time
+
+struct SpillDataHeader
+{
+    wxFileOffset pos, delsize, inssize;
+    int kind;       // 0: insert, 1: delete, 2: overwrite
+};
+
+struct FileOutput
+{
+    wxFile &file;
+    FileOutput(wxFile &f) : file(f) {}
+    bool Write(const void *data, size_t size) { return file.Write(data, size) == size; }
+};
+
+struct BufferOutput
+{
+    vector<wxByte> &buffer;
+    BufferOutput(vector<wxByte> &buf) : buffer(buf) {}
+    bool Write(const void *data, size_t size)
+    {
+        const wxByte *b = (const wxByte *)data;
+        buffer.insert(buffer.end(), b, b + size);
+        return true;
+    }
+};
+
+template <typename Output>
+bool WriteBlocks(Output &out, xm::BlockVector *blocks, vector<wxByte> &buffer)
+{
+    if(blocks == nullptr)
+        return true;
+
+    for(size_t i=0; i<blocks->size(); ++i)
+    {
+        MadBlock &blk = (*blocks)[i];
+        wxFileOffset pos = blk.m_Pos;
+        wxFileOffset size = blk.m_Size;
+        while(size > 0)
+        {
+            size_t bs = (size > (wxFileOffset)SPILL_BUFFER_SIZE) ? SPILL_BUFFER_SIZE : size_t(size);
+            blk.m_Data->Get(pos, &buffer[0], bs);
+            if(!out.Write(&buffer[0], bs))
+                return false;
+            pos += bs;
+            size -= bs;
+        }
+    }
+    return true;
+}
+
+// the data of an undo: count, then header, deleted and inserted bytes of each MadUndoData
+template <typename Output>
+bool WriteUndoData(Output &out, MadUndo &undo)
+{
+    vector<wxByte> buffer(SPILL_BUFFER_SIZE);
+
+    wxUint32 count = wxUint32(undo.m_Undos.size());
+    if(!out.Write(&count, sizeof(count)))
+        return false;
+
+    for(size_t i=0; i<count; ++i)
+    {
+        MadUndoData *ud = undo.m_Undos[i];
+
+        SpillDataHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.pos = ud->m_Pos;
+        hdr.delsize = ud->DelSize();
+        hdr.inssize = ud->InsSize();
+        hdr.kind = (dynamic_cast<MadInsertUndoData*>(ud) != nullptr) ? 0 :
+                   (dynamic_cast<MadDeleteUndoData*>(ud) != nullptr) ? 1 : 2;
+
+        if(!out.Write(&hdr, sizeof(hdr))
+            || !WriteBlocks(out, ud->DelData(), buffer)
+            || !WriteBlocks(out, ud->InsData(), buffer))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the deleted and inserted bytes of an undo
+wxFileOffset UndoDataSize(MadUndo &undo)
+{
+    wxFileOffset size = 0;
+    for(size_t i=0; i<undo.m_Undos.size(); ++i)
+        size += undo.m_Undos[i]->DelSize() + undo.m_Undos[i]->InsSize();
+    return size;
+}
+
+// skip the data written by WriteUndoData()
+bool SkipUndoData(wxFile &file, wxFileOffset filesize)
+{
+    wxUint32 count;
+    if(file.Read(&count, sizeof(count)) != sizeof(count))
+        return false;
+
+    for(size_t i=0; i<count; ++i)
+    {
+        SpillDataHeader hdr;
+        if(file.Read(&hdr, sizeof(hdr)) != sizeof(hdr))
+            return false;
+
+        if(hdr.delsize < 0 || hdr.inssize < 0)
+            return false;
+
+        wxFileOffset pos = file.Seek(hdr.delsize + hdr.inssize, wxFromCurrent);
+        if(pos == wxInvalidOffset || pos > filesize)
+            return false;
+    }
+    return true;
+}
+
+// the slots of the blocks, and the bytes in memdata if the lines don't refer to them
+size_t MemBlocksSize(xm::BlockVector &blocks, MadMemData *memdata, bool pinned)
+{
+    size_t size = blocks.capacity() * sizeof(MadBlock);
+    for(size_t i=0; pinned && i<blocks.size(); ++i)
+    {
+        if(blocks[i].m_Data == memdata)
+            size += size_t(blocks[i].m_Size);
+    }
+    return size;
+}
+
+// defined with the persistent journal
+void UnlockJournal(const wxString &jname);
+
+// read size bytes into memdata as a single block
+bool ReadBlock(wxFile &file, wxFileOffset size, MadMemData *memdata, MadBlock &blk, vector<wxByte> &buffer)
+{
+    blk = MadBlock(memdata, 0, size);
+    while(size > 0)
+    {
+        size_t bs = (size > (wxFileOffset)SPILL_BUFFER_SIZE) ? SPILL_BUFFER_SIZE : size_t(size);
+        if(file.Read(&buffer[0], bs) != (ssize_t)bs)
+            return false;
+
+        wxFileOffset pos = memdata->Put(&buffer[0], bs);
+        if(size == blk.m_Size)
+            blk.m_Pos = pos;
+        size -= bs;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+void MadUndoBuffer::SetMemoryLimit(size_t limit, bool discard)
+{
+    m_MemLimit = limit;
+    m_DiscardOld = discard;
+}
+
+void MadUndoBuffer::Account(MadUndo &undo, bool done)
+{
+    if(undo.m_State != MadUndo::usInMemory || undo.m_MemSize != 0)
+        return;
+
+    // only the bytes in m_MemData which the lines don't refer to are pinned by
+    // the undo: the deleted bytes if it's done, or the inserted ones if it's undone
+    size_t size = undo.m_Undos.capacity() * sizeof(MadUndoData*);
+    for(size_t i=0; i<undo.m_Undos.size(); ++i)
+    {
+        MadUndoData *ud = undo.m_Undos[i];
+        size += UNDODATA_SLOT_SIZE;
+        if(ud->DelData() != nullptr)
+            size += MemBlocksSize(*ud->DelData(), m_MemData, done);
+        if(ud->InsData() != nullptr)
+            size += MemBlocksSize(*ud->InsData(), m_MemData, !done);
+    }
+
+    undo.m_MemSize = size;
+    m_MemSize += size;
+}
+
+void MadUndoBuffer::Reaccount(MadUndo &undo, bool done)
+{
+    if(undo.m_MemSize == 0)
+        return;
+
+    m_MemSize -= undo.m_MemSize;
+    undo.m_MemSize = 0;
+    Account(undo, done);
+}
+
+void MadUndoBuffer::Release(MadUndo &undo)
+{
+    m_MemSize -= undo.m_MemSize;
+    m_Releasable += undo.m_MemSize;
+    undo.m_MemSize = 0;
+}
+
+void MadUndoBuffer::Trim()
+{
+    if(m_MemLimit == 0 || m_MemSize <= m_MemLimit)
+        return;
+
+    MadUndoIterator it = m_HasEvicted ? std::next(m_LastEvicted) : m_UndoList.begin();
+
+    // keep the last undo in memory
+    while(m_MemSize > m_MemLimit && it != m_CurrentUndo && std::next(it) != m_UndoList.end())
+    {
+        if(it->m_Undos.size() != 0)
+        {
+            // the journal has the data already
+            if((m_DiscardOld && !m_Journaling) || !Spill(*it))
+                Discard(*it);
+        }
+
+        m_LastEvicted = it;
+        m_HasEvicted = true;
+        ++it;
+    }
+}
+
+void MadUndoBuffer::Discard(MadUndo &undo)
+{
+    Release(undo);
+    undo.ClearData();
+    undo.m_State = MadUndo::usDiscarded;
+}
+
+bool MadUndoBuffer::Spill(MadUndo &undo)
+{
+    // the data were spilled before and not changed after reloading
+    if(undo.m_SpillPos < 0)
+    {
+        // the journal failed to be appended
+        if(!m_JournalDocName.IsEmpty())
+            return false;
+
+        if(!m_SpillFile.IsOpened())
+        {
+            wxLogNull nolog;
+            m_SpillFileName = wxFileName::CreateTempFileName(wxT("wxmedit_undo"));
+            if(m_SpillFileName.IsEmpty() || !m_SpillFile.Open(m_SpillFileName, wxFile::read_write))
+                return false;
+        }
+
+        wxFileOffset spillpos = m_SpillFile.SeekEnd();
+        if(spillpos == wxInvalidOffset)
+            return false;
+
+        FileOutput out(m_SpillFile);
+        if(!WriteUndoData(out, undo))
+            return false;
+
+        undo.m_SpillPos = spillpos;
+    }
+
+    Release(undo);
+    undo.ClearData();
+    undo.m_State = MadUndo::usSpilled;
+    return true;
+}
+
+bool MadUndoBuffer::Reload(MadUndoIterator it)
+{
+    MadUndo &undo = *it;
+    wxASSERT(undo.m_State == MadUndo::usSpilled && m_SpillFile.IsOpened());
+
+    if(m_Journaling && !FlushJournal())
+        return false;
+
+    if(m_SpillFile.Seek(undo.m_SpillPos) == wxInvalidOffset)
+        return false;
+
+    vector<wxByte> buffer(SPILL_BUFFER_SIZE);
+
+    wxUint32 count;
+    if(m_SpillFile.Read(&count, sizeof(count)) != sizeof(count))
+        return false;
+
+    bool ok = true;
+    vector < MadUndoData* > undos;
+    for(size_t i=0; ok && i<count; ++i)
+    {
+        SpillDataHeader hdr;
+        if(m_SpillFile.Read(&hdr, sizeof(hdr)) != sizeof(hdr))
+        {
+            ok = false;
+            break;
+        }
+
+        MadUndoData *ud;
+        if(hdr.kind == 0)
+            ud = new MadInsertUndoData();
+        else if(hdr.kind == 1)
+            ud = new MadDeleteUndoData();
+        else
+            ud = new MadOverwriteUndoData();
+        undos.push_back(ud);
+
+        ud->m_Pos = hdr.pos;
+        ud->SetDelSize(hdr.delsize);
+
+        MadBlock blk(m_MemData, -1, 0);
+        ok = ReadBlock(m_SpillFile, hdr.delsize, m_MemData, blk, buffer);
+        if(ok && hdr.delsize > 0)
+            ud->DelData()->push_back(blk);
+
+        ok = ok && ReadBlock(m_SpillFile, hdr.inssize, m_MemData, blk, buffer);
+        if(ok && hdr.inssize > 0)
+            ud->SetInsBlock(blk);
+    }
+
+    if(!ok)
+    {
+        for(size_t i=0; i<undos.size(); ++i)
+            delete undos[i];
+        return false;
+    }
+
+    undo.m_Undos.swap(undos);
+    undo.m_State = MadUndo::usInMemory;
+    Account(undo, true);
+
+    // the undos after it were passed by Undo(), so they are in memory
+    if(it == m_UndoList.begin())
+    {
+        m_HasEvicted = false;
+    }
+    else
+    {
+        m_LastEvicted = it;
+        --m_LastEvicted;
+    }
+
+    return true;
+}
+
+void MadUndoBuffer::RemapFileBlocks(MadFileData *oldfd, MadFileData *newfd, const vector<MadSaveMapping> &mappings)
+{
+    bool done = true;
+    for(MadUndoIterator it = m_UndoList.begin(); it != m_UndoList.end(); ++it)
+    {
+        if(it == m_CurrentUndo)
+            done = false;
+
+        for(size_t i=0; i<it->m_Undos.size(); ++i)
+        {
+            MadUndoData *ud = it->m_Undos[i];
+            if(ud->DelData() != nullptr)
+                ::RemapFileBlocks(*ud->DelData(), oldfd, newfd, m_MemData, mappings);
+            if(ud->InsData() != nullptr)
+                ::RemapFileBlocks(*ud->InsData(), oldfd, newfd, m_MemData, mappings);
+        }
+
+        // the bytes not written to newfd are copied to memory
+        Reaccount(*it, done);
+    }
+
+    Trim();
+}
+
+bool MadUndoBuffer::NeedCompacting()
+{
+    return m_Releasable >= COMPACTING_MIN_SIZE && m_Releasable >= m_MemLimit / 4;
+}
+
+bool MadUndoBuffer::CompactMemData(const vector<xm::BlockVector*> &blocks)
+{
+    vector<xm::BlockVector*> allblocks(blocks);
+    for(MadUndoIterator it = m_UndoList.begin(); it != m_UndoList.end(); ++it)
+    {
+        for(size_t i=0; i<it->m_Undos.size(); ++i)
+        {
+            MadUndoData *ud = it->m_Undos[i];
+            if(ud->DelData() != nullptr)
+                allblocks.push_back(ud->DelData());
+            if(ud->InsData() != nullptr)
+                allblocks.push_back(ud->InsData());
+        }
+    }
+
+    if(m_MemData->Compact(allblocks, COMPACTING_STEP_SIZE))
+        return true;
+
+    m_Releasable = 0;
+    return false;
+}
+
+void MadUndoBuffer::CloseSpillFile()
+{
+    if(!m_JournalDocName.IsEmpty())   // keep the journal
+    {
+        if(m_Journaling)
+            FlushJournal();
+
+        m_Journaling = false;
+        m_JournalDocName.Clear();
+        m_JournalBatch.clear();
+        m_SpillFile.Close();
+        UnlockJournal(m_SpillFileName);
+        m_SpillFileName.Clear();
+        return;
+    }
+
+    if(m_SpillFile.IsOpened())
+        m_SpillFile.Close();
+
+    if(!m_SpillFileName.IsEmpty())
+    {
+        wxLogNull nolog;
+        wxRemoveFile(m_SpillFileName);
+        m_SpillFileName.Clear();
+    }
+}
+
+//==================================================
+// Coalescing of keystrokes
+
+namespace
+{
+
+const long MERGING_PAUSE_MILLIS = 1000;
+
+inline bool IsMergingSpace(ucs4_t uc)
+{
+    return uc == 0x20 || uc == 0x09 || uc == 0x3000;
+}
+
+// append blk to blocks, and extend the last block if they are contiguous
+void AppendMergedBlock(xm::BlockVector &blocks, const MadBlock &blk)
+{
+    if(!blocks.empty())
+    {
+        MadBlock &last = blocks.back();
+        if(last.m_Data == blk.m_Data && last.m_Pos + last.m_Size == blk.m_Pos)
+        {
+            last.m_Size += blk.m_Size;
+            return;
+        }
+    }
+    blocks.push_back(blk);
+}
+
+} // anonymous namespace
+
+MadUndo *MadUndoBuffer::GetMergeUndo(MergeKind kind)
+{
+    if(m_MergeKind != kind || m_MergeUndo == nullptr)
+        return nullptr;
+
+    // m_MergeUndo is reset by every other operation, so it's still the last undo
+    wxASSERT(m_CurrentUndo == m_UndoList.end() && m_MergeUndo == &m_UndoList.back());
+    wxASSERT(m_MergeUndo->m_Undos.size() == 1);
+
+    if(wxGetLocalTimeMillis() - m_MergeTime > MERGING_PAUSE_MILLIS)
+        return nullptr;
+
+    return m_MergeUndo;
+}
+
+void MadUndoBuffer::SetMergeable(MadUndo *undo, ucs4_t uc)
+{
+    wxASSERT(undo == &m_UndoList.back() && undo->m_Undos.size() == 1);
+
+    MadUndoData *ud = undo->m_Undos.back();
+    if(dynamic_cast<MadInsertUndoData*>(ud) != nullptr)
+        m_MergeKind = mkInsert;
+    else if(dynamic_cast<MadDeleteUndoData*>(ud) != nullptr)
+        m_MergeKind = mkDelete;
+    else
+    {
+        BreakMerging();
+        return;
+    }
+
+    m_MergeUndo = undo;
+    m_MergeLastChar = uc;
+    m_MergeTime = wxGetLocalTimeMillis();
+}
+
+MadUndo *MadUndoBuffer::MergeInsert(wxFileOffset pos, const MadBlock &blk, ucs4_t uc)
+{
+    MadUndo *undo = GetMergeUndo(mkInsert);
+    if(undo == nullptr)
+        return nullptr;
+
+    MadInsertUndoData *insud = (MadInsertUndoData *)undo->m_Undos.back();
+    if(pos != insud->m_Pos + insud->m_Size)
+        return nullptr;
+
+    // a newline or the first char of a word begins a new group
+    if(uc == 0x0D || uc == 0x0A || (IsMergingSpace(m_MergeLastChar) && !IsMergingSpace(uc)))
+        return nullptr;
+
+    AppendMergedBlock(insud->m_Data, blk);
+    insud->m_Size += blk.m_Size;
+    undo->m_CaretPosAfter = pos + blk.m_Size;
+
+    m_MergeLastChar = uc;
+    m_MergeTime = wxGetLocalTimeMillis();
+    return undo;
+}
+
+MadUndo *MadUndoBuffer::MergeDelete(wxFileOffset pos, wxFileOffset size, const xm::BlockVector &data)
+{
+    MadUndo *undo = GetMergeUndo(mkDelete);
+    if(undo == nullptr)
+        return nullptr;
+
+    MadDeleteUndoData *dudata = (MadDeleteUndoData *)undo->m_Undos.back();
+    if(pos == dudata->m_Pos)               // by Delete key
+    {
+        for(size_t i=0; i<data.size(); ++i)
+            AppendMergedBlock(dudata->m_Data, data[i]);
+    }
+    else if(pos + size == dudata->m_Pos)   // by BackSpace key
+    {
+        xm::BlockVector blocks(data);
+        for(size_t i=0; i<dudata->m_Data.size(); ++i)
+            AppendMergedBlock(blocks, dudata->m_Data[i]);
+        dudata->m_Data.swap(blocks);
+        dudata->m_Pos = pos;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    dudata->m_Size += size;
+    undo->m_CaretPosAfter = pos;
+
+    m_MergeTime = wxGetLocalTimeMillis();
+    return undo;
+}
+
+//==================================================
+// Persistent Journal
+//
+// journal := magic docname record*
+// docname := length utf8bytes
+// record  := 'G' index caretbefore caretafter undodata    (a completed undo)
+//          | 'S' index hash size content                  (a savepoint)
+// the hash is the identity of the saved file by HashFileIdentity(), which
+// finds the savepoint cheaply, and content is the MadContentHash of the file,
+// which is checked before the undos are restored. The content of the savepoint
+// written when a journal is created is 0, no undos are restored by it.
+// the index is the number of the previous undos, so a 'G' record also
+// truncates the undos after it (the redo part cleared by a new undo).
+//
+// the journal "x.undo" is locked by "x.undo.lock", which holds the process id
+// of the wxMEdit writing the journal.
+
+namespace
+{
+
+const char JOURNAL_MAGIC[] = "wxMEdit undo journal 3\n";
+const size_t JOURNAL_MAGIC_SIZE = sizeof(JOURNAL_MAGIC) - 1;
+const size_t JOURNAL_BATCH_SIZE = 64 * 1024;
+const long JOURNAL_FLUSH_MILLIS = 2000;
+const wxFileOffset JOURNAL_COMPACTING_MIN_SIZE = 1024 * 1024;
+const wxUint32 JOURNAL_DOCNAME_MAX_SIZE = 64 * 1024;
+const long JOURNAL_MAX_AGE_DAYS = 30;
+
+const size_t IDENTITY_SAMPLE_SIZE = 4 * 1024;
+const size_t IDENTITY_SAMPLES = 16;
+
+const wxUint64 FNV_OFFSET_BASIS = wxULL(14695981039346656037);
+const wxUint64 FNV_PRIME = wxULL(1099511628211);
+
+inline wxUint64 FNV1a(wxUint64 hash, const wxByte *data, size_t size)
+{
+    for(size_t i=0; i<size; ++i)
+    {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
+MadContentHash::MadContentHash() : m_Hash(FNV_OFFSET_BASIS)
+{
+}
+
+void MadContentHash::Update(const wxByte *data, size_t size)
+{
+    m_Hash = FNV1a(m_Hash, data, size);
+}
+
+namespace
+{
+
+wxString JournalFileName(const wxString &docname)
+{
+    wxCharBuffer name = docname.mb_str(wxConvUTF8);
+    wxUint64 hash = FNV1a(FNV_OFFSET_BASIS, (const wxByte *)name.data(), strlen(name.data()));
+    return wxString::Format(wxT("%08x%08x.undo"), unsigned(hash >> 32), unsigned(hash & 0xFFFFFFFF));
+}
+
+template <typename T>
+inline bool ReadValue(wxFile &file, T &value)
+{
+    return file.Read(&value, sizeof(value)) == (ssize_t)sizeof(value);
+}
+
+template <typename T>
+inline void AppendValue(vector<wxByte> &buffer, const T &value)
+{
+    const wxByte *b = (const wxByte *)&value;
+    buffer.insert(buffer.end(), b, b + sizeof(value));
+}
+
+void AppendJournalHead(vector<wxByte> &buffer, const wxString &docname)
+{
+    wxCharBuffer name = docname.mb_str(wxConvUTF8);
+    wxUint32 len = wxUint32(strlen(name.data()));
+    buffer.insert(buffer.end(), JOURNAL_MAGIC, JOURNAL_MAGIC + JOURNAL_MAGIC_SIZE);
+    AppendValue(buffer, len);
+    buffer.insert(buffer.end(), (const wxByte *)name.data(), (const wxByte *)name.data() + len);
+}
+
+bool ReadJournalHead(wxFile &file, wxString &docname)
+{
+    char magic[JOURNAL_MAGIC_SIZE];
+    wxUint32 len;
+    if(file.Read(magic, JOURNAL_MAGIC_SIZE) != (ssize_t)JOURNAL_MAGIC_SIZE
+        || memcmp(magic, JOURNAL_MAGIC, JOURNAL_MAGIC_SIZE) != 0
+        || !ReadValue(file, len) || len > JOURNAL_DOCNAME_MAX_SIZE)
+    {
+        return false;
+    }
+
+    vector<char> name(len + 1, '\0');
+    if(len > 0 && file.Read(&name[0], len) != (ssize_t)len)
+        return false;
+    docname = wxString(&name[0], wxConvUTF8);
+    return true;
+}
+
+wxString JournalLockName(const wxString &jname)
+{
+    return jname + wxT(".lock");
+}
+
+// the lock is held by a running wxMEdit, this one included
+bool IsJournalLocked(const wxString &jname)
+{
+    wxFile file;
+    if(!file.Open(JournalLockName(jname), wxFile::read))
+        return false;
+
+    char buf[32];
+    ssize_t len = file.Read(buf, sizeof(buf) - 1);
+    if(len <= 0)
+        return false;
+    buf[len] = '\0';
+
+    unsigned long pid = strtoul(buf, nullptr, 10);
+    return pid != 0 && wxProcess::Exists(int(pid));
+}
+
+// a lock left by a wxMEdit not closed normally is taken over
+bool LockJournal(const wxString &jname)
+{
+    const wxString lockname = JournalLockName(jname);
+    for(int i=0; i<2; ++i)
+    {
+        wxFile file;
+        if(file.Create(lockname, false))
+        {
+            wxCharBuffer pid = wxString::Format(wxT("%lu"), wxGetProcessId()).mb_str();
+            return file.Write(pid.data(), strlen(pid.data())) == strlen(pid.data());
+        }
+
+        if(IsJournalLocked(jname))
+            return false;
+        wxRemoveFile(lockname);
+    }
+    return false;
+}
+
+void UnlockJournal(const wxString &jname)
+{
+    wxLogNull nolog;
+    wxRemoveFile(JournalLockName(jname));
+}
+
+} // anonymous namespace
+
+wxString MadUndoBuffer::GetJournalName(const wxString &docname)
+{
+    return s_JournalDir + JournalFileName(docname);
+}
+
+void MadUndoBuffer::PruneJournals()
+{
+    if(s_JournalDir.IsEmpty() || !wxDirExists(s_JournalDir))
+        return;
+
+    wxLogNull nolog;
+    wxArrayString journals;
+    wxDir::GetAllFiles(s_JournalDir, &journals, wxT("*.undo"), wxDIR_FILES);
+
+    time_t oldest = time(nullptr) - time_t(JOURNAL_MAX_AGE_DAYS) * 24 * 60 * 60;
+    for(size_t i=0; i<journals.GetCount(); ++i)
+    {
+        if(IsJournalLocked(journals[i]))
+            continue;
+
+        bool keep = false;
+        {
+            wxFile file;
+            wxString docname;
+            if(file.Open(journals[i], wxFile::read) && ReadJournalHead(file, docname))
+                keep = wxFileExists(docname) && wxFileModificationTime(journals[i]) >= oldest;
+        }
+
+        if(!keep)
+        {
+            wxRemoveFile(journals[i]);
+            if(wxFileExists(JournalLockName(journals[i])))
+                wxRemoveFile(JournalLockName(journals[i]));
+        }
+    }
+}
+
+bool MadUndoBuffer::HashFileIdentity(const wxString &filename, wxUint64 &hash, wxFileOffset &size)
+{
+    wxLogNull nolog;
+    wxFile file(filename);
+    if(!file.IsOpened())
+        return false;
+
+    size = file.Length();
+    if(size == wxInvalidOffset)
+        return false;
+
+    wxInt64 mtime = wxInt64(wxFileModificationTime(filename));
+    hash = FNV1a(FNV_OFFSET_BASIS, (const wxByte *)&mtime, sizeof(mtime));
+
+    // the whole content of a small file, or the samples spread over a large file
+    const wxFileOffset samplesize = IDENTITY_SAMPLE_SIZE;
+    size_t count = 1, len = size_t(size);
+    if(size > samplesize * wxFileOffset(IDENTITY_SAMPLES))
+    {
+        count = IDENTITY_SAMPLES;
+        len = IDENTITY_SAMPLE_SIZE;
+    }
+    if(len == 0)
+        return true;
+
+    vector<wxByte> buffer(len);
+    for(size_t i=0; i<count; ++i)
+    {
+        wxFileOffset pos = (count == 1) ? 0 : (size - samplesize) * wxFileOffset(i) / wxFileOffset(count - 1);
+        if(file.Seek(pos) == wxInvalidOffset || file.Read(&buffer[0], len) != (ssize_t)len)
+            return false;
+
+        hash = FNV1a(hash, &buffer[0], len);
+    }
+
+    return true;
+}
+
+bool MadUndoBuffer::HashFileContent(const wxString &filename, wxUint64 &content)
+{
+    wxLogNull nolog;
+    wxFile file(filename);
+    if(!file.IsOpened())
+        return false;
+
+    MadContentHash hash;
+    vector<wxByte> buffer(SPILL_BUFFER_SIZE);
+    ssize_t len;
+    while((len = file.Read(&buffer[0], buffer.size())) > 0)
+        hash.Update(&buffer[0], size_t(len));
+    if(len < 0)
+        return false;
+
+    content = hash.GetHash();
+    return true;
+}
+
+void MadUndoBuffer::CompletePending()
+{
+    if(m_PendingUndo == nullptr)
+        return;
+
+    Account(*m_PendingUndo, true);
+    if(m_Journaling)
+        AppendToJournal(*m_PendingUndo, m_PendingIndex);
+
+    m_PendingUndo = nullptr;
+}
+
+void MadUndoBuffer::FlushPending()
+{
+    BreakMerging();
+    CompletePending();
+    if(m_Journaling)
+        FlushJournal();
+}
+
+void MadUndoBuffer::AppendToJournal(MadUndo &undo, wxUint32 index)
+{
+    m_JournalBatch.push_back(wxByte('G'));
+    AppendValue(m_JournalBatch, index);
+    AppendValue(m_JournalBatch, undo.m_CaretPosBefore);
+    AppendValue(m_JournalBatch, undo.m_CaretPosAfter);
+
+    undo.m_SpillPos = m_JournalSize + wxFileOffset(m_JournalBatch.size());
+
+    if(UndoDataSize(undo) >= wxFileOffset(JOURNAL_BATCH_SIZE))
+    {
+        // write the large data to the journal directly instead of copying them to the batch
+        FileOutput out(m_SpillFile);
+        if(!FlushJournal() || m_SpillFile.Seek(m_JournalSize) == wxInvalidOffset
+            || !WriteUndoData(out, undo))
+        {
+            undo.m_SpillPos = -1;
+            m_Journaling = false;
+            return;
+        }
+
+        m_JournalSize = m_SpillFile.Tell();
+        return;
+    }
+
+    BufferOutput out(m_JournalBatch);
+    WriteUndoData(out, undo);
+
+    if(m_JournalBatch.size() >= JOURNAL_BATCH_SIZE
+        || wxGetLocalTimeMillis() - m_JournalFlushTime >= JOURNAL_FLUSH_MILLIS)
+    {
+        FlushJournal();
+    }
+}
+
+bool MadUndoBuffer::FlushJournal()
+{
+    if(m_JournalBatch.empty())
+        return true;
+
+    size_t size = m_JournalBatch.size();
+    if(m_SpillFile.Seek(m_JournalSize) == wxInvalidOffset
+        || m_SpillFile.Write(&m_JournalBatch[0], size) != size)
+    {
+        // stop journaling, the undos in the batch can't be reloaded
+        m_Journaling = false;
+        m_JournalBatch.clear();
+        return false;
+    }
+
+    m_JournalSize += size;
+    m_JournalBatch.clear();
+    m_JournalFlushTime = wxGetLocalTimeMillis();
+    return true;
+}
+
+bool MadUndoBuffer::OpenJournal(const wxString &docname, wxUint64 hash, wxFileOffset size)
+{
+    wxASSERT(m_UndoList.empty());
+
+    CloseSpillFile();
+
+    if(s_JournalDir.IsEmpty() || docname.IsEmpty())
+        return false;
+
+    wxLogNull nolog;
+    if(!wxDirExists(s_JournalDir) && !wxFileName::Mkdir(s_JournalDir, 0777, wxPATH_MKDIR_FULL))
+        return false;
+
+    // another wxMEdit is editing the file
+    wxString jname = GetJournalName(docname);
+    if(!LockJournal(jname))
+        return false;
+
+    bool restored = false;
+    if(wxFileExists(jname) && m_SpillFile.Open(jname, wxFile::read_write))
+    {
+        m_SpillFileName = jname;
+        restored = RestoreJournal(docname, hash, size);
+    }
+
+    if(restored)
+    {
+        // the age of a journal is the time it was last used
+        wxFileName(jname).Touch();
+        m_JournalCompactedSize = m_JournalSize;
+    }
+    else
+    {
+        m_SpillFile.Close();
+        m_SpillFileName.Clear();
+
+        wxFile newfile;
+        if(!newfile.Create(jname, true) || !m_SpillFile.Open(jname, wxFile::read_write))
+        {
+            UnlockJournal(jname);
+            return false;
+        }
+
+        m_SpillFileName = jname;
+        m_JournalSize = 0;
+        m_JournalCompactedSize = 0;
+
+        AppendJournalHead(m_JournalBatch, docname);
+        m_JournalBatch.push_back(wxByte('S'));
+        AppendValue(m_JournalBatch, wxUint32(0));
+        AppendValue(m_JournalBatch, hash);
+        AppendValue(m_JournalBatch, size);
+        AppendValue(m_JournalBatch, wxUint64(0));
+    }
+
+    m_JournalDocName = docname;
+    m_Journaling = true;
+    FlushJournal();
+
+    return restored;
+}
+
+bool MadUndoBuffer::RestoreJournal(const wxString &docname, wxUint64 hash, wxFileOffset size)
+{
+    wxFileOffset filesize = m_SpillFile.Length();
+
+    // the name differs if the hashes of two names collide
+    wxString jdocname;
+    if(!ReadJournalHead(m_SpillFile, jdocname) || jdocname != docname)
+        return false;
+
+    struct Group
+    {
+        wxFileOffset before, after, spillpos;
+    };
+    vector<Group> groups;
+
+    bool matched = false;       // the last savepoint matches the file
+    wxUint32 spindex = 0;
+    wxUint64 spcontent = 0;
+    wxFileOffset validsize = m_SpillFile.Tell();
+
+    wxByte tag;
+    while(ReadValue(m_SpillFile, tag))
+    {
+        wxUint32 index;
+        if(tag == 'G')
+        {
+            Group g;
+            if(!ReadValue(m_SpillFile, index) || !ReadValue(m_SpillFile, g.before) || !ReadValue(m_SpillFile, g.after))
+                break;
+
+            g.spillpos = m_SpillFile.Tell();
+            if(index > groups.size() || !SkipUndoData(m_SpillFile, filesize))
+                break;
+
+            groups.resize(index);
+            groups.push_back(g);
+
+            if(index < spindex)     // the savepoint was undone and then changed
+                matched = false;
+        }
+        else if(tag == 'S')
+        {
+            wxUint64 sphash, content;
+            wxFileOffset spsize;
+            if(!ReadValue(m_SpillFile, index) || !ReadValue(m_SpillFile, sphash) || !ReadValue(m_SpillFile, spsize)
+                || !ReadValue(m_SpillFile, content))
+            {
+                break;
+            }
+            if(index > groups.size())
+                break;
+
+            spindex = index;
+            spcontent = content;
+            matched = (sphash == hash && spsize == size);
+        }
+        else
+        {
+            break;
+        }
+
+        validsize = m_SpillFile.Tell();
+    }
+
+    if(!matched)
+        return false;
+
+    // the identity may match a file changed by others, the content must match
+    // too before the undos are applied to it
+    if(spindex != 0)
+    {
+        wxUint64 content;
+        if(!HashFileContent(docname, content) || content != spcontent)
+            return false;
+    }
+
+    // cut off the record broken by a crash
+    if(validsize < filesize)
+    {
+        m_SpillFile.Close();
+        if(!TruncateFile(m_SpillFileName, validsize) || !m_SpillFile.Open(m_SpillFileName, wxFile::read_write))
+            return false;
+    }
+    m_JournalSize = validsize;
+
+    // the undos after the savepoint were not saved, drop them
+    for(size_t i=0; i<spindex; ++i)
+    {
+        MadUndo undo(groups[i].before, groups[i].after);
+        undo.m_CaretMovement = false;
+        undo.m_State = MadUndo::usSpilled;
+        undo.m_SpillPos = groups[i].spillpos;
+        m_UndoList.push_back(undo);
+    }
+
+    m_CurrentUndo = m_UndoList.end();
+    m_DataCount = spindex;
+    m_HasEvicted = (spindex != 0);
+    if(m_HasEvicted)
+        m_LastEvicted = std::prev(m_UndoList.end());
+
+    return true;
+}
+
+void MadUndoBuffer::JournalSavePoint(const wxString &docname, MadUndo *savepoint, wxUint64 hash, wxFileOffset size, wxUint64 content)
+{
+    if(!m_Journaling)
+        return;
+
+    BreakMerging();
+    CompletePending();
+
+    wxUint32 index = 0;
+    if(savepoint != nullptr)
+    {
+        MadUndoIterator it = m_UndoList.begin();
+        for(; it != m_UndoList.end(); ++it)
+        {
+            if(!it->m_CaretMovement)
+                ++index;
+            if(&(*it) == savepoint)
+                break;
+        }
+        if(it == m_UndoList.end())
+            return;
+    }
+
+    if(!FlushJournal())
+        return;
+
+    if(docname != m_JournalDocName) // saved as another file, write a journal for it
+    {
+        wxLogNull nolog;
+        wxString oldname = m_SpillFileName;
+        wxString jname = GetJournalName(docname);
+        if(!LockJournal(jname))
+        {
+            m_Journaling = false;
+            return;
+        }
+        if(!CompactJournal(docname, index, hash, size, content))
+        {
+            UnlockJournal(jname);
+            m_Journaling = false;
+            return;
+        }
+        UnlockJournal(oldname);
+        return;
+    }
+
+    // drop the records of the undos cleared since the journal was compacted
+    if(m_JournalSize >= std::max(JOURNAL_COMPACTING_MIN_SIZE, 2 * m_JournalCompactedSize)
+        && CompactJournal(docname, index, hash, size, content))
+    {
+        return;
+    }
+    if(!m_Journaling)
+        return;
+
+    m_JournalBatch.push_back(wxByte('S'));
+    AppendValue(m_JournalBatch, index);
+    AppendValue(m_JournalBatch, hash);
+    AppendValue(m_JournalBatch, size);
+    AppendValue(m_JournalBatch, content);
+    FlushJournal();
+}
+
+// write the journal of docname with the undos in m_UndoList and a savepoint,
+// the data of the undos are copied from the current journal
+bool MadUndoBuffer::CompactJournal(const wxString &docname, wxUint32 spindex, wxUint64 hash, wxFileOffset size, wxUint64 content)
+{
+    wxLogNull nolog;
+    wxString jname = GetJournalName(docname);
+    wxString tmpname = jname + wxT(".tmp");
+
+    wxFile out;
+    if(!out.Create(tmpname, true))
+        return false;
+
+    vector<wxByte> head;
+    AppendJournalHead(head, docname);
+    bool ok = (out.Write(&head[0], head.size()) == head.size());
+
+    vector<wxByte> buffer(SPILL_BUFFER_SIZE);
+    vector<wxFileOffset> spillpos;
+    wxFileOffset filesize = m_SpillFile.Length();
+    wxUint32 index = 0;
+    for(MadUndoIterator it = m_UndoList.begin(); ok && it != m_UndoList.end(); ++it)
+    {
+        if(it->m_CaretMovement)
+            continue;
+
+        wxFileOffset pos = it->m_SpillPos;
+        ok = pos >= 0 && m_SpillFile.Seek(pos) != wxInvalidOffset && SkipUndoData(m_SpillFile, filesize);
+        if(!ok)
+            break;
+        wxFileOffset len = m_SpillFile.Tell() - pos;
+
+        head.clear();
+        head.push_back(wxByte('G'));
+        AppendValue(head, index);
+        AppendValue(head, it->m_CaretPosBefore);
+        AppendValue(head, it->m_CaretPosAfter);
+        ++index;
+
+        ok = out.Write(&head[0], head.size()) == head.size() && m_SpillFile.Seek(pos) != wxInvalidOffset;
+        spillpos.push_back(out.Tell());
+        while(ok && len > 0)
+        {
+            size_t bs = (len > (wxFileOffset)SPILL_BUFFER_SIZE) ? SPILL_BUFFER_SIZE : size_t(len);
+            ok = m_SpillFile.Read(&buffer[0], bs) == (ssize_t)bs && out.Write(&buffer[0], bs) == bs;
+            len -= bs;
+        }
+    }
+
+    head.clear();
+    head.push_back(wxByte('S'));
+    AppendValue(head, spindex);
+    AppendValue(head, hash);
+    AppendValue(head, size);
+    AppendValue(head, content);
+    ok = ok && out.Write(&head[0], head.size()) == head.size();
+
+    wxFileOffset newsize = out.Tell();
+    ok = out.Close() && ok;
+    if(ok)
+    {
+        m_SpillFile.Close();
+        ok = wxRenameFile(tmpname, jname, true);
+    }
+
+    if(!ok)
+    {
+        wxRemoveFile(tmpname);
+        if(!m_SpillFile.IsOpened() && !m_SpillFile.Open(m_SpillFileName, wxFile::read_write))
+            m_Journaling = false;
+        return false;
+    }
+
+    size_t i = 0;
+    for(MadUndoIterator it = m_UndoList.begin(); it != m_UndoList.end(); ++it)
+    {
+        if(!it->m_CaretMovement)
+            it->m_SpillPos = spillpos[i++];
+    }
+
+    m_SpillFileName = jname;
+    m_JournalDocName = docname;
+    m_JournalSize = newsize;
+    m_JournalCompactedSize = newsize;
+    if(!m_SpillFile.Open(jname, wxFile::read_write))
+        m_Journaling = false;
+    return true;
+}
@@ -26,6 +26,7 @@
 // Include your minimal set of headers here, or wx.h
 #include <wx/wx.h>
 #endif
+#include <wx/file.h>
 // disable 4996 }
 #ifdef _MSC_VER
 # pragma warning( pop )
@@ -36,12 +37,22 @@
 using std::vector;
 using std::list;
 
-#include "wxm_lines.h"
+#include "../xm/line_enc_adapter.h"
+#include "wxm_data.h"
 
 struct MadUndoData
 {
     wxFileOffset     m_Pos;
 
+    // all kinds of MadUndoData are allocated in fixed-size slots of an arena,
+    // so that a long editing session doesn't fragment the heap by small objects
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
+#ifdef _DEBUG
+    static void *operator new(size_t size, int, const char *, int) { return operator new(size); }
+    static void operator delete(void *p, int, const char *, int) { operator delete(p); }
+#endif
+
     virtual wxFileOffset DelSize() = 0;
     virtual wxFileOffset InsSize() = 0;
     virtual xm::BlockVector* DelData() = 0;
@@ -108,14 +119,39 @@ struct MadUndo
     vector < MadUndoData* > m_Undos;
     wxFileOffset m_CaretPosBefore, m_CaretPosAfter;
 
-    MadUndo() {}
+    // the data of an old undo may be spilled to a temporary file or
+    // discarded when the undo buffer exceeds its memory limit
+    enum State { usInMemory, usSpilled, usDiscarded };
+    State m_State;
+    wxFileOffset m_SpillPos;    // position in the spill file, -1 if never spilled
+    size_t m_MemSize;           // accounted memory of the data, 0 if not accounted
+
+    bool m_CaretMovement;       // added by MadUndoBuffer::Add(caretPosBefore, caretPosAfter)
+
+    MadUndo() : m_State(usInMemory), m_SpillPos(-1), m_MemSize(0), m_CaretMovement(false) {}
     MadUndo(wxFileOffset caretPosBefore, wxFileOffset caretPosAfter)
-        :m_CaretPosBefore(caretPosBefore), m_CaretPosAfter(caretPosAfter)
+        :m_CaretPosBefore(caretPosBefore), m_CaretPosAfter(caretPosAfter),
+         m_State(usInMemory), m_SpillPos(-1), m_MemSize(0), m_CaretMovement(true)
     {}
 
+    void ClearData();
+
     ~MadUndo();
 };
 
+// the hash of the whole content of a file, it's computed from the bytes written
+// by saving and checked before the undo history of the file is restored
+class MadContentHash
+{
+private:
+    wxUint64 m_Hash;
+
+public:
+    MadContentHash();
+    void Update(const wxByte *data, size_t size);
+    wxUint64 GetHash() { return m_Hash; }
+};
+
 typedef list < MadUndo > MadUndoList;
 typedef list < MadUndo >::iterator MadUndoIterator;
 
@@ -127,10 +163,60 @@ private:
     MadUndoList m_UndoList;
     MadUndoIterator m_CurrentUndo;   // iterator of list is constant, even if add/del new element
 
+    // the last undo made by a keystroke, which the following keystrokes can be merged into
+    enum MergeKind { mkNone, mkInsert, mkDelete };
+    MergeKind m_MergeKind;
+    MadUndo *m_MergeUndo;
+    ucs4_t m_MergeLastChar;
+    wxLongLong m_MergeTime;
+
+    // memory limit: the oldest undos are spilled or discarded beyond it,
+    // they are always a prefix of m_UndoList ending at m_LastEvicted
+    size_t m_MemLimit;          // 0: unlimited
+    bool m_DiscardOld;
+    size_t m_MemSize;
+    size_t m_Releasable;        // bytes of m_MemData released by the evicted and cleared undos
+    bool m_HasEvicted;
+    MadUndoIterator m_LastEvicted;
+    MadMemData *m_MemData;      // where the reloaded data are put
+    wxString m_SpillFileName;
+    wxFile m_SpillFile;
+
+    // the undo just added by Add(), it's completed by the next operation
+    MadUndo *m_PendingUndo;
+    wxUint32 m_PendingIndex;
+    wxUint32 m_DataCount;       // undos added by Add() in m_UndoList
+
+    // persistent journal, which is used as the spill file if opened
+    bool m_Journaling;
+    wxString m_JournalDocName;  // not empty if m_SpillFile is the journal
+    wxFileOffset m_JournalSize; // flushed size
+    wxFileOffset m_JournalCompactedSize;    // the size after opening or compacting
+    vector<wxByte> m_JournalBatch;  // appended to the journal in batches
+    wxLongLong m_JournalFlushTime;
+    static wxString s_JournalDir;
+
     void ClearTillEnd();       // clear current undo till end
+    MadUndo *GetMergeUndo(MergeKind kind);
+
+    void CompletePending();
+    void AppendToJournal(MadUndo &undo, wxUint32 index);
+    bool FlushJournal();
+    bool RestoreJournal(const wxString &docname, wxUint64 hash, wxFileOffset size);
+    bool CompactJournal(const wxString &docname, wxUint32 spindex, wxUint64 hash, wxFileOffset size, wxUint64 content);
+
+    // done: the undo is before m_CurrentUndo, its edit is in the lines
+    void Account(MadUndo &undo, bool done);
+    void Reaccount(MadUndo &undo, bool done);
+    void Release(MadUndo &undo);
+    void Trim();
+    void Discard(MadUndo &undo);
+    bool Spill(MadUndo &undo);
+    bool Reload(MadUndoIterator it);
+    void CloseSpillFile();
 
 public:
-    MadUndoBuffer();
+    MadUndoBuffer(MadMemData *memdata);
     ~MadUndoBuffer();
 
     void Clear();      // clear all
@@ -146,6 +232,62 @@ public:
     bool CanUndo(bool noCaretMovement);
     bool CanRedo(bool noCaretMovement);
 
+    // Coalescing of keystrokes: inserting a char right after the last typed
+    // chars, or deleting a char adjacent to the last deleted chars, is merged
+    // into the last undo. A group is ended by a newline, the beginning of a
+    // new word, a pause of typing or any other undo operation.
+    // return the merged undo, or nullptr if a new undo should be added.
+    MadUndo *MergeInsert(wxFileOffset pos, const MadBlock &blk, ucs4_t uc);
+    MadUndo *MergeDelete(wxFileOffset pos, wxFileOffset size, const xm::BlockVector &data);
+    // let the undo just added accept the following keystrokes
+    void SetMergeable(MadUndo *undo, ucs4_t uc=0);
+    // e.g. the undo becomes a savepoint
+    void BreakMerging() { m_MergeKind = mkNone; m_MergeUndo = nullptr; }
+
+    // limit: bytes of memory used by the undo data, 0 for unlimited;
+    // discard: discard the oldest undos instead of spilling them to a temporary file
+    void SetMemoryLimit(size_t limit, bool discard);
+    size_t GetMemorySize() { return m_MemSize; }
+
+    // the data of the evicted undos are kept in m_MemData until it is compacted,
+    // blocks: all the blocks referring to m_MemData except the ones of the undos;
+    // a part of m_MemData is compacted at a time, return true if there is more
+    bool NeedCompacting();
+    bool CompactMemData(const vector<xm::BlockVector*> &blocks);
+
+    // the file data of the document is replaced by newfd after saving,
+    // remap the blocks of oldfd in the undos to newfd by the mappings
+    void RemapFileBlocks(MadFileData *oldfd, MadFileData *newfd, const vector<MadSaveMapping> &mappings);
+
+    // Persistent undo history: every completed undo is appended to a journal
+    // in the config dir, named by the hash of the document path. The journal
+    // records the identity and the content hash of the file at each savepoint,
+    // so the undo history can be restored when the same file is opened again;
+    // the restored undos are reloaded from the journal when undoing that far.
+    // When saving, the journal is rewritten with only the undos in the buffer
+    // if it has grown twice as large as it was. A journal is written by one
+    // wxMEdit at a time, the others editing the same file don't journal it.
+    static void SetJournalDir(const wxString &dir) { s_JournalDir = dir; }
+    static wxString GetJournalName(const wxString &docname);
+    // remove the journals of the files deleted or not opened for a long time,
+    // called at startup, the journals locked by other wxMEdits are kept
+    static void PruneJournals();
+    // the identity is a hash of the modification time and of samples of the
+    // content, it reads a few KB at most so that it's cheap for the UI thread
+    static bool HashFileIdentity(const wxString &filename, wxUint64 &hash, wxFileOffset &size);
+    // the MadContentHash of the file, it reads the whole file
+    static bool HashFileContent(const wxString &filename, wxUint64 &content);
+    // must be called with an empty undo buffer, return true if the undo history is restored;
+    // the history is restored only if the identity matches a savepoint and the
+    // content of the file matches its content hash too
+    bool OpenJournal(const wxString &docname, wxUint64 hash, wxFileOffset size);
+    // the document is saved as docname, whose content matches savepoint;
+    // content: the MadContentHash of the bytes written
+    void JournalSavePoint(const wxString &docname, MadUndo *savepoint, wxUint64 hash, wxFileOffset size, wxUint64 content);
+    bool IsJournaling() { return m_Journaling; }
+    // complete the last undo and flush the journal, e.g. before the data of the lines are reset
+    void FlushPending();
+
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include "wxm_undo.h"
 #include "../mad_utils.h"
 #include "../xm/uutils.h"
+#include "../xm/perf.h"
 #include <wx/fontutil.h>
 #ifdef _MSC_VER
 # pragma warning( push )
@@ -29,6 +30,7 @@
 #include <wx/image.h>
 #include <wx/dataobj.h>
 #include <wx/datetime.h>
+#include <wx/stopwatch.h>
 #ifdef __WXMSW__
 # include <wx/msw/private.h>
 #endif
@@ -73,7 +75,16 @@
 #include <boost/static_assert.hpp>
 //#include <boost/scoped_ptr.hpp>
 #include <algorithm>
+#include <memory>
 #include <locale.h>
+#include <stdint.h>
+
+#ifndef __WXMSW__
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
 
 using std::vector;
 using std::list;
@@ -257,6 +268,10 @@ BEGIN_EVENT_TABLE(MadEdit, MadEditSuperClass)
 
     EVT_ERASE_BACKGROUND(MadEdit::OnEraseBackground)
     EVT_PAINT(MadEdit::OnPaint)
+    EVT_IDLE(MadEdit::OnIdle)
+
+    EVT_COMMAND(wxID_ANY, wxmEVT_ASYNCSAVE_PROGRESS, MadEdit::OnAsyncSaveProgress)
+    EVT_COMMAND(wxID_ANY, wxmEVT_ASYNCSAVE_DONE, MadEdit::OnAsyncSaveDone)
 
 END_EVENT_TABLE()
 
@@ -436,6 +451,133 @@ int FontWidthManager::MaxCount=10;
 wxString FontWidthManager::DataDir;
 vector<FontWidthManager::FontWidthBuffers> FontWidthManager::FontWidthBuffersVector;
 list<FontWidthManager::VerifiedFlag> FontWidthManager::VerifiedFlagList;
+void *FontWidthManager::MappedCache=nullptr;
+size_t FontWidthManager::MappedCacheSize=0;
+wxString FontWidthManager::PendingCacheFile;
+
+namespace
+{
+
+// FontWidth.cache := header entry*
+// the entries are fixed-size, so the file can be mapped and used directly
+const char FONTWIDTH_CACHE_MAGIC[8] = { 'w', 'x', 'M', 'E', 'F', 'W', 'C', '\n' };
+const wxUint32 FONTWIDTH_CACHE_VERSION = 1;
+
+struct FontWidthCacheHeader
+{
+    char     magic[8];
+    wxUint32 version;
+    wxUint32 count;     // of entries
+};
+
+struct FontWidthCacheEntry
+{
+    wxUint16 fontname[128]; // UTF-16
+    wxInt32  fontsize;
+    wxInt32  index;         // plane of the widths, 0~16
+    wxUint16 widths[65536];
+};
+
+BOOST_STATIC_ASSERT(sizeof(FontWidthCacheHeader) == 16);
+BOOST_STATIC_ASSERT(sizeof(FontWidthCacheEntry) == 256 + 8 + 65536 * 2);
+
+bool IsValidFontWidthCache(const FontWidthCacheHeader &header, wxFileOffset size)
+{
+    return memcmp(header.magic, FONTWIDTH_CACHE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == FONTWIDTH_CACHE_VERSION
+        && size == wxFileOffset(sizeof(FontWidthCacheHeader)) + wxFileOffset(header.count) * wxFileOffset(sizeof(FontWidthCacheEntry));
+}
+
+bool FontNameEquals(const wxUint16 *name16, const wchar_t *name)
+{
+    for(size_t i=0; i<128; ++i)
+    {
+        if(name16[i] != wxUint16(name[i]))
+            return false;
+        if(name[i] == 0)
+            break;
+    }
+    return true;
+}
+
+// map the file copy-on-write, the changes are not written to the file
+void *MapFileCopyOnWrite(const wxString &filename, size_t &size)
+{
+#ifdef __WXMSW__
+    HANDLE file = ::CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    void *data = nullptr;
+    LARGE_INTEGER filesize;
+    if(::GetFileSizeEx(file, &filesize) && filesize.QuadPart > 0 && filesize.HighPart == 0)
+    {
+        HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if(mapping != nullptr)
+        {
+            data = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            size = size_t(filesize.QuadPart);
+            ::CloseHandle(mapping);
+        }
+    }
+    ::CloseHandle(file);
+    return data;
+#else
+    int fd = open(filename.fn_str(), O_RDONLY);
+    if(fd < 0)
+        return nullptr;
+
+    void *data = nullptr;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        data = mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(data == MAP_FAILED)
+            data = nullptr;
+        size = size_t(st.st_size);
+    }
+    close(fd);
+    return data;
+#endif
+}
+
+void UnmapFile(void *data, size_t size)
+{
+#ifdef __WXMSW__
+    ::UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+// find the entry of the font in the saved cache file, and fill the widths
+// not measured by this process
+void MergeSavedFontWidths(wxFile &saved, wxUint32 count, FontWidthCacheEntry &entry, FontWidthCacheEntry &buffer)
+{
+    const size_t keysize = sizeof(buffer.fontname) + sizeof(buffer.fontsize) + sizeof(buffer.index);
+    for(wxUint32 i=0; i<count; ++i)
+    {
+        saved.Seek(wxFileOffset(sizeof(FontWidthCacheHeader)) + wxFileOffset(i) * wxFileOffset(sizeof(FontWidthCacheEntry)));
+        if(saved.Read(&buffer, keysize) != (ssize_t)keysize)
+            return;
+
+        if(memcmp(&buffer, &entry, keysize) != 0)
+            continue;
+
+        if(saved.Read(buffer.widths, sizeof(buffer.widths)) != (ssize_t)sizeof(buffer.widths))
+            return;
+
+        for(size_t c=0; c<65536; ++c)
+        {
+            if(entry.widths[c] == 0)
+                entry.widths[c] = buffer.widths[c];
+        }
+        return;
+    }
+}
+
+} // anonymous namespace
 
 bool FontWidthManager::VerifyFontWidths(wxUint16 *widths, const wxString &fontname, int fontsize, wxWindow *win)
 {
@@ -518,6 +660,7 @@ void FontWidthManager::ClearBuffer_1_16(const wxString &fontname, int fontsize)
             if(it->fontsize==fontsize && it->fontname==fontname)
             {
                 memset(it->widths, 0, sizeof(wxUint16)*65536);
+                it->reset=true;
                 break;
             }
             ++it;
@@ -526,64 +669,67 @@ void FontWidthManager::ClearBuffer_1_16(const wxString &fontname, int fontsize)
     }
 }
 
-bool FontWidthManager::LoadFromFile(const wxString &filename, FontWidthBuffers &fwbuffers, bool verify)
+wxString FontWidthManager::CacheFileName()
 {
-    if(!wxFileExists(filename))
-        return true;
+    return DataDir + wxT("FontWidth.cache");
+}
 
-    wxFile file(filename.c_str(), wxFile::read);
+void FontWidthManager::MapCache()
+{
+    size_t size=0;
+    void *data=MapFileCopyOnWrite(CacheFileName(), size);
+    if(data==nullptr)
+        return;
 
-    if(file.IsOpened())
+    const FontWidthCacheHeader *header=(const FontWidthCacheHeader*)data;
+    if(size<sizeof(FontWidthCacheHeader) || !IsValidFontWidthCache(*header, wxFileOffset(size)))
     {
-        wxFileOffset size=file.SeekEnd();
-        if( size_t(size) % (sizeof(FontWidthBuffer)+sizeof(wxUint16)*65536) != 0)
-        {
-            // fileformat error!!!
-            // discard all data
-            return false;
-        }
+        // fileformat error!!!
+        // discard all data
+        UnmapFile(data, size);
+        return;
+    }
 
-        file.Seek(0);
+    MappedCache=data;
+    MappedCacheSize=size;
 
-        FontWidthBuffer fwbuf;
-        int i=0;
-        while(!file.Eof() && i<MaxCount)
-        {
-            if(file.Read(&fwbuf, sizeof(FontWidthBuffer))==sizeof(FontWidthBuffer))
-            {
-                fwbuf.widths=new wxUint16[65536];
+    FontWidthCacheEntry *entry=(FontWidthCacheEntry*)(header+1);
+    for(wxUint32 i=0; i<header->count; ++i, ++entry)
+    {
+        if(entry->index<0 || entry->index>16)
+            continue;
 
-                if(file.Read(fwbuf.widths, sizeof(wxUint16)*65536) == sizeof(wxUint16)*65536)
-                {
-                    fwbuffers.push_back(fwbuf);
-                    if(verify)
-                    {
-                        VerifiedFlagList.push_back(VerifiedFlag(fwbuf.widths, false));
-                    }
-                }
-                else
-                {
-                    delete []fwbuf.widths;
-                    // fileformat error!!!
-                    return false;
-                }
-            }
-            else
-            {
-                // fileformat error!!
-                return false;
-            }
-            ++i;
+        FontWidthBuffers &fwbuffers=FontWidthBuffersVector[entry->index];
+        if(int(fwbuffers.size())>=MaxCount)
+            continue;
+
+        wxString fontname;
+        for(size_t c=0; c<127 && entry->fontname[c]!=0; ++c)
+            fontname<<wxChar(entry->fontname[c]);
+
+        fwbuffers.push_back(FontWidthBuffer(fontname, entry->fontsize, entry->widths, true));
+        if(entry->index==0)
+        {
+            VerifiedFlagList.push_back(VerifiedFlag(entry->widths, false));
         }
     }
+}
 
-    return true;
+void FontWidthManager::UnmapCache()
+{
+    if(MappedCache!=nullptr)
+    {
+        UnmapFile(MappedCache, MappedCacheSize);
+        MappedCache=nullptr;
+        MappedCacheSize=0;
+    }
 }
 
 void FontWidthManager::Init(const wxString &datadir)
 {
     DataDir=datadir;
     FontWidthBuffersVector.resize(17); // 0~16 : U+0000 ~ U+10FFFF
+    MapCache();
 }
 
 wxUint16 *FontWidthManager::GetFontWidths(int index, const wxString &fontname, int fontsize, wxWindow *win)
@@ -592,13 +738,6 @@ wxUint16 *FontWidthManager::GetFontWidths(int index, const wxString &fontname, i
 
     FontWidthBuffers &fwbuffers=FontWidthBuffersVector[index];
 
-    if(fwbuffers.size()==0)
-    {
-        wxString fname(wxT("FontWidth"));
-        if(index>0) fname<<index;
-        LoadFromFile(DataDir +fname +wxT(".dat"), fwbuffers, index==0);
-    }
-
     list<FontWidthBuffer>::iterator it=fwbuffers.begin();
     list<FontWidthBuffer>::iterator itend=fwbuffers.end();
     wxUint16 *wid;
@@ -618,18 +757,8 @@ wxUint16 *FontWidthManager::GetFontWidths(int index, const wxString &fontname, i
 
                 // reset font widths
                 memset(wid, 0, sizeof(wxUint16)*65536);
+                it->reset=true;
                 ClearBuffer_1_16(fontname, fontsize);
-
-                // delete 1~16 datafile
-                for(int i=1;i<=16;i++)
-                {
-                    wxString filename(DataDir+wxT("FontWidth"));
-                    filename<<i <<wxT(".dat");
-                    if(wxFileExists(filename))
-                    {
-                        wxRemoveFile(filename);
-                    }
-                }
             }
 
             if(it != fwbuffers.begin())   // move it to front
@@ -644,9 +773,11 @@ wxUint16 *FontWidthManager::GetFontWidths(int index, const wxString &fontname, i
     }
 
     int idx=int(fwbuffers.size());
+    bool mapped=false;
     if(idx>=MaxCount)
     {
         wid=fwbuffers.back().widths;
+        mapped=fwbuffers.back().mapped;
         fwbuffers.pop_back();
     }
     else
@@ -655,7 +786,7 @@ wxUint16 *FontWidthManager::GetFontWidths(int index, const wxString &fontname, i
     }
 
     memset(wid, 0, sizeof(wxUint16)*65536);
-    fwbuffers.push_front(FontWidthBuffer(fontname, fontsize, wid));
+    fwbuffers.push_front(FontWidthBuffer(fontname, fontsize, wid, mapped));
 
     return wid;
 }
@@ -665,36 +796,103 @@ void FontWidthManager::Save()
     if(FontWidthBuffersVector.size()==0)
         return;
 
-    for(int idx=0;idx<=16;idx++)
-    {
-        wxString filename(DataDir+wxT("FontWidth"));
-        if(idx>0) filename<<idx;
-        filename<<wxT(".dat");
+    // write a new cache file and rename it to the cache file, the processes
+    // mapping the old one are not affected
+    const wxString filename=CacheFileName();
+    const wxString tmpname=filename + wxString::Format(wxT(".%lu"), wxGetProcessId());
 
-        if(FontWidthBuffersVector[idx].size()>0)
+    wxLogNull nolog;
+    wxFile file;
+    if(!file.Create(tmpname, true))
+        return;
+
+    // the cache file may be saved by other processes after it was mapped
+    wxFile saved;
+    FontWidthCacheHeader savedheader;
+    bool hassaved=wxFileExists(filename) && saved.Open(filename, wxFile::read)
+        && saved.Read(&savedheader, sizeof(savedheader))==(ssize_t)sizeof(savedheader)
+        && IsValidFontWidthCache(savedheader, saved.Length());
+
+    FontWidthCacheHeader header;
+    memcpy(header.magic, FONTWIDTH_CACHE_MAGIC, sizeof(header.magic));
+    header.version=FONTWIDTH_CACHE_VERSION;
+    header.count=0;
+    bool ok=(file.Write(&header, sizeof(header))==sizeof(header));
+
+    std::unique_ptr<FontWidthCacheEntry> entry(new FontWidthCacheEntry);
+    std::unique_ptr<FontWidthCacheEntry> buffer(new FontWidthCacheEntry);
+    vector<int> counts(17, 0);
+
+    for(int idx=0; ok && idx<=16; idx++)
+    {
+        list<FontWidthBuffer>::iterator it=FontWidthBuffersVector[idx].begin();
+        list<FontWidthBuffer>::iterator itend=FontWidthBuffersVector[idx].end();
+        for(; ok && it != itend && counts[idx]<MaxCount; ++it)
         {
-            //if(wxFileExists(filename))
-            //{
-                //wxRemoveFile(filename);
-            //}
+            memset(entry->fontname, 0, sizeof(entry->fontname));
+            for(size_t c=0; c<127 && it->fontname[c]!=0; ++c)
+                entry->fontname[c]=wxUint16(it->fontname[c]);
+            entry->fontsize=it->fontsize;
+            entry->index=idx;
+            memcpy(entry->widths, it->widths, sizeof(entry->widths));
 
-            wxFile file(filename.c_str(), wxFile::write);
+            if(hassaved && !it->reset)
+                MergeSavedFontWidths(saved, savedheader.count, *entry, *buffer);
 
-            if(file.IsOpened())
-            {
-                list<FontWidthBuffer>::iterator it=FontWidthBuffersVector[idx].begin();
-                list<FontWidthBuffer>::iterator itend=FontWidthBuffersVector[idx].end();
-                int i=0;
-                while(it != itend && i<MaxCount)
-                {
-                    file.Write( &(*it), sizeof(FontWidthBuffer) );
-                    file.Write( it->widths, sizeof(wxUint16)*65536 );
-                    ++it;
-                    ++i;
-                }
-            }
+            ok=(file.Write(entry.get(), sizeof(FontWidthCacheEntry))==sizeof(FontWidthCacheEntry));
+            ++header.count;
+            ++counts[idx];
         }
     }
+
+    // keep the fonts which are used only by other processes
+    for(wxUint32 i=0; ok && hassaved && i<savedheader.count; ++i)
+    {
+        saved.Seek(wxFileOffset(sizeof(FontWidthCacheHeader)) + wxFileOffset(i) * wxFileOffset(sizeof(FontWidthCacheEntry)));
+        if(saved.Read(entry.get(), sizeof(FontWidthCacheEntry))!=(ssize_t)sizeof(FontWidthCacheEntry))
+            break;
+        if(entry->index<0 || entry->index>16 || counts[entry->index]>=MaxCount)
+            continue;
+
+        bool used=false;
+        list<FontWidthBuffer>::iterator it=FontWidthBuffersVector[entry->index].begin();
+        list<FontWidthBuffer>::iterator itend=FontWidthBuffersVector[entry->index].end();
+        for(; !used && it != itend; ++it)
+        {
+            used=(it->fontsize==entry->fontsize && FontNameEquals(entry->fontname, it->fontname));
+        }
+        if(used)
+            continue;
+
+        ok=(file.Write(entry.get(), sizeof(FontWidthCacheEntry))==sizeof(FontWidthCacheEntry));
+        ++header.count;
+        ++counts[entry->index];
+    }
+    saved.Close();
+
+    ok=ok && file.Seek(0)==0 && file.Write(&header, sizeof(header))==sizeof(header);
+    ok=file.Close() && ok;
+
+    if(!ok)
+    {
+        wxRemoveFile(tmpname);
+        return;
+    }
+
+    // the file mapped by this or other processes can't be replaced under MSW,
+    // try it again after unmapping
+    if(!wxRenameFile(tmpname, filename, true))
+        PendingCacheFile=tmpname;
+
+    // remove the data files of the old format
+    for(int idx=0; idx<=16; idx++)
+    {
+        wxString oldfile(DataDir+wxT("FontWidth"));
+        if(idx>0) oldfile<<idx;
+        oldfile<<wxT(".dat");
+        if(wxFileExists(oldfile))
+            wxRemoveFile(oldfile);
+    }
 }
 
 void FontWidthManager::FreeMem()
@@ -708,13 +906,24 @@ void FontWidthManager::FreeMem()
         list<FontWidthBuffer>::iterator itend=FontWidthBuffersVector[idx].end();
         while(it != itend)
         {
-            delete []it->widths;
+            if(!it->mapped)
+                delete []it->widths;
             ++it;
         }
         FontWidthBuffersVector[idx].clear();
     }
 
     FontWidthBuffersVector.clear();
+    VerifiedFlagList.clear();
+    UnmapCache();
+
+    if(!PendingCacheFile.IsEmpty())
+    {
+        wxLogNull nolog;
+        if(!wxRenameFile(PendingCacheFile, CacheFileName(), true))
+            wxRemoveFile(PendingCacheFile);
+        PendingCacheFile.Clear();
+    }
 }
 
 //==================================================
@@ -767,14 +976,32 @@ MadEdit::MadEdit(wxm::ConfigWriter* cfg_writer, wxWindow* parent, wxWindowID id,
     m_Config->Read(wxT("MaxTextFileSize"), &templong, 10*1000*1000);
 
 
-    m_UndoBuffer = new MadUndoBuffer();
+    m_UndoBuffer = new MadUndoBuffer(m_Lines->m_MemData);
     m_SavePoint = nullptr;
+    // the oldest undos are spilled to a temporary file (or discarded) beyond the limit
+    long undomemlimit;
+    bool discardundos;
+    m_Config->Read(wxT("UndoMemoryLimit"), &undomemlimit, 256); // MB, 0: unlimited
+    m_Config->Read(wxT("DiscardOldUndos"), &discardundos, false);
+    if(undomemlimit < 0) undomemlimit = 0;
+    // 4096MB and more overflow size_t of 32-bit builds
+    wxUint64 undomembytes = wxUint64(undomemlimit) * 1024 * 1024;
+    if(undomembytes > wxUint64(SIZE_MAX)) undomembytes = SIZE_MAX;
+    m_UndoBuffer->SetMemoryLimit(size_t(undomembytes), discardundos);
+    m_Config->Read(wxT("PersistentUndo"), &m_PersistentUndo, false);
     m_Config->Read(wxT("RecordCaretMovements"), &m_RecordCaretMovements, false);
 
     m_Modified=false;
     m_ModificationTime=0;
     m_ReadOnly=false;
 
+    m_Recovery = nullptr;
+
+    m_Config->Read(wxT("AsyncSave"), &m_AsyncSave, true);
+    m_Config->Read(wxT("AsyncSaveMinSize"), &m_AsyncSaveMinSize, 16*1024*1024);
+    m_AsyncSavePoint = nullptr;
+    m_AsyncRecoveryMark = 0;
+
 #ifdef __WXMSW__
     wxCaret *caret=new wxCaret(this, 2, 2);
 #else
@@ -802,6 +1029,13 @@ MadEdit::MadEdit(wxm::ConfigWriter* cfg_writer, wxWindow* parent, wxWindowID id,
 
     m_ClientBitmap=m_MarkBitmap=nullptr;     // alloc at OnSize()
 
+    m_RowCacheBitmap=nullptr;
+    m_RowCacheClock=0;
+    m_RowCacheSignature=0;
+    m_RowCacheWidth=0;
+    m_PaintedTopRow=0;
+    m_PaintedXPos=0;
+
     m_CaretPos.Reset(m_Lines->m_LineList.begin());
 
     m_ValidPos_iter=m_Lines->m_LineList.begin();
@@ -880,6 +1114,7 @@ MadEdit::MadEdit(wxm::ConfigWriter* cfg_writer, wxWindow* parent, wxWindowID id,
     // set fonts
     memset(m_TextFontWidths, 0, sizeof(m_TextFontWidths));
     memset(m_HexFontWidths, 0, sizeof(m_HexFontWidths));
+    m_MeasuringWidths=false;
 
     m_Printing=0;
 
@@ -924,10 +1159,14 @@ MadEdit::~MadEdit()
         wxSetCursor(wxNullCursor); // reset to default
     }
 
+    if(m_Lines->IsSavingAsync())
+        m_Lines->EndSaveToFileAsync();
+
+    delete m_UndoBuffer; // it may journal the last undo with the data of m_Lines
     delete m_Lines;
+    delete m_Recovery;  // closed normally, the journal is removed
     //delete m_Encoding;
     delete m_Syntax;
-    delete m_UndoBuffer;
 
     delete []m_WordBuffer;
 #ifdef __WXMSW__
@@ -939,6 +1178,7 @@ MadEdit::~MadEdit()
     if(m_HexDigitBitmap) delete m_HexDigitBitmap;
     delete m_ClientBitmap;
     delete m_MarkBitmap;
+    delete m_RowCacheBitmap;
 
     delete m_MouseMotionTimer;
 
@@ -950,6 +1190,8 @@ MadEdit::~MadEdit()
 
 int MadEdit::GetLineByRow(MadLineIterator &lit, wxFileOffset &pos, int &rowid)
 {
+    XM_PERF_SCOPE(PERF_GET_LINE_BY_ROW);
+
     int lineid, count, rowid0;
 
     // begin <= rowid <= validpos
@@ -1059,6 +1301,8 @@ int MadEdit::GetLineByRow(MadLineIterator &lit, wxFileOffset &pos, int &rowid)
 
 int MadEdit::GetLineByPos(MadLineIterator &lit, wxFileOffset &pos, int &rowid)
 {
+    XM_PERF_SCOPE(PERF_GET_LINE_BY_POS);
+
     int lineid;
     wxFileOffset pos0, size;
 
@@ -1168,6 +1412,8 @@ int MadEdit::GetLineByPos(MadLineIterator &lit, wxFileOffset &pos, int &rowid)
 
 int MadEdit::GetLineByLine(/*OUT*/ MadLineIterator &lit, /*OUT*/ wxFileOffset &pos, /*IN*/ int lineid)
 {
+    XM_PERF_SCOPE(PERF_GET_LINE_BY_LINE);
+
     int rowid, lineid0;
 
     // begin <= lineid <= validpos
@@ -1293,7 +1539,6 @@ void MadEdit::UpdateCaret(MadCaretPos &caretPos,
 
     std::advance(riter, caretPos.subrowid);
 
-    const int rowwidth = riter->m_Width;
     wxFileOffset rowpos = caretPos.linepos - riter->m_Start;
 
     wxASSERT(rowpos >= 0);
@@ -1308,7 +1553,9 @@ void MadEdit::UpdateCaret(MadCaretPos &caretPos,
 
     if(IsTextFile()) // must be a text file
     {
-        m_Lines->InitNextUChar(caretPos.iter, riter->m_Start);
+        MadDecodedRow *dr = InitDisplayRow(caretPos.iter, caretPos.subrowid);
+        size_t ucidx = 0;
+
         const wxFileOffset & row_endpos = (++riter)->m_Start;
 
         while(m_Lines->m_NextUChar_Pos < row_endpos
@@ -1322,7 +1569,7 @@ void MadEdit::UpdateCaret(MadCaretPos &caretPos,
                 break;
             }
 
-            int width = GetUCharTextFontWidth(uc, rowwidth, xpos);
+            int width = GetDisplayCharWidth(dr, ucidx++, uc, xpos);
             widthArray.push_back(width);
             xpos += width;
 
@@ -1364,19 +1611,8 @@ void MadEdit::UpdateCaretByPos(MadCaretPos &caretPos,
     caretPos.lineid=GetLineByPos(caretPos.iter, pos, caretPos.rowid);
 
     caretPos.linepos = caretPos.pos - pos;
-    caretPos.subrowid=0;
-
-    MadRowIndexIterator rit=caretPos.iter->m_RowIndices.begin();
-    MadRowIndexIterator lastrit=caretPos.iter->m_RowIndices.end();
-    --lastrit;
-    ++rit;
-
-    while(rit!=lastrit && caretPos.linepos >= rit->m_Start )
-    {
-        ++caretPos.rowid;
-        ++caretPos.subrowid;
-        ++rit;
-    }
+    caretPos.subrowid = caretPos.iter->GetSubRow(caretPos.linepos);
+    caretPos.rowid += caretPos.subrowid;
 
     UpdateCaret(caretPos, ucharQueue, widthArray, ucharPos);
 }
@@ -1394,9 +1630,9 @@ void MadEdit::UpdateCaretByXPos(int xPos, MadCaretPos &caretPos,
     }
 
     std::advance(riter, caretPos.subrowid);
-    const int rowwidth = riter->m_Width;
 
-    m_Lines->InitNextUChar(caretPos.iter, riter->m_Start);
+    MadDecodedRow *dr = InitDisplayRow(caretPos.iter, caretPos.subrowid);
+    size_t ucidx = 0;
 
     const wxFileOffset & row_endpos = (++riter)->m_Start;
 
@@ -1418,7 +1654,7 @@ void MadEdit::UpdateCaretByXPos(int xPos, MadCaretPos &caretPos,
             break;
         }
 
-        int width = GetUCharTextFontWidth(uc, rowwidth, xpos);
+        int width = GetDisplayCharWidth(dr, ucidx++, uc, xpos);
         widthArray.push_back(width);
         xpos += width;
 
@@ -1798,8 +2034,313 @@ void MadEdit::PaintText(wxDC *dc, int x, int y, const ucs4_t *text, const int *w
 #endif //__WXMSW__
 }
 
-void MadEdit::PaintTextLines(wxDC *dc, const wxRect &rect, int toprow, int rowcount, const wxColor &bgcolor)
+//==================================================
+// Row Cache
+
+namespace
+{
+
+const wxUint64 ROWCACHE_FNV_BASIS = wxULL(14695981039346656037);
+const wxUint64 ROWCACHE_FNV_PRIME = wxULL(1099511628211);
+const int ROWCACHE_MAX_HEIGHT = 16384;  // of m_RowCacheBitmap
+
+template <typename T>
+inline void RowCacheHash(wxUint64 &hash, const T &value)
+{
+    const wxByte *b = (const wxByte *)&value;
+    for(size_t i=0; i<sizeof(value); ++i)
+    {
+        hash ^= b[i];
+        hash *= ROWCACHE_FNV_PRIME;
+    }
+}
+
+// the blocks identify the content of the line, because the data of the
+// blocks are never changed before the cache is invalidated
+wxUint64 RowCacheLineHash(const MadLine &line)
+{
+    wxUint64 hash = ROWCACHE_FNV_BASIS;
+    for(xm::BlockVector::const_iterator bit = line.m_Blocks.begin(); bit != line.m_Blocks.end(); ++bit)
+    {
+        RowCacheHash(hash, bit->m_Data);
+        RowCacheHash(hash, bit->m_Pos);
+        RowCacheHash(hash, bit->m_Size);
+    }
+    RowCacheHash(hash, line.m_Size);
+    RowCacheHash(hash, line.m_nl);
+    RowCacheHash(hash, line.m_State.RangeId);
+    RowCacheHash(hash, line.m_State.CommentId);
+    RowCacheHash(hash, line.m_State.StringId);
+    RowCacheHash(hash, line.m_State.LineComment);
+    RowCacheHash(hash, line.m_State.Directive);
+    RowCacheHash(hash, line.m_RowIndices.size());
+    return hash;
+}
+
+// the key of a row, the horizontal position is not included
+inline void RowCacheRowKey(MadLineIterator lit, int subrow, wxUint64 &hash)
+{
+    RowCacheHash(hash, lit->m_RowIndices[subrow].m_Start);
+    RowCacheHash(hash, lit->m_RowIndices[subrow].m_Width);
+}
+
+} // anonymous namespace
+
+void MadEdit::InvalidateRowCache()
+{
+    m_RowCacheKeys.clear();
+    m_RowCacheStamps.clear();
+    m_PaintedRows.clear();
+}
+
+void MadEdit::ForgetPaintedRows(int firstrow, int rows)
+{
+    RowCacheKey empty = {nullptr, 0, 0};
+    for(int i = firstrow - m_PaintedTopRow; rows > 0; ++i, --rows)
+    {
+        if(i >= 0 && i < int(m_PaintedRows.size()))
+            m_PaintedRows[i] = empty;
+    }
+}
+
+// shift the painted rows in m_ClientBitmap down by rows (up if negative)
+void MadEdit::ScrollPaintedRows(wxMemoryDC &memdc, int rows)
 {
+    const int count = int(m_PaintedRows.size());
+    if(rows == 0 || count == 0)
+        return;
+
+    RowCacheKey empty = {nullptr, 0, 0};
+    if(rows >= count || -rows >= count)
+    {
+        m_PaintedRows.assign(count, empty);
+        return;
+    }
+
+    // copy by m_MarkBitmap, Blit() to the same DC may not handle the overlapping
+    wxMemoryDC tmpdc;
+    tmpdc.SelectObject(*m_MarkBitmap);
+    tmpdc.Blit(0, 0, m_ClientWidth, m_ClientHeight, &memdc, 0, 0);
+
+    const int moved = count - (rows > 0 ? rows : -rows);
+    if(rows > 0)
+    {
+        memdc.Blit(0, rows * m_RowHeight, m_ClientWidth, moved * m_RowHeight, &tmpdc, 0, 0);
+        std::copy_backward(m_PaintedRows.begin(), m_PaintedRows.begin() + moved, m_PaintedRows.end());
+        std::fill(m_PaintedRows.begin(), m_PaintedRows.begin() + rows, empty);
+    }
+    else
+    {
+        memdc.Blit(0, 0, m_ClientWidth, moved * m_RowHeight, &tmpdc, 0, -rows * m_RowHeight);
+        std::copy(m_PaintedRows.begin() - rows, m_PaintedRows.end(), m_PaintedRows.begin());
+        std::fill(m_PaintedRows.begin() + moved, m_PaintedRows.end(), empty);
+    }
+}
+
+// shift the painted text horizontally and paint the exposed columns, return
+// false if some of the rows are changed and must be painted entirely
+bool MadEdit::ScrollPaintedColumns(wxMemoryDC &memdc, int toprow, int rowcount, const wxColor &bgcolor)
+{
+    if(int(m_PaintedRows.size()) < rowcount)
+        return false;
+
+    MadLineIterator lit;
+    wxFileOffset notused;
+    int subrowid = toprow;
+    GetLineByRow(lit, notused, subrowid);
+    subrowid = toprow - subrowid;
+
+    wxUint64 linehash = RowCacheLineHash(*lit);
+    for(int i = 0; i < rowcount; ++i)
+    {
+        if(subrowid == int(lit->RowCount()))
+        {
+            ++lit;
+            subrowid = 0;
+            linehash = RowCacheLineHash(*lit);
+        }
+
+        const RowCacheKey &k = m_PaintedRows[i];
+        wxUint64 hash = linehash;
+        RowCacheRowKey(lit, subrowid, hash);
+        if(k.line != &(*lit) || k.subrow != subrowid || k.hash != hash)
+            return false;
+
+        ++subrowid;
+    }
+
+    const int textleft = CachedLineNumberAreaWidth() + 1;
+    const int textwidth = m_ClientWidth - textleft;
+    const int dx = m_PaintedXPos - m_DrawingXPos;   // > 0: moved right
+    const int adx = dx > 0 ? dx : -dx;
+    if(adx >= textwidth)
+        return false;
+
+    wxMemoryDC tmpdc;
+    tmpdc.SelectObject(*m_MarkBitmap);
+    tmpdc.Blit(0, 0, m_ClientWidth, m_ClientHeight, &memdc, 0, 0);
+
+    wxRect strip(0, 0, adx, rowcount * m_RowHeight);
+    if(dx > 0)
+    {
+        memdc.Blit(textleft + dx, 0, textwidth - dx, strip.height, &tmpdc, textleft, 0);
+        strip.x = textleft;
+    }
+    else
+    {
+        memdc.Blit(textleft, 0, textwidth - adx, strip.height, &tmpdc, textleft + adx, 0);
+        strip.x = m_ClientWidth - adx;
+    }
+
+    memdc.DrawRectangle(strip);
+    memdc.SetClippingRegion(strip);
+    PaintTextLines(&memdc, wxRect(0, 0, m_ClientWidth, m_ClientHeight), toprow, rowcount, bgcolor);
+    memdc.DestroyClippingRegion();
+
+    // clear the area below the last row
+    if(strip.height < m_ClientHeight)
+        memdc.DrawRectangle(0, strip.height, m_ClientWidth, m_ClientHeight - strip.height);
+
+    return true;
+}
+
+// the xpos cached in the row are kept if they are measured with the same font
+// and widths, and a change of the row width changes only the tab chars which
+// are fit in the rest of the row
+void MadEdit::SetDisplayRowWidth(MadDecodedRow *dr, int rowwidth)
+{
+    wxUint64 sig = ROWCACHE_FNV_BASIS;
+    RowCacheHash(sig, m_TextFont);
+    RowCacheHash(sig, m_TextFont->GetPointSize());
+    RowCacheHash(sig, m_FixedWidthMode);
+    RowCacheHash(sig, GetTabMaxCharFontWidth());
+    RowCacheHash(sig, GetSpaceCharFontWidth());
+    if(sig == 0)
+        sig = 1;
+
+    if(dr->m_WidthSignature != sig)
+    {
+        dr->m_WidthSignature = sig;
+        dr->m_XPos.assign(1, 0);
+    }
+    else if(dr->m_RowWidth != rowwidth)
+    {
+        const int fixed = std::min(dr->m_RowWidth, rowwidth) - GetTabMaxCharFontWidth();
+        const size_t count = size_t(std::upper_bound(dr->m_XPos.begin(), dr->m_XPos.end() - 1, fixed) - dr->m_XPos.begin());
+        dr->m_XPos.resize(count + 1);
+    }
+    dr->m_RowWidth = rowwidth;
+}
+
+MadDecodedRow *MadEdit::GetDisplayRow(const MadLineIterator &lit, int subrowid)
+{
+    MadDecodedRow *dr = m_Lines->DecodeRow(lit, subrowid);
+    SetDisplayRowWidth(dr, lit->m_RowIndices[subrowid].m_Width);
+    return dr;
+}
+
+MadDecodedRow *MadEdit::InitDisplayRow(const MadLineIterator &lit, int subrowid)
+{
+    MadDecodedRow *dr = m_Lines->InitNextUCharDecoded(lit, subrowid);
+    SetDisplayRowWidth(dr, lit->m_RowIndices[subrowid].m_Width);
+    return dr;
+}
+
+int MadEdit::GetDisplayCharWidth(MadDecodedRow *dr, size_t idx, ucs4_t uc, int xpos)
+{
+    if(idx + 1 < dr->m_XPos.size())
+        return dr->m_XPos[idx + 1] - dr->m_XPos[idx];
+
+    // same as UpdateCaret(), the xpos of tab chars starts from every row
+    const int width = GetUCharTextFontWidth(uc, dr->m_RowWidth, xpos);
+    if(idx + 1 == dr->m_XPos.size() && idx < dr->m_Chars.size())
+        dr->m_XPos.push_back(dr->m_XPos.back() + width);
+    return width;
+}
+
+// return false if the rows can't be cached
+bool MadEdit::PrepareRowCache(const wxColor &bgcolor, int width)
+{
+    if(width <= 0 || m_RowHeight <= 0)
+        return false;
+
+    wxUint64 sig = ROWCACHE_FNV_BASIS;
+    RowCacheHash(sig, m_Syntax);
+    RowCacheHash(sig, m_Encoding);
+    RowCacheHash(sig, m_TextFont);
+    RowCacheHash(sig, m_TextFont->GetPointSize());
+    RowCacheHash(sig, m_RowHeight);
+    RowCacheHash(sig, m_TextFontHeight);
+    RowCacheHash(sig, m_LeftMarginWidth);
+    RowCacheHash(sig, m_ShowSpaceChar);
+    RowCacheHash(sig, m_ShowTabChar);
+    RowCacheHash(sig, m_ShowEndOfLine);
+    RowCacheHash(sig, m_FixedWidthMode);
+    RowCacheHash(sig, bgcolor.Red());
+    RowCacheHash(sig, bgcolor.Green());
+    RowCacheHash(sig, bgcolor.Blue());
+
+    int slots = int(m_VisibleRowCount) * 2 + 2;
+    if(slots * m_RowHeight > ROWCACHE_MAX_HEIGHT)
+        slots = ROWCACHE_MAX_HEIGHT / m_RowHeight;
+
+    if(m_RowCacheBitmap == nullptr || m_RowCacheWidth != width
+        || m_RowCacheBitmap->GetHeight() != slots * m_RowHeight)
+    {
+        delete m_RowCacheBitmap;
+        m_RowCacheBitmap = new wxBitmap(width, slots * m_RowHeight);
+        m_RowCacheWidth = width;
+        InvalidateRowCache();
+    }
+    else if(sig != m_RowCacheSignature)
+    {
+        InvalidateRowCache();
+    }
+    m_RowCacheSignature = sig;
+
+    if(m_RowCacheKeys.empty())
+    {
+        RowCacheKey empty = {nullptr, 0, 0};
+        m_RowCacheKeys.assign(slots, empty);
+        m_RowCacheStamps.assign(slots, 0);
+    }
+
+    return m_RowCacheBitmap->IsOk();
+}
+
+int MadEdit::FindCachedRow(const RowCacheKey &key)
+{
+    for(size_t i=0; i<m_RowCacheKeys.size(); ++i)
+    {
+        const RowCacheKey &k = m_RowCacheKeys[i];
+        if(k.line == key.line && k.subrow == key.subrow && k.hash == key.hash)
+        {
+            m_RowCacheStamps[i] = ++m_RowCacheClock;
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+// replace the least recently used slot
+int MadEdit::AllocCachedRow(const RowCacheKey &key)
+{
+    size_t slot = 0;
+    for(size_t i=1; i<m_RowCacheStamps.size(); ++i)
+    {
+        if(m_RowCacheStamps[i] < m_RowCacheStamps[slot])
+            slot = i;
+    }
+
+    m_RowCacheKeys[slot] = key;
+    m_RowCacheStamps[slot] = ++m_RowCacheClock;
+    return int(slot);
+}
+
+void MadEdit::PaintTextLines(wxDC *dc, const wxRect &rect, int toprow, int rowcount, const wxColor &bgcolor, bool usecache)
+{
+    XM_PERF_SCOPE(PERF_PAINT_TEXT_LINES);
+
     MadLineIterator lineiter;
     int subrowid = toprow;
     wxFileOffset notused;
@@ -1873,264 +2414,347 @@ void MadEdit::PaintTextLines(wxDC *dc, const wxRect &rect, int toprow, int rowco
     int SelLeft=0/*?*/, SelRight=0/*?*/;
     int xpos1=0, xpos2=0;
 
+    wxMemoryDC cachedc;
+    const int cachewidth = rectright - minleft;
+    if(usecache && !InPrinting() && PrepareRowCache(bgcolor, cachewidth))
+        cachedc.SelectObject(*m_RowCacheBitmap);
+    else
+        usecache = false;
+    wxUint64 linehash = usecache? RowCacheLineHash(*lineiter): 0;
+
+    // the rows not painted already are cleared before painting
+    const bool clearrows = usecache && !m_PaintedRows.empty();
+    if(usecache && m_PaintedRows.size() < m_VisibleRowCount + 1)
+    {
+        RowCacheKey empty = {nullptr, 0, 0};
+        m_PaintedRows.resize(m_VisibleRowCount + 1, empty);
+    }
+
     // Begin Paint Lines
     for(;;)                         // every line
     {
         do                          // every row of line
         {
-            left = leftpos;
-            wxColor current_bgcolor = bgcolor;
-
-            // paint left margin
-            int leftmarginwidth=m_LeftMarginWidth-m_DrawingXPos;
-            if(leftmarginwidth>0)
+            // the selected rows are painted without the cache
+            int cacheslot = -1;
+            bool painted = false;
+            RowCacheKey rowkey = {&(*lineiter), subrowid, linehash}, cachekey;
+            const size_t screenrow = size_t(toprow - m_TopRow);
+            bool cacherow = usecache && !(bPaintSelection
+                && toprow >= m_SelectionBegin->rowid && toprow <= m_SelectionEnd->rowid);
+            if(cacherow)
             {
-                wxColor &c=m_Syntax->GetAttributes(aeText)->bgcolor;
-                if(c != current_bgcolor)
+                RowCacheRowKey(lineiter, subrowid, rowkey.hash);
+                if(screenrow < m_PaintedRows.size())
                 {
-                    current_bgcolor = c;
-                    dc->SetPen(*wxThePenList->FindOrCreatePen(c, 1, wxPENSTYLE_SOLID));
-                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(c));
-                    dc->DrawRectangle(minleft, row_top, rectright-minleft, m_RowHeight);
+                    const RowCacheKey &k = m_PaintedRows[screenrow];
+                    painted = (k.line == rowkey.line && k.subrow == rowkey.subrow && k.hash == rowkey.hash);
                 }
+
+                cachekey = rowkey;
+                RowCacheHash(cachekey.hash, m_DrawingXPos);
+                if(!painted)
+                    cacheslot = FindCachedRow(cachekey);
             }
 
-            if(bPaintSelection)
+            if(painted || cacheslot >= 0)
             {
-                SelLeft = SelRight = leftpos;
-                xpos1 = xpos2 = 0;
-                if(m_EditMode == emTextMode)
+                if(!painted)
+                    dc->Blit(minleft, row_top, cachewidth, m_RowHeight, &cachedc, 0, cacheslot * m_RowHeight);
+
+                // skip the words of the row
+                if(subrowid + 1 == int(lineiter->RowCount()))
                 {
-                    if(toprow == m_SelectionBegin->rowid)
+                    m_Syntax->nw_EndOfLine = true;
+                }
+                else if(m_Syntax->m_CheckState)
+                {
+                    do
                     {
-                        xpos1 = m_SelectionBegin->xpos;
+                        m_Syntax->NextWord(wordwidth);
                     }
-                    if(toprow == m_SelectionEnd->rowid)
+                    while(m_Syntax->nw_LineWidth != 0);
+                }
+                else
+                {
+                    m_Syntax->InitNextWord2(lineiter, subrowid + 1);
+                }
+            }
+            else
+            {
+                if(clearrows)
+                {
+                    dc->SetPen(*wxThePenList->FindOrCreatePen(bgcolor, 1, wxPENSTYLE_SOLID));
+                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(bgcolor));
+                    dc->DrawRectangle(rect.GetLeft(), row_top, rectright-rect.GetLeft(), m_RowHeight);
+                }
+
+                left = leftpos;
+                wxColor current_bgcolor = bgcolor;
+
+                // paint left margin
+                int leftmarginwidth=m_LeftMarginWidth-m_DrawingXPos;
+                if(leftmarginwidth>0)
+                {
+                    wxColor &c=m_Syntax->GetAttributes(aeText)->bgcolor;
+                    if(c != current_bgcolor)
                     {
-                        xpos2 = m_SelectionEnd->xpos;
+                        current_bgcolor = c;
+                        dc->SetPen(*wxThePenList->FindOrCreatePen(c, 1, wxPENSTYLE_SOLID));
+                        dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(c));
+                        dc->DrawRectangle(minleft, row_top, rectright-minleft, m_RowHeight);
+                    }
+                }
+
+                if(bPaintSelection)
+                {
+                    SelLeft = SelRight = leftpos;
+                    xpos1 = xpos2 = 0;
+                    if(m_EditMode == emTextMode)
+                    {
+                        if(toprow == m_SelectionBegin->rowid)
+                        {
+                            xpos1 = m_SelectionBegin->xpos;
+                        }
+                        if(toprow == m_SelectionEnd->rowid)
+                        {
+                            xpos2 = m_SelectionEnd->xpos;
+                        }
                     }
-                }
-                else                    //ColumnMode
-                {
-                    if(toprow >= m_SelectionBegin->rowid && toprow <= m_SelectionEnd->rowid)
+                    else                    //ColumnMode
                     {
-                        xpos1 = m_SelLeftXPos;
-                        xpos2 = m_SelRightXPos;
+                        if(toprow >= m_SelectionBegin->rowid && toprow <= m_SelectionEnd->rowid)
+                        {
+                            xpos1 = m_SelLeftXPos;
+                            xpos2 = m_SelRightXPos;
+                        }
                     }
                 }
-            }
 
-            do                        // every word of row
-            {
-                wordlength = m_Syntax->NextWord(wordwidth);
-                if(wordlength)
+                do                        // every word of row
                 {
-                    if(left < maxright && left + wordwidth > minleft)
+                    wordlength = m_Syntax->NextWord(wordwidth);
+                    if(wordlength)
                     {
-                        if(m_WordBuffer[0] == 0x20 || m_WordBuffer[0] == 0x09)
+                        if(left < maxright && left + wordwidth > minleft)
                         {
-                            if(m_Syntax->nw_BgColor != current_bgcolor)
-                            {
-                                current_bgcolor = m_Syntax->nw_BgColor;
-                                dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
-                                dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_BgColor));
-                                dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
-                            }
-
-                            dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_Color, 1, wxPENSTYLE_SOLID));
-
-                            int idx = 0;
-                            int x0 = left;
-                            do
+                            if(m_WordBuffer[0] == 0x20 || m_WordBuffer[0] == 0x09)
                             {
-                                if (x0 + m_WidthBuffer[idx] <= minleft)
-                                    continue;
-
-                                if(m_WordBuffer[idx] == 0x20)
+                                if(m_Syntax->nw_BgColor != current_bgcolor)
                                 {
-                                    if (m_ShowSpaceChar)
-                                        dc->DrawLines((int)m_space_points.size(), &m_space_points[0], x0, text_top);
+                                    current_bgcolor = m_Syntax->nw_BgColor;
+                                    dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
+                                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_BgColor));
+                                    dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
                                 }
-                                else if(m_ShowTabChar)
+
+                                dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_Color, 1, wxPENSTYLE_SOLID));
+
+                                int idx = 0;
+                                int x0 = left;
+                                do
                                 {
-                                    const wxSize charsz(m_WidthBuffer[idx], m_TextFontHeight);
+                                    if (x0 + m_WidthBuffer[idx] <= minleft)
+                                        continue;
+
+                                    if(m_WordBuffer[idx] == 0x20)
+                                    {
+                                        if (m_ShowSpaceChar)
+                                            dc->DrawLines((int)m_space_points.size(), &m_space_points[0], x0, text_top);
+                                    }
+                                    else if(m_ShowTabChar)
+                                    {
+                                        const wxSize charsz(m_WidthBuffer[idx], m_TextFontHeight);
+
+                                        std::vector<wxPoint> pts;
+                                        CalcTabMarkPoints(pts, charsz);
 
-                                    std::vector<wxPoint> pts;
-                                    CalcTabMarkPoints(pts, charsz);
+                                        dc->DrawLines((int)pts.size(), &pts[0], x0, text_top);
+                                    }
 
-                                    dc->DrawLines((int)pts.size(), &pts[0], x0, text_top);
+                                    x0 += m_WidthBuffer[idx];
                                 }
+                                while(++idx < wordlength && x0<maxright);
 
-                                x0 += m_WidthBuffer[idx];
                             }
-                            while(++idx < wordlength && x0<maxright);
+                            else
+                            {
+                                if(m_Syntax->nw_BgColor != current_bgcolor)
+                                {
+                                    current_bgcolor = m_Syntax->nw_BgColor;
+                                    dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
+                                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_BgColor));
+                                    dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
+                                }
+
+                                dc->SetTextForeground(m_Syntax->nw_Color);
+                                dc->SetFont(*(m_Syntax->nw_Font));
 
+                                PaintText(dc, left, text_top, m_WordBuffer, m_WidthBuffer, wordlength, minleft, maxright);
+                            }
                         }
-                        else
+
+                        if(xpos1 > 0 || xpos2 > 0)
                         {
-                            if(m_Syntax->nw_BgColor != current_bgcolor)
+                            int idx = 0;
+                            int *pw = m_WidthBuffer;
+                            do
                             {
-                                current_bgcolor = m_Syntax->nw_BgColor;
-                                dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
-                                dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_BgColor));
-                                dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
-                            }
+                                if(xpos1 > (*pw >> 1))
+                                {
+                                    SelLeft += *pw;
+                                    xpos1 -= *pw;
+                                }
+                                else
+                                    xpos1 = 0;
 
-                            dc->SetTextForeground(m_Syntax->nw_Color);
-                            dc->SetFont(*(m_Syntax->nw_Font));
+                                if(xpos2 > (*pw >> 1))
+                                {
+                                    SelRight += *pw;
+                                    xpos2 -= *pw;
+                                }
+                                else
+                                    xpos2 = 0;
 
-                            PaintText(dc, left, text_top, m_WordBuffer, m_WidthBuffer, wordlength, minleft, maxright);
+                                ++pw;
+                            }
+                            while(++idx < wordlength && (xpos1 > 0 || xpos2 > 0));
                         }
+
+                        left += wordwidth;
                     }
 
-                    if(xpos1 > 0 || xpos2 > 0)
+                    // ignore the text outside the rect
+                    if(left > maxright)
                     {
-                        int idx = 0;
-                        int *pw = m_WidthBuffer;
-                        do
+                        if(subrowid + 1 == int(lineiter->RowCount()))
                         {
-                            if(xpos1 > (*pw >> 1))
-                            {
-                                SelLeft += *pw;
-                                xpos1 -= *pw;
-                            }
-                            else
-                                xpos1 = 0;
-
-                            if(xpos2 > (*pw >> 1))
-                            {
-                                SelRight += *pw;
-                                xpos2 -= *pw;
-                            }
-                            else
-                                xpos2 = 0;
-
-                            ++pw;
+                            m_Syntax->nw_EndOfLine = true;
+                            break;
                         }
-                        while(++idx < wordlength && (xpos1 > 0 || xpos2 > 0));
+                        /***/
+                        if(m_Syntax->m_CheckState == false)
+                        {
+                            m_Syntax->InitNextWord2(lineiter, subrowid + 1);
+                            break;
+                        }
+                        /***/
                     }
-
-                    left += wordwidth;
                 }
+                while(m_Syntax->nw_LineWidth != 0 && wordwidth != 0);
 
-                // ignore the text outside the rect
-                if(left > maxright)
+                // show end of line
+                if(m_Syntax->nw_EndOfLine && left < maxright && m_ShowEndOfLine)
                 {
-                    if(subrowid + 1 == int(lineiter->RowCount()))
-                    {
-                        m_Syntax->nw_EndOfLine = true;
-                        break;
-                    }
-                    /***/
-                    if(m_Syntax->m_CheckState == false)
+                    m_Syntax->SetAttributes(aeSpace);
+
+                    int w = m_TextFontAveCharWidth;
+
+                    // clear background
+                    if(m_Syntax->nw_BgColor != current_bgcolor)
                     {
-                        m_Syntax->InitNextWord2(lineiter, subrowid + 1);
-                        break;
+                        current_bgcolor = m_Syntax->nw_BgColor;
+                        dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
+                        dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_BgColor));
+                        dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
                     }
-                    /***/
-                }
-            }
-            while(m_Syntax->nw_LineWidth != 0 && wordwidth != 0);
 
-            // show end of line
-            if(m_Syntax->nw_EndOfLine && left < maxright && m_ShowEndOfLine)
-            {
-                m_Syntax->SetAttributes(aeSpace);
+                    dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_Color, 1, wxPENSTYLE_SOLID));
+                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_Color));
 
-                int w = m_TextFontAveCharWidth;
+                    std::vector<wxPoint>& points = lineiter->m_nl->PatternPoints(this);
+                    dc->DrawLines((int)points.size(), &points[0], left, text_top);
 
-                // clear background
-                if(m_Syntax->nw_BgColor != current_bgcolor)
-                {
-                    current_bgcolor = m_Syntax->nw_BgColor;
-                    dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
-                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_BgColor));
-                    dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
+                    left += w;
                 }
 
-                dc->SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_Color, 1, wxPENSTYLE_SOLID));
-                dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(m_Syntax->nw_Color));
-
-                std::vector<wxPoint>& points = lineiter->m_nl->PatternPoints(this);
-                dc->DrawLines((int)points.size(), &points[0], left, text_top);
-
-                left += w;
-            }
-
-            if(left < maxright)       // paint range color at rest of row
-            {
-                wxColor c=m_Syntax->nw_CurrentBgColor;
-                if(c != current_bgcolor)
+                if(left < maxright)       // paint range color at rest of row
                 {
-                    dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(c));
-                    dc->SetPen(*wxThePenList->FindOrCreatePen(c, 1, wxPENSTYLE_SOLID));
-                    dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
+                    wxColor c=m_Syntax->nw_CurrentBgColor;
+                    if(c != current_bgcolor)
+                    {
+                        dc->SetBrush(*wxTheBrushList->FindOrCreateBrush(c));
+                        dc->SetPen(*wxThePenList->FindOrCreatePen(c, 1, wxPENSTYLE_SOLID));
+                        dc->DrawRectangle(left, row_top, rectright-left, m_RowHeight);
+                    }
                 }
-            }
-
-            if(bPaintSelection)
-            {
-                if(!m_ShowEndOfLine && m_Syntax->nw_EndOfLine)
-                    left += m_TextFontAveCharWidth;
 
-                if(m_EditMode == emTextMode)
+                if(bPaintSelection)
                 {
-                    if(toprow == m_SelectionBegin->rowid)
+                    if(!m_ShowEndOfLine && m_Syntax->nw_EndOfLine)
+                        left += m_TextFontAveCharWidth;
+
+                    if(m_EditMode == emTextMode)
                     {
-                        if(toprow == m_SelectionEnd->rowid)  // single row
+                        if(toprow == m_SelectionBegin->rowid)
                         {
-                            INVERT_RECT(dc, SelLeft, text_top, SelRight-SelLeft, m_TextFontHeight);
+                            if(toprow == m_SelectionEnd->rowid)  // single row
+                            {
+                                INVERT_RECT(dc, SelLeft, text_top, SelRight-SelLeft, m_TextFontHeight);
+                            }
+                            else
+                            {
+                                INVERT_RECT(dc, SelLeft, text_top, left-SelLeft, m_TextFontHeight);
+                            }
                         }
-                        else
+                        else if(toprow == m_SelectionEnd->rowid)
                         {
-                            INVERT_RECT(dc, SelLeft, text_top, left-SelLeft, m_TextFontHeight);
+                            INVERT_RECT(dc, leftpos, text_top, SelRight-leftpos, m_TextFontHeight);
+                        }
+                        else if(toprow > m_SelectionBegin->rowid
+                                && toprow < m_SelectionEnd->rowid)
+                        {
+                            INVERT_RECT(dc, leftpos, text_top, left-leftpos, m_TextFontHeight);
                         }
                     }
-                    else if(toprow == m_SelectionEnd->rowid)
-                    {
-                        INVERT_RECT(dc, leftpos, text_top, SelRight-leftpos, m_TextFontHeight);
-                    }
-                    else if(toprow > m_SelectionBegin->rowid
-                            && toprow < m_SelectionEnd->rowid)
-                    {
-                        INVERT_RECT(dc, leftpos, text_top, left-leftpos, m_TextFontHeight);
-                    }
-                }
-                else                    // ColumnMode
-                {
-                    if(toprow >= m_SelectionBegin->rowid && toprow <= m_SelectionEnd->rowid)
+                    else                    // ColumnMode
                     {
-                        if(xpos1 > 0)
+                        if(toprow >= m_SelectionBegin->rowid && toprow <= m_SelectionEnd->rowid)
                         {
-                            const int w = GetSpaceCharFontWidth();
-                            int spaces = xpos1 / w;
-                            xpos1 -= spaces * w;
-                            if(xpos1 > (w >> 1))
+                            if(xpos1 > 0)
                             {
-                                ++spaces;
+                                const int w = GetSpaceCharFontWidth();
+                                int spaces = xpos1 / w;
+                                xpos1 -= spaces * w;
+                                if(xpos1 > (w >> 1))
+                                {
+                                    ++spaces;
+                                }
+                                SelLeft += spaces * w;
                             }
-                            SelLeft += spaces * w;
-                        }
-                        if(xpos2 > 0)
-                        {
-                            const int w = GetSpaceCharFontWidth();
-                            int spaces = xpos2 / w;
-                            xpos2 -= spaces * w;
-                            if(xpos2 > (w >> 1))
+                            if(xpos2 > 0)
                             {
-                                ++spaces;
+                                const int w = GetSpaceCharFontWidth();
+                                int spaces = xpos2 / w;
+                                xpos2 -= spaces * w;
+                                if(xpos2 > (w >> 1))
+                                {
+                                    ++spaces;
+                                }
+                                SelRight += spaces * w;
                             }
-                            SelRight += spaces * w;
-                        }
 
-                        if(SelRight == SelLeft && toprow != m_CaretPos.rowid)
-                        {
-                            SelRight += 2;
-                        }
+                            if(SelRight == SelLeft && toprow != m_CaretPos.rowid)
+                            {
+                                SelRight += 2;
+                            }
 
-                        INVERT_RECT(dc, SelLeft, text_top, SelRight-SelLeft, m_TextFontHeight);
+                            INVERT_RECT(dc, SelLeft, text_top, SelRight-SelLeft, m_TextFontHeight);
+                        }
                     }
                 }
+
+                if(cacherow)
+                {
+                    cacheslot = AllocCachedRow(cachekey);
+                    cachedc.Blit(0, cacheslot * m_RowHeight, cachewidth, m_RowHeight, dc, minleft, row_top);
+                }
+            }
+
+            if(usecache && screenrow < m_PaintedRows.size())
+            {
+                RowCacheKey empty = {nullptr, 0, 0};
+                m_PaintedRows[screenrow] = cacherow? rowkey: empty;
             }
 
             wxRect tmprect(rect.GetLeft(), row_top, CachedLineNumberAreaWidth() + 1, m_RowHeight);
@@ -2155,52 +2779,63 @@ void MadEdit::PaintTextLines(wxDC *dc, const wxRect &rect, int toprow, int rowco
         m_Syntax->InitNextWord2(lineiter, 0);
         subrowid = 0;
         is_trailing_subrow = false;
+        if(usecache)
+            linehash = RowCacheLineHash(*lineiter);
 
         ++lineid;
     }
 }
 
 
-void MadEdit::PaintHexDigit(wxDC *dc, int x, int y, const ucs4_t *hexdigit, const int *width, int count)
+// the hex glyph atlas m_HexDigitBitmap:
+//   row 0: "0123456789ABCDEF|" in aeText
+//   row 1: "0123456789ABCDEF|:" in aeLineNumber
+//   row 2: HexHeader
+//   row 3: "000102...FEFF", the two digits of every byte in aeText
+//   row 4: the same as row 3 in aeLineNumber
+// so a byte of the data or the offset is drawn by one Blit at byte*2 digits
+
+void MadEdit::PaintHexAtlasBytes(wxDC *dc, int y)
 {
-    while(count>0)
+    const int pairwidth = m_HexFontMaxDigitWidth * 2;
+    for(int hi = 0; hi < 16; ++hi)
     {
-        if(*hexdigit != 0x20)
+        int idx = 0;
+        for(int lo = 0; lo < 16; ++lo)
         {
-            int xsrc= *hexdigit - '0';
-            if(xsrc>=10)
-            {
-                if(xsrc>22) xsrc=16;
-                else xsrc-=7;
-            }
-            dc->Blit(x, y, m_HexFontMaxDigitWidth, m_RowHeight, m_HexDigitDC, xsrc*m_HexFontMaxDigitWidth, 0);
+            m_WordBuffer[idx++] = ToHex(hi);
+            m_WordBuffer[idx++] = ToHex(lo);
         }
-
-        x+=*width;
-        ++hexdigit;
-        ++width;
-        --count;
+        PaintText(dc, hi * 16 * pairwidth, y, m_WordBuffer, m_WidthBuffer, 32, 0, 9999999);
     }
 }
 
-void MadEdit::PaintHexOffset(wxDC *dc, int x, int y, const ucs4_t *hexdigit, const int *width, int count)
+void MadEdit::PaintHexBytes(wxDC *dc, int x, int y, const wxByte *bytes, int count)
 {
-    while(count>0)
+    const int pairwidth = m_HexFontMaxDigitWidth * 2;
+    const int ysrc = m_RowHeight * 3;
+    for(int i = 0; i < count; ++i)
     {
-        int xsrc= *hexdigit - '0';
-        if(xsrc>=10)
-        {
-            if(xsrc==10) xsrc=17;
-            else         xsrc-=7;
-        }
+        dc->Blit(x + i * 3 * m_HexFontMaxDigitWidth, y, pairwidth, m_RowHeight, m_HexDigitDC, bytes[i] * pairwidth, ysrc);
+    }
 
-        dc->Blit(x, y, m_HexFontMaxDigitWidth, m_RowHeight, m_HexDigitDC, xsrc*m_HexFontMaxDigitWidth, m_RowHeight);
+    // '|'
+    dc->Blit(x + 16 * 3 * m_HexFontMaxDigitWidth, y, m_HexFontMaxDigitWidth, m_RowHeight, m_HexDigitDC, 16 * m_HexFontMaxDigitWidth, 0);
+}
 
-        x+=*width;
-        ++hexdigit;
-        ++width;
-        --count;
+void MadEdit::PaintHexOffset(wxDC *dc, int x, int y, wxFileOffset offset)
+{
+    const int pairwidth = m_HexFontMaxDigitWidth * 2;
+    const int ysrc = m_RowHeight * 4;
+    wxUint32 hex = wxUint32(offset);
+    for(int i = 3; i >= 0; --i)
+    {
+        dc->Blit(x + i * pairwidth, y, pairwidth, m_RowHeight, m_HexDigitDC, int(hex & 0xFF) * pairwidth, ysrc);
+        hex >>= 8;
     }
+
+    // ':'
+    dc->Blit(x + 8 * m_HexFontMaxDigitWidth, y, m_HexFontMaxDigitWidth, m_RowHeight, m_HexDigitDC, 17 * m_HexFontMaxDigitWidth, m_RowHeight);
 }
 
 void MadEdit::PaintHexLines(wxDC *dc, wxRect &rect, int toprow, int rowcount, bool painthead)
@@ -2256,6 +2891,9 @@ void MadEdit::PaintHexLines(wxDC *dc, wxRect &rect, int toprow, int rowcount, bo
     }
 
     MadLineIterator lineend = m_Lines->m_LineList.end();
+
+    // the bytes of the rows are read in sequence, so seek the block once
+    MadBytesReader reader(lit1, linepos1, lineend);
     m_ActiveRowUChars.clear();
 
 
@@ -2280,54 +2918,20 @@ void MadEdit::PaintHexLines(wxDC *dc, wxRect &rect, int toprow, int rowcount, bo
         left = rect.x;
 
         // paint offset
-        size_t hex = size_t(hexrowpos);
-        for(int i = 7; i >= 0; --i)
-        {
-            m_WordBuffer[i] = ToHex(int(hex & 0x0F));
-            hex >>= 4;
-        }
-        m_WordBuffer[8] = wxT(':');
-        PaintHexOffset(dc, left, top, m_WordBuffer, m_WidthBuffer, 9);
-
+        PaintHexOffset(dc, left, top, hexrowpos);
 
         left += m_HexFontMaxDigitWidth * 10;
 
         // paint binary data
-        int idx = 0;
-        for(int i = 0; i < 16; i++)
-        {
-            if(linepos1 == lit1->m_Size)       // to next line
-            {
-                if((++lit1) == lineend || lit1->m_Size == 0)
-                {
-                    break;
-                }
-                linepos1 = 0;
-            }
-
-            hex = lit1->Get(linepos1++);
-
-            m_WordBuffer[idx++] = ToHex(int(hex >> 4));
-            m_WordBuffer[idx++] = ToHex(int(hex & 0x0F));
-            m_WordBuffer[idx++] = 0x20;
-        }
-
-        if(idx < 16 * 3)
-            do
-            {
-                m_WordBuffer[idx++] = 0x20;
-            }
-            while(idx < 16 * 3);
-
-        m_WordBuffer[idx] = wxT('|');
-
-        PaintHexDigit(dc, left, top, m_WordBuffer, m_WidthBuffer, 16 * 3 + 1);
+        wxByte bytes[16];
+        int nbytes = int(reader.Read(bytes, 16));
+        PaintHexBytes(dc, left, top, bytes, nbytes);
 
 
         left += m_HexFontMaxDigitWidth * (16 * 3 + 2);
 
         // paint text data
-        idx = 0;
+        int idx = 0;
         int *pw = m_WidthBuffer + 60;
 
         if(hexrowpos < pos)         // show spaces
@@ -3034,21 +3638,8 @@ void MadEdit::UpdateHexPosByXPos(int row, int xpos)
     m_CaretPos.pos = pos;
     m_CaretPos.iter = lit;
 
-    m_CaretPos.rowid = rowid;
-    m_CaretPos.subrowid = 0;
-
-    int cnt = int(lit->RowCount() - 1);
-    if(m_CaretPos.subrowid < cnt)
-    {
-        if(m_CaretPos.linepos >= lit->m_RowIndices[1].m_Start)
-        do
-        {
-            ++m_CaretPos.subrowid;
-            ++m_CaretPos.rowid;
-        }
-        while(m_CaretPos.subrowid < cnt
-                && m_CaretPos.linepos >= lit->m_RowIndices[m_CaretPos.subrowid + 1].m_Start);
-    }
+    m_CaretPos.subrowid = lit->GetSubRow(m_CaretPos.linepos);
+    m_CaretPos.rowid = rowid + m_CaretPos.subrowid;
 }
 
 
@@ -4051,6 +4642,9 @@ MadLineIterator MadEdit::DeleteInsertData(wxFileOffset pos,
     wxFileOffset bpos=pos;
     int tmp_rowid;
 
+    if(m_Recovery != nullptr)
+        m_Recovery->Record(pos, delsize, inssize, insdata);
+
     m_UpdateValidPos = 1;   // update if pos < oldpos
 
     int lid = GetLineByPos(lit, bpos, tmp_rowid);
@@ -4645,30 +5239,46 @@ void MadEdit::InsertString(const ucs4_t *ucs, size_t count, bool bColumnEditing,
                 delete[]sp;
             }
 
+            bool keystroke = (count == 1 && moveCaret && !bSelText && m_CaretPos.extraspaces == 0);
+
             UCStoBlock(ucs, count, blk);
 
-            MadInsertUndoData *insud = new MadInsertUndoData;
-            insud->m_Pos = m_CaretPos.pos;
-            insud->m_Size = blk.m_Size;
+            wxFileOffset inspos = m_CaretPos.pos;
+            xm::BlockVector insdata(1, blk);
 
-            insud->m_Data.push_back(blk);
+            // merge consecutive typed chars into one undo
+            MadUndo *undo = nullptr;
+            if(keystroke)
+                undo = m_UndoBuffer->MergeInsert(inspos, blk, ucs[0]);
 
-            MadUndo *undo = m_UndoBuffer->Add();
-            undo->m_CaretPosBefore = m_CaretPos.pos;
-            if(moveCaret)
+            if(undo == nullptr)
             {
-                undo->m_CaretPosAfter = m_CaretPos.pos + blk.m_Size;
-            }
-            else
-            {
-                undo->m_CaretPosAfter = m_CaretPos.pos;
+                MadInsertUndoData *insud = new MadInsertUndoData;
+                insud->m_Pos = inspos;
+                insud->m_Size = blk.m_Size;
+
+                insud->m_Data.push_back(blk);
+
+                undo = m_UndoBuffer->Add();
+                undo->m_CaretPosBefore = m_CaretPos.pos;
+                if(moveCaret)
+                {
+                    undo->m_CaretPosAfter = m_CaretPos.pos + blk.m_Size;
+                }
+                else
+                {
+                    undo->m_CaretPosAfter = m_CaretPos.pos;
+                }
+                undo->m_Undos.push_back(insud);
+
+                if(keystroke)
+                    m_UndoBuffer->SetMergeable(undo, ucs[0]);
             }
-            undo->m_Undos.push_back(insud);
 
             size_t oldrows = m_Lines->m_RowCount;
             size_t oldlines = m_Lines->m_LineCount;
 
-            MadLineIterator lit = DeleteInsertData(insud->m_Pos, 0, nullptr, insud->m_Size, &insud->m_Data);
+            MadLineIterator lit = DeleteInsertData(inspos, 0, nullptr, blk.m_Size, &insdata);
 
             if(IsTextFile())
             {
@@ -4725,8 +5335,8 @@ void MadEdit::InsertString(const ucs4_t *ucs, size_t count, bool bColumnEditing,
             if(bSelText)
             {
                 m_Selection=true;
-                m_SelectionPos1.pos=insud->m_Pos;
-                m_SelectionPos2.pos=insud->m_Pos+insud->m_Size;
+                m_SelectionPos1.pos=inspos;
+                m_SelectionPos2.pos=inspos+blk.m_Size;
                 UpdateSelectionPos();
             }
 
@@ -5584,16 +6194,9 @@ MadUndo *MadEdit::DeleteSelection(bool bCorrectCaretPos, vector <int> *rpos, boo
                 m_SelectionBegin->lineid=GetLineByPos(m_SelectionBegin->iter, m_SelectionBegin->linepos, m_SelectionBegin->rowid);
                 m_SelectionBegin->linepos=m_SelectionBegin->pos - m_SelectionBegin->linepos;
 
-                m_SelectionBegin->subrowid=0;
-                MadRowIndexIterator riter = m_SelectionBegin->iter->m_RowIndices.begin() + 1;
-                while(m_SelectionBegin->subrowid+1 < int(m_SelectionBegin->iter->RowCount()) && riter->m_Start<= m_SelectionBegin->linepos)
-                {
-                    ++m_SelectionBegin->subrowid;
-                    ++m_SelectionBegin->rowid;
-                    ++riter;
-                }
-
-                --riter;
+                m_SelectionBegin->subrowid = m_SelectionBegin->iter->GetSubRow(m_SelectionBegin->linepos);
+                m_SelectionBegin->rowid += m_SelectionBegin->subrowid;
+                MadRowIndexIterator riter = m_SelectionBegin->iter->m_RowIndices.begin() + m_SelectionBegin->subrowid;
                 m_SelectionBegin->pos -= (m_SelectionBegin->linepos - riter->m_Start);
                 m_SelectionBegin->linepos = riter->m_Start;
 
@@ -5698,6 +6301,33 @@ MadUndo *MadEdit::DeleteSelection(bool bCorrectCaretPos, vector <int> *rpos, boo
     return undo;
 }
 
+MadUndo *MadEdit::DeleteByKeystroke(wxFileOffset pos, wxFileOffset size, MadLineIterator &lit)
+{
+    wxFileOffset caretPosBefore = m_CaretPos.pos;
+
+    xm::BlockVector deldata;
+    lit = DeleteInsertData(pos, size, &deldata, 0, nullptr);
+
+    // merge consecutive deleted chars into one undo
+    MadUndo *undo = m_UndoBuffer->MergeDelete(pos, size, deldata);
+    if(undo == nullptr)
+    {
+        MadDeleteUndoData *dudata = new MadDeleteUndoData;
+        dudata->m_Pos = pos;
+        dudata->m_Size = size;
+        dudata->m_Data.swap(deldata);
+
+        undo = m_UndoBuffer->Add();
+        undo->m_CaretPosBefore = caretPosBefore;
+        undo->m_CaretPosAfter = pos;
+        undo->m_Undos.push_back(dudata);
+
+        m_UndoBuffer->SetMergeable(undo);
+    }
+
+    return undo;
+}
+
 void MadEdit::InsertHexChar(int hc) // handle input in hexarea
 {
     wxASSERT(0 <= hc && hc <= 15);
@@ -5875,6 +6505,8 @@ void MadEdit::OverwriteDataSingle(vector<wxFileOffset> &del_bpos, vector<wxFileO
                          vector<const ucs4_t*> *ins_ucs, vector<wxByte*> *ins_data,
                          vector<wxFileOffset> &ins_len)
 {
+    XM_PERF_SCOPE(PERF_OVERWRITE_DATA_SINGLE);
+
     bool oldModified=m_Modified;
 
     MadMemData *md=m_Lines->m_MemData;
@@ -6063,6 +6695,8 @@ void MadEdit::OverwriteDataMultiple(vector<wxFileOffset> &del_bpos, vector<wxFil
                          vector<const ucs4_t*> *ins_ucs, vector<wxByte*> *ins_data,
                          vector<wxFileOffset> &ins_len)
 {
+    XM_PERF_SCOPE(PERF_OVERWRITE_DATA_MULTIPLE);
+
     bool oldModified=m_Modified;
 
     MadMemData *md=m_Lines->m_MemData;
@@ -7628,20 +8262,11 @@ void MadEdit::ProcessCommand(MadEditCommand command)
                                         xm::UCQueue ucqueue;
                                         m_Lines->NextUChar(ucqueue);
 
-                                        MadDeleteUndoData *dudata = new MadDeleteUndoData;
-                                        dudata->m_Pos = m_CaretPos.pos;
-                                        dudata->m_Size = ucqueue.front().nbytes();
-
                                         size_t oldrows = m_Lines->m_RowCount;
                                         size_t oldlines = m_Lines->m_LineCount;
 
-                                        MadLineIterator lit =
-                                            DeleteInsertData(dudata->m_Pos, dudata->m_Size, &dudata->m_Data, 0, nullptr);
-
-                                        MadUndo *undo = m_UndoBuffer->Add();
-                                        undo->m_CaretPosBefore = m_CaretPos.pos;
-                                        undo->m_CaretPosAfter = m_CaretPos.pos;
-                                        undo->m_Undos.push_back(dudata);
+                                        MadLineIterator lit;
+                                        DeleteByKeystroke(m_CaretPos.pos, ucqueue.front().nbytes(), lit);
 
                                         bool sc= (m_Modified==false);
                                         m_Modified = true;
@@ -7802,25 +8427,18 @@ void MadEdit::ProcessCommand(MadEditCommand command)
                                             wxASSERT(m_CaretRowUCharPos != 0);
 
                                             // delete last char of current row
-                                            MadDeleteUndoData *dudata = new MadDeleteUndoData;
-
                                             size_t len = m_ActiveRowUChars.back().nbytes();
-                                            dudata->m_Pos = m_CaretPos.pos - len;
-                                            dudata->m_Size = len;
+                                            wxFileOffset delpos = m_CaretPos.pos - len;
 
-                                            MadLineIterator lit = DeleteInsertData(dudata->m_Pos, dudata->m_Size, &dudata->m_Data, 0, nullptr);
-
-                                            MadUndo *undo = m_UndoBuffer->Add();
-                                            undo->m_CaretPosBefore=m_CaretPos.pos;
-                                            undo->m_CaretPosAfter=dudata->m_Pos;
-                                            undo->m_Undos.push_back(dudata);
+                                            MadLineIterator lit;
+                                            DeleteByKeystroke(delpos, len, lit);
 
                                             bool sc= (m_Modified==false);
                                             m_Modified = true;
 
                                             m_Lines->Reformat(lit, lit);
 
-                                            m_CaretPos.pos = dudata->m_Pos;
+                                            m_CaretPos.pos = delpos;
                                             UpdateCaretByPos(m_CaretPos, m_ActiveRowUChars, m_ActiveRowWidths, m_CaretRowUCharPos);
 
                                             AppearCaret();
@@ -7877,28 +8495,21 @@ void MadEdit::ProcessCommand(MadEditCommand command)
                                     }
                                     else          // in middle of row
                                     {
-                                        MadDeleteUndoData *dudata = new MadDeleteUndoData;
-
                                         size_t len = m_ActiveRowUChars[m_CaretRowUCharPos - 1].nbytes();
-                                        dudata->m_Pos = m_CaretPos.pos - len;
-                                        dudata->m_Size = len;
+                                        wxFileOffset delpos = m_CaretPos.pos - len;
 
                                         size_t oldrows = m_Lines->m_RowCount;
                                         size_t oldlines = m_Lines->m_LineCount;
 
-                                        MadLineIterator lit = DeleteInsertData(dudata->m_Pos, dudata->m_Size, &dudata->m_Data, 0, nullptr);
-
-                                        MadUndo *undo = m_UndoBuffer->Add();
-                                        undo->m_CaretPosBefore=m_CaretPos.pos;
-                                        undo->m_CaretPosAfter=dudata->m_Pos;
-                                        undo->m_Undos.push_back(dudata);
+                                        MadLineIterator lit;
+                                        DeleteByKeystroke(delpos, len, lit);
 
                                         bool sc= (m_Modified==false);
                                         m_Modified = true;
 
                                         size_t count = m_Lines->Reformat(lit, lit);
 
-                                        m_CaretPos.pos = dudata->m_Pos;
+                                        m_CaretPos.pos = delpos;
                                         UpdateCaretByPos(m_CaretPos, m_ActiveRowUChars, m_ActiveRowWidths, m_CaretRowUCharPos);
 
                                         AppearCaret();
@@ -9123,6 +9734,7 @@ void MadEdit::UpdateClientBitmap()
     {
         m_ClientBitmap=new wxBitmap(w,h);
         m_MarkBitmap=new wxBitmap(w,h);
+        m_PaintedRows.clear();
 
 #if FIXINVERT != 0
         if(InvertRect==nullptr)
@@ -9336,6 +9948,8 @@ void MadEdit::OnEraseBackground(wxEraseEvent &evt)
 
 void MadEdit::OnPaint(wxPaintEvent &evt)
 {
+    XM_PERF_SCOPE(PERF_ON_PAINT);
+
     wxPaintDC dc(this);
     wxMemoryDC memdc, markdc;
 
@@ -9391,15 +10005,39 @@ void MadEdit::OnPaint(wxPaintEvent &evt)
                 // update LineNumberAreaWidth cache
                 CacheLineNumberAreaWidth(CalcLineNumberAreaWidth(lit, lineid, rowid, m_TopRow, rowcount));
 
-                // clear client area
                 wxColor &bgcolor=m_Syntax->GetAttributes(aeText)->bgcolor;
                 memdc.SetBrush(*wxTheBrushList->FindOrCreateBrush(bgcolor));
                 memdc.SetPen(*wxThePenList->FindOrCreatePen(bgcolor, 1, wxPENSTYLE_SOLID));
-                memdc.DrawRectangle(0, 0, m_ClientWidth, m_ClientHeight);
 
-                // paint rows
+                // reuse the painted rows if only scrolled or some rows are changed
+                bool reuse = PrepareRowCache(bgcolor, m_ClientWidth - CachedLineNumberAreaWidth())
+                    && !m_PaintedRows.empty();
+
                 wxRect rect(0,0, m_ClientWidth,m_ClientHeight);
-                PaintTextLines(&memdc, rect, m_TopRow, rowcount, bgcolor);
+                if(reuse && m_DrawingXPos == m_PaintedXPos)
+                {
+                    ScrollPaintedRows(memdc, m_PaintedTopRow - int(m_TopRow));
+                    m_PaintedTopRow = int(m_TopRow);
+
+                    // clear the area below the last row
+                    if(rowcount * m_RowHeight < m_ClientHeight)
+                        memdc.DrawRectangle(0, rowcount * m_RowHeight, m_ClientWidth, m_ClientHeight - rowcount * m_RowHeight);
+
+                    PaintTextLines(&memdc, rect, m_TopRow, rowcount, bgcolor, true);
+                }
+                else if(!(reuse && int(m_TopRow) == m_PaintedTopRow
+                          && ScrollPaintedColumns(memdc, m_TopRow, rowcount, bgcolor)))
+                {
+                    // clear client area
+                    memdc.DrawRectangle(0, 0, m_ClientWidth, m_ClientHeight);
+
+                    // paint rows
+                    m_PaintedRows.clear();
+                    m_PaintedTopRow = int(m_TopRow);
+                    PaintTextLines(&memdc, rect, m_TopRow, rowcount, bgcolor, true);
+                }
+                ForgetPaintedRows(int(m_TopRow) + rowcount, int(m_PaintedRows.size()));
+                m_PaintedXPos = m_DrawingXPos;
 
                 m_RepaintAll = false;
                 m_RepaintSelection = false;
@@ -9426,13 +10064,14 @@ void MadEdit::OnPaint(wxPaintEvent &evt)
                     int rows = (int)(lastrow1 - firstrow + 1);
 
                     rect.height = rows * m_RowHeight;
+                    ForgetPaintedRows(firstrow, rows);
 
                     wxColor &bgcolor=m_Syntax->GetAttributes(aeText)->bgcolor;
                     memdc.SetBrush(*wxTheBrushList->FindOrCreateBrush(bgcolor));
                     memdc.SetPen(*wxThePenList->FindOrCreatePen(bgcolor, 1, wxPENSTYLE_SOLID));
                     memdc.DrawRectangle(rect.x, rect.y, rect.width, rect.height);
 
-                    PaintTextLines(&memdc, rect, firstrow, rows, bgcolor);
+                    PaintTextLines(&memdc, rect, firstrow, rows, bgcolor, true);
                 }
 
                 m_RepaintSelection=false;
@@ -9597,6 +10236,8 @@ void MadEdit::OnPaint(wxPaintEvent &evt)
                 if(m_TopRow != m_HexTopRow || count != m_HexRowCount)
                     PrepareHexRowIndex(m_TopRow, count);
 
+                m_PaintedRows.clear();
+
                 // clear client area
                 wxColor &bgcolor=m_Syntax->GetAttributes(aeText)->bgcolor;
                 memdc.SetBrush(*wxTheBrushList->FindOrCreateBrush(bgcolor));
@@ -9605,7 +10246,7 @@ void MadEdit::OnPaint(wxPaintEvent &evt)
 
                 if(m_HexDigitBitmap==nullptr)
                 {
-                    m_HexDigitBitmap=new wxBitmap(m_HexFontMaxDigitWidth*76, m_RowHeight*3);
+                    m_HexDigitBitmap=new wxBitmap(m_HexFontMaxDigitWidth*512, m_RowHeight*5);
                     memdc.SelectObject(*m_HexDigitBitmap);
                     memdc.SetFont(*m_HexFont);
 
@@ -9618,6 +10259,10 @@ void MadEdit::OnPaint(wxPaintEvent &evt)
                     memdc.SetTextForeground(m_Syntax->nw_Color);
                     PaintText(&memdc, 0, 0, &HexHeader[60], m_WidthBuffer, 17, 0, 9999999);
 
+                    // fourth line: aeText bytes
+                    memdc.DrawRectangle(0, m_RowHeight*3, m_HexFontMaxDigitWidth*512, m_RowHeight);
+                    PaintHexAtlasBytes(&memdc, m_RowHeight*3);
+
                     // second line: aeLineNumberArea hexdigit
                     m_Syntax->SetAttributes(aeLineNumber);
                     memdc.SetPen(*wxThePenList->FindOrCreatePen(m_Syntax->nw_BgColor, 1, wxPENSTYLE_SOLID));
@@ -9629,6 +10274,10 @@ void MadEdit::OnPaint(wxPaintEvent &evt)
                     // third line: hexheader
                     PaintText(&memdc, 0, m_RowHeight*2, HexHeader, m_WidthBuffer, 76, 0, 9999999);
 
+                    // fifth line: aeLineNumberArea bytes
+                    memdc.DrawRectangle(0, m_RowHeight*4, m_HexFontMaxDigitWidth*512, m_RowHeight);
+                    PaintHexAtlasBytes(&memdc, m_RowHeight*4);
+
                     memdc.SelectObject(*m_ClientBitmap);
                 }
 
@@ -10084,6 +10733,18 @@ int MadEdit::GetUCharWidth(ucs4_t uc)
             w=m_TextFontWidths[0][0x20];
         }
         *pw16=w;
+
+        // the other chars of the block are likely to be used, measure them
+        // in idle time
+        if(!m_MeasuringWidths)
+        {
+            const ucs4_t block = uc & ~0xFF;
+            vector<ucs4_t>::iterator it = m_WidthBlocksToMeasure.begin();
+            while(it != m_WidthBlocksToMeasure.end() && (*it & ~0xFF) != block)
+                ++it;
+            if(it == m_WidthBlocksToMeasure.end())
+                m_WidthBlocksToMeasure.push_back(block);
+        }
     }
 
     if(m_FixedWidthMode)
@@ -10101,6 +10762,55 @@ int MadEdit::GetUCharWidth(ucs4_t uc)
     return w;
 }
 
+void MadEdit::OnIdle(wxIdleEvent &evt)
+{
+    if(!m_WidthBlocksToMeasure.empty() && !InPrinting())
+    {
+        // a few milliseconds at a time, the last queued block first
+        wxStopWatch sw;
+        m_MeasuringWidths = true;
+        while(!m_WidthBlocksToMeasure.empty() && sw.Time() < 8)
+        {
+            ucs4_t uc = m_WidthBlocksToMeasure.back();
+            const ucs4_t end = (uc | 0xFF) + 1;
+            for(int count = 0; count < 32 && uc < end; ++uc)
+            {
+                if(uc >= 0xD800 && uc <= 0xDFFF)  // surrogates
+                    continue;
+
+                wxUint16 *widths = m_TextFontWidths[uc >> 16];
+                if(widths == nullptr || widths[uc & 0xFFFF] == 0)
+                {
+                    GetUCharWidth(uc);
+                    ++count;
+                }
+            }
+
+            if(uc == end)
+                m_WidthBlocksToMeasure.pop_back();
+            else
+                m_WidthBlocksToMeasure.back() = uc;
+        }
+        m_MeasuringWidths = false;
+
+        if(!m_WidthBlocksToMeasure.empty())
+            evt.RequestMore();
+    }
+
+    // the painted rows are kept too, a moved row doesn't match its old key
+    if(m_UndoBuffer->NeedCompacting() && !m_Lines->IsSavingAsync()
+        && m_Lines->CompactMemData())
+    {
+        evt.RequestMore();
+    }
+
+    // the edits recorded since the last idle time are written at once
+    if(m_Recovery != nullptr)
+        m_Recovery->Flush();
+
+    evt.Skip();
+}
+
 int MadEdit::GetHexUCharWidth(ucs4_t uc)
 {
     if(uc>0x10FFFF || uc<0) uc='?';
@@ -37,6 +37,7 @@
 #include "../xm/encoding/encoding.h"
 #include "wxm_syntax.h"
 #include "wxm_undo.h"
+#include "wxm_recovery.h"
 
 #include <wx/confbase.h>
 
@@ -84,10 +85,12 @@ public:
         wchar_t fontname[128];
         int fontsize;
         wxUint16 *widths;
+        bool mapped;    // widths is in the mapped cache file, not allocated
+        bool reset;     // widths are reset, don't merge the saved widths
 
         FontWidthBuffer() {}
-        FontWidthBuffer(const wxString &fn, int fs, wxUint16 *ws)
-            :fontsize(fs), widths(ws)
+        FontWidthBuffer(const wxString &fn, int fs, wxUint16 *ws, bool mp=false)
+            :fontsize(fs), widths(ws), mapped(mp), reset(false)
         {
             size_t count=fn.Length();
             if(count>127) count=127;
@@ -105,9 +108,17 @@ public:
     static list<VerifiedFlag> VerifiedFlagList; // indicate FontWidthBuffer is verified or not
 
 private:
+    // the cache file is mapped copy-on-write and shared by the processes,
+    // the widths measured by this process are written back by Save()
+    static void *MappedCache;
+    static size_t MappedCacheSize;
+    static wxString PendingCacheFile;   // saved, but not renamed to the cache file yet
+
     static bool VerifyFontWidths(wxUint16 *widths, const wxString &fontname, int fontsize, wxWindow *win);
     static void ClearBuffer_1_16(const wxString &fontname, int fontsize); //clear FontWidthBuffersVector[1~16] with the same name,size
-    static bool LoadFromFile(const wxString &filename, FontWidthBuffers &fwbuffers, bool verify);
+    static wxString CacheFileName();
+    static void MapCache();
+    static void UnmapCache();
 
 public:
     static void Init(const wxString &datadir); // where to load data file
@@ -247,6 +258,8 @@ private:
 
     MadUndoBuffer   *m_UndoBuffer;
     MadUndo         *m_SavePoint;
+    bool            m_PersistentUndo;   // keep the undo history of files in journals
+    MadRecoveryJournal *m_Recovery;     // nullptr if the unsaved edits are not recorded
     bool            m_RecordCaretMovements;
 
     ucs4_t          *m_WordBuffer;
@@ -257,6 +270,40 @@ private:
     wxBitmap        *m_ClientBitmap, *m_MarkBitmap;
     int             m_LastPaintBitmap;// 0:client, 1:mark
 
+    // the rendered text of rows are cached to be blitted when they are
+    // painted again, e.g. scrolled, instead of laying out and drawing them
+    struct RowCacheKey
+    {
+        const MadLine *line;
+        int subrow;
+        wxUint64 hash;      // blocks, state and row index of the line
+    };
+    wxBitmap        *m_RowCacheBitmap;  // the cached rows, one slot per row
+    vector<RowCacheKey> m_RowCacheKeys;
+    vector<wxUint32> m_RowCacheStamps;  // last used time of the slots
+    wxUint32        m_RowCacheClock;
+    wxUint64        m_RowCacheSignature;// the settings the rows are rendered with
+    int             m_RowCacheWidth;
+
+    // the rows in m_ClientBitmap, they are shifted when scrolled and only
+    // the changed or exposed rows are painted again
+    vector<RowCacheKey> m_PaintedRows;  // null key if the row must be painted
+    int             m_PaintedTopRow;
+    int             m_PaintedXPos;
+
+    void SetDisplayRowWidth(MadDecodedRow *dr, int rowwidth);
+    MadDecodedRow *GetDisplayRow(const MadLineIterator &lit, int subrowid);
+    MadDecodedRow *InitDisplayRow(const MadLineIterator &lit, int subrowid);
+    int GetDisplayCharWidth(MadDecodedRow *dr, size_t idx, ucs4_t uc, int xpos);
+
+    void InvalidateRowCache();
+    bool PrepareRowCache(const wxColor &bgcolor, int width);
+    int FindCachedRow(const RowCacheKey &key);
+    int AllocCachedRow(const RowCacheKey &key);
+    void ForgetPaintedRows(int firstrow, int rows);
+    void ScrollPaintedRows(wxMemoryDC &memdc, int rows);
+    bool ScrollPaintedColumns(wxMemoryDC &memdc, int toprow, int rowcount, const wxColor &bgcolor);
+
     std::vector<wxPoint> m_space_points;
 public:
     std::vector<wxPoint> m_cr_points, m_lf_points, m_crlf_points, m_eof_points;
@@ -324,6 +371,10 @@ private:
     int             m_HexFontMaxDigitWidth;
 
     wxUint16        *m_TextFontWidths[17], *m_HexFontWidths[17];
+    // the blocks of 256 chars to be measured in idle time, every one is
+    // the next char to be measured in the block
+    vector<ucs4_t>  m_WidthBlocksToMeasure;
+    bool            m_MeasuringWidths;
 
 protected:
     wxm::ConfigWriter* m_cfg_writer;
@@ -349,6 +400,11 @@ private:
     time_t          m_ModificationTime;
     bool            m_ReadOnly;
 
+    bool            m_AsyncSave;        // save large files by a worker thread
+    long            m_AsyncSaveMinSize;
+    MadUndo         *m_AsyncSavePoint;  // the savepoint when the snapshot was taken
+    wxFileOffset    m_AsyncRecoveryMark; // the mark of m_Recovery when the snapshot was taken
+
     int             m_TopRow, m_TextTopRow, m_HexTopRow;
 protected:
     int             m_DrawingXPos;
@@ -484,14 +540,15 @@ protected:
     void UpdateSelectionPos();
 
     void PaintText(wxDC *dc, int x, int y, const ucs4_t *text, const int *width, int count, int minleft, int maxright);
-    void PaintTextLines(wxDC *dc, const wxRect &rect, int toprow, int rowcount, const wxColor &bgcolor);
+    void PaintTextLines(wxDC *dc, const wxRect &rect, int toprow, int rowcount, const wxColor &bgcolor, bool usecache=false);
 
     virtual int CachedLineNumberAreaWidth() = 0;
     virtual void CacheLineNumberAreaWidth(int width) = 0;
     virtual void PaintLineNumberArea(const wxColor & bgcolor, wxDC * dc, const wxRect& rect, bool is_trailing_subrow, MadLineIterator lineiter, int lineid, int text_top) = 0;
 
-    void PaintHexDigit(wxDC *dc, int x, int y, const ucs4_t *hexdigit, const int *width, int count);
-    void PaintHexOffset(wxDC *dc, int x, int y, const ucs4_t *hexdigit, const int *width, int count);
+    void PaintHexAtlasBytes(wxDC *dc, int y);
+    void PaintHexBytes(wxDC *dc, int x, int y, const wxByte *bytes, int count);
+    void PaintHexOffset(wxDC *dc, int x, int y, wxFileOffset offset);
     void PaintHexLines(wxDC *dc, wxRect &rect, int toprow, int rowcount, bool painthead);
 
     int GetVisibleHexRowCount();
@@ -580,6 +637,8 @@ protected:
     void DecreaseIndentSpaces(vector <ucs4_t> &spaces);
 
     MadUndo *DeleteSelection(bool bCorrectCaretPos, vector <int> *rpos, bool bColumnEditing);
+    // delete a char by Delete/BackSpace key, it may be merged into the last undo
+    MadUndo *DeleteByKeystroke(wxFileOffset pos, wxFileOffset size, MadLineIterator &lit);
 
     void InsertHexChar(int hc);
     void InsertRawBytes(wxByte *bytes, size_t count, bool overwirte);
@@ -654,6 +713,10 @@ protected:
 
     void OnEraseBackground(wxEraseEvent &evt);
     void OnPaint(wxPaintEvent &evt);
+    void OnIdle(wxIdleEvent &evt);
+
+    void OnAsyncSaveProgress(wxCommandEvent &evt);
+    void OnAsyncSaveDone(wxCommandEvent &evt);
 
     virtual void OnPaintInPrinting(wxPaintDC& dc, wxMemoryDC& memdc) = 0;
 
@@ -667,6 +730,8 @@ public:
 protected:
     virtual void DoSelectionChanged() {}
     virtual void DoStatusChanged() {}
+    // percent: 0~100, or -1 when the asynchronous saving is finished
+    virtual void DoAsyncSaveProgress(int percent) {}
     virtual void DoToggleWindow() {}
     virtual void DoMouseRightUp() {}
 
@@ -940,7 +1005,27 @@ public: // basic functions
     virtual wxm::WXMSearcher* Searcher(bool inhex, bool use_regex) = 0;
 
     bool LoadFromFile(const wxString& filename, const std::wstring& encoding=wxEmptyString, bool hexmode=false);
-    bool SaveToFile(const wxString& filename);
+    // if async is true and AsyncSave is enabled, large files are saved by a worker thread,
+    // then m_Modified is updated in EndSaveToFileAsync(); the files which must be
+    // written in place, like symbolic links, are always saved synchronously
+    bool SaveToFile(const wxString& filename, bool async=false);
+    bool IsSavingAsync() { return m_Lines->IsSavingAsync(); }
+    // wait for the asynchronous saving and apply the result
+    bool EndSaveToFileAsync();
+private:
+    void JournalSavePoint(const wxString& filename);
+    void ResetRecoveryJournal();
+    void RebaseRecoveryJournal();
+public:
+    // record the unsaved edits to be recovered after a crash if RecoveryJournal
+    // is enabled; only the documents of the main frame are recorded
+    void EnableRecoveryJournal();
+    // replay the unsaved edits recorded in the journal of a crashed session
+    // to the document, which must be just loaded from the same file
+    bool RecoverFromJournal(const wxString& journal);
+
+    void SetAsyncSave(bool value) { m_AsyncSave=value; }
+    bool GetAsyncSave() { return m_AsyncSave; }
 
     struct WXMLocations
     {
@@ -956,7 +1041,7 @@ public: // basic functions
     // write back to the original FileName;
     // if FileName is empty, ask the user to get filename
     // return wxID_YES(Saved), wxID_NO(Not Saved), or wxID_CANCEL
-    int Save(bool ask, const wxString &title, bool saveas);
+    int Save(bool ask, const wxString &title, bool saveas, bool async=false);
 
 public: // advanced functions
     void ConvertEncoding(const std::wstring & newenc, MadConvertEncodingFlag flag);
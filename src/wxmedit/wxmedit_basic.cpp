@@ -82,6 +82,7 @@ void MadEdit::SetSyntax(const wxString &title, bool manual)
     delete m_Syntax;
     m_Syntax = MadSyntax::GetSyntaxByTitle(title);
     m_Syntax->SetEncoding(m_Encoding);
+    InvalidateRowCache();
     m_Syntax->InitNextWord1(m_Lines, m_WordBuffer, m_WidthBuffer,
         m_TextFont->GetFaceName(), m_TextFont->GetPointSize(), m_TextFont->GetFamily());
 
@@ -109,6 +110,7 @@ void MadEdit::ApplySyntaxAttributes(MadSyntax *syn, bool matchTitle)
     if(!matchTitle || syn->GetTitle()==m_Syntax->GetTitle())
     {
         m_Syntax->AssignAttributes(syn);
+        InvalidateRowCache();
         if(m_EditMode==emHexMode && m_HexDigitBitmap)
         {
             delete m_HexDigitBitmap;
@@ -128,6 +130,8 @@ void MadEdit::SetEncoding(const std::wstring & encname)
     m_Encoding = xm::EncodingManager::Instance().GetEncoding(encname);
     m_Lines->SetEncoding(m_Encoding);
     m_Syntax->SetEncoding(m_Encoding);
+    if(m_Recovery != nullptr)
+        m_Recovery->SetEncoding(GetEncodingName());
 
     wxString fontname;
     m_Config->Read(wxString(wxT("/Fonts/"))+m_Encoding->GetName().c_str(), &fontname, m_Encoding->GetFontName().c_str());
@@ -251,6 +255,7 @@ void MadEdit::SetTextFont(const wxString &name, int size, bool forceReset)
 
         memset(m_TextFontWidths, 0, sizeof(m_TextFontWidths));
         m_TextFontWidths[0] = FontWidthManager::GetFontWidths(0, name, size, this);
+        m_WidthBlocksToMeasure.clear();
 
         m_cfg_writer->Record(wxString(wxT("/Fonts/"))+m_Encoding->GetName().c_str(), name);
         m_cfg_writer->Record(wxT("/wxMEdit/TextFontSize"), size);
@@ -1608,6 +1613,9 @@ void MadEdit::SetCaretPosition(wxFileOffset pos, wxFileOffset selbeg, wxFileOffs
 
 bool MadEdit::LoadFromFile(const wxString& filename, const std::wstring& encoding, bool hexmode)
 {
+    if(m_Lines->IsSavingAsync())
+        EndSaveToFileAsync();
+
     wxFileName fn(filename);
     if(MadDirExists(fn.GetPath(wxPATH_GET_VOLUME))==0)
     {
@@ -1615,14 +1623,30 @@ bool MadEdit::LoadFromFile(const wxString& filename, const std::wstring& encodin
         return false;
     }
 
+    // the last undo refers to the data of m_Lines
+    m_UndoBuffer->FlushPending();
+
     if(m_Lines->LoadFromFile(filename, encoding, hexmode)==false)
         return false;
 
     m_UndoBuffer->Clear();
     m_SavePoint = nullptr;
+
+    if(m_PersistentUndo)
+    {
+        wxUint64 hash;
+        wxFileOffset size;
+        if(MadUndoBuffer::HashFileIdentity(m_Lines->m_Name, hash, size)
+            && m_UndoBuffer->OpenJournal(m_Lines->m_Name, hash, size))
+        {
+            m_SavePoint = m_UndoBuffer->GetPrevUndo();
+        }
+    }
     m_Modified = false;
     m_ModificationTime = wxFileModificationTime(filename);
     m_ReadOnly = false; // use IsReadOnly() to check ReadOnly or not
+    ResetRecoveryJournal();
+    InvalidateRowCache();   // the blocks refer to the new data
 
     m_newline_for_insert = m_newline;
 
@@ -1669,8 +1693,11 @@ bool MadEdit::LoadFromFile(const wxString& filename, const std::wstring& encodin
     return true;
 }
 
-bool MadEdit::SaveToFile(const wxString &filename)
+bool MadEdit::SaveToFile(const wxString &filename, bool async)
 {
+    if(m_Lines->IsSavingAsync() && !EndSaveToFileAsync())
+        return false;
+
     wxFileName fn(filename);
     if(MadDirExists(fn.GetPath(wxPATH_GET_VOLUME))==0)
     {
@@ -1678,6 +1705,20 @@ bool MadEdit::SaveToFile(const wxString &filename)
         return false;
     }
 
+    if(async && m_AsyncSave && m_Lines->GetSize() >= m_AsyncSaveMinSize)
+    {
+        if(m_Lines->BeginSaveToFileAsync(filename, this))
+        {
+            m_AsyncSavePoint = m_UndoBuffer->GetPrevUndo();
+            if(m_Recovery != nullptr)
+                m_AsyncRecoveryMark = m_Recovery->GetMark();
+            m_UndoBuffer->BreakMerging();
+            DoAsyncSaveProgress(0);
+            return true;
+        }
+        // fall back to synchronous saving
+    }
+
     wxFileOffset tempsize=m_Lines->GetMaxTempSize(filename);
     wxMemorySize memsize=wxGetFreeMemory();
 
@@ -1702,17 +1743,204 @@ bool MadEdit::SaveToFile(const wxString &filename)
     }
 
     m_SavePoint = m_UndoBuffer->GetPrevUndo();
+    m_UndoBuffer->BreakMerging(); // the savepoint must not be changed by merging
     m_Modified=false;
     wxLogNull nolog;
     m_ModificationTime = wxFileModificationTime(filename);
     m_ReadOnly=false;
+    JournalSavePoint(filename);
+    ResetRecoveryJournal();
+    InvalidateRowCache();   // the blocks refer to the new data
+    DoStatusChanged();
+
+    return true;
+}
+
+void MadEdit::JournalSavePoint(const wxString& filename)
+{
+    if(!m_UndoBuffer->IsJournaling())
+        return;
+
+    wxUint64 hash;
+    wxFileOffset size;
+    if(MadUndoBuffer::HashFileIdentity(filename, hash, size))
+        m_UndoBuffer->JournalSavePoint(filename, m_SavePoint, hash, size, m_Lines->GetSavedContentHash());
+}
+
+void MadEdit::EnableRecoveryJournal()
+{
+    bool recovery;
+    m_Config->Read(wxT("/wxMEdit/RecoveryJournal"), &recovery, true);
+    if(!recovery || m_Recovery != nullptr)
+        return;
+
+    m_Recovery = new MadRecoveryJournal();
+    ResetRecoveryJournal();
+}
+
+void MadEdit::ResetRecoveryJournal()
+{
+    if(m_Recovery == nullptr)
+        return;
+
+    MadRecoveryHeader header;
+    header.docname = m_Lines->m_Name;
+    header.encoding = GetEncodingName();
+    header.filesize = m_Lines->m_Size;
+    header.modtime = m_ModificationTime;
+    m_Recovery->Reset(header);
+}
+
+void MadEdit::RebaseRecoveryJournal()
+{
+    if(m_Recovery == nullptr)
+        return;
+
+    // the edits made while saving asynchronously are applied to the saved file
+    MadRecoveryHeader header;
+    header.docname = m_Lines->m_Name;
+    header.encoding = GetEncodingName();
+    header.filesize = m_Lines->m_FileData->GetSize();
+    header.modtime = m_ModificationTime;
+    m_Recovery->Rebase(header, m_AsyncRecoveryMark);
+}
+
+bool MadEdit::RecoverFromJournal(const wxString& journal)
+{
+    MadRecoveryReader reader;
+    if(IsReadOnly() || m_Modified || !reader.Open(journal))
+        return false;
+
+    const MadRecoveryHeader &header = reader.GetHeader();
+    if(header.docname != m_Lines->m_Name || header.filesize != m_Lines->m_Size
+        || (!header.docname.IsEmpty() && header.modtime != wxInt64(m_ModificationTime)))
+    {
+        return false;   // the file was changed after the crash
+    }
+
+    MadUndo *undo = nullptr;
+    wxFileOffset pos, delsize, caretpos = m_CaretPos.pos;
+    MadBlock blk(m_Lines->m_MemData, -1, 0);
+
+    // all of the recovered edits are undone at once
+    while(reader.Next(pos, delsize, m_Lines->m_MemData, blk))
+    {
+        if(pos + delsize > m_Lines->m_Size)
+            break;
+
+        MadOverwriteUndoData *oudata = new MadOverwriteUndoData();
+        oudata->m_Pos = pos;
+        oudata->m_DelSize = delsize;
+        oudata->m_InsSize = 0;
+        if(blk.m_Size > 0)
+            oudata->SetInsBlock(blk);
+
+        MadLineIterator lit = DeleteInsertData(oudata->m_Pos, oudata->m_DelSize, &oudata->m_DelData,
+                                                  oudata->m_InsSize, &oudata->m_InsData);
+        if(IsTextFile())
+            m_Lines->Reformat(lit, lit);
+
+        if(undo == nullptr)
+        {
+            undo = m_UndoBuffer->Add();
+            undo->m_CaretPosBefore = m_CaretPos.pos;
+        }
+        undo->m_Undos.push_back(oudata);
+        caretpos = pos + oudata->m_InsSize;
+    }
+
+    if(header.encoding != GetEncodingName())
+        SetEncoding(header.encoding.wc_str());
+
+    if(undo == nullptr)
+        return true;
+
+    undo->m_CaretPosAfter = caretpos;
+
+    m_Modified = true;
+    m_Selection = false;
+    m_RepaintAll = true;
+
+    m_CaretPos.pos = caretpos;
+    if(IsTextFile())
+        UpdateCaretByPos(m_CaretPos, m_ActiveRowUChars, m_ActiveRowWidths, m_CaretRowUCharPos);
+    else
+        m_CaretPos.linepos = m_CaretPos.pos;
+
+    AppearCaret();
+    UpdateScrollBarPos();
+    Refresh(false);
+
+    DoSelectionChanged();
+    DoStatusChanged();
+
+    return true;
+}
+
+bool MadEdit::EndSaveToFileAsync()
+{
+    if(!m_Lines->IsSavingAsync())
+        return true;
+
+    wxString filename = m_Lines->GetSavingFileName();
+    wxString keptfile;
+    bool ok = m_Lines->EndSaveToFileAsync(&keptfile);
+    DoAsyncSaveProgress(-1);
+
+    if(!ok)
+    {
+        wxString msg = wxString(_("Cannot save this file:")) +wxT("\n\n") + filename;
+        if(!keptfile.IsEmpty())
+        {
+            // the document is kept by the saved temporary file only, which
+            // must not be removed before the document is saved again
+            msg << wxT("\n\n") << _("The original file cannot be opened either. The document is kept in this file until it is saved:")
+                << wxT("\n\n") << keptfile;
+            m_Modified = true;
+            InvalidateRowCache();   // the blocks refer to the temporary file
+            DoStatusChanged();
+        }
+
+        wxMessageDialog dlg(this, msg, wxT("wxMEdit"), wxOK|wxICON_ERROR );
+        dlg.ShowModal();
+
+        return false;
+    }
+
+    // the edits made while saving keep the file modified
+    m_SavePoint = m_AsyncSavePoint;
+    m_Modified = (m_UndoBuffer->GetPrevUndo() != m_SavePoint);
+    wxLogNull nolog;
+    m_ModificationTime = wxFileModificationTime(filename);
+    m_ReadOnly=false;
+    JournalSavePoint(filename);
+    if(m_Modified)
+        RebaseRecoveryJournal();
+    else
+        ResetRecoveryJournal();
+    InvalidateRowCache();   // the blocks refer to the new data
     DoStatusChanged();
 
     return true;
 }
 
-int MadEdit::Save(bool ask, const wxString &title, bool saveas) // return YES, NO, CANCEL
+void MadEdit::OnAsyncSaveProgress(wxCommandEvent &evt)
 {
+    if(m_Lines->IsAsyncSaveEvent(evt))
+        DoAsyncSaveProgress(evt.GetInt());
+}
+
+void MadEdit::OnAsyncSaveDone(wxCommandEvent &evt)
+{
+    if(m_Lines->IsAsyncSaveEvent(evt))
+        EndSaveToFileAsync();
+}
+
+int MadEdit::Save(bool ask, const wxString &title, bool saveas, bool async) // return YES, NO, CANCEL
+{
+    if(m_Lines->IsSavingAsync())
+        EndSaveToFileAsync();
+
     int ret=wxID_YES;
     wxString filename=m_Lines->m_Name;
     if(filename.IsEmpty())
@@ -1764,7 +1992,7 @@ int MadEdit::Save(bool ask, const wxString &title, bool saveas) // return YES, N
 
         if(ret==wxID_YES)
         {
-            SaveToFile(filename);
+            SaveToFile(filename, async);
         }
     }
 
@@ -13,6 +13,7 @@
 #include "mad_utils.h"
 #include "wxm/utils.h"
 #include "wxm/update.h"
+#include "wxm/benchmark.h"
 //#include "xm/remote.h"
 #include "dialog/wxmedit_options_dialog.h"
 
@@ -25,6 +26,7 @@
 // disable 4996 {
 #include <wx/filename.h>
 #include <wx/fileconf.h>
+#include <wx/sstream.h>
 // disable 4996 }
 #ifdef _MSC_VER
 # pragma warning( pop )
@@ -270,6 +272,22 @@ bool MadEditApp::OnInit()
 
     wxm::AppPath::Instance().Init(GetAppName());
 
+    wxArrayString args;
+    for(int i=1; i<argc; i++)
+        args.Add(argv[i]);
+
+    if(wxm::IsBenchmarkCommand(args))
+    {
+        // no main frame, no other instances, and the settings are not changed
+        m_Benchmark = true;
+        m_BenchmarkArgs = args;
+        g_DoNotSaveSettings = true;
+
+        wxStringInputStream nocfg(wxEmptyString);
+        wxFileConfig::Set(new wxFileConfig(nocfg));
+        return true;
+    }
+
     // parse commandline to filelist
     wxm::FileList filelist;
     for(int i=1; i<argc; i++)
@@ -375,6 +393,9 @@ bool MadEditApp::OnInit()
     if(FontWidthManager::MaxCount < 4) FontWidthManager::MaxCount=4;
     else if(FontWidthManager::MaxCount>40) FontWidthManager::MaxCount=40;
     FontWidthManager::Init(wxm::AppPath::Instance().HomeDir());
+    MadUndoBuffer::SetJournalDir(wxm::AppPath::Instance().HomeDir() + wxT("undo") + wxFILE_SEP_PATH);
+    MadUndoBuffer::PruneJournals();
+    MadRecoveryJournal::SetDir(wxm::AppPath::Instance().HomeDir() + wxT("recovery") + wxFILE_SEP_PATH);
 
 
     // create the main frame
@@ -419,6 +440,8 @@ bool MadEditApp::OnInit()
         OnReceiveMessage(files.c_str(), (files.size()+1)*sizeof(wxChar));
     }
 
+    myFrame->RecoverFiles();
+
     if(myFrame->OpenedFileCount()==0)
     {
         myFrame->OpenFile(wxEmptyString, false);
@@ -427,6 +450,14 @@ bool MadEditApp::OnInit()
     return true;
 }
 
+int MadEditApp::OnRun()
+{
+    if(m_Benchmark)
+        return wxm::RunDocumentBenchmark(m_BenchmarkArgs);
+
+    return wxApp::OnRun();
+}
+
 int MadEditApp::OnExit()
 {
    // xm::RemoteAccessCleanup();
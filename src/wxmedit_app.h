@@ -31,8 +31,14 @@
 class MadEditApp:public wxApp
 {
 public:
+	MadEditApp(): m_Benchmark(false) {}
 	bool OnInit();
+	int OnRun();
 	int OnExit();
+private:
+	// run "wxmedit --benchmark" instead of the main frame
+	bool m_Benchmark;
+	wxArrayString m_BenchmarkArgs;
 };
 
  
@@ -22,6 +22,7 @@
 #include "dialog/wxm_purge_histories_dialog.h"
 #include "dialog/wxm_conv_enc_dialog.h"
 #include "dialog/wxm_word_count_dialog.h"
+#include "dialog/wxm_performance_dialog.h"
 #include "dialog/wxm_sort_dialog.h"
 #include "dialog/wxmedit_about_dialog.h"
 #include "dialog/wxmedit_options_dialog.h"
@@ -32,6 +33,7 @@
 #include "wxm/edit/inframe.h"
 #include "wxm/update.h"
 #include "wxm/recent_list.h"
+#include "wxm/trigram_index.h"
 #include "wxm/def.h"
 
 #ifdef _MSC_VER
@@ -1055,6 +1057,7 @@ BEGIN_EVENT_TABLE(MadEditFrame,wxFrame)
 	// help
 	EVT_MENU(menuCheckUpdates, MadEditFrame::OnHelpCheckUpdates)
 	EVT_MENU(menuAbout, MadEditFrame::OnHelpAbout)
+	EVT_MENU(menuPerformance, MadEditFrame::OnHelpPerformance)
 	
 	EVT_CLOSE(MadEditFrame::MadEditFrameClose)
 	EVT_KEY_DOWN(MadEditFrame::MadEditFrameKeyDown)
@@ -2167,6 +2170,9 @@ void MadEditFrame::MadEditFrameClose(wxCloseEvent& event)
 
     delete m_ImageList;
 
+    // the indexer detects the encodings of the files
+    wxm::TrigramIndexer::Instance().Shutdown();
+
     xm::EncodingManager::Instance().FreeEncodings();
     wxm::AppPath::Instance().DestroyInstance();
 
@@ -2262,6 +2268,10 @@ void MadEditFrame::ResetAcceleratorTable()
 {
     vector<wxAcceleratorEntry> entries;
     MadEdit::ms_KeyBindings.BuildAccelEntries(true, entries);
+
+    // the Performance dialog is hidden from the menus and the key bindings
+    entries.push_back(wxAcceleratorEntry(wxACCEL_CTRL|wxACCEL_ALT|wxACCEL_SHIFT, int('P'), menuPerformance));
+
     if(entries.size()>0)
     {
         wxAcceleratorTable accel(int(entries.size()), &entries[0]);
@@ -2771,6 +2781,55 @@ void MadEditFrame::OpenFile(const wxString &filename, bool mustExist, const Line
     SetTitle(wxString(wxT("wxMEdit - ["))+ title +wxString(wxT("] ")));
 }
 
+void MadEditFrame::RecoverFiles()
+{
+    vector<wxString> journals;
+    MadRecoveryJournal::FindOrphans(journals);
+
+    for(size_t i=0; i<journals.size(); ++i)
+    {
+        // the journal is removed only if it is replayed or declined, otherwise
+        // it is moved aside for the user to recover the changes by hand
+        bool done = false;
+        wxString name;
+        {
+            MadRecoveryReader reader;
+            if(reader.Open(journals[i]))
+            {
+                name = reader.GetHeader().docname;
+                bool isnew = name.IsEmpty();
+                if(isnew)
+                    name = _("A new file");
+
+                if(wxYES == wxMessageBox(wxString::Format(_("wxMEdit was not closed normally.\nDo you want to recover the unsaved changes of the following file?\n\n%s"), name.c_str()), _("Recover Unsaved Files"), wxYES_NO|wxICON_QUESTION))
+                {
+                    OpenFile(reader.GetHeader().docname, !isnew);
+
+                    done = g_active_wxmedit != nullptr && g_active_wxmedit->GetFileName() == reader.GetHeader().docname
+                        && g_active_wxmedit->RecoverFromJournal(journals[i]);
+                }
+                else
+                {
+                    done = true;
+                }
+            }
+        }
+
+        if(done)
+        {
+            wxLogNull nolog;
+            wxRemoveFile(journals[i]);
+            continue;
+        }
+
+        wxString kept = MadRecoveryJournal::KeepAside(journals[i]);
+        wxString msg = name.IsEmpty()? wxString(_("Cannot read the recovery journal of the unsaved changes.")):
+            wxString(_("Cannot recover the unsaved changes of this file:")) + wxT("\n\n") + name;
+        msg << wxT("\n\n") << _("The journal of the changes is kept in:") << wxT("\n\n") << kept;
+        wxLogError(msg);
+    }
+}
+
 void MadEditFrame::CloseFile(int pageId)
 {
     if (!QueryCloseFile(pageId))
@@ -3274,7 +3333,7 @@ void MadEditFrame::OnFileSave(wxCommandEvent& event)
         if(name[name.Len()-1]==wxT('*'))
             name.Truncate(name.Len()-1);
 
-        if (g_active_wxmedit->Save(false, name, false)==wxID_YES)
+        if (g_active_wxmedit->Save(false, name, false, true)==wxID_YES)
         {
             m_RecentFiles->AddFileToHistory(g_active_wxmedit->GetFileName());
         }
@@ -3289,7 +3348,7 @@ void MadEditFrame::OnFileSaveAs(wxCommandEvent& event)
         if(name[name.Len()-1]==wxT('*'))
             name.Truncate(name.Len()-1);
 
-        if (g_active_wxmedit->Save(false, name, true)==wxID_YES)
+        if (g_active_wxmedit->Save(false, name, true, true)==wxID_YES)
         {
             m_RecentFiles->AddFileToHistory(g_active_wxmedit->GetFileName());
         }
@@ -3309,7 +3368,7 @@ void MadEditFrame::OnFileSaveAll(wxCommandEvent& event)
         if(name[name.Len()-1]==wxT('*'))
             name.Truncate(name.Len()-1);
 
-        if (wxmedit->Save(false, name, false) == wxID_CANCEL)
+        if (wxmedit->Save(false, name, false, true) == wxID_CANCEL)
             return;
     }
 
@@ -3343,7 +3402,7 @@ void MadEditFrame::OnFileSaveAll(wxCommandEvent& event)
         if(name[name.Len()-1]==wxT('*'))
             name.Truncate(name.Len()-1);
 
-        if (wxmedit->Save(false, name, false) == wxID_CANCEL)
+        if (wxmedit->Save(false, name, false, true) == wxID_CANCEL)
             return;
 
         sid=id;
@@ -5011,6 +5070,12 @@ void MadEditFrame::OnHelpCheckUpdates(wxCommandEvent& event)
     //wxm::ManualCheckUpdates();
 }
 
+void MadEditFrame::OnHelpPerformance(wxCommandEvent& event)
+{
+    WXMPerformanceDialog dialog(this);
+    dialog.ShowModal();
+}
+
 const wxString& GetCredits()
 {
     static wxString credits;
@@ -302,6 +302,7 @@ public:
 
     void OnHelpCheckUpdates(wxCommandEvent& event);
     void OnHelpAbout(wxCommandEvent& event);
+    void OnHelpPerformance(wxCommandEvent& event);
 
     void OnSize(wxSizeEvent& event);
 private:
@@ -314,6 +315,8 @@ public:
     int OpenedFileCount();
     // if filename is empty, open a new file
     void OpenFile(const wxString &filename, bool mustExist, const LineNumberList& bmklns=LineNumberList());
+    // recover the unsaved files of the sessions which were not closed normally
+    void RecoverFiles();
     void CloseFile(int pageId);
     void CloseAllFiles(bool force);
     void MadEditFrameKeyDown(wxKeyEvent& event);
@@ -550,6 +553,7 @@ enum { // menu id
 
     // help
     menuCheckUpdates,
+    menuPerformance,    // not in the menus
 };
 
 class wxMadAuiNotebook : public wxAuiNotebook
@@ -18,10 +18,10 @@
 //#include <boost/shared_ptr.hpp>
 #include<memory>
 #include <boost/assign/list_inserter.hpp>
-#include <boost/assign/list_of.hpp>
 #include <boost/range/iterator_range.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <string>
+#include <cstring>
 
 #ifdef _DEBUG
 #include <crtdbg.h>
@@ -190,178 +190,235 @@ class UTF16BEChecker: public UTF16Checker
 };
 
 
-struct UTF8BytesChecker
+// the ASCII runs are skipped a word at a time, which is the most of the text
+// even in the languages not written in Latin
+inline uint64_t LoadWord(const ubyte* p)
 {
-	bool Check(const ubyte* str, size_t len, bool& nonascii) const
-	{
-		if (len < this->TakenBytes())
-			return false;
-
-		nonascii = nonascii || NonASCII();
-		return this->BytesMatch(str);
-	}
-
-	virtual bool NonASCII() const { return true; }
-	virtual bool BytesMatch(const ubyte* bytes) const= 0;
-	virtual size_t TakenBytes() const = 0;
+	uint64_t w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
 
-	virtual ~UTF8BytesChecker() {}
-};
+const uint64_t word_high_bits = 0x8080808080808080ULL;
+const uint64_t word_low_bits = 0x0101010101010101ULL;
 
-struct UTF8SingleByteChecker: public UTF8BytesChecker
+inline bool HasNonASCIIByte(uint64_t w)
 {
-	virtual bool BytesMatch(const ubyte* bytes) const override { return true; }
-	virtual bool NonASCII() const override { return false; }
+	return (w & word_high_bits) != 0;
+}
 
-	virtual size_t TakenBytes() const override { return 1; }
-};
+inline bool HasZeroByte(uint64_t w)
+{
+	return ((w - word_low_bits) & ~w & word_high_bits) != 0;
+}
 
-struct UTF8TwoBytesChecker: public UTF8BytesChecker
+// all the bytes are in 0x20-0x7F; a byte below 0x20 borrows and sets its high bit
+inline bool IsPrintableASCIIWord(uint64_t w)
 {
-	virtual bool BytesMatch(const ubyte* b) const override
-	{
-		return (b[1] & 0xC0)==0x80;
-	}
-	virtual size_t TakenBytes() const override { return 2; }
-};
+	return (((w - 0x20 * word_low_bits) | w) & word_high_bits) == 0;
+}
 
-struct UTF8ThreeBytesChecker: public UTF8BytesChecker
+// the length of the valid non-ASCII character at s, 0 if invalid or truncated
+// 0xC2-0xDF b2-1
+// 0xE0      0xA0-0xBF b3-2
+// 0xED      0x80-0x9F b3-2 (skip surrogates)
+// 0xE1-0xEF b3-1
+// 0xF0      0x90-0xBF b4-2
+// 0xF4      0x80-0x8F b4-2
+// 0xF1-0xF3 b4-1
+inline size_t UTF8NonASCIILength(const ubyte* s, size_t len)
 {
-	virtual bool BytesMatch(const ubyte* b) const override
+	const ubyte b = s[0];
+	if (b < 0xC2 || b > 0xF4)
+		return 0;
+
+	size_t n = (b < 0xE0)? 2: (b < 0xF0)? 3: 4;
+	if (len < n)
+		return 0;
+
+	ubyte lo = 0x80, hi = 0xBF;
+	if (b == 0xE0)
+		lo = 0xA0;
+	else if (b == 0xED)
+		hi = 0x9F;
+	else if (b == 0xF0)
+		lo = 0x90;
+	else if (b == 0xF4)
+		hi = 0x8F;
+
+	if (s[1] < lo || s[1] > hi)
+		return 0;
+	for (size_t i = 2; i < n; ++i)
 	{
-		return (b[1] & 0xC0)==0x80 && (b[2] & 0xC0)==0x80;
+		if ((s[i] & 0xC0) != 0x80)
+			return 0;
 	}
 
-	virtual size_t TakenBytes() const override { return 3; }
-};
+	return n;
+}
 
-// first byte is 0xE0, second byte should >=0xA0
-struct UTF8ThreeBytesCheckerLB: public UTF8ThreeBytesChecker
+// stop at the first invalid byte
+bool ValidateUTF8(const ubyte* str, size_t len, bool& nonascii)
 {
-	virtual bool BytesMatch(const ubyte* b) const override
+	const ubyte* end = str + len;
+	while (str < end)
 	{
-		return (b[1] & 0xE0)==0xA0 && (b[2] & 0xC0)==0x80;
+		if (size_t(end - str) >= 8 && !HasNonASCIIByte(LoadWord(str)))
+		{
+			str += 8;
+			continue;
+		}
+
+		if (str[0] < 0x80)
+		{
+			++str;
+			continue;
+		}
+
+		size_t n = UTF8NonASCIILength(str, size_t(end - str));
+		if (n == 0)
+			return false;
+
+		nonascii = true;
+		str += n;
 	}
 
-};
+	return true;
+}
 
-// first byte is 0xED, second byte should < 0xA0
-// skip surrogates
-struct UTF8ThreeBytesCheckerM: public UTF8ThreeBytesChecker
+struct UTF8Checker: public EncodingChecker
 {
-	virtual bool BytesMatch(const ubyte* b) const override
+	virtual std::string BOM() const override
 	{
-		return (b[1] & 0xA0)==0x80 && (b[2] & 0xC0)==0x80;
+		return "\xEF\xBB\xBF";
 	}
-};
 
-struct UTF8FourBytesChecker: public UTF8BytesChecker
-{
-	virtual bool BytesMatch(const ubyte* b) const override
+	virtual bool MatchText(const ubyte* str, size_t len) const override
 	{
-		return (b[1] & 0xC0)==0x80 && (b[2] & 0xC0)==0x80 && (b[3] & 0xC0)==0x80;
+		bool nonascii = false;
+		return ValidateUTF8(str, len, nonascii) && nonascii;
 	}
 
-	virtual size_t TakenBytes() const override { return 4; }
+	virtual std::string EncodingName() const override
+	{
+		return "UTF-8";
+	}
 };
 
-// first byte is 0xF0, second byte should >=0x90
-struct UTF8FourBytesCheckerLB: public UTF8FourBytesChecker
+bool IsUTF8(const ubyte* text, size_t len)
+{
+	static const UTF8Checker checker;
+	return checker.MatchText(text, len);
+}
+
+void ByteStats::Scan(const ubyte* data, size_t len)
 {
-	virtual bool BytesMatch(const ubyte* b) const override
+	const ubyte* end = data + len;
+	while (data < end)
 	{
-		return (b[1] & 0xF0)>=0x90 && (b[1] & 0xF0)<=0xb0 && (b[2] & 0xC0)==0x80 && (b[3] & 0xC0)==0x80;
-	}
+		if (size_t(end - data) >= 8 && IsPrintableASCIIWord(LoadWord(data)))
+		{
+			m_cr = false;
+			data += 8;
+			continue;
+		}
 
-};
+		ubyte b = *data++;
+		if (b == 0x0A)
+		{
+			++lfs;
+			if (m_cr)
+				++crlfs;
+			m_cr = false;
+			continue;
+		}
+
+		m_cr = (b == 0x0D);
+		if (m_cr)
+			++crs;
+		else if (b >= 0x80)
+			++highbits;
+		else if (b == 0x00)
+			++nuls;
+	}
+}
 
-// first byte is 0xF4, second byte should <=0x8F
-struct UTF8FourBytesCheckerUB: public UTF8FourBytesChecker
+bool IsASCII(const ubyte* text, size_t len)
 {
-	virtual bool BytesMatch(const ubyte* b) const override
+	const ubyte* end = text + len;
+	for (; size_t(end - text) >= 8; text += 8)
 	{
-		return (b[1] & 0xF0)==0x80 && (b[2] & 0xC0)==0x80 && (b[3] & 0xC0)==0x80;
+		uint64_t w = LoadWord(text);
+		if (HasNonASCIIByte(w) || HasZeroByte(w))
+			return false;
 	}
 
-};
+	for (ubyte b : boost::make_iterator_range(text, end))
+	{
+		if (b==0x00 || b >= 0x80)
+			return false;
+	}
+	return true;
+}
 
-struct UTF8InvalidBytesChecker: public UTF8BytesChecker
+// the lead bytes of a character cut by the beginning of a sample are skipped
+inline size_t UTF8SampleBegin(const ubyte* s, size_t len)
 {
-	virtual bool BytesMatch(const ubyte* bytes) const override { return false; }
-	virtual size_t TakenBytes() const override { return 1; }
-};
+	size_t i = 0;
+	while (i < len && i < 3 && (s[i] & 0xC0) == 0x80)
+		++i;
+	return i;
+}
 
-struct UTF8Checker: public EncodingChecker
+// a character cut by the end of a sample is dropped
+inline size_t UTF8SampleEnd(const ubyte* s, size_t len)
 {
-	UTF8Checker()
-	{
-		// 0x00-0x7F b1
-		// 0x80-0xBF bx-2 bx-3 bx-4
-		// 0xC0-0xC1 err
-		// 0xC2-0xDF b2-1
-		// 0xE0-0xEF b3-1
-		// 0xF0-0xF7 b4-1
-		m_decoders[0x7F] = &m_dec1;
-		m_decoders[0xC1] = &m_dec_invalid;
-		m_decoders[0xDF] = &m_dec2;
-		m_decoders[0xE0] = &m_dec3lb;
-		m_decoders[0xEC] = &m_dec3;
-		m_decoders[0xED] = &m_dec3m;
-		m_decoders[0xEF] = &m_dec3;
-		m_decoders[0xF0] = &m_dec4lb;
-		m_decoders[0xF3] = &m_dec4;
-		m_decoders[0xF4] = &m_dec4ub;
-		m_decoders[0xFF] = &m_dec_invalid;
-	}
-
-	virtual std::string BOM() const override
+	for (size_t i = len; i > 0 && len - i < 3; --i)
 	{
-		return "\xEF\xBB\xBF";
+		ubyte b = s[i - 1];
+		if (b < 0xC0)
+			continue;
+
+		size_t n = (b < 0xE0)? 2: (b < 0xF0)? 3: 4;
+		return (len - (i - 1) < n)? i - 1: len;
 	}
+	return len;
+}
 
-	virtual bool MatchText(const ubyte* str, size_t len) const override
-	{
-		bool nonascii = false;
-		while(len > 0)
+void ReadDetectingSamples(std::vector<ubyte>& samples, const BytesReader& read, uint64_t filesize, size_t headsize)
+{
+	const size_t sample_size = 4096;
+	const size_t sample_count = 8;
+
+	samples.clear();
+	if (filesize <= headsize)
+		return;
+
+	const uint64_t rest = filesize - headsize;
+	const bool whole = (rest <= sample_size * sample_count);
+	const size_t count = whole? 1: sample_count;
+	for (size_t i = 0; i < count; ++i)
+	{
+		// spread evenly from the end of the head to the end of the file
+		uint64_t pos = headsize;
+		size_t size = size_t(rest);
+		if (!whole)
 		{
-			CheckerMap::const_iterator it = m_decoders.lower_bound(str[0]);
-			const UTF8BytesChecker* checker = it->second;
-			if (!checker->Check(str, len, nonascii))
-				return false;
-
-			size_t bytes = checker->TakenBytes();
-			len -= bytes;
-			str += bytes;
+			pos += (rest - sample_size) * i / (count - 1);
+			size = sample_size;
 		}
 
-		return nonascii;
-	}
+		size_t old = samples.size();
+		samples.resize(old + size);
+		ubyte* s = &samples[old];
+		size_t got = read(pos, s, size);
 
-	virtual std::string EncodingName() const override
-	{
-		return "UTF-8";
+		size_t end = (pos + got < filesize)? UTF8SampleEnd(s, got): got;
+		size_t beg = UTF8SampleBegin(s, end);
+		if (beg != 0)
+			memmove(s, s + beg, end - beg);
+		samples.resize(old + end - beg);
 	}
-
-private:
-
-	typedef std::map<ubyte, UTF8BytesChecker*> CheckerMap;
-	CheckerMap m_decoders;
-
-	UTF8SingleByteChecker   m_dec1;
-	UTF8TwoBytesChecker     m_dec2;
-	UTF8ThreeBytesCheckerLB m_dec3lb;
-	UTF8ThreeBytesChecker   m_dec3;
-	UTF8ThreeBytesCheckerM  m_dec3m;
-	UTF8FourBytesCheckerLB  m_dec4lb;
-	UTF8FourBytesChecker    m_dec4;
-	UTF8FourBytesCheckerUB  m_dec4ub;
-	UTF8InvalidBytesChecker m_dec_invalid;
-};
-
-bool IsUTF8(const ubyte* text, size_t len)
-{
-	static const UTF8Checker checker;
-	return checker.MatchText(text, len);
 }
 
 struct GB18030Checker: public EncodingChecker
@@ -391,12 +448,7 @@ struct ISO646Checker: public EncodingChecker
 
 	virtual bool MatchText(const ubyte* text, size_t len) const override
 	{
-		for(ubyte b : boost::make_iterator_range(text, text+len))
-		{
-			if (b==0x00 || b >= 0x80)
-				return false;
-		}
-		return true;
+		return IsASCII(text, len);
 	}
 
 	virtual std::string EncodingName() const override
@@ -522,8 +574,9 @@ bool MatchMBMoreThanUTF16(const ubyte * text, size_t len)
 	}
 
 	// counting effetive C0 bytes
-	const static std::vector<ubyte> exceptC0bytes( boost::assign::list_of('\t')('\r')('\n')('\v')('\f')('\x1B')
-		.convert_to_container<std::vector<ubyte> >() );
+	// a plain array instead of a static container, so that no initialization
+	// is shared by the threads detecting
+	static const ubyte exceptC0bytes[] = {'\t', '\r', '\n', '\v', '\f', '\x1B'};
 
 	for(ubyte b : exceptC0bytes)
 		byte_cnt[size_t(b)] = 0;
@@ -536,13 +589,41 @@ bool MatchMBMoreThanUTF16(const ubyte * text, size_t len)
 	return eff_c0_cnt * 100 < len;
 }
 
-void DetectEncoding(const ubyte* text, size_t len, EncodingID& enc, bool skip_utf8)
+CharsetDetector::~CharsetDetector()
+{
+	if (m_csd != nullptr)
+		ucsdet_close(m_csd);
+}
+
+UCharsetDetector* CharsetDetector::Get()
+{
+	if (m_csd == nullptr)
+	{
+		UErrorCode status = U_ZERO_ERROR;
+		m_csd = ucsdet_open(&status);
+		if (U_FAILURE(status) && m_csd != nullptr)
+		{
+			ucsdet_close(m_csd);
+			m_csd = nullptr;
+		}
+	}
+	return m_csd;
+}
+
+void DetectEncoding(const ubyte* text, size_t len, EncodingID& enc, bool skip_utf8, CharsetDetector& detector)
 {
+	UCharsetDetector* csd = detector.Get();
+	if (csd == nullptr)
+		return;
+
+	// setting the text resets the detector
 	UErrorCode status = U_ZERO_ERROR;
-	LocalUCharsetDetectorPointer csd(ucsdet_open(&status));
-	ucsdet_setText(csd.getAlias(), (const char*)text, (int32_t)len, &status);
+	ucsdet_setText(csd, (const char*)text, (int32_t)len, &status);
 	int32_t match_count = 0;
-	const UCharsetMatch **matches = ucsdet_detectAll(csd.getAlias(), &match_count, &status);
+	const UCharsetMatch **matches = ucsdet_detectAll(csd, &match_count, &status);
+	if (U_FAILURE(status) || match_count == 0)
+		return;
+
 	std::string enc_name(ucsdet_getName(matches[0], &status));
 
 #if U_ICU_VERSION_MAJOR_NUM >= 53
@@ -9,15 +9,69 @@
 #ifndef _XM_ENCDET_H_
 #define _XM_ENCDET_H_
 
+#include "cxx11.h"
 #include "encoding/encoding_def.h"
 
 #include <string>
+#include <vector>
+#include <functional>
+#include <boost/noncopyable.hpp>
+
+struct UCharsetDetector;
 
 namespace xm
 {
 	bool IsUTF8(const ubyte* text, size_t len);
+	// no NUL nor non-ASCII byte
+	bool IsASCII(const ubyte* text, size_t len);
 	bool MatchEncoding(std::string& enc, const ubyte* text, size_t len);
-	void DetectEncoding(const ubyte* text, size_t len, EncodingID& enc, bool skip_utf8);
+
+	// the counts of the kinds of the bytes taken in one pass, the data may be
+	// scanned by blocks; the printable ASCII runs are skipped a word at a time
+	struct ByteStats
+	{
+		size_t nuls;
+		size_t crs;         // CR of CRLF included
+		size_t lfs;         // LF of CRLF included
+		size_t crlfs;
+		size_t highbits;    // the bytes >= 0x80
+
+		ByteStats(): nuls(0), crs(0), lfs(0), crlfs(0), highbits(0), m_cr(false) {}
+
+		void Scan(const ubyte* data, size_t len);
+
+		// no NUL nor non-ASCII byte
+		bool IsASCII() const { return nuls == 0 && highbits == 0; }
+		// NUL found, like IsBinaryData()
+		bool IsBinary() const { return nuls != 0; }
+
+	private:
+		bool m_cr;          // the last byte is CR
+	};
+
+	// an ICU charset detector opened once and reset by every detection, every
+	// thread detecting owns one
+	class CharsetDetector: private boost::noncopyable
+	{
+	public:
+		CharsetDetector(): m_csd(nullptr) {}
+		~CharsetDetector();
+
+		// nullptr if the detector cannot be opened
+		UCharsetDetector* Get();
+	private:
+		UCharsetDetector* m_csd;
+	};
+
+	void DetectEncoding(const ubyte* text, size_t len, EncodingID& enc, bool skip_utf8, CharsetDetector& detector);
+
+	// read the bytes at pos of a file into buf, return the count of the bytes read
+	typedef std::function<size_t(uint64_t pos, ubyte* buf, size_t len)> BytesReader;
+
+	// the head of a big file in plain ASCII tells nothing about the rest, so
+	// the samples spread over the rest are detected instead, or the whole rest
+	// if it is small; every sample is cut at the boundaries of UTF-8 chars
+	void ReadDetectingSamples(std::vector<ubyte>& samples, const BytesReader& read, uint64_t filesize, size_t headsize);
 } //namespace xm
 
 #endif //_XM_ENCDET_H_
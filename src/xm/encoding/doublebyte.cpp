@@ -201,6 +201,12 @@ bool DoubleByteEncoding::IsLeadByte(ubyte byte)
 	return m_leadbyte_tab[byte]==lbLeadByte;
 }
 
+void DoubleByteEncoding::FillDecodingTables()
+{
+	for (int b = 0; b <= 0xFF; ++b)
+		IsLeadByte(ubyte(b));
+}
+
 size_t DoubleByteEncoding::UCS4toMultiByte(ucs4_t ucs4, ubyte* buf)
 {
 	uint16_t mb = GetCachedMBofUCS4(ucs4);
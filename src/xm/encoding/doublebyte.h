@@ -68,6 +68,7 @@ struct DoubleByteEncoding: public MultiByteEncoding
 	virtual ucs4_t MultiBytetoUCS4(const ubyte* buf) override;
 	virtual size_t UCS4toMultiByte(ucs4_t ucs4, ubyte* buf) override;
 	virtual bool NextUChar32(UCQueue &ucqueue, UChar32BytesMapper& mapper) override;
+	virtual void FillDecodingTables() override;
 
 	virtual bool IsSingleByteEncoding() override
 	{
@@ -233,6 +233,12 @@ public:
 		return false;
 	}
 
+	// fill the tables cached lazily by ICU for decoding, then the decoding
+	// only reads the tables and can be shared by the threads
+	virtual void FillDecodingTables()
+	{
+	}
+
 	std::wstring GetName() { return m_name; }
 	std::wstring GetDescription() { return m_desc; }
 	std::wstring GetNameWithAliases() { return m_name_with_aliases; }
@@ -87,13 +87,11 @@ ucs4_t EncodingGB18030::QByte2BMP(const ubyte* buf)
 	if (m_qb2u[idx] != (ucs4_t)svtUCS4NotCached)
 		return m_qb2u[idx];
 
+	// the invalid ones are cached too, or ICU is called for them every time
 	UChar32 ch = 0;
 	size_t len = m_icucnv.MB2WC(ch, (const char*)buf, 4);
-	if (len == 0)
-		return (ucs4_t)svtInvaliad;
-
-	m_qb2u[idx] = (ucs4_t)ch;
-	return (ucs4_t)ch;
+	m_qb2u[idx] = (len == 0)? (ucs4_t)svtInvaliad: (ucs4_t)ch;
+	return m_qb2u[idx];
 }
 
 ucs4_t EncodingGB18030::DByte2BMP(const ubyte* buf)
@@ -104,11 +102,24 @@ ucs4_t EncodingGB18030::DByte2BMP(const ubyte* buf)
 
 	UChar32 ch = 0;
 	size_t len = m_icucnv.MB2WC(ch, (const char*)buf, 2);
-	if (len==0)
-		return (ucs4_t)svtInvaliad;
+	m_db2u[idx] = (len == 0)? (ucs4_t)svtInvaliad: (ucs4_t)ch;
+	return m_db2u[idx];
+}
+
+void EncodingGB18030::FillDecodingTables()
+{
+	for (size_t idx = 0; idx < BMP_QBYTE_CNT; ++idx)
+	{
+		ubyte buf[4] = {ubyte(0x81 + idx/12600), ubyte(0x30 + idx/1260%10),
+		                ubyte(0x81 + idx/10%126), ubyte(0x30 + idx%10)};
+		QByte2BMP(buf);
+	}
 
-	m_db2u[idx] = (ucs4_t)ch;
-	return (ucs4_t)ch;
+	for (size_t idx = 0; idx < BMP_DBYTE_CNT; ++idx)
+	{
+		ubyte buf[3] = {ubyte(0x81 + idx/(0xFE - 0x40 + 1)), ubyte(0x40 + idx%(0xFE - 0x40 + 1)), '\0'};
+		DByte2BMP(buf);
+	}
 }
 
 size_t EncodingGB18030::UCS4toMultiByte(ucs4_t ucs4, ubyte* buf)
@@ -28,6 +28,7 @@ struct EncodingGB18030: public MultiByteEncoding, EncodingDecoderISO646
 	virtual ucs4_t MultiBytetoUCS4(const ubyte* buf) override;
 	virtual size_t UCS4toMultiByte(ucs4_t ucs4, ubyte* buf) override;
 	virtual bool NextUChar32(UCQueue &ucqueue, UChar32BytesMapper& mapper) override;
+	virtual void FillDecodingTables() override;
 
 	virtual bool IsSingleByteEncoding() override
 	{
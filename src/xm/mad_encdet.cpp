@@ -8,6 +8,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "mad_encdet.h"
+#include "cxx11.h"
+
+#include <cstring>
 
 #ifdef _DEBUG
 #include <crtdbg.h>
@@ -16,16 +19,8 @@
 
 bool IsBinaryData(const ubyte* data, size_t len)
 {
-	size_t i = 0;
-	ubyte b;
-	while(i < len)
-	{
-		b = data[i];
-		if(b == 0)
-			return true;
-		i++;
-	}
-	return false;
+	// memchr() of the C library is vectorized
+	return memchr(data, 0, len) != nullptr;
 }
 
 void DetectChineseEncoding(const ubyte * text, size_t len, xm::EncodingID &enc)
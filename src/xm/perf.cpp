@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        xm/perf.cpp
+// Description: Performance Counters of the Hot Paths
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#include "perf.h"
+
+#include <atomic>
+#include <cstdio>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#define new new(_NORMAL_BLOCK ,__FILE__, __LINE__)
+#endif
+
+namespace xm
+{
+
+namespace
+{
+	struct PerfOperationInfo
+	{
+		const char* name;
+		bool timed;
+	};
+
+	// in the order of PerfOperation
+	const PerfOperationInfo OPERATIONS[PERF_OPERATION_COUNT] =
+	{
+		{ "LoadFromFile",          true },
+		{ "SaveToFile",            true },
+		{ "Reformat",              true },
+		{ "RecountLineWidth",      true },
+		{ "OnPaint",               true },
+		{ "PaintTextLines",        true },
+		{ "GetLineByRow",          true },
+		{ "GetLineByPos",          true },
+		{ "GetLineByLine",         true },
+		{ "Search",                true },
+		{ "SearchHex",             true },
+		{ "OverwriteDataSingle",   true },
+		{ "OverwriteDataMultiple", true },
+		{ "NextWord",              true },
+		{ "NextUChar32",           false },
+	};
+
+	// relaxed: the counters only need to be exact when the threads are done
+	struct PerfCounter
+	{
+		std::atomic<uint64_t> calls;
+		std::atomic<uint64_t> total_ns;
+		std::atomic<uint64_t> max_ns;
+	};
+
+	PerfCounter g_counters[PERF_OPERATION_COUNT];
+}
+
+bool PerfCountersEnabled()
+{
+#ifdef XM_PERF_COUNTERS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void PerfCount(PerfOperation op)
+{
+	g_counters[op].calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfAdd(PerfOperation op, std::chrono::steady_clock::duration elapsed)
+{
+	uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+	PerfCounter& c = g_counters[op];
+	c.calls.fetch_add(1, std::memory_order_relaxed);
+	c.total_ns.fetch_add(ns, std::memory_order_relaxed);
+
+	uint64_t max = c.max_ns.load(std::memory_order_relaxed);
+	while (ns > max && !c.max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+		;
+}
+
+void GetPerfStats(std::vector<PerfStat>& stats)
+{
+	stats.resize(PERF_OPERATION_COUNT);
+	for (size_t i = 0; i < PERF_OPERATION_COUNT; ++i)
+	{
+		PerfStat& s = stats[i];
+		s.name = OPERATIONS[i].name;
+		s.timed = OPERATIONS[i].timed;
+		s.calls = g_counters[i].calls.load(std::memory_order_relaxed);
+		s.total_ns = g_counters[i].total_ns.load(std::memory_order_relaxed);
+		s.max_ns = g_counters[i].max_ns.load(std::memory_order_relaxed);
+	}
+}
+
+void ResetPerfStats()
+{
+	for (size_t i = 0; i < PERF_OPERATION_COUNT; ++i)
+	{
+		g_counters[i].calls.store(0, std::memory_order_relaxed);
+		g_counters[i].total_ns.store(0, std::memory_order_relaxed);
+		g_counters[i].max_ns.store(0, std::memory_order_relaxed);
+	}
+}
+
+std::string PerfStatsToJSON()
+{
+	std::vector<PerfStat> stats;
+	GetPerfStats(stats);
+
+	std::string json(PerfCountersEnabled()? "{\n  \"enabled\": true,\n": "{\n  \"enabled\": false,\n");
+	json += "  \"counters\": [\n";
+
+	char buf[256];
+	for (size_t i = 0; i < stats.size(); ++i)
+	{
+		const PerfStat& s = stats[i];
+		const char* sep = (i + 1 < stats.size())? ",": "";
+		if (s.timed)
+		{
+			double mean_us = (s.calls == 0)? 0.0: double(s.total_ns) / double(s.calls) / 1e3;
+			snprintf(buf, sizeof(buf),
+				"    {\"name\": \"%s\", \"calls\": %llu, \"total_ms\": %.3f, \"mean_us\": %.3f, \"max_us\": %.3f}%s\n",
+				s.name, (unsigned long long)s.calls, double(s.total_ns) / 1e6, mean_us, double(s.max_ns) / 1e3, sep);
+		}
+		else
+		{
+			snprintf(buf, sizeof(buf), "    {\"name\": \"%s\", \"calls\": %llu}%s\n",
+				s.name, (unsigned long long)s.calls, sep);
+		}
+		json += buf;
+	}
+	json += "  ]\n}\n";
+
+	return json;
+}
+
+} //namespace xm
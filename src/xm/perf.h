@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        xm/perf.h
+// Description: Performance Counters of the Hot Paths
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _XM_PERF_H_
+#define _XM_PERF_H_
+
+#include "cxx11.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/noncopyable.hpp>
+
+// the counters are compiled in by "configure --enable-perf-counters", which
+// defines XM_PERF_COUNTERS; otherwise XM_PERF_SCOPE() and XM_PERF_COUNT() are
+// empty and every counter stays 0
+#ifdef XM_PERF_COUNTERS
+# define XM_PERF_SCOPE(op)  xm::PerfScope xm_perf_scope_(xm::op)
+# define XM_PERF_COUNT(op)  xm::PerfCount(xm::op)
+#else
+# define XM_PERF_SCOPE(op)  ((void)0)
+# define XM_PERF_COUNT(op)  ((void)0)
+#endif
+
+namespace xm
+{
+	enum PerfOperation
+	{
+		PERF_LOAD_FROM_FILE,
+		PERF_SAVE_TO_FILE,
+		PERF_REFORMAT,
+		PERF_RECOUNT_LINE_WIDTH,
+		PERF_ON_PAINT,
+		PERF_PAINT_TEXT_LINES,
+		PERF_GET_LINE_BY_ROW,
+		PERF_GET_LINE_BY_POS,
+		PERF_GET_LINE_BY_LINE,
+		PERF_SEARCH,
+		PERF_SEARCH_HEX,
+		PERF_OVERWRITE_DATA_SINGLE,
+		PERF_OVERWRITE_DATA_MULTIPLE,
+		PERF_NEXT_WORD,
+		PERF_NEXT_UCHAR32,      // counted only, it is too short to be timed
+		PERF_OPERATION_COUNT
+	};
+
+	struct PerfStat
+	{
+		const char* name;
+		bool timed;
+		uint64_t calls;
+		uint64_t total_ns;
+		uint64_t max_ns;        // the longest call
+	};
+
+	bool PerfCountersEnabled();
+
+	void PerfCount(PerfOperation op);
+	void PerfAdd(PerfOperation op, std::chrono::steady_clock::duration elapsed);
+
+	// a snapshot of all counters in the order of PerfOperation, they are
+	// updated by any thread meanwhile
+	void GetPerfStats(std::vector<PerfStat>& stats);
+	void ResetPerfStats();
+	std::string PerfStatsToJSON();
+
+	// time the enclosing scope as one call of op
+	class PerfScope: private boost::noncopyable
+	{
+	public:
+		explicit PerfScope(PerfOperation op): m_op(op), m_start(std::chrono::steady_clock::now()) {}
+		~PerfScope() { PerfAdd(m_op, std::chrono::steady_clock::now() - m_start); }
+	private:
+		PerfOperation m_op;
+		std::chrono::steady_clock::time_point m_start;
+	};
+} //namespace xm
+
+#endif //_XM_PERF_H_
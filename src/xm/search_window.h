@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Name:        xm/search_window.h
+// Description: The Commit Points of a Window Sliding over a Searched File
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _XM_SEARCH_WINDOW_H_
+#define _XM_SEARCH_WINDOW_H_
+
+#include "cxx11.h"
+#include "encoding/encoding_def.h"
+
+#include <stddef.h>
+
+namespace xm
+{
+	// a file is searched through a window of the decoded chars sliding over it,
+	// the matches beginning before the commit point of the window are final
+	// and the chars before it are dropped
+	struct SlidingWindow
+	{
+		size_t tail;        // the chars searched but not committed at the end
+		size_t max_chars;   // committed in the middle of a line at this size
+		size_t max_match;   // the size a regex match may grow the window to
+		bool regex;
+		bool dot_newline;   // '.' of the regex matches the newlines
+
+		SlidingWindow(size_t tail_, size_t max_chars_, size_t max_match_)
+			: tail(tail_), max_chars(max_chars_), max_match(max_match_), regex(false), dot_newline(false)
+		{}
+
+		// a match of a fixed length ends in the tail; a regex match is searched
+		// in whole lines, or in the whole file if '.' matches the newlines
+		size_t CommitPoint(const ucs4_t* chars, size_t count, bool eof) const
+		{
+			if (eof)
+				return count;
+			if (count <= tail)
+				return 0;
+			if (!regex)
+				return count - tail;
+			if (dot_newline)
+				return (count >= max_match) ? count - tail : 0;
+
+			// after the last newline before the tail
+			for (size_t i = count - tail; i > 0; --i)
+			{
+				ucs4_t uc = chars[i - 1];
+				if (uc == 0x0A || (uc == 0x0D && chars[i] != 0x0A))
+					return i;
+			}
+
+			return (count >= max_chars) ? count - tail : 0;
+		}
+
+		// a regex match reaching the end of the window, or a partial one, may
+		// go on in the chars after it, so it is searched again when the window
+		// has grown; the ones longer than max_match are cut at the end of it
+		bool Growing(size_t count, bool eof) const
+		{
+			return regex && !eof && count < max_match;
+		}
+
+		bool Unfinished(size_t matchend, size_t count, bool eof) const
+		{
+			return matchend >= count && Growing(count, eof);
+		}
+	};
+} // namespace xm
+
+#endif //_XM_SEARCH_WINDOW_H_
@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Benchmark Suite
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "bench.h"
+#include "../../src/xm/encoding/external.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+std::wstring GetMSCPFontName(const std::wstring & /*mscp*/) { return L"monospace"; }
+std::wstring GetASCIIArtFontName() { return L"monospace"; }
+const wchar_t * LocalizeText(const wchar_t* txt) { return txt; }
+
+namespace bench
+{
+
+namespace
+{
+
+const size_t KB = 1024;
+const size_t MB = 1024 * 1024;
+
+// the corpus sizes from 1 KB to 100 MB, the ones over --max-size are skipped
+const size_t all_sizes[] = { 1*KB, 64*KB, 1*MB, 16*MB, 100*MB };
+
+bool ParseSize(const char* arg, size_t& size)
+{
+	char* end = nullptr;
+	unsigned long n = strtoul(arg, &end, 10);
+	if (end == arg)
+		return false;
+
+	if (*end == 'K' || *end == 'k')
+		n *= KB, ++end;
+	else if (*end == 'M' || *end == 'm')
+		n *= MB, ++end;
+
+	size = size_t(n);
+	return *end == '\0';
+}
+
+bool OptionValue(const char* arg, const char* opt, const char*& value)
+{
+	size_t len = strlen(opt);
+	if (strncmp(arg, opt, len) != 0 || arg[len] != '=')
+		return false;
+	value = arg + len + 1;
+	return true;
+}
+
+} // anonymous namespace
+
+std::string SizeName(size_t size)
+{
+	std::ostringstream os;
+	if (size >= MB && size % MB == 0)
+		os << size / MB << "MB";
+	else if (size >= KB && size % KB == 0)
+		os << size / KB << "KB";
+	else
+		os << size << "B";
+	return os.str();
+}
+
+bool Runner::ParseArgs(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* value = nullptr;
+		if (OptionValue(argv[i], "--max-size", value))
+		{
+			if (!ParseSize(value, m_max_size))
+				return false;
+		}
+		else if (OptionValue(argv[i], "--min-time", value))
+		{
+			m_min_seconds = atof(value);
+		}
+		else if (OptionValue(argv[i], "--filter", value))
+		{
+			m_filter = value;
+		}
+		else if (OptionValue(argv[i], "--json", value))
+		{
+			m_json_file = value;
+		}
+		else if (strcmp(argv[i], "--help") == 0)
+		{
+			m_help = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < sizeof(all_sizes) / sizeof(all_sizes[0]); ++i)
+	{
+		if (all_sizes[i] <= m_max_size)
+			m_sizes.push_back(all_sizes[i]);
+	}
+
+	return true;
+}
+
+bool Runner::Selected(const std::string& name) const
+{
+	return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void Runner::Run(const std::string& name, size_t bytes, Case& c)
+{
+	if (!Selected(name))
+		return;
+
+	typedef std::chrono::steady_clock clock;
+
+	// warm up the caches and the lazily created tables
+	c.Run();
+
+	size_t iterations = 0;
+	double elapsed = 0;
+	clock::time_point start = clock::now();
+	do
+	{
+		c.Run();
+		++iterations;
+		elapsed = std::chrono::duration<double>(clock::now() - start).count();
+	}
+	while (elapsed < m_min_seconds);
+
+	Result r;
+	r.name = name;
+	r.bytes = bytes;
+	r.iterations = iterations;
+	r.seconds = elapsed / iterations;
+	m_results.push_back(r);
+
+	std::cout << std::left << std::setw(48) << name << std::right
+		<< std::setw(12) << std::fixed << std::setprecision(2) << r.MBps() << " MB/s"
+		<< std::setw(10) << iterations << " runs" << std::endl;
+}
+
+void Runner::PrintSummary(std::ostream& os) const
+{
+	os << m_results.size() << " cases, corpora up to " << SizeName(m_max_size) << std::endl;
+}
+
+void Runner::WriteJSON(std::ostream& os) const
+{
+	os << "{\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const Result& r = m_results[i];
+		os << "    {\"name\": \"" << r.name << "\", \"bytes\": " << r.bytes
+			<< ", \"iterations\": " << r.iterations
+			<< ", \"seconds\": " << std::scientific << std::setprecision(6) << r.seconds
+			<< ", \"mb_per_second\": " << std::fixed << std::setprecision(3) << r.MBps() << "}"
+			<< (i + 1 < m_results.size() ? ",\n" : "\n");
+	}
+	os << "  ]\n}\n";
+}
+
+} // namespace bench
+
+int main(int argc, char* argv[])
+{
+	bench::Runner runner;
+	const bool parsed = runner.ParseArgs(argc, argv);
+	if (!parsed || runner.Help())
+	{
+		(parsed? std::cout: std::cerr) << "usage: " << argv[0]
+			<< " [--max-size=N[K|M]] [--min-time=SECONDS] [--filter=TEXT] [--json=FILE] [--help]" << std::endl;
+		return parsed? 0: 2;
+	}
+
+	bench::bench_encoding(runner);
+	bench::bench_document(runner);
+
+	runner.PrintSummary(std::cout);
+
+	if (!runner.JSONFile().empty())
+	{
+		std::ofstream ofs(runner.JSONFile().c_str());
+		runner.WriteJSON(ofs);
+		if (!ofs)
+		{
+			std::cerr << "failed to write " << runner.JSONFile() << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Benchmark Harness
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#ifndef WXMEDIT_BENCH_H
+#define WXMEDIT_BENCH_H
+
+#include "../../src/xm/encoding/encoding_def.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace bench
+{
+
+// a case is run repeatedly for at least the minimum time, its result is the
+// average time of one run over the bytes it processed
+struct Result
+{
+	std::string name;
+	size_t bytes;
+	size_t iterations;
+	double seconds;     // of one iteration
+
+	double MBps() const
+	{
+		return seconds > 0 ? double(bytes) / (1024.0 * 1024.0) / seconds : 0;
+	}
+};
+
+struct Case
+{
+	virtual void Run() = 0;
+	virtual ~Case() {}
+};
+
+class Runner
+{
+public:
+	Runner(): m_max_size(1024 * 1024), m_min_seconds(0.2), m_help(false) {}
+
+	// return false for the bad arguments
+	bool ParseArgs(int argc, char* argv[]);
+	// --help is given, print the usage and run nothing
+	bool Help() const { return m_help; }
+
+	size_t MaxSize() const { return m_max_size; }
+	const std::vector<size_t>& Sizes() const { return m_sizes; }
+	bool Selected(const std::string& name) const;
+
+	void Run(const std::string& name, size_t bytes, Case& c);
+
+	void PrintSummary(std::ostream& os) const;
+	void WriteJSON(std::ostream& os) const;
+	const std::string& JSONFile() const { return m_json_file; }
+
+private:
+	size_t m_max_size;
+	double m_min_seconds;
+	bool m_help;
+	std::string m_filter;
+	std::string m_json_file;
+	std::vector<size_t> m_sizes;
+	std::vector<Result> m_results;
+};
+
+// the corpora are generated by a fixed seed, so every run measures the same bytes
+class Random
+{
+public:
+	explicit Random(unsigned long seed = 0x2545F491UL): m_state(seed) {}
+
+	unsigned long Next()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state & 0xFFFFFFFFUL;
+	}
+	size_t Below(size_t n) { return size_t(Next() % n); }
+
+private:
+	unsigned long m_state;
+};
+
+std::string SizeName(size_t size);
+
+void bench_encoding(Runner& runner);
+void bench_document(Runner& runner);
+
+} // namespace bench
+
+#endif //WXMEDIT_BENCH_H
@@ -0,0 +1,421 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Benchmarks of the Document Storage, the Undo Buffer and Searching
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "bench.h"
+#include "../../src/wxm/buffer_searcher.h"
+#include "../../src/wxmedit/wxm_undo.h"
+
+#include <wx/file.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// the scenarios which need a MadEdit, as loading into the lines, reformatting
+// and the searchers of MadEdit, are measured by "wxmedit --benchmark"
+
+namespace bench
+{
+
+namespace
+{
+
+// keep the results alive, so the measured work is not optimized out
+volatile size_t g_sink = 0;
+
+void AppendUTF8(std::string& buf, ucs4_t uc)
+{
+	if (uc < 0x80)
+	{
+		buf += char(uc);
+	}
+	else if (uc < 0x800)
+	{
+		buf += char(0xC0 | (uc >> 6));
+		buf += char(0x80 | (uc & 0x3F));
+	}
+	else
+	{
+		buf += char(0xE0 | (uc >> 12));
+		buf += char(0x80 | ((uc >> 6) & 0x3F));
+		buf += char(0x80 | (uc & 0x3F));
+	}
+}
+
+void AppendASCII(ucs4string& text, const char* s)
+{
+	for (; *s != '\0'; ++s)
+		text += ucs4_t(ubyte(*s));
+}
+
+void AppendLogLine(ucs4string& text, Random& rnd)
+{
+	static const char* levels[] = { "INFO ", "DEBUG", "WARN ", "ERROR" };
+	char line[256];
+	sprintf(line, "2019-%02lu-%02lu %02lu:%02lu:%02lu.%03lu [%s] worker-%lu request id=%lu took %lu ms path=/api/v1/items/%lu\n",
+		(unsigned long)(1 + rnd.Below(12)), (unsigned long)(1 + rnd.Below(28)), (unsigned long)rnd.Below(24),
+		(unsigned long)rnd.Below(60), (unsigned long)rnd.Below(60), (unsigned long)rnd.Below(1000),
+		levels[rnd.Below(4)], (unsigned long)rnd.Below(16), rnd.Next(), (unsigned long)rnd.Below(5000),
+		(unsigned long)rnd.Below(100000));
+	AppendASCII(text, line);
+}
+
+void AppendCSVLine(ucs4string& text, Random& rnd)
+{
+	static const char* words[] = { "apple", "banana", "cherry", "durian", "elder", "fig", "grape" };
+	char line[256];
+	sprintf(line, "%lu,item-%lu,%lu.%02lu,%lu,2019-%02lu-%02lu,\"%s %s\"\n",
+		rnd.Next(), (unsigned long)rnd.Below(100000), (unsigned long)rnd.Below(1000),
+		(unsigned long)rnd.Below(100), (unsigned long)rnd.Below(500), (unsigned long)(1 + rnd.Below(12)),
+		(unsigned long)(1 + rnd.Below(28)), words[rnd.Below(7)], words[rnd.Below(7)]);
+	AppendASCII(text, line);
+}
+
+void AppendCJKLine(ucs4string& text, Random& rnd)
+{
+	size_t len = 20 + rnd.Below(40);
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (rnd.Below(12) == 0)
+			text += ucs4_t(0xFF0C); // fullwidth comma
+		else
+			text += ucs4_t(0x4E00 + rnd.Below(0x9FA6 - 0x4E00));
+	}
+	text += ucs4_t(0x3002); // ideographic full stop
+	text += ucs4_t('\n');
+}
+
+typedef void (*AppendFunc)(ucs4string& text, Random& rnd);
+
+// the same corpora as "wxmedit --benchmark", without the binary one
+struct Corpus
+{
+	const char* name;
+	AppendFunc append;
+	// for FindAll and ReplaceAll: a frequent text, its replacement, and a regex
+	const wchar_t* frequent;
+	const wchar_t* replacement;
+	const wchar_t* regex;
+};
+
+const Corpus CORPORA[] =
+{
+	{ "log", AppendLogLine, L"took", L"TOOK", L"id=[0-9]+" },
+	{ "csv", AppendCSVLine, L"item-", L"ITEM-", L"[0-9]+\\.[0-9]{2}" },
+	{ "cjk", AppendCJKLine, L"\uFF0C", L"\u3001", L"\uFF0C[^\uFF0C\u3002]{2}" },
+};
+
+ucs4string ToUCS4(const wchar_t* s)
+{
+	ucs4string u;
+	for (; *s != L'\0'; ++s)
+		u += ucs4_t(*s);
+	return u;
+}
+
+std::vector<wxByte> ToUTF8(const ucs4string& text)
+{
+	std::string buf;
+	for (size_t i = 0; i < text.size(); ++i)
+		AppendUTF8(buf, text[i]);
+	return std::vector<wxByte>(buf.begin(), buf.end());
+}
+
+// the lines of the corpus till the UTF-8 bytes reach size
+void GenerateCorpus(const Corpus& corpus, size_t size, ucs4string& text, std::vector<wxByte>& bytes)
+{
+	Random rnd;
+	text.clear();
+	size_t len = 0;
+	while (len < size)
+	{
+		size_t old = text.size();
+		corpus.append(text, rnd);
+		for (size_t i = old; i < text.size(); ++i)
+			len += text[i] < 0x80 ? 1 : (text[i] < 0x800 ? 2 : 3);
+	}
+	bytes = ToUTF8(text);
+}
+
+wxString WriteTempFile(const std::vector<wxByte>& bytes)
+{
+	wxString name = wxFileName::CreateTempFileName(wxT("wxmbench"));
+	wxFile file(name, wxFile::write);
+	file.Write(&bytes[0], bytes.size());
+	return name;
+}
+
+// opens the file and reads all its bytes by the blocks of MadFileData
+class LoadCase: public Case
+{
+public:
+	LoadCase(const wxString& filename): m_filename(filename), m_buf(BUFFER_SIZE) {}
+
+	virtual void Run() override
+	{
+		MadFileData fd(m_filename);
+		size_t sum = 0;
+		for (wxFileOffset pos = 0; pos < fd.GetSize(); pos += BUFFER_SIZE)
+		{
+			size_t n = size_t(std::min(wxFileOffset(BUFFER_SIZE), fd.GetSize() - pos));
+			fd.Get(pos, &m_buf[0], n);
+			sum += m_buf[n - 1];
+		}
+		g_sink += sum;
+	}
+
+private:
+	wxString m_filename;
+	std::vector<wxByte> m_buf;
+};
+
+class FindTextCase: public Case
+{
+public:
+	FindTextCase(wxm::BufferSearcher& searcher, const ucs4string& text): m_searcher(searcher), m_text(text) {}
+
+	virtual void Run() override
+	{
+		const ucs4_t* begin = m_text.data();
+		g_sink += size_t(m_searcher.FindAll(begin, begin + m_text.size(), 0, false, m_begidx, m_endidx));
+		m_begidx.clear();
+		m_endidx.clear();
+	}
+
+private:
+	wxm::BufferSearcher& m_searcher;
+	const ucs4string& m_text;
+	std::vector<size_t> m_begidx, m_endidx;
+};
+
+class FindHexCase: public Case
+{
+public:
+	FindHexCase(wxm::BufferSearcher& searcher, const std::vector<wxByte>& bytes): m_searcher(searcher), m_bytes(bytes) {}
+
+	virtual void Run() override
+	{
+		const wxByte* begin = &m_bytes[0];
+		g_sink += size_t(m_searcher.FindAll(begin, begin + m_bytes.size(), false, m_begidx, m_endidx));
+		m_begidx.clear();
+		m_endidx.clear();
+	}
+
+private:
+	wxm::BufferSearcher& m_searcher;
+	const std::vector<wxByte>& m_bytes;
+	std::vector<size_t> m_begidx, m_endidx;
+};
+
+// builds the replaced text from the matches, like ReplaceAll of MadEdit
+class ReplaceCase: public Case
+{
+public:
+	ReplaceCase(wxm::BufferSearcher& searcher, const ucs4string& text): m_searcher(searcher), m_text(text) {}
+
+	virtual void Run() override
+	{
+		const ucs4_t* begin = m_text.data();
+		std::vector<size_t> begidx, endidx;
+		m_searcher.FindAll(begin, begin + m_text.size(), 0, false, begidx, endidx);
+
+		ucs4string out, rep;
+		out.reserve(m_text.size());
+		size_t last = 0;
+		for (size_t i = 0; i < begidx.size(); ++i)
+		{
+			out.append(begin + last, begin + begidx[i]);
+			rep.clear();
+			m_searcher.Replace(begin + begidx[i], begin + endidx[i], rep);
+			out += rep;
+			last = endidx[i];
+		}
+		out.append(begin + last, begin + m_text.size());
+		g_sink += out.size();
+	}
+
+private:
+	wxm::BufferSearcher& m_searcher;
+	const ucs4string& m_text;
+};
+
+// the blocks of many small edits, as a document after typing
+const size_t EDIT_SIZE = 4 * 1024;
+
+void PutEdits(MadMemData& md, const std::vector<wxByte>& bytes, std::vector<xm::BlockVector>& blocks)
+{
+	for (size_t pos = 0; pos < bytes.size(); pos += EDIT_SIZE)
+	{
+		size_t n = std::min(EDIT_SIZE, bytes.size() - pos);
+		xm::BlockVector bv;
+		bv.push_back(MadBlock(&md, md.Put(const_cast<wxByte*>(&bytes[pos]), n), n));
+		blocks.push_back(bv);
+	}
+}
+
+// writes the blocks to a file and hashes them, like saving a document
+class SaveCase: public Case
+{
+public:
+	SaveCase(const std::vector<wxByte>& bytes): m_filename(wxFileName::CreateTempFileName(wxT("wxmbench"))),
+		m_buf(BUFFER_SIZE)
+	{
+		PutEdits(m_md, bytes, m_blocks);
+	}
+	~SaveCase()
+	{
+		wxRemoveFile(m_filename);
+	}
+
+	virtual void Run() override
+	{
+		wxFile file(m_filename, wxFile::write);
+		MadContentHash hash;
+		for (size_t i = 0; i < m_blocks.size(); ++i)
+		{
+			MadBlock& blk = m_blocks[i][0];
+			size_t n = size_t(blk.m_Size);
+			blk.m_Data->Get(blk.m_Pos, &m_buf[0], n);
+			hash.Update(&m_buf[0], n);
+			file.Write(&m_buf[0], n);
+		}
+		g_sink += size_t(hash.GetHash());
+	}
+
+private:
+	wxString m_filename;
+	MadMemData m_md;
+	std::vector<xm::BlockVector> m_blocks;
+	std::vector<wxByte> m_buf;
+};
+
+// compacts the memory data after three of four edits are deleted,
+// the putting is measured too, since the compacting changes the data
+class CompactCase: public Case
+{
+public:
+	CompactCase(const std::vector<wxByte>& bytes): m_bytes(bytes) {}
+
+	virtual void Run() override
+	{
+		MadMemData md;
+		std::vector<xm::BlockVector> blocks;
+		PutEdits(md, m_bytes, blocks);
+
+		std::vector<xm::BlockVector*> inuse;
+		for (size_t i = 0; i < blocks.size(); i += 4)
+			inuse.push_back(&blocks[i]);
+
+		// in the steps of MadUndoBuffer::CompactMemData()
+		while (md.Compact(inuse, 4 * 1024 * 1024))
+			;
+		g_sink += md.GetBufferedSize();
+	}
+
+private:
+	const std::vector<wxByte>& m_bytes;
+};
+
+// the undos of deleting all the edits under a memory limit of a quarter
+// of them, then undoing and redoing all, so the old undos are spilled
+// and reloaded
+class UndoCase: public Case
+{
+public:
+	UndoCase(const std::vector<wxByte>& bytes): m_bytes(bytes) {}
+
+	virtual void Run() override
+	{
+		MadMemData md;
+		MadUndoBuffer ub(&md);
+		ub.SetMemoryLimit(std::max(m_bytes.size() / 4, size_t(EDIT_SIZE)), false);
+
+		std::vector<xm::BlockVector*> noblocks;
+		for (size_t pos = 0; pos < m_bytes.size(); pos += EDIT_SIZE)
+		{
+			size_t n = std::min(EDIT_SIZE, m_bytes.size() - pos);
+			MadDeleteUndoData* dudata = new MadDeleteUndoData;
+			dudata->m_Pos = wxFileOffset(pos);
+			dudata->m_Size = wxFileOffset(n);
+			dudata->m_Data.push_back(MadBlock(&md, md.Put(const_cast<wxByte*>(&m_bytes[pos]), n), n));
+			ub.Add()->m_Undos.push_back(dudata);
+
+			if (ub.NeedCompacting())
+				while (ub.CompactMemData(noblocks))
+					;
+		}
+
+		size_t count = 0;
+		while (ub.Undo(false) != nullptr)
+			++count;
+		while (ub.Redo(false) != nullptr)
+			++count;
+		g_sink += count;
+	}
+
+private:
+	const std::vector<wxByte>& m_bytes;
+};
+
+void BenchCorpus(Runner& runner, const Corpus& corpus, size_t size)
+{
+	const std::string suffix = std::string("/") + corpus.name + "/" + SizeName(size);
+
+	ucs4string text;
+	std::vector<wxByte> bytes;
+	GenerateCorpus(corpus, size, text, bytes);
+
+	if (runner.Selected("load" + suffix))
+	{
+		wxString filename = WriteTempFile(bytes);
+		LoadCase load(filename);
+		runner.Run("load" + suffix, bytes.size(), load);
+		wxRemoveFile(filename);
+	}
+
+	wxm::BufferSearcher str_searcher;
+	str_searcher.PrepareText(ToUCS4(corpus.frequent), false, true, false, false);
+	FindTextCase find_string(str_searcher, text);
+	runner.Run("FindAll/string" + suffix, bytes.size(), find_string);
+
+	wxm::BufferSearcher regex_searcher;
+	regex_searcher.PrepareText(ToUCS4(corpus.regex), true, true, false, false);
+	FindTextCase find_regex(regex_searcher, text);
+	runner.Run("FindAll/regex" + suffix, bytes.size(), find_regex);
+
+	wxm::BufferSearcher hex_searcher;
+	hex_searcher.PrepareHex(ToUTF8(ToUCS4(corpus.frequent)));
+	FindHexCase find_hex(hex_searcher, bytes);
+	runner.Run("FindAll/hex" + suffix, bytes.size(), find_hex);
+
+	str_searcher.PrepareFormat(ToUCS4(corpus.replacement));
+	ReplaceCase replace(str_searcher, text);
+	runner.Run("ReplaceAll" + suffix, bytes.size(), replace);
+
+	SaveCase save(bytes);
+	runner.Run("save" + suffix, bytes.size(), save);
+
+	CompactCase compact(bytes);
+	runner.Run("Compact" + suffix, bytes.size(), compact);
+
+	UndoCase undo(bytes);
+	runner.Run("undo/spill" + suffix, bytes.size(), undo);
+}
+
+} // anonymous namespace
+
+void bench_document(Runner& runner)
+{
+	const std::vector<size_t>& sizes = runner.Sizes();
+	for (size_t i = 0; i < sizes.size(); ++i)
+	{
+		for (size_t c = 0; c < sizeof(CORPORA) / sizeof(CORPORA[0]); ++c)
+			BenchCorpus(runner, CORPORA[c], sizes[i]);
+	}
+}
+
+} // namespace bench
@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Benchmarks of Encodings and Encoding Detection
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "bench.h"
+#include "../../src/xm/encoding/encoding.h"
+#include "../../src/xm/encdet.h"
+#include "../../src/xm/mad_encdet.h"
+
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+namespace
+{
+
+// keep the results alive, so the measured work is not optimized out
+volatile size_t g_sink = 0;
+
+std::string NarrowName(const std::wstring& name)
+{
+	return std::string(name.begin(), name.end());
+}
+
+// decodes from a memory buffer, like MadLines does from the blocks of a line
+class MemoryBytesMapper: public xm::UChar32BytesMapper
+{
+public:
+	MemoryBytesMapper(const std::vector<ubyte>& data): m_data(data), m_pos(0) {}
+
+	virtual void MoveUChar32Bytes(xm::UCQueue &ucqueue, ucs4_t uc, size_t len) override
+	{
+		ucqueue.push_back(xm::CharUnit(uc, int(len)));
+		m_pos += len;
+	}
+
+	virtual ubyte* BufferLoadBytes(int64_t& rest, size_t /*buf_len*/) override
+	{
+		rest = int64_t(m_data.size()) - int64_t(m_pos);
+		if (rest <= 0)
+			return nullptr;
+		return const_cast<ubyte*>(&m_data[m_pos]);
+	}
+
+private:
+	const std::vector<ubyte>& m_data;
+	size_t m_pos;
+};
+
+// picks the non-ASCII chars by their bytes in the encoding
+typedef bool (*CharFilter)(const ubyte* mb, size_t len);
+
+// the code points the encoding can convert: ASCII, and the non-ASCII ones
+// of the Latin, Greek, Cyrillic, CJK symbols, kana, CJK and Hangul blocks
+void EncodableChars(xm::Encoding* enc, std::vector<ucs4_t>& ascii, std::vector<ucs4_t>& others,
+	CharFilter filter)
+{
+	static const ucs4_t ranges[][2] =
+	{
+		{ 0x00A0, 0x052F }, { 0x2000, 0x206F }, { 0x3000, 0x30FF },
+		{ 0x4E00, 0x9FFF }, { 0xAC00, 0xD7A3 }, { 0xFF00, 0xFFEF },
+	};
+
+	ubyte buf[16];
+	for (ucs4_t u = 0x20; u < 0x7F; ++u)
+		ascii.push_back(u);
+
+	for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r)
+	{
+		for (ucs4_t u = ranges[r][0]; u <= ranges[r][1]; ++u)
+		{
+			size_t n = enc->UCS4toMultiByte(u, buf);
+			if (n != 0 && (filter == nullptr || filter(buf, n)))
+				others.push_back(u);
+		}
+	}
+}
+
+// text of lines about 80 chars, one of every four chars is non-ASCII
+// when the encoding has them
+void GenerateText(xm::Encoding* enc, size_t size, std::vector<ucs4_t>& text, std::vector<ubyte>& bytes,
+	CharFilter filter = nullptr)
+{
+	std::vector<ucs4_t> ascii, others;
+	EncodableChars(enc, ascii, others, filter);
+
+	Random rnd;
+	ubyte buf[16];
+	size_t col = 0;
+	text.clear();
+	bytes.clear();
+	bytes.reserve(size + 16);
+	while (bytes.size() < size)
+	{
+		ucs4_t u;
+		if (++col >= 80)
+		{
+			u = 0x0A;
+			col = 0;
+		}
+		else if (!others.empty() && rnd.Below(4) == 0)
+		{
+			u = others[rnd.Below(others.size())];
+		}
+		else
+		{
+			u = ascii[rnd.Below(ascii.size())];
+		}
+
+		size_t n = enc->UCS4toMultiByte(u, buf);
+		if (n == 0)
+			continue;
+
+		text.push_back(u);
+		bytes.insert(bytes.end(), buf, buf + n);
+	}
+}
+
+struct DecodeCase: public Case
+{
+	xm::Encoding* enc;
+	const std::vector<ubyte>& bytes;
+
+	DecodeCase(xm::Encoding* e, const std::vector<ubyte>& b): enc(e), bytes(b) {}
+
+	virtual void Run() override
+	{
+		MemoryBytesMapper mapper(bytes);
+		xm::UCQueue ucqueue;
+		size_t count = 0;
+		while (enc->NextUChar32(ucqueue, mapper))
+		{
+			if (ucqueue.size() >= 1024)
+			{
+				count += ucqueue.size();
+				ucqueue.clear();
+			}
+		}
+		g_sink = count + ucqueue.size();
+	}
+};
+
+struct EncodeCase: public Case
+{
+	xm::Encoding* enc;
+	const std::vector<ucs4_t>& text;
+
+	EncodeCase(xm::Encoding* e, const std::vector<ucs4_t>& t): enc(e), text(t) {}
+
+	virtual void Run() override
+	{
+		ubyte buf[16];
+		size_t total = 0;
+		for (size_t i = 0; i < text.size(); ++i)
+			total += enc->UCS4toMultiByte(text[i], buf);
+		g_sink = total;
+	}
+};
+
+typedef void (*DetectFunc)(const ubyte* text, size_t len, xm::EncodingID& enc);
+
+struct DetectCase: public Case
+{
+	DetectFunc func;
+	const std::vector<ubyte>& bytes;
+
+	DetectCase(DetectFunc f, const std::vector<ubyte>& b): func(f), bytes(b) {}
+
+	virtual void Run() override
+	{
+		xm::EncodingID enc = xm::ENC_DEFAULT;
+		func(&bytes[0], bytes.size(), enc);
+		g_sink = size_t(enc);
+	}
+};
+
+typedef bool (*CheckFunc)(const ubyte* text, size_t len);
+
+struct CheckCase: public Case
+{
+	CheckFunc func;
+	const std::vector<ubyte>& bytes;
+
+	CheckCase(CheckFunc f, const std::vector<ubyte>& b): func(f), bytes(b) {}
+
+	virtual void Run() override
+	{
+		g_sink = func(&bytes[0], bytes.size()) ? 1 : 0;
+	}
+};
+
+// the MS936 chars which cannot decide DetectChineseEncoding() at once,
+// the ones with trail bytes in [0x80~0xA0] are invalid in big5
+bool UndecidedMS936(const ubyte* mb, size_t len)
+{
+	return len == 2 && mb[1] > 0xA0;
+}
+
+// the MS932 chars which cannot decide DetectJapaneseEncoding(), the ones
+// also valid in EUC-JP
+bool UndecidedMS932(const ubyte* mb, size_t len)
+{
+	return len == 2 && mb[0] >= 0xE0 && mb[0] <= 0xEF && mb[1] >= 0xA1;
+}
+
+void DetectEncodingWithUTF8(const ubyte* text, size_t len, xm::EncodingID& enc)
+{
+	static xm::CharsetDetector detector;
+	xm::DetectEncoding(text, len, enc, false, detector);
+}
+
+void BenchEncodings(Runner& runner, size_t size)
+{
+	xm::EncodingManager& em = xm::EncodingManager::Instance();
+	std::vector<ucs4_t> text;
+	std::vector<ubyte> bytes;
+
+	for (size_t i = 0; i < em.GetEncodingsCount(); ++i)
+	{
+		xm::Encoding* enc = em.GetEncoding(ssize_t(i));
+		std::string encname = NarrowName(enc->GetName());
+		std::string suffix = "/" + encname + "/" + SizeName(size);
+		if (!runner.Selected("NextUChar32" + suffix) && !runner.Selected("UCS4toMultiByte" + suffix))
+			continue;
+
+		GenerateText(enc, size, text, bytes);
+
+		DecodeCase decode(enc, bytes);
+		runner.Run("NextUChar32" + suffix, bytes.size(), decode);
+
+		EncodeCase encode(enc, text);
+		runner.Run("UCS4toMultiByte" + suffix, bytes.size(), encode);
+	}
+}
+
+// the stopping cases are given the data deciding them only at the end, so
+// every case scans all the bytes it reports
+void BenchDetection(Runner& runner, size_t size)
+{
+	xm::EncodingManager& em = xm::EncodingManager::Instance();
+	std::vector<ucs4_t> text;
+	std::vector<ubyte> utf8, ms936, ms950, ms932, bad_utf8, binary, ms936_tail, ms932_tail;
+
+	GenerateText(em.GetEncoding(xm::ENC_UTF_8), size, text, utf8);
+	GenerateText(em.GetEncoding(xm::ENC_MS936), size, text, ms936);
+	GenerateText(em.GetEncoding(xm::ENC_MS950), size, text, ms950);
+	GenerateText(em.GetEncoding(xm::ENC_MS932), size, text, ms932);
+
+	// an invalid byte after the UTF-8 text
+	bad_utf8 = utf8;
+	bad_utf8.push_back(0xFF);
+
+	// the first NUL is the last byte
+	Random rnd;
+	binary.resize(size);
+	for (size_t i = 0; i + 1 < size; ++i)
+		binary[i] = ubyte(rnd.Next() % 255 + 1);
+	binary[size - 1] = 0;
+
+	// the MS936 text of the GB2312 chars ended by a GBK one
+	static const ubyte gbk_tail[] = { 0x81, 0x80, 0x0A };
+	GenerateText(em.GetEncoding(xm::ENC_MS936), size, text, ms936_tail, &UndecidedMS936);
+	ms936_tail.insert(ms936_tail.end(), gbk_tail, gbk_tail + sizeof(gbk_tail));
+
+	// the MS932 text of the kanji also valid in EUC-JP ended by a hiragana
+	static const ubyte sjis_tail[] = { 0x82, 0xA0 };
+	GenerateText(em.GetEncoding(xm::ENC_MS932), size, text, ms932_tail, &UndecidedMS932);
+	ms932_tail.insert(ms932_tail.end(), sjis_tail, sjis_tail + sizeof(sjis_tail));
+
+	const std::string suffix = "/" + SizeName(size);
+
+	CheckCase isutf8(&xm::IsUTF8, utf8);
+	runner.Run("IsUTF8/UTF-8" + suffix, utf8.size(), isutf8);
+	CheckCase isutf8_bad(&xm::IsUTF8, bad_utf8);
+	runner.Run("IsUTF8/invalid-tail" + suffix, bad_utf8.size(), isutf8_bad);
+
+	CheckCase binary_text(&IsBinaryData, utf8);
+	runner.Run("IsBinaryData/UTF-8" + suffix, utf8.size(), binary_text);
+	CheckCase binary_data(&IsBinaryData, binary);
+	runner.Run("IsBinaryData/binary" + suffix, binary.size(), binary_data);
+
+	DetectCase detect_utf8(&DetectEncodingWithUTF8, utf8);
+	runner.Run("DetectEncoding/UTF-8" + suffix, utf8.size(), detect_utf8);
+	DetectCase detect_936(&DetectEncodingWithUTF8, ms936);
+	runner.Run("DetectEncoding/MS936" + suffix, ms936.size(), detect_936);
+	DetectCase detect_932(&DetectEncodingWithUTF8, ms932);
+	runner.Run("DetectEncoding/MS932" + suffix, ms932.size(), detect_932);
+
+	DetectCase chinese_936(&DetectChineseEncoding, ms936_tail);
+	runner.Run("DetectChineseEncoding/MS936" + suffix, ms936_tail.size(), chinese_936);
+	DetectCase chinese_950(&DetectChineseEncoding, ms950);
+	runner.Run("DetectChineseEncoding/MS950" + suffix, ms950.size(), chinese_950);
+
+	DetectCase japanese(&DetectJapaneseEncoding, ms932_tail);
+	runner.Run("DetectJapaneseEncoding/MS932" + suffix, ms932_tail.size(), japanese);
+}
+
+} // anonymous namespace
+
+void bench_encoding(Runner& runner)
+{
+	xm::EncodingManager::Instance().InitEncodings();
+
+	const std::vector<size_t>& sizes = runner.Sizes();
+	for (size_t i = 0; i < sizes.size(); ++i)
+	{
+		BenchEncodings(runner, sizes[i]);
+		BenchDetection(runner, sizes[i]);
+	}
+}
+
+} // namespace bench
@@ -0,0 +1,536 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Undo Buffer Test
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "../document_test.h"
+#include "../../src/wxmedit/wxm_undo.h"
+
+#define BOOST_TEST_INCLUDED
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+wxString WriteTempFile(const std::string &content)
+{
+	wxString name = wxFileName::CreateTempFileName(wxT("wxmtest"));
+	wxFile file(name, wxFile::write);
+	file.Write(content.data(), content.size());
+	return name;
+}
+
+std::string ReadBlocks(xm::BlockVector *blocks)
+{
+	std::string s;
+	for(size_t i=0; i<blocks->size(); ++i)
+	{
+		MadBlock &blk = (*blocks)[i];
+		std::vector<wxByte> buf(size_t(blk.m_Size));
+		blk.m_Data->Get(blk.m_Pos, &buf[0], buf.size());
+		s.append(buf.begin(), buf.end());
+	}
+	return s;
+}
+
+bool RefersTo(xm::BlockVector *blocks, MadInData *data)
+{
+	for(size_t i=0; i<blocks->size(); ++i)
+	{
+		if((*blocks)[i].m_Data == data)
+			return true;
+	}
+	return false;
+}
+
+const std::string old_content = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// the document deleted [10,20) and overwrote [30,40) by "XY" before saving,
+// the new file is old[0,10) + old[20,30) + "XY" + old[40,62)
+const std::string new_content = old_content.substr(0, 10) + old_content.substr(20, 10)
+	+ "XY" + old_content.substr(40);
+
+std::vector<MadSaveMapping> SaveMappings()
+{
+	std::vector<MadSaveMapping> mappings;
+	mappings.push_back(MadSaveMapping(0, 10, 0));
+	mappings.push_back(MadSaveMapping(20, 10, 10));
+	mappings.push_back(MadSaveMapping(40, 22, 22));
+	return mappings;
+}
+
+// the undos of the edits above, and of an insertion restored from the old file
+void AddUndos(MadUndoBuffer &ub, MadFileData *fd, MadMemData *md)
+{
+	MadDeleteUndoData *dudata = new MadDeleteUndoData;
+	dudata->m_Pos = 10;
+	dudata->m_Size = 10;
+	dudata->m_Data.push_back(MadBlock(fd, 10, 10));
+	ub.Add()->m_Undos.push_back(dudata);
+
+	wxByte xy[] = { 'X', 'Y' };
+	MadOverwriteUndoData *oudata = new MadOverwriteUndoData;
+	oudata->m_Pos = 20;
+	oudata->m_DelSize = 10;
+	oudata->m_DelData.push_back(MadBlock(fd, 30, 10));
+	oudata->m_InsSize = 2;
+	oudata->m_InsData.push_back(MadBlock(md, md->Put(xy, 2), 2));
+	ub.Add()->m_Undos.push_back(oudata);
+
+	MadInsertUndoData *iudata = new MadInsertUndoData;
+	iudata->m_Pos = 25;
+	iudata->m_Size = 15;
+	iudata->m_Data.push_back(MadBlock(fd, 5, 5));
+	iudata->m_Data.push_back(MadBlock(fd, 45, 10));
+	ub.Add()->m_Undos.push_back(iudata);
+}
+
+// the undo of deleting bytes at pos
+void AddDeleteUndo(MadUndoBuffer &ub, MadMemData &md, wxFileOffset pos, const std::string &bytes)
+{
+	MadDeleteUndoData *dudata = new MadDeleteUndoData;
+	dudata->m_Pos = pos;
+	dudata->m_Size = wxFileOffset(bytes.size());
+	dudata->m_Data.push_back(MadBlock(&md, md.Put((wxByte*)bytes.data(), bytes.size()), bytes.size()));
+	ub.Add()->m_Undos.push_back(dudata);
+}
+
+wxString MakeJournalDir()
+{
+	wxString jdir = wxFileName::CreateTempFileName(wxT("wxmtest"));
+	wxRemoveFile(jdir);
+	jdir += wxFileName::GetPathSeparator();
+	MadUndoBuffer::SetJournalDir(jdir);
+	return jdir;
+}
+
+} // namespace
+
+void test_undo_remap_after_save()
+{
+	wxString oldname = WriteTempFile(old_content);
+	wxString newname = WriteTempFile(new_content);
+
+	MadMemData md;
+	MadFileData *oldfd = new MadFileData(oldname);
+	MadFileData *newfd = new MadFileData(newname);
+	BOOST_REQUIRE(oldfd->OpenSuccess() && newfd->OpenSuccess());
+
+	MadUndoBuffer ub(&md);
+	AddUndos(ub, oldfd, &md);
+
+	ub.RemapFileBlocks(oldfd, newfd, SaveMappings());
+
+	// the old file is replaced by the saved one
+	delete oldfd;
+	wxRemoveFile(oldname);
+
+	MadUndo *undo = ub.Undo(false);
+	BOOST_REQUIRE(undo != nullptr);
+	xm::BlockVector *ins = undo->m_Undos[0]->InsData();
+	BOOST_CHECK(!RefersTo(ins, oldfd));
+	BOOST_CHECK(RefersTo(ins, newfd));
+	BOOST_CHECK_EQUAL(ReadBlocks(ins), old_content.substr(5, 5) + old_content.substr(45, 10));
+
+	undo = ub.Undo(false);
+	BOOST_REQUIRE(undo != nullptr);
+	BOOST_CHECK_EQUAL(ReadBlocks(undo->m_Undos[0]->DelData()), old_content.substr(30, 10));
+	BOOST_CHECK_EQUAL(ReadBlocks(undo->m_Undos[0]->InsData()), std::string("XY"));
+
+	undo = ub.Undo(false);
+	BOOST_REQUIRE(undo != nullptr);
+	xm::BlockVector *del = undo->m_Undos[0]->DelData();
+	BOOST_CHECK(!RefersTo(del, oldfd));
+	BOOST_CHECK_EQUAL(ReadBlocks(del), old_content.substr(10, 10));
+
+	BOOST_CHECK(ub.Undo(false) == nullptr);
+
+	ub.Clear();
+	delete newfd;
+	wxRemoveFile(newname);
+}
+
+void test_undo_remap_back()
+{
+	wxString oldname = WriteTempFile(old_content);
+	wxString newname = WriteTempFile(new_content);
+
+	MadMemData md;
+	MadFileData *oldfd = new MadFileData(oldname);
+	MadFileData *newfd = new MadFileData(newname);
+	BOOST_REQUIRE(oldfd->OpenSuccess() && newfd->OpenSuccess());
+
+	MadUndoBuffer ub(&md);
+	AddUndos(ub, oldfd, &md);
+
+	// the saved file can't replace the old one, so the blocks refer to the old file again
+	std::vector<MadSaveMapping> mappings = SaveMappings();
+	ub.RemapFileBlocks(oldfd, newfd, mappings);
+	ub.RemapFileBlocks(newfd, oldfd, InvertSaveMappings(mappings));
+
+	delete newfd;
+	wxRemoveFile(newname);
+
+	MadUndo *undo = ub.Undo(false);
+	BOOST_REQUIRE(undo != nullptr);
+	xm::BlockVector *ins = undo->m_Undos[0]->InsData();
+	BOOST_CHECK(!RefersTo(ins, newfd));
+	BOOST_CHECK(RefersTo(ins, oldfd));
+	BOOST_CHECK_EQUAL(ReadBlocks(ins), old_content.substr(5, 5) + old_content.substr(45, 10));
+
+	undo = ub.Undo(false);
+	BOOST_REQUIRE(undo != nullptr);
+	BOOST_CHECK_EQUAL(ReadBlocks(undo->m_Undos[0]->DelData()), old_content.substr(30, 10));
+
+	undo = ub.Undo(false);
+	BOOST_REQUIRE(undo != nullptr);
+	BOOST_CHECK_EQUAL(ReadBlocks(undo->m_Undos[0]->DelData()), old_content.substr(10, 10));
+
+	ub.Clear();
+	delete oldfd;
+	wxRemoveFile(oldname);
+}
+
+void test_undo_memory_limit()
+{
+	const size_t limit = 1024 * 1024;
+	const size_t chunk = 64 * 1024;
+	const size_t count = 256;
+	// the bytes in use may be split into partially used buffers
+	const size_t buffered = limit + 2 * BUFFER_SIZE;
+
+	MadMemData md;
+	MadUndoBuffer ub(&md);
+	ub.SetMemoryLimit(limit, false);
+
+	// every undo keeps a chunk of deleted bytes, which are not in the lines
+	std::vector<xm::BlockVector*> noblocks;
+	std::vector<wxByte> bytes(chunk);
+	for(size_t i=0; i<count; ++i)
+	{
+		std::fill(bytes.begin(), bytes.end(), wxByte(i));
+
+		MadDeleteUndoData *dudata = new MadDeleteUndoData;
+		dudata->m_Pos = 0;
+		dudata->m_Size = chunk;
+		dudata->m_Data.push_back(MadBlock(&md, md.Put(&bytes[0], chunk), chunk));
+		ub.Add()->m_Undos.push_back(dudata);
+
+		BOOST_CHECK_LE(ub.GetMemorySize(), limit);
+		if(ub.NeedCompacting())
+		{
+			while(ub.CompactMemData(noblocks))
+				;
+			BOOST_CHECK_LE(md.GetBufferedSize(), buffered);
+		}
+	}
+
+	while(ub.CompactMemData(noblocks))
+		;
+	BOOST_CHECK_LE(md.GetBufferedSize(), buffered);
+
+	// undoing reloads the spilled data, redoing evicts them again
+	for(size_t cycle=0; cycle<3; ++cycle)
+	{
+		for(size_t i=count; i-->0; )
+		{
+			MadUndo *undo = ub.Undo(false);
+			BOOST_REQUIRE(undo != nullptr);
+			std::fill(bytes.begin(), bytes.end(), wxByte(i));
+			BOOST_CHECK(ReadBlocks(undo->m_Undos[0]->DelData()) == std::string(bytes.begin(), bytes.end()));
+		}
+
+		while(ub.Redo(false) != nullptr)
+			;
+
+		BOOST_CHECK_LE(ub.GetMemorySize(), limit);
+		while(ub.CompactMemData(noblocks))
+			;
+		BOOST_CHECK_LE(md.GetBufferedSize(), buffered);
+	}
+}
+
+void test_undo_memory_pinned()
+{
+	const size_t limit = 1024 * 1024;
+	const size_t chunk = 64 * 1024;
+	const size_t count = 64;
+
+	MadMemData md;
+	MadUndoBuffer ub(&md);
+	ub.SetMemoryLimit(limit, false);
+
+	// the inserted bytes are in the lines, the undos don't pin them
+	std::vector<wxByte> bytes(chunk, wxByte('a'));
+	for(size_t i=0; i<count; ++i)
+	{
+		MadInsertUndoData *iudata = new MadInsertUndoData;
+		iudata->m_Pos = wxFileOffset(i * chunk);
+		iudata->SetInsBlock(MadBlock(&md, md.Put(&bytes[0], chunk), chunk));
+		ub.Add()->m_Undos.push_back(iudata);
+	}
+	ub.FlushPending();
+	BOOST_CHECK_LT(ub.GetMemorySize(), chunk);
+
+	// an undone insertion pins its bytes until it's redone
+	BOOST_REQUIRE(ub.Undo(false) != nullptr);
+	BOOST_CHECK_GE(ub.GetMemorySize(), chunk);
+	BOOST_REQUIRE(ub.Redo(false) != nullptr);
+	BOOST_CHECK_LT(ub.GetMemorySize(), chunk);
+
+	// all the undos are kept in memory
+	for(size_t i=0; i<count; ++i)
+		BOOST_REQUIRE(ub.Undo(false) != nullptr);
+	BOOST_CHECK(ub.Undo(false) == nullptr);
+}
+
+void test_memdata_compact_steps()
+{
+	const size_t chunk = BUFFER_SIZE / 4;
+	const size_t count = 64;
+
+	MadMemData md;
+	std::vector<xm::BlockVector> blocks(count);
+	for(size_t i=0; i<count; ++i)
+	{
+		std::vector<wxByte> bytes(chunk, wxByte(i));
+		blocks[i].push_back(MadBlock(&md, md.Put(&bytes[0], chunk), chunk));
+	}
+
+	// keep one chunk of every buffer
+	std::vector<xm::BlockVector*> inuse;
+	for(size_t i=0; i<count; i+=4)
+		inuse.push_back(&blocks[i]);
+
+	// at most 2 chunks are moved in a step
+	size_t steps = 0;
+	while(md.Compact(inuse, 2 * chunk))
+		++steps;
+	BOOST_CHECK_GE(steps, count / 4 / 2 - 1);
+	BOOST_CHECK_LE(md.GetBufferedSize(), (count / 4 / 4 + 2) * size_t(BUFFER_SIZE));
+
+	for(size_t i=0; i<count; i+=4)
+		BOOST_CHECK(ReadBlocks(&blocks[i]) == std::string(chunk, char(i)));
+}
+
+void test_undo_journal()
+{
+	wxString docname = WriteTempFile(old_content);
+	wxString jdir = wxFileName::CreateTempFileName(wxT("wxmtest"));
+	wxRemoveFile(jdir);
+	jdir += wxFileName::GetPathSeparator();
+	MadUndoBuffer::SetJournalDir(jdir);
+
+	// a small undo is batched, a large one is written to the journal directly
+	std::vector<std::string> deleted;
+	deleted.push_back(std::string(100, 's'));
+	deleted.push_back(std::string(200 * 1024, 'L'));
+	deleted.push_back(std::string(10, 't'));
+
+	wxUint64 hash, content;
+	wxFileOffset size;
+	BOOST_REQUIRE(MadUndoBuffer::HashFileIdentity(docname, hash, size));
+	BOOST_CHECK_EQUAL(size, wxFileOffset(old_content.size()));
+	BOOST_REQUIRE(MadUndoBuffer::HashFileContent(docname, content));
+
+	// the content hash is computed from the bytes written by saving
+	MadContentHash written;
+	written.Update((const wxByte *)old_content.data(), 10);
+	written.Update((const wxByte *)old_content.data() + 10, old_content.size() - 10);
+	BOOST_CHECK(written.GetHash() == content);
+
+	{
+		MadMemData md;
+		MadUndoBuffer ub(&md);
+		BOOST_CHECK(!ub.OpenJournal(docname, hash, size));
+		BOOST_REQUIRE(ub.IsJournaling());
+
+		for(size_t i=0; i<deleted.size(); ++i)
+		{
+			std::vector<wxByte> bytes(deleted[i].begin(), deleted[i].end());
+			MadDeleteUndoData *dudata = new MadDeleteUndoData;
+			dudata->m_Pos = wxFileOffset(i);
+			dudata->m_Size = wxFileOffset(bytes.size());
+			dudata->m_Data.push_back(MadBlock(&md, md.Put(&bytes[0], bytes.size()), bytes.size()));
+			ub.Add()->m_Undos.push_back(dudata);
+		}
+
+		ub.JournalSavePoint(docname, ub.GetPrevUndo(), hash, size, content);
+		BOOST_CHECK(ub.IsJournaling());
+		ub.Clear();
+	}
+
+	wxUint64 hash2;
+	wxFileOffset size2;
+	BOOST_REQUIRE(MadUndoBuffer::HashFileIdentity(docname, hash2, size2));
+	BOOST_CHECK(hash2 == hash && size2 == size);
+
+	MadMemData md;
+	MadUndoBuffer ub(&md);
+	BOOST_REQUIRE(ub.OpenJournal(docname, hash, size));
+	for(size_t i=deleted.size(); i-->0; )
+	{
+		MadUndo *undo = ub.Undo(false);
+		BOOST_REQUIRE(undo != nullptr);
+		BOOST_CHECK_EQUAL(undo->m_Undos[0]->m_Pos, wxFileOffset(i));
+		BOOST_CHECK(ReadBlocks(undo->m_Undos[0]->DelData()) == deleted[i]);
+	}
+	BOOST_CHECK(ub.Undo(false) == nullptr);
+
+	ub.Clear();
+	wxRemoveFile(MadUndoBuffer::GetJournalName(docname));
+	wxRmdir(jdir);
+	wxRemoveFile(docname);
+}
+
+void test_undo_journal_compacting()
+{
+	wxString docname = WriteTempFile(old_content);
+	wxString jdir = MakeJournalDir();
+	wxString jname = MadUndoBuffer::GetJournalName(docname);
+
+	wxUint64 hash, content;
+	wxFileOffset size;
+	BOOST_REQUIRE(MadUndoBuffer::HashFileIdentity(docname, hash, size));
+	BOOST_REQUIRE(MadUndoBuffer::HashFileContent(docname, content));
+
+	std::vector<std::string> deleted;
+	for(size_t i=0; i<6; ++i)
+		deleted.push_back(std::string(200 * 1024, char('a' + i)));
+
+	{
+		MadMemData md;
+		MadUndoBuffer ub(&md);
+		BOOST_CHECK(!ub.OpenJournal(docname, hash, size));
+		BOOST_REQUIRE(ub.IsJournaling());
+
+		for(size_t i=0; i<deleted.size(); ++i)
+			AddDeleteUndo(ub, md, wxFileOffset(i), deleted[i]);
+
+		// the last 3 undos are cleared by a new one
+		for(size_t i=0; i<3; ++i)
+			BOOST_REQUIRE(ub.Undo(false) != nullptr);
+		deleted.resize(3);
+		deleted.push_back("new");
+		AddDeleteUndo(ub, md, 3, deleted.back());
+		ub.FlushPending();
+
+		wxFileOffset before = wxFile(jname).Length();
+		BOOST_CHECK_GT(before, wxFileOffset(1200 * 1024));
+
+		ub.JournalSavePoint(docname, ub.GetPrevUndo(), hash, size, content);
+		BOOST_CHECK(ub.IsJournaling());
+		BOOST_CHECK_LT(wxFile(jname).Length(), wxFileOffset(700 * 1024));
+
+		// the undos reloaded from the compacted journal
+		BOOST_REQUIRE(ub.Undo(false) != nullptr);
+		ub.Redo(false);
+		ub.Clear();
+	}
+
+	MadMemData md;
+	MadUndoBuffer ub(&md);
+	BOOST_REQUIRE(ub.OpenJournal(docname, hash, size));
+	for(size_t i=deleted.size(); i-->0; )
+	{
+		MadUndo *undo = ub.Undo(false);
+		BOOST_REQUIRE(undo != nullptr);
+		BOOST_CHECK_EQUAL(undo->m_Undos[0]->m_Pos, wxFileOffset(i));
+		BOOST_CHECK(ReadBlocks(undo->m_Undos[0]->DelData()) == deleted[i]);
+	}
+	BOOST_CHECK(ub.Undo(false) == nullptr);
+
+	ub.Clear();
+	wxRemoveFile(jname);
+	wxRmdir(jdir);
+	wxRemoveFile(docname);
+}
+
+void test_undo_journal_content()
+{
+	wxString docname = WriteTempFile(old_content);
+	wxString jdir = MakeJournalDir();
+	wxString jname = MadUndoBuffer::GetJournalName(docname);
+
+	wxUint64 hash, content;
+	wxFileOffset size;
+	BOOST_REQUIRE(MadUndoBuffer::HashFileIdentity(docname, hash, size));
+	BOOST_REQUIRE(MadUndoBuffer::HashFileContent(docname, content));
+
+	// the identity matches the file, but the content saved was another one
+	{
+		MadMemData md;
+		MadUndoBuffer ub(&md);
+		BOOST_CHECK(!ub.OpenJournal(docname, hash, size));
+		BOOST_REQUIRE(ub.IsJournaling());
+		AddDeleteUndo(ub, md, 0, "abc");
+		ub.JournalSavePoint(docname, ub.GetPrevUndo(), hash, size, content ^ 1);
+		ub.Clear();
+	}
+
+	{
+		MadMemData md;
+		MadUndoBuffer ub(&md);
+		BOOST_CHECK(!ub.OpenJournal(docname, hash, size));
+		BOOST_CHECK(ub.Undo(false) == nullptr);
+		ub.Clear();
+	}
+
+	wxRemoveFile(jname);
+	wxRmdir(jdir);
+	wxRemoveFile(docname);
+}
+
+void test_undo_journal_lock_and_prune()
+{
+	wxString docname = WriteTempFile(old_content);
+	wxString deletedname = WriteTempFile(old_content);
+	wxString jdir = MakeJournalDir();
+
+	wxUint64 hash;
+	wxFileOffset size;
+	BOOST_REQUIRE(MadUndoBuffer::HashFileIdentity(docname, hash, size));
+
+	MadMemData md;
+	MadUndoBuffer ub(&md);
+	ub.OpenJournal(docname, hash, size);
+	BOOST_REQUIRE(ub.IsJournaling());
+	AddDeleteUndo(ub, md, 0, "abc");
+
+	// the journal is written by one undo buffer at a time
+	{
+		MadMemData md2;
+		MadUndoBuffer ub2(&md2);
+		BOOST_CHECK(!ub2.OpenJournal(docname, hash, size));
+		BOOST_CHECK(!ub2.IsJournaling());
+	}
+
+	// the journal of a deleted file
+	{
+		MadMemData md2;
+		MadUndoBuffer ub2(&md2);
+		BOOST_REQUIRE(MadUndoBuffer::HashFileIdentity(deletedname, hash, size));
+		ub2.OpenJournal(deletedname, hash, size);
+		BOOST_REQUIRE(ub2.IsJournaling());
+		AddDeleteUndo(ub2, md2, 0, "def");
+		ub2.Clear();
+	}
+	wxRemoveFile(deletedname);
+	wxRemoveFile(docname);
+
+	// the locked journal is kept even if its file is deleted
+	MadUndoBuffer::PruneJournals();
+	BOOST_CHECK(!wxFileExists(MadUndoBuffer::GetJournalName(deletedname)));
+	BOOST_CHECK(wxFileExists(MadUndoBuffer::GetJournalName(docname)));
+
+	ub.Clear();
+	MadUndoBuffer::PruneJournals();
+	BOOST_CHECK(!wxFileExists(MadUndoBuffer::GetJournalName(docname)));
+
+	wxRmdir(jdir);
+}
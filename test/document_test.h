@@ -0,0 +1,20 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Document Test Utils
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#ifndef WXMEDIT_DOCUMENT_TEST_H
+#define WXMEDIT_DOCUMENT_TEST_H
+
+void test_undo_remap_after_save();
+void test_undo_remap_back();
+void test_undo_memory_limit();
+void test_undo_memory_pinned();
+void test_memdata_compact_steps();
+void test_undo_journal();
+void test_undo_journal_compacting();
+void test_undo_journal_content();
+void test_undo_journal_lock_and_prune();
+
+#endif //WXMEDIT_DOCUMENT_TEST_H
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Byte Statistics Test
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "../encdet_test.h"
+#include "../../src/xm/encdet.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+const std::string han = "\xE4\xB8\xAD"; // U+4E2D in UTF-8
+
+bool IsASCII(const std::string& s)
+{
+	return xm::IsASCII((const ubyte*)s.data(), s.size());
+}
+
+} // anonymous namespace
+
+void test_encdet_byte_stats()
+{
+	std::cout << "wxMEdit-encdet-byte-stats" << std::endl;
+
+	xm::ByteStats empty;
+	empty.Scan((const ubyte*)"", 0);
+	BOOST_CHECK(empty.IsASCII() && !empty.IsBinary());
+
+	// the bytes counted in the words and after them, by one pass or by blocks
+	std::string data = std::string(13, 'a') + "\t\r\n" + han + std::string(9, 'b') + '\0'
+		+ "\x7F\x01" + std::string(20, 'c') + han + '\0' + "\xFF\rdd\n\r";
+	for (size_t block = 1; block <= data.size(); ++block)
+	{
+		xm::ByteStats stats;
+		for (size_t pos = 0; pos < data.size(); pos += block)
+			stats.Scan((const ubyte*)data.data() + pos, std::min(block, data.size() - pos));
+
+		BOOST_CHECK_MESSAGE(stats.nuls == 2, "blocks of " << block);
+		BOOST_CHECK_MESSAGE(stats.crs == 3, "blocks of " << block);
+		BOOST_CHECK_MESSAGE(stats.lfs == 2, "blocks of " << block);
+		BOOST_CHECK_MESSAGE(stats.crlfs == 1, "blocks of " << block);
+		BOOST_CHECK_MESSAGE(stats.highbits == 7, "blocks of " << block);
+		BOOST_CHECK(!stats.IsASCII() && stats.IsBinary());
+	}
+
+	// the control bytes and DEL are ASCII
+	std::string ascii = std::string(30, 'a') + "\x01\x1F\x7F\t\r\n" + std::string(7, 'b');
+	xm::ByteStats stats;
+	stats.Scan((const ubyte*)ascii.data(), ascii.size());
+	BOOST_CHECK(stats.nuls == 0 && stats.highbits == 0);
+	BOOST_CHECK(stats.crs == 1 && stats.lfs == 1 && stats.crlfs == 1);
+	BOOST_CHECK(stats.IsASCII() && !stats.IsBinary());
+	BOOST_CHECK(stats.IsASCII() == IsASCII(ascii));
+
+	// a NUL alone is binary but not ASCII
+	std::string nul = std::string(16, 'a') + '\0' + std::string(16, 'a');
+	stats = xm::ByteStats();
+	stats.Scan((const ubyte*)nul.data(), nul.size());
+	BOOST_CHECK(stats.nuls == 1 && stats.highbits == 0);
+	BOOST_CHECK(!stats.IsASCII() && stats.IsBinary());
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Encoding Detection Test of the Reused Detector
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "data_from_icudet.h"
+#include "../encdet_test.h"
+#include "test_detenc.h"
+#include "../../src/xm/encdet.h"
+
+#include <boost/foreach.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static xm::EncodingID detect_encoding(const std::string& text, bool skip_utf8, xm::CharsetDetector& detector)
+{
+	xm::EncodingID enc = xm::ENC_DEFAULT;
+	xm::DetectEncoding((const ubyte*)text.data(), text.size(), enc, skip_utf8, detector);
+	return enc;
+}
+
+// a detector reused by the texts of all the lengths and the encodings, in
+// both orders, detects every text like a fresh one
+void test_encdet_detector_reuse()
+{
+	std::cout << "wxMEdit-encdet-detector-reuse" << std::endl;
+
+	std::vector<std::string> texts;
+	BOOST_FOREACH(const ICUEncDetTestCase& tcase, data_icudet_tests)
+	{
+		std::vector<std::string> tenclangs;
+		boost::algorithm::split(tenclangs, tcase._encs, boost::algorithm::is_any_of(" "));
+		BOOST_FOREACH(const std::string& tenclang, tenclangs)
+		{
+			std::string text;
+			if (javaesc_to_enc(text, tcase._text, tenclang.substr(0, tenclang.find('/'))))
+				texts.push_back(text);
+		}
+	}
+	BOOST_REQUIRE(!texts.empty());
+
+	for (int skip_utf8 = 0; skip_utf8 < 2; ++skip_utf8)
+	{
+		std::vector<xm::EncodingID> fresh;
+		BOOST_FOREACH(const std::string& text, texts)
+		{
+			xm::CharsetDetector detector;
+			fresh.push_back(detect_encoding(text, skip_utf8 != 0, detector));
+		}
+
+		xm::CharsetDetector reused;
+		for (size_t i = 0; i < texts.size(); ++i)
+			BOOST_CHECK(detect_encoding(texts[i], skip_utf8 != 0, reused) == fresh[i]);
+		for (size_t i = texts.size(); i > 0; --i)
+			BOOST_CHECK(detect_encoding(texts[i - 1], skip_utf8 != 0, reused) == fresh[i - 1]);
+	}
+}
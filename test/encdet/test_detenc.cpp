@@ -70,7 +70,8 @@ void test_detenc(const std::string& text, const std::string& enc)
 	}
 	else
 	{
-		xm::DetectEncoding(btext, text.size(), detencid, true);
+		static xm::CharsetDetector detector;
+		xm::DetectEncoding(btext, text.size(), detencid, true, detector);
 
 		// use GB18030      instead of detected encoding MS936
 		if (detencid == xm::ENC_MS936)
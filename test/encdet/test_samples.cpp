@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Encoding Detection Sampling Test
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "../encdet_test.h"
+#include "../../src/xm/encdet.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const std::string han = "\xE4\xB8\xAD"; // U+4E2D in UTF-8
+
+bool IsASCII(const std::string& s)
+{
+	return xm::IsASCII((const ubyte*)s.data(), s.size());
+}
+
+bool IsUTF8(const std::string& s)
+{
+	return xm::IsUTF8((const ubyte*)s.data(), s.size());
+}
+
+std::string Samples(const std::string& data, size_t headsize)
+{
+	std::vector<ubyte> samples;
+	xm::ReadDetectingSamples(samples, [&data](uint64_t pos, ubyte* buf, size_t len) -> size_t
+	{
+		if (pos >= data.size())
+			return 0;
+		size_t n = std::min(len, size_t(data.size() - pos));
+		memcpy(buf, data.data() + pos, n);
+		return n;
+	}, data.size(), headsize);
+
+	return std::string(samples.begin(), samples.end());
+}
+
+} // anonymous namespace
+
+void test_encdet_ascii()
+{
+	std::cout << "wxMEdit-encdet-ASCII" << std::endl;
+
+	// the lengths cover the words and the bytes after them
+	for (size_t len = 0; len <= 20; ++len)
+	{
+		std::string txt(len, 'a');
+		BOOST_CHECK(IsASCII(txt));
+
+		for (size_t i = 0; i < len; ++i)
+		{
+			std::string high = txt;
+			high[i] = '\x80';
+			BOOST_CHECK_MESSAGE(!IsASCII(high), "0x80 at " << i << " of " << len);
+
+			std::string nul = txt;
+			nul[i] = '\0';
+			BOOST_CHECK_MESSAGE(!IsASCII(nul), "NUL at " << i << " of " << len);
+		}
+	}
+}
+
+void test_encdet_utf8_validation()
+{
+	std::cout << "wxMEdit-encdet-UTF8-validation" << std::endl;
+
+	// UTF-8 needs a non-ASCII char
+	BOOST_CHECK(!IsUTF8(std::string(20, 'a')));
+
+	// a char across every position of the words, and after them
+	for (size_t i = 0; i <= 20; ++i)
+	{
+		std::string txt = std::string(i, 'a') + han + std::string(20 - i, 'b');
+		BOOST_CHECK_MESSAGE(IsUTF8(txt), "U+4E2D at " << i);
+
+		std::string bad = txt;
+		bad[i + 1] = 'x';
+		BOOST_CHECK_MESSAGE(!IsUTF8(bad), "broken U+4E2D at " << i);
+	}
+
+	// an ASCII head with a non-ASCII tail
+	std::string head(4096, 'a');
+	BOOST_CHECK(IsUTF8(head + han));
+	BOOST_CHECK(!IsUTF8(head + "\xFF"));
+	BOOST_CHECK(!IsUTF8(head + han + "\xC0\xAF"));
+
+	// a truncated trailing sequence
+	BOOST_CHECK(!IsUTF8(head + han + han.substr(0, 2)));
+	BOOST_CHECK(!IsUTF8(head + han + "\xF0\xA0\x80"));
+	BOOST_CHECK(IsUTF8(head + han + "\xF0\xA0\x80\x80"));
+}
+
+void test_encdet_samples()
+{
+	std::cout << "wxMEdit-encdet-samples" << std::endl;
+
+	// no more data after the head
+	BOOST_CHECK(Samples(std::string(100, 'a'), 100).empty());
+	BOOST_CHECK(Samples(std::string(100, 'a'), 200).empty());
+
+	// a small rest is read whole, the char cut by the head is skipped
+	std::string small = std::string(4, 'a') + han + "bbb" + han;
+	BOOST_CHECK(Samples(small, 4) == han + "bbb" + han);
+	BOOST_CHECK(Samples(small, 5) == "bbb" + han);
+	BOOST_CHECK(Samples(small, 6) == "bbb" + han);
+	BOOST_CHECK(Samples(small, 7) == "bbb" + han);
+
+	// the end of the file cuts nothing, a truncated trailing sequence is kept
+	std::string truncated = std::string(4, 'a') + han + han.substr(0, 2);
+	BOOST_CHECK(Samples(truncated, 4) == han + han.substr(0, 2));
+	BOOST_CHECK(!IsUTF8(Samples(truncated, 4)));
+
+	// an ASCII head with a non-ASCII tail, the head and the samples of the big
+	// rest cut inside the 3-byte chars
+	std::string head(64 * 1024, 'a');
+	std::string tail;
+	while (tail.size() < 1024 * 1024)
+		tail += "x" + han + han;
+	BOOST_CHECK(IsASCII(head));
+
+	for (size_t headsize = head.size(); headsize < head.size() + 4; ++headsize)
+	{
+		std::string data = head + tail;
+		std::string samples = Samples(data, headsize);
+		BOOST_CHECK(!samples.empty());
+		BOOST_CHECK(samples.size() <= 8 * 4096);
+		BOOST_CHECK_MESSAGE(IsUTF8(samples), "head of " << headsize);
+		BOOST_CHECK(samples.compare(samples.size() - 3, 3, han) == 0);
+
+		// a truncated sequence at the end of the file stays in the last sample
+		data += han.substr(0, 1);
+		samples = Samples(data, headsize);
+		BOOST_CHECK(!IsUTF8(samples));
+		BOOST_CHECK(IsUTF8(samples.substr(0, samples.size() - 1)));
+	}
+}
@@ -15,5 +15,10 @@ void test_encdet_wxmedit_utf16();
 void test_encdet_wxmedit_utf8();
 void test_encdet_wxmedit_bom();
 void test_encdet_wxmedit_iso646();
+void test_encdet_ascii();
+void test_encdet_utf8_validation();
+void test_encdet_samples();
+void test_encdet_byte_stats();
+void test_encdet_detector_reuse();
 
 #endif //WXMEDIT_ENCEET_TEST_H
@@ -7,11 +7,14 @@
 #include "data_multibyte_conv.h"
 #include "../encoding_test.h"
 #include "../../src/xm/encoding/encoding.h"
+#include "../../src/xm/encoding/gb18030.h"
 
 #define BOOST_TEST_INCLUDED
 #include <boost/test/unit_test.hpp>
 
 #include <iostream>
+#include <vector>
+#include <string.h>
 
 void data_gb18030_conv_init()
 {
@@ -176,3 +179,50 @@ void test_gb18030_conv()
 
 	xm::EncodingManager::Instance().FreeEncodings();
 }
+
+// the workers share an encoding after its tables are filled, so decoding
+// every BMP char must not write the encoding any more
+void test_gb18030_filled_tables()
+{
+	// a fresh GB18030 with nothing cached
+	xm::EncodingManager::Instance().FreeEncodings();
+	xm::EncodingManager::Instance().InitEncodings();
+
+	std::cout << "wxMEdit-enc-GB18030-filled-tables" << std::endl;
+
+	xm::Encoding* enc = xm::EncodingManager::Instance().GetEncoding(xm::ENC_GB18030);
+	xm::EncodingGB18030* gb = dynamic_cast<xm::EncodingGB18030*>(enc);
+	BOOST_REQUIRE(gb != nullptr);
+
+	enc->FillDecodingTables();
+
+	const char* obj = (const char*)gb;
+	std::vector<char> filled(obj, obj + sizeof(xm::EncodingGB18030));
+
+	for (size_t i=0x81; i<=0xFE; ++i)
+	{
+		for (size_t j=0x40; j<=0xFE; ++j)
+		{
+			ubyte bs[3] = { ubyte(i), ubyte(j), 0 };
+			enc->MultiBytetoUCS4(bs);
+		}
+	}
+	for (size_t i=0x81; i<0x90; ++i)
+	{
+		for (size_t j=0x30; j<=0x39; ++j)
+		{
+			for (size_t k=0x81; k<=0xFE; ++k)
+			{
+				for (size_t l=0x30; l<=0x39; ++l)
+				{
+					ubyte bs[4] = { ubyte(i), ubyte(j), ubyte(k), ubyte(l) };
+					enc->MultiBytetoUCS4(bs);
+				}
+			}
+		}
+	}
+
+	BOOST_CHECK(memcmp(&filled[0], obj, filled.size()) == 0);
+
+	xm::EncodingManager::Instance().FreeEncodings();
+}
@@ -14,6 +14,7 @@ void test_doublebyte_conv();
 void data_doublebyte_conv_init();
 
 void test_gb18030_conv();
+void test_gb18030_filled_tables();
 void data_gb18030_conv_init();
 
 #endif //WXMEDIT_ENCODING_TEST_H
@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Test of Searching and Replacing in Buffers
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "../search_test.h"
+#include "../../src/wxm/buffer_searcher.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+ucs4string U(const std::string& s)
+{
+	return ucs4string(s.begin(), s.end());
+}
+
+// the found ranges as "begin-end,..."
+std::string FindText(wxm::BufferSearcher& searcher, const std::string& text, size_t from = 0,
+	bool first_only = false)
+{
+	ucs4string u = U(text);
+	std::vector<size_t> begidx, endidx;
+	int n = searcher.FindAll(u.c_str(), u.c_str() + u.size(), from, first_only, begidx, endidx);
+	if (n == SR_EXPR_ERROR)
+		return "error";
+
+	BOOST_CHECK_EQUAL(size_t(n), begidx.size());
+	BOOST_CHECK_EQUAL(begidx.size(), endidx.size());
+
+	std::string out;
+	for (size_t i = 0; i < begidx.size(); ++i)
+	{
+		if (i != 0)
+			out += ',';
+		out += std::to_string(begidx[i]) + '-' + std::to_string(endidx[i]);
+	}
+	return out;
+}
+
+} // namespace
+
+void test_buffer_searcher_literal()
+{
+	wxm::BufferSearcher searcher;
+
+	BOOST_CHECK(searcher.PrepareText(U("cat"), false, true, false, false));
+	BOOST_CHECK(!searcher.InHex());
+	BOOST_CHECK(!searcher.IsRegex());
+	BOOST_CHECK_EQUAL(FindText(searcher, "cat concat Cat cat"), "0-3,7-10,15-18");
+	BOOST_CHECK_EQUAL(FindText(searcher, "cat concat Cat cat", 1), "7-10,15-18");
+	BOOST_CHECK_EQUAL(FindText(searcher, "cat concat Cat cat", 0, true), "0-3");
+	BOOST_CHECK_EQUAL(FindText(searcher, "dog"), "");
+
+	// the expr is in normal case
+	BOOST_CHECK(searcher.PrepareText(U("cat"), false, false, false, false));
+	BOOST_CHECK_EQUAL(FindText(searcher, "cat concat Cat CAT"), "0-3,7-10,11-14,15-18");
+
+	BOOST_CHECK(searcher.PrepareText(U("cat"), false, true, true, false));
+	BOOST_CHECK_EQUAL(FindText(searcher, "cat concat cats cat."), "0-3,16-19");
+	// the chars before from are the context of the whole word
+	BOOST_CHECK_EQUAL(FindText(searcher, "concat", 3), "");
+
+	std::vector<ucs4string> factors;
+	searcher.LiteralFactors(factors);
+	BOOST_REQUIRE_EQUAL(factors.size(), 1u);
+	BOOST_CHECK(factors[0] == U("cat"));
+}
+
+void test_buffer_searcher_regex()
+{
+	wxm::BufferSearcher searcher;
+
+	BOOST_CHECK(!searcher.PrepareText(U("a(b"), true, true, false, false));
+
+	BOOST_CHECK(searcher.PrepareText(U("b+c"), true, true, false, false));
+	BOOST_CHECK(searcher.IsRegex());
+	BOOST_CHECK_EQUAL(FindText(searcher, "abbc bc c"), "1-4,5-7");
+
+	BOOST_CHECK(searcher.PrepareText(U("a.b"), true, true, false, false));
+	BOOST_CHECK(!searcher.DotMatchesNewline());
+	BOOST_CHECK_EQUAL(FindText(searcher, "a\nb axb"), "4-7");
+
+	BOOST_CHECK(searcher.PrepareText(U("a.b"), true, true, false, true));
+	BOOST_CHECK(searcher.DotMatchesNewline());
+	BOOST_CHECK_EQUAL(FindText(searcher, "a\nb axb"), "0-3,4-7");
+
+	BOOST_CHECK(searcher.PrepareText(U("abc|xyz"), true, true, false, false));
+	std::vector<ucs4string> factors;
+	searcher.LiteralFactors(factors);
+	BOOST_CHECK(factors.empty());
+}
+
+void test_buffer_searcher_partial()
+{
+	wxm::BufferSearcher searcher;
+	BOOST_CHECK(searcher.PrepareText(U("ab+c"), true, true, false, false));
+
+	ucs4string u = U("xabc abc xabb");
+	std::vector<size_t> begidx, endidx;
+	size_t partial = 0;
+	int n = searcher.FindAll(u.c_str(), u.c_str() + u.size(), 0, false, begidx, endidx, &partial);
+	// the last match may only be told by the chars after the end
+	BOOST_CHECK_EQUAL(n, 2);
+	BOOST_CHECK_EQUAL(partial, 10u);
+
+	u = U("xabc abc x");
+	n = searcher.FindAll(u.c_str(), u.c_str() + u.size(), 0, false, begidx, endidx, &partial);
+	BOOST_CHECK_EQUAL(n, 2);
+	BOOST_CHECK_EQUAL(partial, u.size());
+}
+
+void test_buffer_searcher_hex()
+{
+	wxm::BufferSearcher searcher;
+	std::vector<wxByte> hex;
+	hex.push_back(0x0D);
+	hex.push_back(0x0A);
+	searcher.PrepareHex(hex);
+	BOOST_CHECK(searcher.InHex());
+	BOOST_CHECK(!searcher.IsRegex());
+
+	const wxByte data[] = { 'a', 0x0D, 0x0A, 'b', 0x0D, 0x0D, 0x0A };
+	std::vector<size_t> begidx, endidx;
+	BOOST_CHECK_EQUAL(searcher.FindAll(data, data + sizeof(data), false, begidx, endidx), 2);
+	BOOST_REQUIRE_EQUAL(begidx.size(), 2u);
+	BOOST_CHECK_EQUAL(begidx[0], 1u);
+	BOOST_CHECK_EQUAL(endidx[0], 3u);
+	BOOST_CHECK_EQUAL(begidx[1], 5u);
+	BOOST_CHECK_EQUAL(endidx[1], 7u);
+
+	BOOST_CHECK_EQUAL(searcher.FindAll(data, data + sizeof(data), true, begidx, endidx), 1);
+}
+
+void test_buffer_searcher_replace()
+{
+	wxm::BufferSearcher searcher;
+	ucs4string out;
+
+	BOOST_CHECK(searcher.PrepareText(U("cat"), false, true, false, false));
+	BOOST_CHECK(searcher.PrepareFormat(U("$1\\n")));
+	ucs4string u = U("cat");
+	BOOST_CHECK(searcher.Replace(u.c_str(), u.c_str() + u.size(), out));
+	BOOST_CHECK(out == U("$1\\n"));
+
+	BOOST_CHECK(searcher.PrepareText(U("(\\w+)@(\\w+)"), true, true, false, false));
+	BOOST_CHECK(!searcher.PrepareFormat(U("$2\\")));
+	BOOST_CHECK(searcher.PrepareFormat(U("$2\\t$1")));
+	u = U("user@host");
+	BOOST_CHECK(searcher.Replace(u.c_str(), u.c_str() + u.size(), out));
+	BOOST_CHECK(out == U("host\tuser"));
+}
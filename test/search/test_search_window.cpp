@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Test of the Window Sliding over a Searched File
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#include "../search_test.h"
+#include "../../src/xm/search_window.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/xpressive/xpressive_dynamic.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xp = boost::xpressive;
+
+namespace
+{
+
+typedef std::vector<std::pair<size_t, size_t> > Matches;
+
+// small sizes, so the windows of the short texts are committed many times
+const size_t tail = 16;
+const size_t max_chars = 256;
+const size_t max_match = 4096;
+const size_t block = 64;
+
+xp::sregex Compile(const std::string& expr, bool dot_newline)
+{
+	xp::regex_constants::syntax_option_type opt = xp::regex_constants::ECMAScript;
+	if (!dot_newline)
+		opt = opt | xp::regex_constants::not_dot_newline;
+	return xp::sregex::compile(expr, opt);
+}
+
+// the matches in [from, end) of s, until a partial one if partial is given
+void FindAll(const std::string& s, size_t from, const xp::sregex& re, Matches& found, size_t* partial = nullptr)
+{
+	xp::regex_constants::match_flag_type flags = xp::regex_constants::match_default;
+	if (partial != nullptr)
+	{
+		*partial = s.size();
+		flags = flags | xp::regex_constants::match_partial;
+	}
+
+	xp::smatch what;
+	std::string::const_iterator it = s.begin() + from;
+	while (it < s.end() && xp::regex_search(it, s.end(), what, re, flags))
+	{
+		if (!what[0].matched)
+		{
+			*partial = size_t(what[0].first - s.begin());
+			break;
+		}
+
+		size_t beg = size_t(what[0].first - s.begin());
+		size_t end = size_t(what[0].second - s.begin());
+		found.push_back(std::make_pair(beg, end));
+		it = s.begin() + std::max(end, beg + 1);
+	}
+}
+
+Matches SearchWhole(const std::string& text, const std::string& expr, bool dot_newline)
+{
+	Matches found;
+	FindAll(text, 0, Compile(expr, dot_newline), found);
+	return found;
+}
+
+// decode a block and search the window like the workers of Find in Files
+Matches SearchSliding(const std::string& text, const std::string& expr, bool dot_newline, size_t& maxwin)
+{
+	const xp::sregex re = Compile(expr, dot_newline);
+	xm::SlidingWindow win(tail, max_chars, max_match);
+	win.regex = true;
+	win.dot_newline = dot_newline;
+
+	Matches result;
+	std::vector<ucs4_t> chars;
+	size_t winpos = 0, nextfrom = 0, read = 0;
+	maxwin = 0;
+	for (;;)
+	{
+		size_t n = std::min(block, text.size() - read);
+		for (size_t i = read; i < read + n; ++i)
+			chars.push_back(ucs4_t((unsigned char)text[i]));
+		read += n;
+		maxwin = std::max(maxwin, chars.size());
+
+		const bool eof = (read == text.size());
+		size_t commit = win.CommitPoint(chars.empty() ? nullptr : &chars[0], chars.size(), eof);
+		if (commit > 0)
+		{
+			Matches found;
+			size_t partial = chars.size();
+			const bool growing = win.Growing(chars.size(), eof);
+			FindAll(text.substr(winpos, chars.size()), nextfrom - winpos, re, found, growing ? &partial : nullptr);
+			commit = std::min(commit, partial);
+			for (size_t m = 0; m < found.size(); ++m)
+			{
+				if (found[m].first >= commit)
+					break;
+				if (win.Unfinished(found[m].second, chars.size(), eof))
+				{
+					commit = found[m].first;
+					break;
+				}
+
+				result.push_back(std::make_pair(winpos + found[m].first, winpos + found[m].second));
+				nextfrom = winpos + std::max(found[m].second, found[m].first + 1);
+			}
+			nextfrom = std::max(nextfrom, winpos + commit);
+
+			chars.erase(chars.begin(), chars.begin() + commit);
+			winpos += commit;
+		}
+
+		if (eof)
+			return result;
+	}
+}
+
+std::string Lines(size_t count, const std::string& line)
+{
+	std::string s;
+	for (size_t i = 0; i < count; ++i)
+		s += line + "\n";
+	return s;
+}
+
+void CheckSliding(const std::string& text, const std::string& expr, bool dot_newline)
+{
+	size_t maxwin = 0;
+	Matches sliding = SearchSliding(text, expr, dot_newline, maxwin);
+	Matches whole = SearchWhole(text, expr, dot_newline);
+	BOOST_CHECK_MESSAGE(!whole.empty(), expr);
+	BOOST_CHECK_MESSAGE(sliding == whole, expr << (dot_newline ? " with" : " without") << " '.' matching newlines");
+}
+
+} // anonymous namespace
+
+void test_search_window_commit()
+{
+	std::cout << "wxMEdit-search-window-commit" << std::endl;
+
+	xm::SlidingWindow win(tail, max_chars, max_match);
+	std::string text = Lines(10, "0123456789");
+	std::vector<ucs4_t> chars(text.begin(), text.end());
+
+	// a fixed length match ends in the tail
+	BOOST_CHECK(win.CommitPoint(&chars[0], chars.size(), false) == chars.size() - tail);
+	BOOST_CHECK(win.CommitPoint(&chars[0], tail, false) == 0);
+	BOOST_CHECK(win.CommitPoint(&chars[0], chars.size(), true) == chars.size());
+	BOOST_CHECK(!win.Unfinished(chars.size(), chars.size(), false));
+
+	// a regex match is searched in whole lines
+	win.regex = true;
+	BOOST_CHECK(win.CommitPoint(&chars[0], chars.size(), false) == 88);
+	BOOST_CHECK(win.Unfinished(chars.size(), chars.size(), false));
+	BOOST_CHECK(!win.Unfinished(chars.size() - 1, chars.size(), false));
+	BOOST_CHECK(!win.Unfinished(chars.size(), chars.size(), true));
+
+	// or in the whole file if '.' matches the newlines
+	win.dot_newline = true;
+	BOOST_CHECK(win.CommitPoint(&chars[0], chars.size(), false) == 0);
+	BOOST_CHECK(win.CommitPoint(&chars[0], chars.size(), true) == chars.size());
+}
+
+void test_search_window_sliding()
+{
+	std::cout << "wxMEdit-search-window-sliding" << std::endl;
+
+	// the matches across the lines and the blocks, greedy to the end of the file
+	std::string text = "a" + Lines(150, "the lines between a and b") + "b" + Lines(20, "no more");
+	CheckSliding(text, "a.*b", true);
+	CheckSliding(text, "a.*?b", true);
+	CheckSliding(text, "between a", true);
+	CheckSliding(text, "between a", false);
+
+	// a match across the lines, partial at the end of the window
+	std::string spaced = "x" + std::string(2000, '\n') + "y" + Lines(20, "no more");
+	CheckSliding(spaced, "x\\s+y", false);
+	CheckSliding(spaced, "x[^y]*y", false);
+
+	// a match in a line longer than the window
+	std::string longline = Lines(3, "short") + std::string(1000, 'q') + "!" + Lines(3, "short");
+	CheckSliding(longline, "q+!", false);
+	CheckSliding(longline, "q+", false);
+}
+
+void test_search_window_max_match()
+{
+	std::cout << "wxMEdit-search-window-max-match" << std::endl;
+
+	// a match longer than max_match is cut, and the window stays bounded
+	std::string text = "a" + Lines(1000, "the lines after a");
+	size_t maxwin = 0;
+	Matches sliding = SearchSliding(text, "a.*", true, maxwin);
+	BOOST_REQUIRE(!sliding.empty());
+	BOOST_CHECK(sliding[0].first == 0);
+	BOOST_CHECK(sliding[0].second <= max_match + block);
+	BOOST_CHECK(sliding.back().second == text.size());
+	BOOST_CHECK(maxwin < max_match + 2 * block);
+}
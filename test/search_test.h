@@ -0,0 +1,20 @@
+///////////////////////////////////////////////////////////////////////////////
+// vim:         sw=4 ts=4
+// Description: Search Test Utils
+// Copyright:   2013-2019  JiaYanwei   <wxmedit@gmail.com>
+// License:     GPLv3
+///////////////////////////////////////////////////////////////////////////////
+#ifndef WXMEDIT_SEARCH_TEST_H
+#define WXMEDIT_SEARCH_TEST_H
+
+void test_search_window_commit();
+void test_search_window_sliding();
+void test_search_window_max_match();
+
+void test_buffer_searcher_literal();
+void test_buffer_searcher_regex();
+void test_buffer_searcher_partial();
+void test_buffer_searcher_hex();
+void test_buffer_searcher_replace();
+
+#endif //WXMEDIT_SEARCH_TEST_H
@@ -6,6 +6,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "encoding_test.h"
 #include "encdet_test.h"
+#include "document_test.h"
+#include "search_test.h"
 #include "../src/xm/encoding/external.h"
 
 # include <boost/test/included/unit_test.hpp>
@@ -19,6 +21,7 @@ const wchar_t * LocalizeText(const wchar_t* txt) { return txt; }
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
 	boost::unit_test::test_suite* encoding_test = BOOST_TEST_SUITE("encoding_test");
+	encoding_test->add(BOOST_TEST_CASE(&test_gb18030_filled_tables));
 	encoding_test->add(BOOST_TEST_CASE(&test_gb18030_conv));
 	encoding_test->add(BOOST_TEST_CASE(&test_doublebyte_conv));
 	encoding_test->add(BOOST_TEST_CASE(&test_singlebyte_conv));
@@ -38,10 +41,38 @@ boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 	encdet_test->add(encdet_test_wxmedit_cases);
 	encdet_test->add(encdet_test_with_mozcases);
 	encdet_test->add(BOOST_TEST_CASE(&test_encdet_with_icucases));
+	encdet_test->add(BOOST_TEST_CASE(&test_encdet_ascii));
+	encdet_test->add(BOOST_TEST_CASE(&test_encdet_utf8_validation));
+	encdet_test->add(BOOST_TEST_CASE(&test_encdet_samples));
+	encdet_test->add(BOOST_TEST_CASE(&test_encdet_byte_stats));
+	encdet_test->add(BOOST_TEST_CASE(&test_encdet_detector_reuse));
+
+	boost::unit_test::test_suite* document_test = BOOST_TEST_SUITE("document_test");
+	document_test->add(BOOST_TEST_CASE(&test_undo_remap_after_save));
+	document_test->add(BOOST_TEST_CASE(&test_undo_remap_back));
+	document_test->add(BOOST_TEST_CASE(&test_undo_memory_limit));
+	document_test->add(BOOST_TEST_CASE(&test_undo_memory_pinned));
+	document_test->add(BOOST_TEST_CASE(&test_memdata_compact_steps));
+	document_test->add(BOOST_TEST_CASE(&test_undo_journal));
+	document_test->add(BOOST_TEST_CASE(&test_undo_journal_compacting));
+	document_test->add(BOOST_TEST_CASE(&test_undo_journal_content));
+	document_test->add(BOOST_TEST_CASE(&test_undo_journal_lock_and_prune));
+
+	boost::unit_test::test_suite* search_test = BOOST_TEST_SUITE("search_test");
+	search_test->add(BOOST_TEST_CASE(&test_search_window_commit));
+	search_test->add(BOOST_TEST_CASE(&test_search_window_sliding));
+	search_test->add(BOOST_TEST_CASE(&test_search_window_max_match));
+	search_test->add(BOOST_TEST_CASE(&test_buffer_searcher_literal));
+	search_test->add(BOOST_TEST_CASE(&test_buffer_searcher_regex));
+	search_test->add(BOOST_TEST_CASE(&test_buffer_searcher_partial));
+	search_test->add(BOOST_TEST_CASE(&test_buffer_searcher_hex));
+	search_test->add(BOOST_TEST_CASE(&test_buffer_searcher_replace));
 
 	boost::unit_test::test_suite* test = BOOST_TEST_SUITE("wxmedit_test");
 	test->add(encdet_test);
 	test->add(encoding_test);
+	test->add(document_test);
+	test->add(search_test);
 
 	return test;
 }